@@ -95,7 +95,10 @@ static int runQtApplication(int argc, char* argv[], qtwebapp::LoggerWithFile *lo
     // This will run the task from the application event loop
     QTimer::singleShot(0, &m, SLOT(run()));
 
-    return a.exec();
+    int res = a.exec();
+
+    // a failed correctness check makes the run fail
+    return m.getNbFailures() > 0 ? 1 : res;
 }
 
 int main(int argc, char* argv[])
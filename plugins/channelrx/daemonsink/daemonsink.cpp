@@ -25,6 +25,8 @@
 #include <boost/crc.hpp>
 #include <boost/cstdint.hpp>
 
+#include <QElapsedTimer>
+
 #include "SWGChannelSettings.h"
 
 #include "util/simpleserializer.h"
@@ -54,10 +56,14 @@ DaemonSink::DaemonSink(DeviceSourceAPI *deviceAPI) :
         m_sampleRate(48000),
         m_nbBlocksFEC(0),
         m_txDelay(35),
+        m_nbBlocksPerDatagram(1),
+        m_codecType(SDRDaemonCodec::CodecNone),
+        m_codecBits(12),
         m_dataAddress("127.0.0.1"),
         m_dataPort(9090)
 {
     setObjectName(m_channelId);
+    m_codec.setCodec(SDRDaemonCodec::CodecNone, 0, SDR_RX_SAMP_SZ <= 16 ? 2 : 4);
 
     m_channelizer = new DownChannelizer(this);
     m_threadedChannelizer = new ThreadedBasebandSampleSink(m_channelizer, this);
@@ -81,7 +87,9 @@ DaemonSink::~DaemonSink()
 void DaemonSink::setTxDelay(int txDelay, int nbBlocksFEC)
 {
     double txDelayRatio = txDelay / 100.0;
-    int samplesPerBlock = SDRDaemonNbBytesPerBlock / sizeof(Sample);
+    SDRDaemonCodec codec; // blocks carry more samples when coded
+    codec.setCodec(m_codecType, m_codecBits, SDR_RX_SAMP_SZ <= 16 ? 2 : 4);
+    int samplesPerBlock = codec.getNbSamplesPerBlock();
     double delay = m_sampleRate == 0 ? 1.0 : (127*samplesPerBlock*txDelayRatio) / m_sampleRate;
     delay /= 128 + nbBlocksFEC;
     m_txDelay = roundf(delay*1e6); // microseconds
@@ -97,6 +105,20 @@ void DaemonSink::setNbBlocksFEC(int nbBlocksFEC)
     m_nbBlocksFEC = nbBlocksFEC;
 }
 
+void DaemonSink::setDatagramSize(int datagramSize)
+{
+    m_nbBlocksPerDatagram = SDRDaemonNbBlocksPerDatagram(datagramSize);
+    qDebug() << "DaemonSink::setDatagramSize: datagramSize: " << datagramSize << " blocks per datagram: " << m_nbBlocksPerDatagram;
+}
+
+void DaemonSink::setCodec(int codec, int codecBits)
+{
+    m_codecType = (codec > (int) SDRDaemonCodec::CodecNone) && (codec <= (int) SDRDaemonCodec::CodecBFP) ?
+            (SDRDaemonCodec::CodecType) codec : SDRDaemonCodec::CodecNone;
+    m_codecBits = codecBits;
+    qDebug() << "DaemonSink::setCodec: codec: " << (int) m_codecType << " codecBits: " << m_codecBits;
+}
+
 void DaemonSink::feed(const SampleVector::const_iterator& begin, const SampleVector::const_iterator& end, bool firstOfBurst)
 {
     (void) firstOfBurst;
@@ -115,7 +137,7 @@ void DaemonSink::feed(const SampleVector::const_iterator& begin, const SampleVec
 
             metaData.m_centerFrequency = m_centerFrequency;
             metaData.m_sampleRate = m_sampleRate;
-            metaData.m_sampleBytes = (SDR_RX_SAMP_SZ <= 16 ? 2 : 4);
+            metaData.setSampleBytes(SDR_RX_SAMP_SZ <= 16 ? 2 : 4, m_nbBlocksPerDatagram);
             metaData.m_sampleBits = SDR_RX_SAMP_SZ;
             metaData.m_nbOriginalBlocks = SDRDaemonNbOrginalBlocks;
             metaData.m_nbFECBlocks = m_nbBlocksFEC;
@@ -126,6 +148,8 @@ void DaemonSink::feed(const SampleVector::const_iterator& begin, const SampleVec
                 m_dataBlock = new SDRDaemonDataBlock();
             }
 
+            m_codec.setCodec(m_codecType, m_codecBits, SDR_RX_SAMP_SZ <= 16 ? 2 : 4); // codec changes only at frame boundaries
+
             boost::crc_32_type crc32;
             crc32.process_bytes(&metaData, 20);
             metaData.m_crc32 = crc32.checksum();
@@ -135,6 +159,8 @@ void DaemonSink::feed(const SampleVector::const_iterator& begin, const SampleVec
             superBlock.m_header.m_blockIndex = m_txBlockIndex;
             superBlock.m_header.m_sampleBytes = (SDR_RX_SAMP_SZ <= 16 ? 2 : 4);
             superBlock.m_header.m_sampleBits = SDR_RX_SAMP_SZ;
+            superBlock.m_header.m_codec = (uint8_t) m_codec.getCodecType();
+            superBlock.m_header.m_codecBits = m_codec.getNbBits();
 
             SDRDaemonMetaDataFEC *destMeta = (SDRDaemonMetaDataFEC *) &superBlock.m_protectedBlock;
             *destMeta = metaData;
@@ -147,6 +173,9 @@ void DaemonSink::feed(const SampleVector::const_iterator& begin, const SampleVec
                         << ":" << metaData.m_sampleRate
                         << ":" << (int) (metaData.m_sampleBytes & 0xF)
                         << ":" << (int) metaData.m_sampleBits
+                        << ":" << metaData.getNbBlocksPerDatagram()
+                        << "|" << (int) m_codec.getCodecType()
+                        << ":" << m_codec.getNbBits()
                         << "|" << (int) metaData.m_nbOriginalBlocks
                         << ":" << (int) metaData.m_nbFECBlocks
                         << "|" << metaData.m_tv_sec
@@ -158,11 +187,14 @@ void DaemonSink::feed(const SampleVector::const_iterator& begin, const SampleVec
             m_txBlockIndex = 1; // next Tx block with data
         } // block zero
 
-        // handle different sample sizes...
-        int samplesPerBlock = SDRDaemonNbBytesPerBlock / (SDR_RX_SAMP_SZ <= 16 ? 4 : 8); // two I or Q samples
+        // samples are staged in the raw sample buffer when coded
+        int samplesPerBlock = m_codec.getNbSamplesPerBlock();
+        uint8_t *blockSamples = m_codec.getCodecType() == SDRDaemonCodec::CodecNone ?
+                m_superBlock.m_protectedBlock.buf : (uint8_t *) m_codecSamples;
+
         if (m_sampleIndex + inRemainingSamples < samplesPerBlock) // there is still room in the current super block
         {
-            memcpy((void *) &m_superBlock.m_protectedBlock.buf[m_sampleIndex*sizeof(Sample)],
+            memcpy((void *) &blockSamples[m_sampleIndex*sizeof(Sample)],
                     (const void *) &(*(begin+inSamplesIndex)),
                     inRemainingSamples * sizeof(Sample));
             m_sampleIndex += inRemainingSamples;
@@ -170,16 +202,26 @@ void DaemonSink::feed(const SampleVector::const_iterator& begin, const SampleVec
         }
         else // complete super block and initiate the next if not end of frame
         {
-            memcpy((void *) &m_superBlock.m_protectedBlock.buf[m_sampleIndex*sizeof(Sample)],
+            memcpy((void *) &blockSamples[m_sampleIndex*sizeof(Sample)],
                     (const void *) &(*(begin+inSamplesIndex)),
                     (samplesPerBlock - m_sampleIndex) * sizeof(Sample));
             it += samplesPerBlock - m_sampleIndex;
             m_sampleIndex = 0;
 
+            if (m_codec.getCodecType() != SDRDaemonCodec::CodecNone)
+            {
+                QElapsedTimer encodeTimer;
+                encodeTimer.start();
+                m_codec.encode(blockSamples, m_superBlock.m_protectedBlock.buf);
+                m_encodeNsPerSample(encodeTimer.nsecsElapsed() / (double) samplesPerBlock);
+            }
+
             m_superBlock.m_header.m_frameIndex = m_frameCount;
             m_superBlock.m_header.m_blockIndex = m_txBlockIndex;
             m_superBlock.m_header.m_sampleBytes = (SDR_RX_SAMP_SZ <= 16 ? 2 : 4);
             m_superBlock.m_header.m_sampleBits = SDR_RX_SAMP_SZ;
+            m_superBlock.m_header.m_codec = (uint8_t) m_codec.getCodecType();
+            m_superBlock.m_header.m_codecBits = m_codec.getNbBits();
             m_dataBlock->m_superBlocks[m_txBlockIndex] = m_superBlock;
 
             if (m_txBlockIndex == SDRDaemonNbOrginalBlocks - 1) // frame complete
@@ -190,6 +232,7 @@ void DaemonSink::feed(const SampleVector::const_iterator& begin, const SampleVec
                 m_dataBlock->m_txControlBlock.m_complete = true;
                 m_dataBlock->m_txControlBlock.m_nbBlocksFEC = m_nbBlocksFEC;
                 m_dataBlock->m_txControlBlock.m_txDelay = m_txDelay;
+                m_dataBlock->m_txControlBlock.m_nbBlocksPerDatagram = m_currentMetaFEC.getNbBlocksPerDatagram();
                 m_dataBlock->m_txControlBlock.m_dataAddress = m_dataAddress;
                 m_dataBlock->m_txControlBlock.m_dataPort = m_dataPort;
 
@@ -321,10 +364,20 @@ void DaemonSink::applySettings(const DaemonSinkSettings& settings, bool force)
     qDebug() << "DaemonSink::applySettings:"
             << " m_nbFECBlocks: " << settings.m_nbFECBlocks
             << " m_txDelay: " << settings.m_txDelay
+            << " m_datagramSize: " << settings.m_datagramSize
+            << " m_codec: " << settings.m_codec
+            << " m_codecBits: " << settings.m_codecBits
             << " m_dataAddress: " << settings.m_dataAddress
             << " m_dataPort: " << settings.m_dataPort
             << " force: " << force;
 
+    if ((m_settings.m_codec != settings.m_codec)
+     || (m_settings.m_codecBits != settings.m_codecBits) || force)
+    {
+        setCodec(settings.m_codec, settings.m_codecBits);
+        setTxDelay(settings.m_txDelay, settings.m_nbFECBlocks);
+    }
+
     if ((m_settings.m_nbFECBlocks != settings.m_nbFECBlocks) || force) {
         setNbBlocksFEC(settings.m_nbFECBlocks);
         setTxDelay(settings.m_txDelay, settings.m_nbFECBlocks);
@@ -334,6 +387,10 @@ void DaemonSink::applySettings(const DaemonSinkSettings& settings, bool force)
         setTxDelay(settings.m_txDelay, settings.m_nbFECBlocks);
     }
 
+    if ((m_settings.m_datagramSize != settings.m_datagramSize) || force) {
+        setDatagramSize(settings.m_datagramSize);
+    }
+
     if ((m_settings.m_dataAddress != settings.m_dataAddress) || force) {
         m_dataAddress = settings.m_dataAddress;
     }
@@ -387,6 +444,32 @@ int DaemonSink::webapiSettingsPutPatch(
         }
     }
 
+    if (channelSettingsKeys.contains("datagramSize"))
+    {
+        int datagramSize = response.getDaemonSinkSettings()->getDatagramSize();
+
+        if ((datagramSize < SDRDaemonUdpSize) || (datagramSize > SDRDaemonMaxDatagramSize)) {
+            settings.m_datagramSize = SDRDaemonUdpSize;
+        } else {
+            settings.m_datagramSize = datagramSize;
+        }
+    }
+
+    if (channelSettingsKeys.contains("codec"))
+    {
+        int codec = response.getDaemonSinkSettings()->getCodec();
+
+        if ((codec < 0) || (codec > (int) SDRDaemonCodec::CodecBFP)) {
+            settings.m_codec = 0;
+        } else {
+            settings.m_codec = codec;
+        }
+    }
+
+    if (channelSettingsKeys.contains("codecBits")) {
+        settings.m_codecBits = response.getDaemonSinkSettings()->getCodecBits();
+    }
+
     if (channelSettingsKeys.contains("dataAddress")) {
         settings.m_dataAddress = *response.getDaemonSinkSettings()->getDataAddress();
     }
@@ -429,6 +512,9 @@ void DaemonSink::webapiFormatChannelSettings(SWGSDRangel::SWGChannelSettings& re
 {
     response.getDaemonSinkSettings()->setNbFecBlocks(settings.m_nbFECBlocks);
     response.getDaemonSinkSettings()->setTxDelay(settings.m_txDelay);
+    response.getDaemonSinkSettings()->setDatagramSize(settings.m_datagramSize);
+    response.getDaemonSinkSettings()->setCodec(settings.m_codec);
+    response.getDaemonSinkSettings()->setCodecBits(settings.m_codecBits);
 
     if (response.getDaemonSinkSettings()->getDataAddress()) {
         *response.getDaemonSinkSettings()->getDataAddress() = settings.m_dataAddress;
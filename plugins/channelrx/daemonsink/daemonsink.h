@@ -29,6 +29,8 @@
 #include "dsp/basebandsamplesink.h"
 #include "channel/channelsinkapi.h"
 #include "channel/sdrdaemondatablock.h"
+#include "channel/sdrdaemoncodec.h"
+#include "util/movingaverage.h"
 #include "daemonsinksettings.h"
 
 class DeviceSourceAPI;
@@ -116,9 +118,16 @@ public:
 
     void setNbBlocksFEC(int nbBlocksFEC);
     void setTxDelay(int txDelay, int nbBlocksFEC);
+    void setDatagramSize(int datagramSize);
+    void setCodec(int codec, int codecBits);
     void setDataAddress(const QString& address) { m_dataAddress = address; }
     void setDataPort(uint16_t port) { m_dataPort = port; }
 
+    /** Compression ratio of the current codec */
+    float getCompressionRatio() const { return m_codec.getCompressionRatio(); }
+    /** Average encoder time in nanoseconds per I/Q sample */
+    double getEncodeNsPerSample() const { return m_encodeNsPerSample.asDouble(); }
+
     static const QString m_channelIdURI;
     static const QString m_channelId;
 
@@ -146,6 +155,12 @@ private:
     uint32_t m_sampleRate;
     int m_nbBlocksFEC;
     int m_txDelay;
+    int m_nbBlocksPerDatagram;
+    SDRDaemonCodec::CodecType m_codecType; //!< requested codec applied at next frame
+    int m_codecBits;                       //!< requested codec bits applied at next frame
+    SDRDaemonCodec m_codec;                //!< codec of the current frame
+    Sample m_codecSamples[SDRDaemonNbBytesPerBlock]; //!< raw samples of the current block when coded. Any codec has less samples per block than bytes.
+    MovingAverageUtil<double, double, 16> m_encodeNsPerSample;
     QString m_dataAddress;
     uint16_t m_dataPort;
 
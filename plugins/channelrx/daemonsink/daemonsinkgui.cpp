@@ -131,7 +131,7 @@ DaemonSinkGUI::DaemonSinkGUI(PluginAPI* pluginAPI, DeviceUISet *deviceUISet, Bas
     m_deviceUISet->addRollupWidget(this);
 
     connect(getInputMessageQueue(), SIGNAL(messageEnqueued()), this, SLOT(handleSourceMessages()));
-    //connect(&(m_deviceUISet->m_deviceSourceAPI->getMasterTimer()), SIGNAL(timeout()), this, SLOT(tick()));
+    connect(&MainWindow::getInstance()->getMasterTimer(), SIGNAL(timeout()), this, SLOT(tick()));
 
     m_time.start();
 
@@ -182,6 +182,17 @@ void DaemonSinkGUI::displaySettings()
     ui->txDelayText->setText(tr("%1%").arg(m_settings.m_txDelay));
     ui->txDelay->setValue(m_settings.m_txDelay);
     updateTxDelayTime();
+
+    int nbBlocksPerDatagram = SDRDaemonNbBlocksPerDatagram(m_settings.m_datagramSize);
+    int datagramSizeIndex = 0;
+
+    while ((1 << datagramSizeIndex) < nbBlocksPerDatagram) {
+        datagramSizeIndex++;
+    }
+
+    ui->datagramSize->setCurrentIndex(datagramSizeIndex);
+    ui->codec->setCurrentIndex(m_settings.m_codec);
+    ui->codecBits->setValue(m_settings.m_codecBits);
     blockApplySettings(false);
 }
 
@@ -288,10 +299,32 @@ void DaemonSinkGUI::on_nbFECBlocks_valueChanged(int value)
     applySettings();
 }
 
+void DaemonSinkGUI::on_datagramSize_currentIndexChanged(int index)
+{
+    m_settings.m_datagramSize = SDRDaemonUdpSize << index;
+    applySettings();
+}
+
+void DaemonSinkGUI::on_codec_currentIndexChanged(int index)
+{
+    m_settings.m_codec = index;
+    updateTxDelayTime();
+    applySettings();
+}
+
+void DaemonSinkGUI::on_codecBits_valueChanged(int value)
+{
+    m_settings.m_codecBits = value;
+    updateTxDelayTime();
+    applySettings();
+}
+
 void DaemonSinkGUI::updateTxDelayTime()
 {
     double txDelayRatio = m_settings.m_txDelay / 100.0;
-    int samplesPerBlock = SDRDaemonNbBytesPerBlock / sizeof(Sample);
+    SDRDaemonCodec codec;
+    codec.setCodec((SDRDaemonCodec::CodecType) m_settings.m_codec, m_settings.m_codecBits, SDR_RX_SAMP_SZ <= 16 ? 2 : 4);
+    int samplesPerBlock = codec.getNbSamplesPerBlock();
     double delay = m_sampleRate == 0 ? 0.0 : (127*samplesPerBlock*txDelayRatio) / m_sampleRate;
     delay /= 128 + m_settings.m_nbFECBlocks;
     ui->txDelayTime->setText(tr("%1µs").arg(QString::number(delay*1e6, 'f', 0)));
@@ -299,7 +332,11 @@ void DaemonSinkGUI::updateTxDelayTime()
 
 void DaemonSinkGUI::tick()
 {
-    if (++m_tickCount == 20) { // once per second
+    if (++m_tickCount == 20) // once per second
+    {
+        ui->codecStatsText->setText(tr("x%1 %2 ns/S")
+            .arg(QString::number(m_daemonSink->getCompressionRatio(), 'f', 2))
+            .arg(QString::number(m_daemonSink->getEncodeNsPerSample(), 'f', 1)));
         m_tickCount = 0;
     }
 }
@@ -87,6 +87,9 @@ private slots:
     void on_dataApplyButton_clicked(bool checked);
     void on_nbFECBlocks_valueChanged(int value);
     void on_txDelay_valueChanged(int value);
+    void on_datagramSize_currentIndexChanged(int index);
+    void on_codec_currentIndexChanged(int index);
+    void on_codecBits_valueChanged(int value);
     void onWidgetRolled(QWidget* widget, bool rollDown);
     void onMenuDialogCalled(const QPoint& p);
     void tick();
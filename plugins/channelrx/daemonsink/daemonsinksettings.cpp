@@ -35,6 +35,9 @@ void DaemonSinkSettings::resetToDefaults()
 {
     m_nbFECBlocks = 0;
     m_txDelay = 35;
+    m_datagramSize = 512;
+    m_codec = 0;
+    m_codecBits = 12;
     m_dataAddress = "127.0.0.1";
     m_dataPort = 9090;
     m_rgbColor = QColor(140, 4, 4).rgb();
@@ -51,6 +54,9 @@ QByteArray DaemonSinkSettings::serialize() const
     s.writeU32(4, m_dataPort);
     s.writeU32(5, m_rgbColor);
     s.writeString(6, m_title);
+    s.writeU32(7, m_datagramSize);
+    s.writeU32(8, m_codec);
+    s.writeU32(9, m_codecBits);
 
     return s.final();
 }
@@ -90,6 +96,10 @@ bool DaemonSinkSettings::deserialize(const QByteArray& data)
 
         d.readU32(5, &m_rgbColor, QColor(0, 255, 255).rgb());
         d.readString(6, &m_title, "Daemon sink");
+        d.readU32(7, &m_datagramSize, 512);
+        d.readU32(8, &tmp, 0);
+        m_codec = tmp < 3 ? tmp : 0;
+        d.readU32(9, &m_codecBits, 12);
 
         return true;
     }
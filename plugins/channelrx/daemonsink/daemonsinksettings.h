@@ -31,6 +31,9 @@ struct DaemonSinkSettings
 {
     uint16_t m_nbFECBlocks;
     uint32_t m_txDelay;
+    uint32_t m_datagramSize; //!< UDP datagram size in bytes: 512 or jumbo frames up to 8192 bytes
+    uint32_t m_codec;        //!< sample codec (SDRDaemonCodec::CodecType)
+    uint32_t m_codecBits;    //!< codec bits per I or Q component
     QString  m_dataAddress;
     uint16_t m_dataPort;
     quint32 m_rgbColor;
@@ -20,9 +20,8 @@
 // along with this program. If not, see <http://www.gnu.org/licenses/>.          //
 ///////////////////////////////////////////////////////////////////////////////////
 
-#include <QUdpSocket>
-
 #include "channel/sdrdaemondatablock.h"
+#include "util/udpbatchsocket.h"
 #include "daemonsinkthread.h"
 
 #include "cm256.h"
@@ -32,17 +31,33 @@ MESSAGE_CLASS_DEFINITION(DaemonSinkThread::MsgStartStop, Message)
 DaemonSinkThread::DaemonSinkThread(QObject* parent) :
     QThread(parent),
     m_running(false),
+    m_encoderPool(DAEMONSINKTHREAD_NBENCODERS),
     m_address(QHostAddress::LocalHost),
     m_socket(0)
 {
+    m_cm256p = m_cm256;
+
+    for (int i = 0; i < DAEMONSINKTHREAD_NBENCODERS; i++)
+    {
+        if (!m_cm256[i].isInitialized()) {
+            m_cm256p = 0;
+        }
+    }
 
-    m_cm256p = m_cm256.isInitialized() ? &m_cm256 : 0;
     connect(&m_inputMessageQueue, SIGNAL(messageEnqueued()), this, SLOT(handleInputMessages()), Qt::QueuedConnection);
+    connect(&m_encoderPool, SIGNAL(jobProcessed()), this, SLOT(handleEncodedDataBlocks()), Qt::QueuedConnection);
 }
 
 DaemonSinkThread::~DaemonSinkThread()
 {
     qDebug("DaemonSinkThread::~DaemonSinkThread");
+    EncodeJob *encodeJob;
+
+    while ((encodeJob = (EncodeJob *) m_encoderPool.popWait()) != 0)
+    {
+        delete encodeJob->m_dataBlock;
+        delete encodeJob;
+    }
 }
 
 void DaemonSinkThread::startStop(bool start)
@@ -55,7 +70,8 @@ void DaemonSinkThread::startWork()
 {
     qDebug("DaemonSinkThread::startWork");
 	m_startWaitMutex.lock();
-	m_socket = new QUdpSocket(this);
+	m_socket = new UDPBatchSocket(this);
+    m_socket->setBufferSizes(256 * SDRDaemonUdpSize, 0); // room for a full frame with FEC
 	start();
 	while(!m_running)
 		m_startWaiter.wait(&m_startWaitMutex, 100);
@@ -65,6 +81,15 @@ void DaemonSinkThread::startWork()
 void DaemonSinkThread::stopWork()
 {
 	qDebug("DaemonSinkThread::stopWork");
+    EncodeJob *encodeJob;
+
+    while ((encodeJob = (EncodeJob *) m_encoderPool.popWait()) != 0) // flush data blocks in flight
+    {
+        transmitDataBlock(*encodeJob->m_dataBlock);
+        delete encodeJob->m_dataBlock;
+        delete encodeJob;
+    }
+
     delete m_socket;
     m_socket = 0;
 	m_running = false;
@@ -88,78 +113,94 @@ void DaemonSinkThread::run()
 
 void DaemonSinkThread::processDataBlock(SDRDaemonDataBlock *dataBlock)
 {
-    handleDataBlock(*dataBlock);
-    delete dataBlock;
+    m_encoderPool.push(new EncodeJob(m_cm256p, dataBlock));
 }
 
-void DaemonSinkThread::handleDataBlock(SDRDaemonDataBlock& dataBlock)
+void DaemonSinkThread::handleEncodedDataBlocks()
+{
+    EncodeJob *encodeJob;
+
+    while ((encodeJob = (EncodeJob *) m_encoderPool.popProcessed()) != 0)
+    {
+        transmitDataBlock(*encodeJob->m_dataBlock);
+        delete encodeJob->m_dataBlock;
+        delete encodeJob;
+    }
+}
+
+bool DaemonSinkThread::EncodeJob::process(unsigned int workerIndex)
 {
 	CM256::cm256_encoder_params cm256Params;  //!< Main interface with CM256 encoder
 	CM256::cm256_block descriptorBlocks[256]; //!< Pointers to data for CM256 encoder
 	SDRDaemonProtectedBlock fecBlocks[256];   //!< FEC data
 
-    uint16_t frameIndex = dataBlock.m_txControlBlock.m_frameIndex;
-    int nbBlocksFEC = dataBlock.m_txControlBlock.m_nbBlocksFEC;
-    int txDelay = dataBlock.m_txControlBlock.m_txDelay;
-    m_address.setAddress(dataBlock.m_txControlBlock.m_dataAddress);
-    uint16_t dataPort = dataBlock.m_txControlBlock.m_dataPort;
-    SDRDaemonSuperBlock *txBlockx = dataBlock.m_superBlocks;
+    uint16_t frameIndex = m_dataBlock->m_txControlBlock.m_frameIndex;
+    int nbBlocksFEC = m_dataBlock->m_txControlBlock.m_nbBlocksFEC;
+    SDRDaemonSuperBlock *txBlockx = m_dataBlock->m_superBlocks;
+
+    if ((nbBlocksFEC == 0) || !m_cm256) { // Do not FEC encode
+        return false;
+    }
+
+    cm256Params.BlockBytes = sizeof(SDRDaemonProtectedBlock);
+    cm256Params.OriginalCount = SDRDaemonNbOrginalBlocks;
+    cm256Params.RecoveryCount = nbBlocksFEC;
 
-    if ((nbBlocksFEC == 0) || !m_cm256p) // Do not FEC encode
+    // Fill pointers to data
+    for (int i = 0; i < cm256Params.OriginalCount + cm256Params.RecoveryCount; ++i)
     {
-        if (m_socket)
-        {
-            for (int i = 0; i < SDRDaemonNbOrginalBlocks; i++)
-            {
-                // send block via UDP
-                m_socket->writeDatagram((const char*)&txBlockx[i], (qint64 ) SDRDaemonUdpSize, m_address, dataPort);
-                usleep(txDelay);
-            }
+        if (i >= cm256Params.OriginalCount) {
+            memset((void *) &txBlockx[i].m_protectedBlock, 0, sizeof(SDRDaemonProtectedBlock));
         }
+
+        txBlockx[i].m_header.m_frameIndex = frameIndex;
+        txBlockx[i].m_header.m_blockIndex = i;
+        txBlockx[i].m_header.m_sampleBytes = (SDR_RX_SAMP_SZ <= 16 ? 2 : 4);
+        txBlockx[i].m_header.m_sampleBits = SDR_RX_SAMP_SZ;
+        txBlockx[i].m_header.m_codec = txBlockx[0].m_header.m_codec; // FEC blocks carry the codec of the frame
+        txBlockx[i].m_header.m_codecBits = txBlockx[0].m_header.m_codecBits;
+        descriptorBlocks[i].Block = (void *) &(txBlockx[i].m_protectedBlock);
+        descriptorBlocks[i].Index = txBlockx[i].m_header.m_blockIndex;
     }
-    else
+
+    // Encode FEC blocks
+    if (m_cm256[workerIndex].cm256_encode(cm256Params, descriptorBlocks, fecBlocks))
     {
-        cm256Params.BlockBytes = sizeof(SDRDaemonProtectedBlock);
-        cm256Params.OriginalCount = SDRDaemonNbOrginalBlocks;
-        cm256Params.RecoveryCount = nbBlocksFEC;
+        qWarning("DaemonSinkThread::EncodeJob::process: CM256 encode failed. No transmission.");
+        // TODO: send without FEC changing meta data to set indication of no FEC
+    }
 
-        // Fill pointers to data
-        for (int i = 0; i < cm256Params.OriginalCount + cm256Params.RecoveryCount; ++i)
-        {
-            if (i >= cm256Params.OriginalCount) {
-                memset((void *) &txBlockx[i].m_protectedBlock, 0, sizeof(SDRDaemonProtectedBlock));
-            }
+    // Merge FEC with data to transmit
+    for (int i = 0; i < cm256Params.RecoveryCount; i++)
+    {
+        txBlockx[i + cm256Params.OriginalCount].m_protectedBlock = fecBlocks[i];
+    }
 
-            txBlockx[i].m_header.m_frameIndex = frameIndex;
-            txBlockx[i].m_header.m_blockIndex = i;
-            txBlockx[i].m_header.m_sampleBytes = (SDR_RX_SAMP_SZ <= 16 ? 2 : 4);
-            txBlockx[i].m_header.m_sampleBits = SDR_RX_SAMP_SZ;
-            descriptorBlocks[i].Block = (void *) &(txBlockx[i].m_protectedBlock);
-            descriptorBlocks[i].Index = txBlockx[i].m_header.m_blockIndex;
-        }
+    return true;
+}
 
-        // Encode FEC blocks
-        if (m_cm256p->cm256_encode(cm256Params, descriptorBlocks, fecBlocks))
-        {
-            qWarning("SDRDaemonChannelSinkThread::handleDataBlock: CM256 encode failed. No transmission.");
-            // TODO: send without FEC changing meta data to set indication of no FEC
-        }
+void DaemonSinkThread::transmitDataBlock(SDRDaemonDataBlock& dataBlock)
+{
+    int nbBlocksFEC = dataBlock.m_txControlBlock.m_nbBlocksFEC;
+    int txDelay = dataBlock.m_txControlBlock.m_txDelay;
+    m_address.setAddress(dataBlock.m_txControlBlock.m_dataAddress);
+    uint16_t dataPort = dataBlock.m_txControlBlock.m_dataPort;
+    int nbBlocks = SDRDaemonNbOrginalBlocks + (m_cm256p ? nbBlocksFEC : 0);
+    int nbBlocksPerDatagram = dataBlock.m_txControlBlock.m_nbBlocksPerDatagram;
 
-        // Merge FEC with data to transmit
-        for (int i = 0; i < cm256Params.RecoveryCount; i++)
-        {
-            txBlockx[i + cm256Params.OriginalCount].m_protectedBlock = fecBlocks[i];
-        }
+    // Transmit all blocks packing consecutive blocks in datagrams with a last shorter datagram if necessary
+    if (m_socket)
+    {
+        const char *txBlocks = (const char *) dataBlock.m_superBlocks;
+        int nbFullDatagrams = nbBlocks / nbBlocksPerDatagram;
+        int nbRemainderBlocks = nbBlocks % nbBlocksPerDatagram;
 
-        // Transmit all blocks
-        if (m_socket)
-        {
-            for (int i = 0; i < cm256Params.OriginalCount + cm256Params.RecoveryCount; i++)
-            {
-                // send block via UDP
-                m_socket->writeDatagram((const char*)&txBlockx[i], (qint64 ) SDRDaemonUdpSize, m_address, dataPort);
-                usleep(txDelay);
-            }
+        m_socket->setDestination(m_address, dataPort);
+        m_socket->setPacing(nbBlocksPerDatagram * SDRDaemonUdpSize, nbBlocksPerDatagram * txDelay);
+        m_socket->writeDatagrams(txBlocks, nbBlocksPerDatagram * SDRDaemonUdpSize, nbFullDatagrams);
+
+        if (nbRemainderBlocks > 0) {
+            m_socket->writeDatagrams(&txBlocks[nbFullDatagrams * nbBlocksPerDatagram * SDRDaemonUdpSize], nbRemainderBlocks * SDRDaemonUdpSize, 1);
         }
     }
 
@@ -29,10 +29,13 @@
 
 #include "util/message.h"
 #include "util/messagequeue.h"
+#include "util/orderedworkerpool.h"
+
+#define DAEMONSINKTHREAD_NBENCODERS 4 // maximum number of concurrent FEC encoders
 
 class SDRDaemonDataBlock;
 class CM256;
-class QUdpSocket;
+class UDPBatchSocket;
 
 class DaemonSinkThread : public QThread {
     Q_OBJECT
@@ -66,15 +69,31 @@ public slots:
     void processDataBlock(SDRDaemonDataBlock *dataBlock);
 
 private:
+    /** FEC encodes one data block in a pool thread */
+    class EncodeJob : public OrderedWorkerPool::Job
+    {
+    public:
+        EncodeJob(CM256 *cm256, SDRDaemonDataBlock *dataBlock) :
+            m_cm256(cm256),
+            m_dataBlock(dataBlock)
+        {}
+
+        virtual bool process(unsigned int workerIndex);
+
+        CM256 *m_cm256; //!< CM256 objects one per encoder or null if CM256 is not available
+        SDRDaemonDataBlock *m_dataBlock;
+    };
+
 	QMutex m_startWaitMutex;
 	QWaitCondition m_startWaiter;
 	volatile bool m_running;
 
-    CM256 m_cm256;
+    CM256 m_cm256[DAEMONSINKTHREAD_NBENCODERS];
     CM256 *m_cm256p;
+    OrderedWorkerPool m_encoderPool;
 
     QHostAddress m_address;
-    QUdpSocket *m_socket;
+    UDPBatchSocket *m_socket;
 
     MessageQueue m_inputMessageQueue;
 
@@ -82,8 +101,9 @@ private:
     void stopWork();
 
     void run();
-    void handleDataBlock(SDRDaemonDataBlock& dataBlock);
+    void transmitDataBlock(SDRDaemonDataBlock& dataBlock);
 
 private slots:
     void handleInputMessages();
+    void handleEncodedDataBlocks();
 };
@@ -20,6 +20,7 @@
 #include "boost/format.hpp"
 #include <stdio.h>
 #include <complex.h>
+#include <algorithm>
 
 #include "SWGChannelSettings.h"
 #include "SWGBFMDemodSettings.h"
@@ -55,6 +56,7 @@ BFMDemod::BFMDemod(DeviceSourceAPI *deviceAPI) :
         m_audioFifo(250000),
         m_settingsMutex(QMutex::Recursive),
         m_pilotPLL(19000/384000, 50/384000, 0.01),
+        m_rdsParserWorker(m_rdsParser),
         m_deemphasisFilterX(default_deemphasis * 48000 * 1.0e-6),
         m_deemphasisFilterY(default_deemphasis * 48000 * 1.0e-6),
 	m_fmExcursion(default_excursion)
@@ -77,6 +79,7 @@ BFMDemod::BFMDemod(DeviceSourceAPI *deviceAPI) :
 
     m_interpolatorRDSDistance = 0.0f;
     m_interpolatorRDSDistanceRemain = 0.0f;
+    std::fill(m_pilotPLLSamples, m_pilotPLLSamples + 5, 0.0f);
 
     m_interpolatorStereoDistance = 0.0f;
     m_interpolatorStereoDistanceRemain = 0.0f;
@@ -96,6 +99,8 @@ BFMDemod::BFMDemod(DeviceSourceAPI *deviceAPI) :
     applyChannelSettings(m_inputSampleRate, m_inputFrequencyOffset, true);
     applySettings(m_settings, true);
 
+    m_rdsParserWorker.startWork();
+
     m_channelizer = new DownChannelizer(this);
     m_threadedChannelizer = new ThreadedBasebandSampleSink(m_channelizer, this);
     m_deviceAPI->addThreadedSink(m_threadedChannelizer);
@@ -111,6 +116,7 @@ BFMDemod::~BFMDemod()
     delete m_threadedChannelizer;
     delete m_channelizer;
     delete m_rfFilter;
+    m_rdsParserWorker.stopWork();
 }
 
 void BFMDemod::feed(const SampleVector::const_iterator& begin, const SampleVector::const_iterator& end, bool firstOfBurst)
@@ -167,24 +173,8 @@ void BFMDemod::feed(const SampleVector::const_iterator& begin, const SampleVecto
 				m_sampleBuffer.push_back(Sample(demod * SDR_RX_SCALEF, 0.0));
 			}
 
-			if (m_settings.m_rdsActive)
-			{
-				//Complex r(demod * 2.0 * std::cos(3.0 * m_pilotPLLSamples[3]), 0.0);
-				Complex r(demod * 2.0 * std::cos(3.0 * m_pilotPLLSamples[3]), 0.0);
-
-				if (m_interpolatorRDS.decimate(&m_interpolatorRDSDistanceRemain, r, &cr))
-				{
-					bool bit;
-
-					if (m_rdsDemod.process(cr.real(), bit))
-					{
-						if (m_rdsDecoder.frameSync(bit)) {
-						    m_rdsParser.parseGroup(m_rdsDecoder.getGroup());
-						}
-					}
-
-					m_interpolatorRDSDistanceRemain += m_interpolatorRDSDistance;
-				}
+			if (m_settings.m_rdsActive) { // mix the 57 kHz subcarrier down. Demodulated by block after the loop.
+				m_rdsSamples.push_back(demod * 2.0 * m_pilotPLLSamples[4]);
 			}
 
 			Real sampleStereo = 0.0f;
@@ -261,6 +251,10 @@ void BFMDemod::feed(const SampleVector::const_iterator& begin, const SampleVecto
 		}
 	}
 
+	if (m_rdsSamples.size() > 0) {
+		processRDS();
+	}
+
 	if (m_audioBufferFill > 0)
 	{
 		uint res = m_audioFifo.write((const quint8*)&m_audioBuffer[0], m_audioBufferFill);
@@ -281,6 +275,32 @@ void BFMDemod::feed(const SampleVector::const_iterator& begin, const SampleVecto
 	m_settingsMutex.unlock();
 }
 
+void BFMDemod::processRDS()
+{
+	Complex cr;
+	m_rdsBaseband.clear();
+
+	for (std::vector<Real>::const_iterator it = m_rdsSamples.begin(); it != m_rdsSamples.end(); ++it)
+	{
+		if (m_interpolatorRDS.decimate(&m_interpolatorRDSDistanceRemain, Complex(*it, 0.0), &cr))
+		{
+			m_rdsBaseband.push_back(cr.real());
+			m_interpolatorRDSDistanceRemain += m_interpolatorRDSDistance;
+		}
+	}
+
+	m_rdsSamples.clear();
+	m_rdsBits.clear();
+	m_rdsDemod.process(m_rdsBaseband.data(), m_rdsBaseband.size(), m_rdsBits);
+
+	for (std::vector<quint8>::const_iterator it = m_rdsBits.begin(); it != m_rdsBits.end(); ++it)
+	{
+		if (m_rdsDecoder.frameSync(*it != 0)) {
+			m_rdsParserWorker.pushGroup(m_rdsDecoder.getGroup());
+		}
+	}
+}
+
 void BFMDemod::start()
 {
 	m_squelchState = 0;
@@ -37,6 +37,7 @@
 #include "rdsparser.h"
 #include "rdsdecoder.h"
 #include "rdsdemod.h"
+#include "rdsparserworker.h"
 #include "bfmdemodsettings.h"
 
 class DeviceSourceAPI;
@@ -252,11 +253,15 @@ private:
 	QMutex m_settingsMutex;
 
 	RDSPhaseLock m_pilotPLL;
-	Real m_pilotPLLSamples[4];
+	Real m_pilotPLLSamples[5];
 
 	RDSDemod m_rdsDemod;
 	RDSDecoder m_rdsDecoder;
 	RDSParser m_rdsParser;
+	RDSParserWorker m_rdsParserWorker;
+	std::vector<Real> m_rdsSamples;   //!< subcarrier mixed samples of the current block
+	std::vector<Real> m_rdsBaseband;  //!< decimated to 250 kS/s
+	std::vector<quint8> m_rdsBits;
 
 	LowPassFilterRC m_deemphasisFilterX;
 	LowPassFilterRC m_deemphasisFilterY;
@@ -272,6 +277,7 @@ private:
 	void applyAudioSampleRate(int sampleRate);
     void applyChannelSettings(int inputSampleRate, int inputFrequencyOffset, bool force = false);
 	void applySettings(const BFMDemodSettings& settings, bool force = false);
+	void processRDS(); //!< demodulate and decode the RDS samples collected by feed
 
     void webapiFormatChannelSettings(SWGSDRangel::SWGChannelSettings& response, const BFMDemodSettings& settings);
     void webapiFormatChannelReport(SWGSDRangel::SWGChannelReport& response);
@@ -38,6 +38,7 @@ SOURCES += bfmdemod.cpp\
     bfmplugin.cpp\
     rdsdemod.cpp\
     rdsdecoder.cpp\
+    rdsparserworker.cpp\
     rdsparser.cpp\
     rdstmc.cpp
 
@@ -47,6 +48,7 @@ HEADERS += bfmdemod.h\
     bfmplugin.h\
     rdsdemod.h\
     rdsdecoder.h\
+    rdsparserworker.h\
     rdsparser.h\
     rdstmc.h
 
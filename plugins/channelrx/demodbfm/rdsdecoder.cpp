@@ -23,6 +23,8 @@
 const unsigned int RDSDecoder::offset_pos[5] = {0,1,2,3,2};
 const unsigned int RDSDecoder::offset_word[5] = {252,408,360,436,848};
 const unsigned int RDSDecoder::syndrome[5] = {383,14,303,663,748};
+unsigned short RDSDecoder::m_syndromeTable[4][256];
+bool RDSDecoder::m_syndromeTableInit = false;
 
 RDSDecoder::RDSDecoder()
 {
@@ -41,6 +43,31 @@ RDSDecoder::RDSDecoder()
 	m_goodBlock            = false;
 	m_qua                  = 0.0f;
 	memset(m_group, 0, 4*sizeof(int));
+	initSyndromeTable();
+}
+
+void RDSDecoder::initSyndromeTable()
+{
+	if (m_syndromeTableInit) {
+		return;
+	}
+
+	for (int k = 0; k < 4; k++)
+	{
+		for (unsigned long byte = 0; byte < 256; byte++) {
+			m_syndromeTable[k][byte] = calc_syndrome(byte << (8*k), 26);
+		}
+	}
+
+	m_syndromeTableInit = true;
+}
+
+unsigned int RDSDecoder::syndrome26(unsigned long message)
+{
+	return m_syndromeTable[0][message & 0xff]
+		^ m_syndromeTable[1][(message >> 8) & 0xff]
+		^ m_syndromeTable[2][(message >> 16) & 0xff]
+		^ m_syndromeTable[3][(message >> 24) & 0x03];
 }
 
 RDSDecoder::~RDSDecoder()
@@ -59,7 +86,7 @@ bool RDSDecoder::frameSync(bool bit)
 	switch (m_sync)
 	{
 	case NO_SYNC:
-		reg_syndrome = calc_syndrome(m_reg,26);
+		reg_syndrome = syndrome26(m_reg);
 
 		for (int j = 0; j < 5; j++)
 		{
@@ -110,7 +137,7 @@ bool RDSDecoder::frameSync(bool bit)
 		{
 			m_goodBlock = false;
 			dataword = (m_reg>>10) & 0xffff;
-			block_calculated_crc = calc_syndrome(dataword, 16);
+			block_calculated_crc = syndrome26(dataword);
 			checkword = m_reg & 0x3ff;
 
 			// manage special case of C or C' offset word
@@ -32,6 +32,7 @@ public:
 
 protected:
 	unsigned int calc_syndrome(unsigned long message, unsigned char mlen);
+	static unsigned int syndrome26(unsigned long message); //!< calc_syndrome(message, 26) with table lookups
 	void enter_sync(unsigned int sync_block_number);
 	void enter_no_sync();
 
@@ -56,6 +57,12 @@ private:
 	static const unsigned int offset_pos[5];
 	static const unsigned int offset_word[5];
 	static const unsigned int syndrome[5];
+
+	/* syndromes of the bytes of a 26 bit message: syndrome of byte k is m_syndromeTable[k][byte]
+	 * and the syndrome of the message is the xor of the syndromes of its bytes */
+	static unsigned short m_syndromeTable[4][256];
+	static bool m_syndromeTableInit;
+	void initSyndromeTable();
 };
 
 
@@ -21,6 +21,7 @@
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #undef M_PI
 #define M_PI 3.14159265358979323846
@@ -36,7 +37,6 @@ RDSDemod::RDSDemod()
 	m_srate = 250000;
 
 	m_parms.subcarr_phi = 0;
-	memset(m_parms.subcarr_bb, 0, sizeof(m_parms.subcarr_bb));
 	m_parms.clock_offset = 0;
 	m_parms.clock_phi = 0;
 	m_parms.prev_clock_phi = 0;
@@ -51,9 +51,8 @@ RDSDemod::RDSDemod()
 	m_parms.reading_frame = 0;
 	memset(m_parms.tot_errs, 0, sizeof(m_parms.tot_errs));
 	m_parms.dbit = 0;
-	m_prev = 0.0f;
-	memset(m_xv, 0, 6*sizeof(Real));
-	memset(m_yv, 0, 6*sizeof(Real));
+	memset(m_xv, 0, 3*sizeof(Real));
+	memset(m_yv, 0, 3*sizeof(Real));
     memset(m_xw, 0, 2*sizeof(Real));
     memset(m_yw, 0, 2*sizeof(Real));
     m_report.acc = 0.0f;
@@ -71,67 +70,88 @@ void RDSDemod::setSampleRate(int srate) /// FIXME: fix rate for now
     (void) srate;
 }
 
-bool RDSDemod::process(Real demod, bool& bit)
+int RDSDemod::process(const Real *rdsSamples, int nbSamples, std::vector<quint8>& bits)
 {
-	bool ret = false;
-
-	//m_udpDebug.write(m_parms.lo_clock * m_parms.subcarr_bb[0]); // UDP debug
+	int nbBits = 0;
+	const double dphi = (2 * M_PI * m_fsc) / (Real) m_srate;
 
-	// Subcarrier downmix & phase recovery
+	// Subcarrier low pass filtering of the whole block
 
-	m_parms.subcarr_bb[0] = filter_lp_2400_iq(demod, 0);
+	if ((int) m_filtered.size() < nbSamples) {
+		m_filtered.resize(nbSamples);
+	}
 
-	// 1187.5 Hz clock
+	filter_lp_2400(rdsSamples, m_filtered.data(), nbSamples);
 
-	/*
-	if (m_parms.subcarr_phi > 1e9) // ~ every 37 hours =>  not really useful
+	for (int i = 0; i < nbSamples; i++)
 	{
-		qDebug("RDSDemod::process: reset 1187.5 Hz clock");
-		m_parms.subcarr_phi = 0;
-		m_parms.clock_offset = 0;
-	}*/
+		Real bb = m_filtered[i];
 
-    m_parms.subcarr_phi += (2 * M_PI * m_fsc) / (Real) m_srate;
-	m_parms.clock_phi = m_parms.subcarr_phi + m_parms.clock_offset;
+		// 1187.5 Hz clock. Phases are kept wrapped so that there is no fmod per sample
+		// and no loss of precision as time goes by.
 
-	// Clock phase recovery
+		m_parms.subcarr_phi += dphi;
 
-	if (sign(m_parms.prev_bb) != sign(m_parms.subcarr_bb[0]))
-	{
-		m_parms.d_cphi = std::fmod(m_parms.clock_phi, M_PI);
+		if (m_parms.subcarr_phi >= 2 * M_PI) {
+			m_parms.subcarr_phi -= 2 * M_PI;
+		}
 
-		if (m_parms.d_cphi >= M_PI_2)
-		{
-			m_parms.d_cphi -= M_PI;
+		m_parms.clock_phi = m_parms.subcarr_phi + m_parms.clock_offset;
+
+		if (m_parms.clock_phi >= 2 * M_PI) {
+			m_parms.clock_phi -= 2 * M_PI;
 		}
 
-		m_parms.clock_offset -= 0.005 * m_parms.d_cphi;
-	}
+		// Clock phase recovery
+
+		if (sign(m_parms.prev_bb) != sign(bb))
+		{
+			m_parms.d_cphi = m_parms.clock_phi >= M_PI ? m_parms.clock_phi - M_PI : m_parms.clock_phi;
 
-	m_parms.clock_phi = std::fmod(m_parms.clock_phi, 2 * M_PI);
-	m_parms.lo_clock = (m_parms.clock_phi < M_PI ? 1 : -1);
+			if (m_parms.d_cphi >= M_PI_2)
+			{
+				m_parms.d_cphi -= M_PI;
+			}
 
-	/* Decimate band-limited signal */
-	if (m_parms.numsamples % 8 == 0)
-	{
-		/* biphase symbol integrate & dump */
-		m_parms.acc += m_parms.subcarr_bb[0] * m_parms.lo_clock;
+			m_parms.clock_offset -= 0.005 * m_parms.d_cphi;
 
-		if (sign(m_parms.lo_clock) != sign(m_parms.prev_lo_clock))
+			if (m_parms.clock_offset < 0) {
+				m_parms.clock_offset += 2 * M_PI;
+			} else if (m_parms.clock_offset >= 2 * M_PI) {
+				m_parms.clock_offset -= 2 * M_PI;
+			}
+		}
+
+		m_parms.lo_clock = (m_parms.clock_phi < M_PI ? 1 : -1);
+
+		/* Decimate band-limited signal */
+		if (m_parms.numsamples == 0)
 		{
-			ret = biphase(m_parms.acc, bit, m_parms.clock_phi - m_parms.prev_clock_phi);
-			m_parms.acc = 0;
+			/* biphase symbol integrate & dump */
+			m_parms.acc += bb * m_parms.lo_clock;
+
+			if (sign(m_parms.lo_clock) != sign(m_parms.prev_lo_clock))
+			{
+				bool bit;
+
+				if (biphase(m_parms.acc, bit, m_parms.clock_phi - m_parms.prev_clock_phi))
+				{
+					bits.push_back(bit ? 1 : 0);
+					nbBits++;
+				}
+
+				m_parms.acc = 0;
+			}
+
+			m_parms.prev_lo_clock = m_parms.lo_clock;
 		}
 
-		m_parms.prev_lo_clock = m_parms.lo_clock;
+		m_parms.numsamples = (m_parms.numsamples + 1) & 7;
+		m_parms.prev_bb = bb;
+		m_parms.prev_clock_phi = m_parms.clock_phi;
 	}
 
-	m_parms.numsamples++;
-	m_parms.prev_bb = m_parms.subcarr_bb[0];
-	m_parms.prev_clock_phi = m_parms.clock_phi;
-	m_prev = demod;
-
-	return ret;
+	return nbBits;
 }
 
 bool RDSDemod::biphase(Real acc, bool& bit, Real d_cphi)
@@ -182,19 +202,27 @@ bool RDSDemod::biphase(Real acc, bool& bit, Real d_cphi)
 	return ret;
 }
 
-Real RDSDemod::filter_lp_2400_iq(Real input, int iqIndex)
+void RDSDemod::filter_lp_2400(const Real *in, Real *out, int nbSamples)
 {
 	/* Digital filter designed by mkfilter/mkshape/gencode A.J. Fisher
 	 Command line: /www/usr/fisher/helpers/mkfilter -Bu -Lp -o 10
 	 -a 4.8000000000e-03 0.0000000000e+00 -l */
 
-	m_xv[iqIndex][0] = m_xv[iqIndex][1]; m_xv[iqIndex][1] = m_xv[iqIndex][2];
-	m_xv[iqIndex][2] = input / 4.491730007e+03;
-	m_yv[iqIndex][0] = m_yv[iqIndex][1]; m_yv[iqIndex][1] = m_yv[iqIndex][2];
-	m_yv[iqIndex][2] =   (m_xv[iqIndex][0] + m_xv[iqIndex][2]) + 2 * m_xv[iqIndex][1]
-	+ ( -0.9582451124 * m_yv[iqIndex][0]) + (  1.9573545869 * m_yv[iqIndex][1]);
+	// The state is kept in locals over the block
+	Real x0 = m_xv[1], x1 = m_xv[2];
+	Real y0 = m_yv[1], y1 = m_yv[2];
+
+	for (int i = 0; i < nbSamples; i++)
+	{
+		Real x2 = in[i] / 4.491730007e+03;
+		Real y2 = (x0 + x2) + 2 * x1 + (-0.9582451124 * y0) + (1.9573545869 * y1);
+		out[i] = y2;
+		x0 = x1; x1 = x2;
+		y0 = y1; y1 = y2;
+	}
 
-	return m_yv[iqIndex][2];
+	m_xv[1] = x0; m_xv[2] = x1;
+	m_yv[1] = y0; m_yv[2] = y1;
 }
 
 Real RDSDemod::filter_lp_pll(Real input)
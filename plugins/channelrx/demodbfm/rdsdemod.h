@@ -16,11 +16,13 @@
 ///////////////////////////////////////////////////////////////////////////////////
 
 
+
 #ifndef PLUGINS_CHANNEL_BFM_RDSDEMOD_H_
 #define PLUGINS_CHANNEL_BFM_RDSDEMOD_H_
 
+#include <vector>
+
 #include <QObject>
-//#include "util/udpsink.h" // UDP debug
 
 #include "dsp/dsptypes.h"
 
@@ -32,7 +34,11 @@ public:
 	~RDSDemod();
 
 	void setSampleRate(int srate);
-	bool process(Real rdsSample, bool &bit);
+	/**
+	 * Demodulate a block of RDS baseband samples at 250 kS/s (subcarrier already mixed down).
+	 * Decoded bits are appended to bits. Returns the number of bits appended.
+	 */
+	int process(const Real *rdsSamples, int nbSamples, std::vector<quint8>& bits);
 
 	struct{
 		Real acc;
@@ -42,16 +48,15 @@ public:
 
 protected:
 	bool biphase(Real acc, bool &bit, Real d_cphi);
-	Real filter_lp_2400_iq(Real in, int iqIndex);
+	void filter_lp_2400(const Real *in, Real *out, int nbSamples);
 	Real filter_lp_pll(Real input);
 	int sign(Real a);
 
 private:
 	struct
 	{
-		double subcarr_phi;
-		Real subcarr_bb[2];
-		double clock_offset;
+		double subcarr_phi;   //!< 1187.5 Hz clock phase wrapped to [0, 2*pi[
+		double clock_offset;  //!< wrapped to [0, 2*pi[
 		double clock_phi;
 		double prev_clock_phi;
 		Real lo_clock;
@@ -59,7 +64,7 @@ private:
 		Real prev_bb;
 		double d_cphi;
 		Real acc;
-		int numsamples;
+		int numsamples;       //!< modulo 8
 		Real prev_acc;
 		int counter;
 		int reading_frame;
@@ -67,11 +72,11 @@ private:
 		int dbit;
 	} m_parms;
 
-	Real m_xv[2][2+1];
-	Real m_yv[2][2+1];
+	Real m_xv[2+1];
+	Real m_yv[2+1];
 	Real m_xw[1+1];
 	Real m_yw[1+1];
-	Real m_prev;
+	std::vector<Real> m_filtered; //!< low pass filtered block
 
 	int m_srate;
 
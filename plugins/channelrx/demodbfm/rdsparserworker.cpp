@@ -0,0 +1,100 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+
+#include <algorithm>
+
+#include <QMutexLocker>
+
+#include "rdsparser.h"
+#include "rdsparserworker.h"
+
+RDSParserWorker::RDSParserWorker(RDSParser& parser) :
+	m_parser(parser),
+	m_running(false),
+	m_droppedGroups(0)
+{
+}
+
+RDSParserWorker::~RDSParserWorker()
+{
+	stopWork();
+}
+
+void RDSParserWorker::startWork()
+{
+	if (m_running) {
+		return;
+	}
+
+	m_running = true;
+	start(QThread::LowPriority);
+}
+
+void RDSParserWorker::stopWork()
+{
+	if (!m_running) {
+		return;
+	}
+
+	m_mutex.lock();
+	m_running = false;
+	m_groupQueued.wakeAll();
+	m_mutex.unlock();
+	wait();
+}
+
+void RDSParserWorker::pushGroup(const unsigned int *group)
+{
+	QMutexLocker mutexLocker(&m_mutex);
+
+	if (m_groups.size() >= m_maxGroups)
+	{
+		m_droppedGroups++;
+		return;
+	}
+
+	Group g;
+	std::copy(group, group + 4, g.m_blocks);
+	m_groups.push_back(g);
+	m_groupQueued.wakeOne();
+}
+
+void RDSParserWorker::run()
+{
+	m_mutex.lock();
+
+	while (m_running)
+	{
+		if (m_groups.empty())
+		{
+			m_groupQueued.wait(&m_mutex);
+			continue;
+		}
+
+		Group g = m_groups.front();
+		m_groups.pop_front();
+		m_mutex.unlock();
+
+		m_parser.parseGroup(g.m_blocks);
+
+		m_mutex.lock();
+	}
+
+	m_groups.clear();
+	m_mutex.unlock();
+}
@@ -0,0 +1,63 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef PLUGINS_CHANNEL_BFM_RDSPARSERWORKER_H_
+#define PLUGINS_CHANNEL_BFM_RDSPARSERWORKER_H_
+
+#include <deque>
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+
+class RDSParser;
+
+/**
+ * Runs the RDS group parser (and TMC decoding) in a low priority thread so that the
+ * string building does not load the demodulator thread. Groups are queued by the
+ * demodulator and dropped if the parser falls more than m_maxGroups behind.
+ */
+class RDSParserWorker : public QThread
+{
+public:
+	RDSParserWorker(RDSParser& parser);
+	~RDSParserWorker();
+
+	void startWork();
+	void stopWork();
+	void pushGroup(const unsigned int *group); //!< Queue a group of 4 blocks for parsing. Never blocks for long.
+	unsigned int getDroppedGroups() const { return m_droppedGroups; }
+
+private:
+	struct Group {
+		unsigned int m_blocks[4];
+	};
+
+	RDSParser& m_parser;
+	std::deque<Group> m_groups;
+	QMutex m_mutex;
+	QWaitCondition m_groupQueued;
+	bool m_running;
+	unsigned int m_droppedGroups;
+
+	static const unsigned int m_maxGroups = 64; //!< about 5 seconds of groups
+
+	void run();
+};
+
+#endif /* PLUGINS_CHANNEL_BFM_RDSPARSERWORKER_H_ */
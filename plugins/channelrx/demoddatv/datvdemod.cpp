@@ -19,11 +19,13 @@
 #include "datvdemod.h"
 
 #include <QTime>
+#include <QThread>
 #include <QDebug>
 #include <stdio.h>
 #include <complex.h>
 #include "audio/audiooutput.h"
 #include "dsp/dspengine.h"
+#include "dsp/viterbik7kernels.h"
 
 #include "dsp/downchannelizer.h"
 #include "dsp/threadedbasebandsamplesink.h"
@@ -34,6 +36,7 @@ const QString DATVDemod::m_channelId = "DATVDemod";
 
 MESSAGE_CLASS_DEFINITION(DATVDemod::MsgConfigureDATVDemod, Message)
 MESSAGE_CLASS_DEFINITION(DATVDemod::MsgConfigureChannelizer, Message)
+MESSAGE_CLASS_DEFINITION(DATVDemod::MsgConfigureTSOutput, Message)
 
 DATVDemod::DATVDemod(DeviceSourceAPI *deviceAPI) :
     ChannelSinkAPI(m_channelIdURI),
@@ -179,6 +182,16 @@ void DATVDemod::configure(MessageQueue* objMessageQueue,
     objMessageQueue->push(msgCmd);
 }
 
+void DATVDemod::configureTSOutput(MessageQueue* objMessageQueue,
+                                  DATVTSOutput enmTSOutput,
+                                  const QString& strAddress,
+                                  quint16 intPort,
+                                  const QString& strPath)
+{
+    Message* msgCmd = MsgConfigureTSOutput::create(enmTSOutput, strAddress, intPort, strPath);
+    objMessageQueue->push(msgCmd);
+}
+
 void DATVDemod::InitDATVParameters(int intMsps,
                                    int intRFBandwidth,
                                    int intCenterFrequency,
@@ -242,6 +255,7 @@ void DATVDemod::CleanUpDATVFramework(bool blnRelease)
     {
         if(m_objScheduler!=NULL)
         {
+            m_objScheduler->dump_cpu();
             m_objScheduler->shutdown();
             delete m_objScheduler;
         }
@@ -316,6 +330,8 @@ void DATVDemod::CleanUpDATVFramework(bool blnRelease)
         //OUTPUT : To remove
         if(r_stdout!=NULL) delete r_stdout;
         if(r_videoplayer!=NULL) delete r_videoplayer;
+        if(r_tsudp!=NULL) delete r_tsudp;
+        if(r_tspipe!=NULL) delete r_tspipe;
 
         //CONSTELLATION
         if(r_scope_symbols!=NULL) delete r_scope_symbols;
@@ -413,6 +429,8 @@ void DATVDemod::CleanUpDATVFramework(bool blnRelease)
     //OUTPUT : To remove
     r_stdout = NULL;
     r_videoplayer = NULL;
+    r_tsudp = NULL;
+    r_tspipe = NULL;
 
 
     //CONSTELLATION
@@ -500,42 +518,48 @@ void DATVDemod::InitDATVFramework()
     m_objCfg.sampler = m_objRunning.enmFilter;
     m_objCfg.viterbi = m_objRunning.blnViterbi;
 
+    int nbThreads = m_objCfg.threads > 0 ? m_objCfg.threads : std::max(1, std::min(4, QThread::idealThreadCount()));
+
+    // With several threads every stage reads the data produced during the previous step
+    // while the stage before it writes the next step data: give the pipes room for both.
+    int pipelineDepth = nbThreads > 1 ? 2 : 1;
+    int bufFactor = m_objCfg.buf_factor * pipelineDepth;
 
     // Min buffer size for baseband data
     //   scopes: 1024
     //   ss_estimator: 1024
     //   anf: 4096
     //   cstln_receiver: reads in chunks of 128+1
-    BUF_BASEBAND = 4096 * m_objCfg.buf_factor;
+    BUF_BASEBAND = 4096 * bufFactor;
 
     // Min buffer size for IQ symbols
     //   cstln_receiver: writes in chunks of 128/omega symbols (margin 128)
     //   deconv_sync: reads at least 64+32
     // A larger buffer improves performance significantly.
-    BUF_SYMBOLS = 1024 * m_objCfg.buf_factor;
+    BUF_SYMBOLS = 1024 * bufFactor;
 
     // Min buffer size for unsynchronized bytes
     //   deconv_sync: writes 32 bytes
     //   mpeg_sync: reads up to 204*scan_syncs = 1632 bytes
-    BUF_BYTES = 2048 * m_objCfg.buf_factor;
+    BUF_BYTES = 2048 * bufFactor;
 
     // Min buffer size for synchronized (but interleaved) bytes
     //   mpeg_sync: writes 1 rspacket
     //   deinterleaver: reads 17*11*12+204 = 2448 bytes
-    BUF_MPEGBYTES = 2448 * m_objCfg.buf_factor;
+    BUF_MPEGBYTES = 2448 * bufFactor;
 
     // Min buffer size for packets: 1
-    BUF_PACKETS = m_objCfg.buf_factor;
+    BUF_PACKETS = bufFactor;
 
     // Min buffer size for misc measurements: 1
-    BUF_SLOW = m_objCfg.buf_factor;
+    BUF_SLOW = bufFactor;
 
-    m_lngExpectedReadIQ  = BUF_BASEBAND;
+    m_lngExpectedReadIQ  = BUF_BASEBAND / pipelineDepth;
 
     m_objScheduler = new leansdr::scheduler();
 
     //***************
-    p_rawiq = new leansdr::pipebuf<leansdr::cf32>(m_objScheduler, "rawiq", BUF_BASEBAND);
+    p_rawiq = new leansdr::pipebuf<leansdr::cf32>(m_objScheduler, "rawiq", m_lngExpectedReadIQ);
     p_rawiq_writer = new leansdr::pipewriter<leansdr::cf32>(*p_rawiq);
     p_preprocessed = p_rawiq;
 
@@ -702,7 +726,7 @@ void DATVDemod::InitDATVFramework()
       }
 
       //To uncomment -> Linking Problem : undefined symbol: _ZN7leansdr21viterbi_dec_interfaceIhhiiE6updateEPiS2_
-      r = new leansdr::viterbi_sync(m_objScheduler, (*p_symbols), (*p_bytes), m_objDemodulator->cstln, m_objCfg.fec);
+      r = new leansdr::viterbi_sync(m_objScheduler, (*p_symbols), (*p_bytes), m_objDemodulator->cstln, m_objCfg.fec, m_objCfg.fast_fec);
 
       if ( m_objCfg.fastlock )
       {
@@ -735,7 +759,7 @@ void DATVDemod::InitDATVFramework()
     p_vbitcount = new leansdr::pipebuf<int>(m_objScheduler, "Bits processed", BUF_PACKETS);
     p_verrcount = new leansdr::pipebuf<int>(m_objScheduler, "Bits corrected", BUF_PACKETS);
     p_rtspackets = new leansdr::pipebuf<leansdr::tspacket>(m_objScheduler, "rand TS packets", BUF_PACKETS);
-    r_rsdec = new leansdr::rs_decoder<leansdr::u8, 0> (m_objScheduler, *p_rspackets, *p_rtspackets, p_vbitcount, p_verrcount);
+    r_rsdec = new leansdr::rs_decoder<leansdr::u8, 0> (m_objScheduler, *p_rspackets, *p_rtspackets, p_vbitcount, p_verrcount, m_objCfg.fast_fec);
 
 
     // BER ESTIMATION
@@ -759,7 +783,29 @@ void DATVDemod::InitDATVFramework()
 
 
     // OUTPUT
-    r_videoplayer = new leansdr::datvvideoplayer<leansdr::tspacket>(m_objScheduler, *p_tspackets,m_objVideoStream);
+    // UDP and pipe outputs read the TS packets from the derandomizer output buffer and bypass the video player
+
+    if (m_objRunning.enmTSOutput == TSOutputUDP)
+    {
+        r_tsudp = new leansdr::datvudpoutput<leansdr::tspacket>(m_objScheduler, *p_tspackets,
+            m_objRunning.strTSOutputAddress, m_objRunning.intTSOutputPort);
+        qDebug() << "DATVDemod::InitDATVFramework: TS output to UDP "
+            << m_objRunning.strTSOutputAddress << ":" << m_objRunning.intTSOutputPort;
+    }
+    else if (m_objRunning.enmTSOutput == TSOutputPipe)
+    {
+        r_tspipe = new leansdr::datvpipeoutput<leansdr::tspacket>(m_objScheduler, *p_tspackets, m_objRunning.strTSOutputPath);
+        qDebug() << "DATVDemod::InitDATVFramework: TS output to " << m_objRunning.strTSOutputPath;
+    }
+    else
+    {
+        r_videoplayer = new leansdr::datvvideoplayer<leansdr::tspacket>(m_objScheduler, *p_tspackets,m_objVideoStream);
+    }
+
+    m_objScheduler->set_threads(nbThreads);
+    qDebug() << "DATVDemod::InitDATVFramework: scheduler threads: " << nbThreads;
+    qDebug() << "DATVDemod::InitDATVFramework: fast FEC: " << m_objCfg.fast_fec
+        << " Viterbi ISA: " << ViterbiK7Kernels::getISAName(ViterbiK7Kernels::getISA());
 
     m_blnDVBInitialized=true;
 }
@@ -963,6 +1009,37 @@ bool DATVDemod::handleMessage(const Message& cmd)
 
 		return true;
 	}
+    else if (MsgConfigureTSOutput::match(cmd))
+    {
+        MsgConfigureTSOutput& objCfg = (MsgConfigureTSOutput&) cmd;
+
+        qDebug() << "DATVDemod::handleMessage: MsgConfigureTSOutput:"
+                << " enmTSOutput: " << objCfg.getTSOutput()
+                << " strAddress: " << objCfg.getAddress()
+                << " intPort: " << objCfg.getPort()
+                << " strPath: " << objCfg.getPath();
+
+        m_objSettingsMutex.lock();
+
+        if ((objCfg.getTSOutput() != m_objRunning.enmTSOutput)
+           || (objCfg.getAddress() != m_objRunning.strTSOutputAddress)
+           || (objCfg.getPort() != m_objRunning.intTSOutputPort)
+           || (objCfg.getPath() != m_objRunning.strTSOutputPath))
+        {
+            m_objRunning.enmTSOutput = objCfg.getTSOutput();
+            m_objRunning.strTSOutputAddress = objCfg.getAddress();
+            m_objRunning.intTSOutputPort = objCfg.getPort();
+            m_objRunning.strTSOutputPath = objCfg.getPath();
+
+            if (m_blnInitialized) {
+                m_blnNeedConfigUpdate = true; // rebuild the output stage
+            }
+        }
+
+        m_objSettingsMutex.unlock();
+
+        return true;
+    }
 	else
 	{
 		return false;
@@ -45,6 +45,7 @@ class DownChannelizer;
 
 #include "datvconstellation.h"
 #include "datvvideoplayer.h"
+#include "datvtsoutput.h"
 
 #include "channel/channelsinkapi.h"
 #include "dsp/basebandsamplesink.h"
@@ -68,6 +69,7 @@ class DownChannelizer;
 enum DATVModulation { BPSK, QPSK, PSK8, APSK16, APSK32, APSK64E, QAM16, QAM64, QAM256 };
 enum dvb_version { DVB_S, DVB_S2 };
 enum dvb_sampler { SAMP_NEAREST, SAMP_LINEAR, SAMP_RRC };
+enum DATVTSOutput { TSOutputVideo, TSOutputUDP, TSOutputPipe };
 
 inline int decimation(float Fin, float Fout) { int d = Fin / Fout; return std::max(d, 1); }
 
@@ -98,6 +100,8 @@ struct config
   bool hdlc;           // Expect HDLC frames instead of MPEG packets
   bool packetized;     // Output frames with 16-bit BE length
   float Finfo;         // Desired refresh rate on fd_info (Hz)
+  int threads;         // Scheduler threads, 1 = single thread, 0 = auto
+  bool fast_fec;       // SIMD Viterbi and table driven RS decoders
 
   config() :
       standard(DVB_S),
@@ -123,7 +127,9 @@ struct config
       rolloff(0.35),
       hdlc(false),
       packetized(false),
-      Finfo(5)
+      Finfo(5),
+      threads(0),
+      fast_fec(true)
   {
   }
 };
@@ -147,6 +153,10 @@ struct DATVConfig
     float fltRollOff;
     bool blnViterbi;
     int intExcursion;
+    DATVTSOutput enmTSOutput;
+    QString strTSOutputAddress;
+    quint16 intTSOutputPort;
+    QString strTSOutputPath;
 
     DATVConfig() :
         intMsps(1024000),
@@ -164,7 +174,11 @@ struct DATVConfig
         blnHardMetric(false),
         fltRollOff(0.35),
         blnViterbi(false),
-        intExcursion(10)
+        intExcursion(10),
+        enmTSOutput(TSOutputVideo),
+        strTSOutputAddress("127.0.0.1"),
+        intTSOutputPort(8882),
+        strTSOutputPath("/tmp/datv.ts")
     {
     }
 };
@@ -204,6 +218,13 @@ public:
         bool blnViterbi,
         int intfltExcursion);
 
+    void configureTSOutput(
+        MessageQueue* objMessageQueue,
+        DATVTSOutput enmTSOutput,
+        const QString& strAddress,
+        quint16 intPort,
+        const QString& strPath);
+
 	virtual void feed(const SampleVector::const_iterator& begin, const SampleVector::const_iterator& end, bool po);
 	virtual void start();
 	virtual void stop();
@@ -324,6 +345,36 @@ private:
             }
     };
 
+    class MsgConfigureTSOutput : public Message
+    {
+        MESSAGE_CLASS_DECLARATION
+
+        public:
+            DATVTSOutput getTSOutput() const { return m_enmTSOutput; }
+            const QString& getAddress() const { return m_strAddress; }
+            quint16 getPort() const { return m_intPort; }
+            const QString& getPath() const { return m_strPath; }
+
+            static MsgConfigureTSOutput* create(DATVTSOutput enmTSOutput, const QString& strAddress, quint16 intPort, const QString& strPath)
+            {
+                return new MsgConfigureTSOutput(enmTSOutput, strAddress, intPort, strPath);
+            }
+
+        private:
+            DATVTSOutput m_enmTSOutput;
+            QString m_strAddress;
+            quint16 m_intPort;
+            QString m_strPath;
+
+            MsgConfigureTSOutput(DATVTSOutput enmTSOutput, const QString& strAddress, quint16 intPort, const QString& strPath) :
+                Message(),
+                m_enmTSOutput(enmTSOutput),
+                m_strAddress(strAddress),
+                m_intPort(intPort),
+                m_strPath(strPath)
+            { }
+    };
+
     unsigned long m_lngExpectedReadIQ;
     unsigned long m_lngReadIQ;
 
@@ -428,6 +479,8 @@ private:
     //OUTPUT
     leansdr::file_writer<leansdr::tspacket> *r_stdout;
     leansdr::datvvideoplayer<leansdr::tspacket> *r_videoplayer;
+    leansdr::datvudpoutput<leansdr::tspacket> *r_tsudp;
+    leansdr::datvpipeoutput<leansdr::tspacket> *r_tspipe;
 
     //CONSTELLATION
     leansdr::datvconstellation<leansdr::f32> *r_scope_symbols;
@@ -97,6 +97,11 @@ void DATVDemodGUI::resetToDefaults()
     ui->spiRollOff->setValue(35);
     ui->spiExcursion->setValue(10);
 
+    m_strTSOutputUDP = "127.0.0.1:8882";
+    m_strTSOutputPipe = "/tmp/datv.ts";
+    ui->cmbTSOutput->setCurrentIndex(0);
+    displayTSOutput();
+
 
     blockApplySettings(false);
 
@@ -126,6 +131,10 @@ QByteArray DATVDemodGUI::serialize() const
     s.writeS32(14, ui->spiSymbolRate->value());
     s.writeS32(15, ui->spiExcursion->value());
 
+    s.writeS32(16, ui->cmbTSOutput->currentIndex());
+    s.writeString(17, m_strTSOutputUDP);
+    s.writeString(18, m_strTSOutputPipe);
+
     return s.final();
 }
 
@@ -205,6 +214,12 @@ bool DATVDemodGUI::deserialize(const QByteArray& arrData)
         d.readS32(15, &tmp, false);
         ui->spiExcursion->setValue(tmp);
 
+        d.readS32(16, &tmp, 0);
+        ui->cmbTSOutput->setCurrentIndex(tmp);
+        d.readString(17, &m_strTSOutputUDP, "127.0.0.1:8882");
+        d.readString(18, &m_strTSOutputPipe, "/tmp/datv.ts");
+        displayTSOutput();
+
 
         blockApplySettings(false);
         m_objChannelMarker.blockSignals(false);
@@ -486,6 +501,18 @@ void DATVDemodGUI::applySettings()
             ui->chkViterbi->isChecked(),
             ui->spiExcursion->value());
 
+        // TS output: "address:port" for UDP
+        int intPortPos = m_strTSOutputUDP.lastIndexOf(':');
+        QString strAddress = intPortPos < 0 ? m_strTSOutputUDP : m_strTSOutputUDP.left(intPortPos);
+        quint16 intPort = intPortPos < 0 ? 8882 : m_strTSOutputUDP.mid(intPortPos + 1).toUShort();
+
+        m_objDATVDemod->configureTSOutput(
+            m_objDATVDemod->getInputMessageQueue(),
+            (DATVTSOutput) ui->cmbTSOutput->currentIndex(),
+            strAddress,
+            intPort,
+            m_strTSOutputPipe);
+
         qDebug() << "DATVDemodGUI::applySettings:"
                 << " m_objDATVDemod->getCenterFrequency: " << m_objDATVDemod->getCenterFrequency()
                 << " m_objDATVDemod->GetSampleRate: " << m_objDATVDemod->GetSampleRate();
@@ -821,3 +848,27 @@ void DATVDemodGUI::on_spiExcursion_valueChanged(int arg1)
     (void) arg1;
     applySettings();
 }
+
+void DATVDemodGUI::displayTSOutput()
+{
+    ui->txtTSOutput->setEnabled(ui->cmbTSOutput->currentIndex() != TSOutputVideo);
+    ui->txtTSOutput->setText(ui->cmbTSOutput->currentIndex() == TSOutputPipe ? m_strTSOutputPipe : m_strTSOutputUDP);
+}
+
+void DATVDemodGUI::on_cmbTSOutput_currentIndexChanged(int index)
+{
+    (void) index;
+    displayTSOutput();
+    applySettings();
+}
+
+void DATVDemodGUI::on_txtTSOutput_editingFinished()
+{
+    if (ui->cmbTSOutput->currentIndex() == TSOutputPipe) {
+        m_strTSOutputPipe = ui->txtTSOutput->text();
+    } else if (ui->cmbTSOutput->currentIndex() == TSOutputUDP) {
+        m_strTSOutputUDP = ui->txtTSOutput->text();
+    }
+
+    applySettings();
+}
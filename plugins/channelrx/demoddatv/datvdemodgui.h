@@ -94,6 +94,8 @@ private slots:
     void on_spiExcursion_valueChanged(int arg1);
     void on_deltaFrequency_changed(qint64 value);
     void on_rfBandwidth_changed(qint64 value);
+    void on_cmbTSOutput_currentIndexChanged(int index);
+    void on_txtTSOutput_editingFinished();
 
 private:
     Ui::DATVDemodGUI* ui;
@@ -117,6 +119,9 @@ private:
     bool m_blnDoApplySettings;
     bool m_blnButtonPlayClicked;
 
+    QString m_strTSOutputUDP;  //!< address:port
+    QString m_strTSOutputPipe; //!< named pipe path
+
     MovingAverageUtil<double, double, 4> m_objMagSqAverage;
 
     explicit DATVDemodGUI(PluginAPI* objPluginAPI, DeviceUISet *deviceUISet, BasebandSampleSink *rxChannel, QWidget* objParent = 0);
@@ -127,6 +132,7 @@ private:
     QString formatBytes(qint64 intBytes);
 
     void displayRRCParameters(bool blnVisible);
+    void displayTSOutput();
 
 	void leaveEvent(QEvent*);
 	void enterEvent(QEvent*);
@@ -0,0 +1,204 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 F4HKW                                                      //
+// for F4EXB / SDRAngel                                                          //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DATVTSOUTPUT_H
+#define DATVTSOUTPUT_H
+
+#include <QString>
+#include <QHostAddress>
+#include <QDebug>
+
+#include <fcntl.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifdef _MSC_VER
+#include <io.h>
+#else
+#include <unistd.h>
+#include <limits.h>
+#endif
+
+#include "leansdr/framework.h"
+#include "util/udpbatchsocket.h"
+
+namespace leansdr
+{
+
+// Transport stream output to UDP without going through the video player.
+// Datagrams of 7 TS packets (1316 bytes, the usual TS over UDP payload)
+// are sent straight from the pipe buffer in batches.
+// run() may be called from any thread of the scheduler pool so only the native
+// socket is used (Linux, IPv4): the QUdpSocket fallback is tied to the thread
+// that created it. Sends do not block and datagrams that do not fit in the
+// socket buffer are dropped.
+template<typename T> struct datvudpoutput: runnable
+{
+    static const int packetsPerDatagram = 7;
+
+    datvudpoutput(scheduler *sch, pipebuf<T> &_in, const QString& address, quint16 port) :
+            runnable(sch, "TS UDP output"), in(_in), m_nbSent(0), m_nbDropped(0)
+    {
+        m_socket.setDestination(QHostAddress(address), port);
+        m_socket.setBufferSizes(1<<20, 0); // about 50 ms at 20 Mb/s
+        m_socket.setNonBlocking(true);
+        m_socket.setFallbackEnabled(false);
+
+        if (!m_socket.openSender()) {
+            qWarning("leansdr::datvudpoutput: cannot send to %s:%d: an IPv4 address and sendmmsg support are needed",
+                qPrintable(address), port);
+        }
+    }
+
+    ~datvudpoutput()
+    {
+        qDebug("leansdr::datvudpoutput: %lu packets sent %lu dropped", m_nbSent, m_nbDropped);
+    }
+
+    void run()
+    {
+        int nbDatagrams = in.readable() / packetsPerDatagram;
+
+        if (!nbDatagrams) {
+            return;
+        }
+
+        int nbSent = m_socket.writeDatagrams((const char *) in.rd(), packetsPerDatagram * sizeof(T), nbDatagrams);
+
+        // Never stall the demodulator: unsent datagrams are lost as on the network
+        m_nbSent += nbSent * packetsPerDatagram;
+        m_nbDropped += (nbDatagrams - nbSent) * packetsPerDatagram;
+        in.read(nbDatagrams * packetsPerDatagram);
+    }
+
+private:
+    pipereader<T> in;
+    UDPBatchSocket m_socket;
+    unsigned long m_nbSent;
+    unsigned long m_nbDropped;
+};
+
+// Transport stream output to a named pipe (created if it does not exist) or a file.
+// The pipe is opened for reading too so that the writes never fail when the reader
+// is not there yet. Writes are non blocking and made of whole packets: when the
+// reader is too slow packets are dropped instead of stalling the demodulator.
+template<typename T> struct datvpipeoutput: runnable
+{
+    datvpipeoutput(scheduler *sch, pipebuf<T> &_in, const QString& path) :
+            runnable(sch, "TS pipe output"), in(_in), m_fd(-1), m_nbSent(0), m_nbDropped(0)
+    {
+        QByteArray pathBytes = path.toLocal8Bit();
+#ifdef _MSC_VER
+        m_fd = _open(pathBytes.constData(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+        m_packetsPerWrite = 64;
+#else
+        struct stat st;
+
+        if ((stat(pathBytes.constData(), &st) < 0) && (errno == ENOENT))
+        {
+            if (mkfifo(pathBytes.constData(), 0666) < 0) {
+                qWarning("leansdr::datvpipeoutput: cannot create %s: %s", pathBytes.constData(), strerror(errno));
+            }
+        }
+
+        if ((stat(pathBytes.constData(), &st) == 0) && S_ISFIFO(st.st_mode))
+        {
+            m_fd = open(pathBytes.constData(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+            m_packetsPerWrite = PIPE_BUF / sizeof(T); // atomic writes: all or nothing
+        }
+        else
+        {
+            m_fd = open(pathBytes.constData(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+            m_packetsPerWrite = 64;
+        }
+#endif
+        if (m_fd < 0) {
+            qWarning("leansdr::datvpipeoutput: cannot open %s: %s", pathBytes.constData(), strerror(errno));
+        }
+    }
+
+    ~datvpipeoutput()
+    {
+        qDebug("leansdr::datvpipeoutput: %lu packets sent %lu dropped", m_nbSent, m_nbDropped);
+
+        if (m_fd >= 0) {
+#ifdef _MSC_VER
+            _close(m_fd);
+#else
+            close(m_fd);
+#endif
+        }
+    }
+
+    void run()
+    {
+        unsigned long nbPackets = in.readable();
+
+        if (!nbPackets) {
+            return;
+        }
+
+        const T *p = in.rd();
+        unsigned long nbWritten = 0;
+
+        while ((m_fd >= 0) && (nbWritten < nbPackets))
+        {
+            int nbChunk = std::min(nbPackets - nbWritten, (unsigned long) m_packetsPerWrite);
+#ifdef _MSC_VER
+            int nw = _write(m_fd, p + nbWritten, nbChunk * sizeof(T));
+#else
+            ssize_t nw = write(m_fd, p + nbWritten, nbChunk * sizeof(T));
+#endif
+            if (nw < 0)
+            {
+                if (errno == EINTR) {
+                    continue;
+                }
+
+                if (errno != EAGAIN) {
+                    qWarning("leansdr::datvpipeoutput::run: write: %s", strerror(errno));
+                }
+
+                break;
+            }
+
+            nbWritten += nw / sizeof(T);
+
+            if (nw % sizeof(T) != 0)
+            {
+                fatal("leansdr::datvpipeoutput::run: partial write");
+                break;
+            }
+        }
+
+        m_nbSent += nbWritten;
+        m_nbDropped += nbPackets - nbWritten;
+        in.read(nbPackets);
+    }
+
+private:
+    pipereader<T> in;
+    int m_fd;
+    int m_packetsPerWrite;
+    unsigned long m_nbSent;
+    unsigned long m_nbDropped;
+};
+
+}
+
+#endif // DATVTSOUTPUT_H
@@ -52,6 +52,7 @@ HEADERS += datvdemod.h\
     leansdr/viterbi.h \
     datvconstellation.h \
     datvvideoplayer.h \
+    datvtsoutput.h \
     datvideostream.h \
     datvideorender.h
 
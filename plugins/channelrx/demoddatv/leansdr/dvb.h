@@ -875,6 +875,10 @@ struct mpeg_sync: runnable
     {
         state_out = _state_out ? new pipewriter<int>(*_state_out) : NULL;
         locktime_out = locktime_out ? new pipewriter<unsigned long>(*_locktime_out) : NULL;
+
+        if (deconv) {
+            sch->group(this, deconv); // next_sync() changes the deconvolver state
+        }
     }
 
     void run()
@@ -1187,10 +1191,12 @@ template<typename Tbyte, int BYTE_ERASED>
 struct rs_decoder: runnable
 {
     rs_engine rs;
+    // fast: check error free packets with the remainder modulo G and
+    // compute the syndromes with tables
     rs_decoder(scheduler *sch, pipebuf<rspacket<Tbyte> > &_in,
             pipebuf<tspacket> &_out, pipebuf<int> *_bitcount = NULL,
-            pipebuf<int> *_errcount = NULL) :
-            runnable(sch, "RS decoder"), in(_in), out(_out)
+            pipebuf<int> *_errcount = NULL, bool _fast = false) :
+            runnable(sch, "RS decoder"), in(_in), out(_out), fast(_fast)
     {
         bitcount = _bitcount ? new pipewriter<int>(*_bitcount) : NULL;
         errcount = _errcount ? new pipewriter<int>(*_errcount) : NULL;
@@ -1221,7 +1227,12 @@ struct rs_decoder: runnable
             }
 
             u8 synd[16];
-            bool corrupted = rs.syndromes(pin, synd);
+            bool corrupted;
+
+            if (fast)
+                corrupted = !rs.divisible(pin) && rs.syndromes_table(pin, synd);
+            else
+                corrupted = rs.syndromes(pin, synd);
 
 #if 0
             if ( ! corrupted )
@@ -1271,6 +1282,7 @@ private:
     pipereader<rspacket<Tbyte> > in;
     pipewriter<tspacket> out;
     pipewriter<int> *bitcount, *errcount;
+    bool fast;
 };
 // rs_decoder
 
@@ -1405,7 +1417,8 @@ private:
 // Simplified metric to support large constellations.
 
 // This version implements puncturing by expanding the trellis.
-// TBD Compare performance vs skipping updates in a 1/2 trellis.
+// With fast set, viterbi_k7_dec skips the punctured bits in the
+// 1/2 trellis instead.
 
 struct viterbi_sync: runnable
 {
@@ -1470,8 +1483,9 @@ private:
 public:
     int resync_period;
 
+    // fast: decode with the SIMD K=7 decoder instead of the expanded trellis
     viterbi_sync(scheduler *sch, pipebuf<softsymbol> &_in,
-            pipebuf<unsigned char> &_out, cstln_lut<256> *_cstln, code_rate cr) :
+            pipebuf<unsigned char> &_out, cstln_lut<256> *_cstln, code_rate cr, bool fast = false) :
             runnable(sch, "viterbi_sync"), in(_in), out(_out, chunk_size), cstln(
                     _cstln), current_sync(0), resync_phase(0), resync_period(32) // 1/32 = 9% synchronization overhead TBD
     {
@@ -1540,7 +1554,12 @@ public:
 #endif
         }
 
-        if (cr == FEC12)
+        if (fast && fec->bits_in)
+        {
+            for (int s = 0; s < nsyncs; ++s)
+                syncs[s].dec = new viterbi_k7_dec<TUS, TCS, TBM, TPM>(fec->polys, fec->bits_in, fec->bits_out, DVBS_G1, DVBS_G2);
+        }
+        else if (cr == FEC12)
         {
             trellis_12 *trell = new trellis_12();
             trell->init_convolutional(fec->polys);
@@ -3,11 +3,18 @@
 
 #include <cstddef>
 #include <algorithm>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <chrono>
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <time.h>
 
 namespace leansdr
 {
@@ -31,6 +38,13 @@ inline void fail(const char *f, const char *s)
 // [pipereader] is a client-side hook reading from a [pipebuf].
 // [runnable] is anything that moves data between [pipebufs].
 // [scheduler] is a global context which invokes [runnables] until fixpoint.
+//
+// The scheduler can run the [runnables] of a step on a pool of threads.
+// Every stage then works on the data produced by the previous one during
+// the previous step. A [pipebuf] has a single writer and its write pointer
+// is published atomically so readers never need a lock. Moving data back
+// to the start of a [pipebuf] (pack) is done between steps when no
+// [runnable] is active.
 
 static const int MAX_PIPES = 64;
 static const int MAX_RUNNABLES = 64;
@@ -53,8 +67,12 @@ struct pipebuf_common
         (void) total_bufs;
     }
 
+    virtual void pack()
+    {
+    }
+
     pipebuf_common(const char *_name) :
-            name(_name)
+            name(_name), deferred_pack(false), pack_requested(false)
     {
     }
 
@@ -63,12 +81,26 @@ struct pipebuf_common
     }
 
     const char *name;
+    bool deferred_pack;               // set by a multithreaded scheduler: pack between steps only
+    std::atomic<bool> pack_requested; // a writer ran short of space during the step
 };
 
+// CPU time of the calling thread in nanoseconds
+inline unsigned long long thread_cpu_ns()
+{
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
 struct runnable_common
 {
     runnable_common(const char *_name) :
-            name(_name)
+            name(_name), group(-1), cpu_ns(0), nb_runs(0)
     {
     }
 
@@ -90,6 +122,9 @@ struct runnable_common
 #endif
 
     const char *name;
+    int group;                 // runnables of the same group never run concurrently
+    unsigned long long cpu_ns; // CPU time spent in run()
+    unsigned long long nb_runs;
 };
 
 struct window_placement
@@ -108,12 +143,18 @@ struct scheduler
     bool verbose, debug;
 
     scheduler() :
-            npipes(0), nrunnables(0), windows(nullptr), verbose(false), debug(false)
+            npipes(0), nrunnables(0), windows(nullptr), verbose(false), debug(false),
+            ngroups(0), pool_generation(0), pool_pending(0), pool_exit(false), next_group(0)
     {
         std::fill(pipes, pipes + MAX_PIPES, nullptr);
         std::fill(runnables, runnables + MAX_RUNNABLES, nullptr);
     }
 
+    ~scheduler()
+    {
+        set_threads(1);
+    }
+
     void add_pipe(pipebuf_common *p)
     {
         if (npipes == MAX_PIPES)
@@ -121,6 +162,7 @@ struct scheduler
             fail("scheduler::add_pipe", "MAX_PIPES");
             return;
         }
+        p->deferred_pack = !workers.empty();
         pipes[npipes++] = p;
     }
 
@@ -129,14 +171,93 @@ struct scheduler
         if (nrunnables == MAX_RUNNABLES)
         {
             fail("scheduler::add_runnable", "MAX_RUNNABLES");
+            return;
         }
+        r->group = nrunnables;
+        group_leaders[ngroups++] = nrunnables;
         runnables[nrunnables++] = r;
     }
 
+    // a and b share state: never run them concurrently
+    void group(runnable_common *a, runnable_common *b)
+    {
+        int from = std::max(a->group, b->group);
+        int to = std::min(a->group, b->group);
+        ngroups = 0;
+
+        for (int i = 0; i < nrunnables; ++i)
+        {
+            if (runnables[i]->group == from) {
+                runnables[i]->group = to;
+            }
+            if (runnables[i]->group == i) {
+                group_leaders[ngroups++] = i;
+            }
+        }
+    }
+
+    // Run the steps on nthreads threads including the caller. 1 runs everything in the caller thread.
+    void set_threads(int nthreads)
+    {
+        if (!workers.empty())
+        {
+            {
+                std::lock_guard<std::mutex> lock(pool_mutex);
+                pool_exit = true;
+            }
+            pool_start.notify_all();
+            for (std::size_t i = 0; i < workers.size(); ++i) {
+                workers[i].join();
+            }
+            workers.clear();
+            pool_exit = false;
+        }
+
+        for (int i = 1; i < nthreads; ++i) {
+            workers.push_back(std::thread(&scheduler::worker, this, pool_generation));
+        }
+
+        for (int i = 0; i < npipes; ++i) {
+            pipes[i]->deferred_pack = !workers.empty();
+        }
+    }
+
+    int threads() const
+    {
+        return workers.size() + 1;
+    }
+
     void step()
     {
-        for (int i = 0; i < nrunnables; ++i) {
-            runnables[i]->run();
+        if (workers.empty())
+        {
+            for (int i = 0; i < nrunnables; ++i) {
+                run_timed(runnables[i]);
+            }
+            return;
+        }
+
+        next_group = 0;
+        {
+            std::lock_guard<std::mutex> lock(pool_mutex);
+            pool_pending = workers.size();
+            pool_generation++;
+        }
+        pool_start.notify_all();
+        run_groups();
+        {
+            std::unique_lock<std::mutex> lock(pool_mutex);
+            pool_done.wait(lock, [this]{ return pool_pending == 0; });
+        }
+
+        // All runnables are idle
+        for (int i = 0; i < npipes; ++i)
+        {
+            if (pipes[i]->pack_requested)
+            {
+                pipes[i]->pack();
+                pipes[i]->pack_requested = false;
+            }
         }
     }
 
@@ -157,6 +278,8 @@ struct scheduler
 
     void shutdown()
     {
+        set_threads(1);
+
         for (int i = 0; i < nrunnables; ++i) {
             runnables[i]->shutdown();
         }
@@ -180,6 +303,84 @@ struct scheduler
         }
         fprintf(stderr, "leansdr::scheduler::dump Total buffer memory: %ld KiB\n", (unsigned long) total_bufs / 1024);
     }
+
+    void dump_cpu()
+    {
+        unsigned long long total_ns = 0;
+        for (int i = 0; i < nrunnables; ++i) {
+            total_ns += runnables[i]->cpu_ns;
+        }
+        for (int i = 0; i < nrunnables; ++i)
+        {
+            fprintf(stderr, "leansdr::scheduler::dump_cpu: %-24s %10.3f ms %5.1f%% %10llu runs\n",
+                    runnables[i]->name,
+                    runnables[i]->cpu_ns / 1e6,
+                    total_ns ? (100.0 * runnables[i]->cpu_ns) / total_ns : 0.0,
+                    runnables[i]->nb_runs);
+        }
+        fprintf(stderr, "leansdr::scheduler::dump_cpu: %d threads total %.3f ms\n", threads(), total_ns / 1e6);
+    }
+
+private:
+    int group_leaders[MAX_RUNNABLES]; // first runnable of each group
+    int ngroups;
+    std::vector<std::thread> workers;
+    std::mutex pool_mutex;
+    std::condition_variable pool_start;
+    std::condition_variable pool_done;
+    unsigned long pool_generation; // one per threaded step
+    int pool_pending;              // workers still busy in the current step
+    bool pool_exit;
+    std::atomic<int> next_group;
+
+    static void run_timed(runnable_common *r)
+    {
+        unsigned long long t0 = thread_cpu_ns();
+        r->run();
+        r->cpu_ns += thread_cpu_ns() - t0;
+        r->nb_runs++;
+    }
+
+    // Take groups until none is left for this step. A group runs its runnables in order.
+    void run_groups()
+    {
+        int g;
+
+        while ((g = next_group.fetch_add(1)) < ngroups)
+        {
+            int leader = group_leaders[g];
+            for (int i = leader; i < nrunnables; ++i)
+            {
+                if (runnables[i]->group == leader) {
+                    run_timed(runnables[i]);
+                }
+            }
+        }
+    }
+
+    void worker(unsigned long generation)
+    {
+        while (1)
+        {
+            {
+                std::unique_lock<std::mutex> lock(pool_mutex);
+                pool_start.wait(lock, [this, generation]{ return pool_exit || (pool_generation != generation); });
+                if (pool_exit) {
+                    return;
+                }
+                generation = pool_generation;
+            }
+
+            run_groups();
+
+            {
+                std::lock_guard<std::mutex> lock(pool_mutex);
+                if (--pool_pending == 0) {
+                    pool_done.notify_one();
+                }
+            }
+        }
+    }
 };
 
 struct runnable: runnable_common
@@ -199,7 +400,7 @@ struct pipebuf: pipebuf_common
     T *buf;
     T *rds[MAX_READERS];
     int nrd;
-    T *wr;
+    std::atomic<T*> wr; // published by the writer, read by the readers
     T *end;
 
     int sizeofT()
@@ -221,21 +422,22 @@ struct pipebuf: pipebuf_common
             fail("pipebuf::add_reader", "too many readers");
             return nrd;
         }
-        rds[nrd] = wr;
+        rds[nrd] = wr.load();
         return nrd++;
     }
 
     void pack()
     {
-        T *rd = wr;
+        T *w = wr.load();
+        T *rd = w;
         for (int i = 0; i < nrd; ++i)
         {
             if (rds[i] < rd) {
                 rd = rds[i];
             }
         }
-        memmove(buf, rd, (wr - rd) * sizeof(T));
-        wr -= rd - buf;
+        memmove(buf, rd, (w - rd) * sizeof(T));
+        wr.store(w - (rd - buf));
         for (int i = 0; i < nrd; ++i) {
             rds[i] -= rd - buf;
         }
@@ -249,7 +451,7 @@ struct pipebuf: pipebuf_common
     void dump(std::size_t *total_bufs)
     {
         if (total_written < 10000) {
-            fprintf(stderr, "leansdr::pipebuf::dump: .%-16s : %4ld/%4ld", name, total_read, total_written);
+            fprintf(stderr, "leansdr::pipebuf::dump: .%-16s : %4ld/%4ld", name, total_read.load(), total_written.load());
         } else if (total_written < 1000000) {
             fprintf(stderr, "leansdr::pipebuf::dump: .%-16s : %3ldk/%3ldk", name, total_read / 1000, total_written / 1000);
         } else {
@@ -257,9 +459,10 @@ struct pipebuf: pipebuf_common
         }
 
         *total_bufs += (end - buf) * sizeof(T);
-        unsigned long nw = end - wr;
+        T *w = wr.load();
+        unsigned long nw = end - w;
         fprintf(stderr, "leansdr::pipebuf: %6ld writable %c,", nw, (nw < min_write) ? '!' : ' ');
-        T *rd = wr;
+        T *rd = w;
 
         for (int j = 0; j < nrd; ++j)
         {
@@ -268,16 +471,16 @@ struct pipebuf: pipebuf_common
             }
         }
 
-        fprintf(stderr, "leansdr::pipebuf::dump: %6d unread (", (int) (wr - rd));
+        fprintf(stderr, "leansdr::pipebuf::dump: %6d unread (", (int) (w - rd));
 
         for (int j = 0; j < nrd; ++j) {
-            fprintf(stderr, "leansdr::pipebuf: %d", (int) (wr - rds[j]));
+            fprintf(stderr, "leansdr::pipebuf: %d", (int) (w - rds[j]));
         }
 
         fprintf(stderr, "leansdr::pipebuf::dump: )\n");
     }
     unsigned long min_write;
-    unsigned long total_written, total_read;
+    std::atomic<unsigned long> total_written, total_read;
 #ifdef DEBUG
     ~pipebuf()
     {   fprintf(stderr, "Deallocating %s !\n", name);}
@@ -300,16 +503,23 @@ struct pipewriter
     /** Return number of items writable at this->wr, 0 if full. */
     unsigned long writable()
     {
-        if (buf.end < buf.wr)
+        T *w = buf.wr.load(std::memory_order_relaxed);
+
+        if (buf.end < w)
         {
             fprintf(stderr, "leansdr::pipewriter::writable: overflow in %s buffer\n", buf.name);
             return 0;
         }
 
-        unsigned long delta = buf.end - buf.wr;
+        unsigned long delta = buf.end - w;
 
-        if (delta < buf.min_write) {
-            buf.pack();
+        if (delta < buf.min_write)
+        {
+            if (buf.deferred_pack) {
+                buf.pack_requested = true; // readers may be active: the scheduler packs after the step
+            } else {
+                buf.pack();
+            }
         }
 
         return delta;
@@ -317,18 +527,20 @@ struct pipewriter
 
     T *wr()
     {
-        return buf.wr;
+        return buf.wr.load(std::memory_order_relaxed);
     }
 
     void written(unsigned long n)
     {
-        if (buf.wr + n > buf.end)
+        T *w = buf.wr.load(std::memory_order_relaxed);
+
+        if (w + n > buf.end)
         {
             fprintf(stderr, "leansdr::pipewriter::written: overflow in %s buffer\n", buf.name);
             return;
         }
-        buf.wr += n;
-        buf.total_written += n;
+        buf.wr.store(w + n, std::memory_order_release);
+        buf.total_written.fetch_add(n, std::memory_order_relaxed);
     }
 
     void write(const T &e)
@@ -373,7 +585,7 @@ struct pipereader
 
     unsigned long readable()
     {
-        return buf.wr - buf.rds[id];
+        return buf.wr.load(std::memory_order_acquire) - buf.rds[id];
     }
 
     T *rd()
@@ -383,13 +595,13 @@ struct pipereader
 
     void read(unsigned long n)
     {
-        if (buf.rds[id] + n > buf.wr)
+        if (buf.rds[id] + n > buf.wr.load(std::memory_order_acquire))
         {
             fprintf(stderr, "leansdr::pipereader::read: underflow in %s buffer\n", buf.name);
             return;
         }
         buf.rds[id] += n;
-        buf.total_read += n;
+        buf.total_read.fetch_add(n, std::memory_order_relaxed);
     }
 };
 
@@ -118,6 +118,7 @@ struct rs_engine
         for ( int i=0; i<=16; ++i ) fprintf(stderr, " %02x", G[i]);
         fprintf(stderr, "\n");
 #endif
+        init_tables();
     }
 
     // RS-encoded messages are interpreted as coefficients in
@@ -137,6 +138,46 @@ struct rs_engine
         }
         return corrupted;
     }
+
+    // Same as syndromes() with one pass over the message and
+    // multiplications by alpha^i looked up in tables.
+    bool syndromes_table(const u8 *poly, u8 *synd)
+    {
+        u8 acc[16];
+        memset(acc, 0, sizeof(acc));
+        for (int n = 0; n < 204; ++n)
+        {
+            u8 c = poly[n];
+            for (int i = 0; i < 16; ++i)
+                acc[i] = synd_mul[i][acc[i]] ^ c;
+        }
+        bool corrupted = false;
+        for (int i = 0; i < 16; ++i)
+        {
+            synd[i] = acc[i];
+            if (acc[i])
+                corrupted = true;
+        }
+        return corrupted;
+    }
+
+    // True when the codeword is a multiple of G i.e. all syndromes are zero.
+    // The remainder modulo G is computed 8 bytes at a time in a
+    // 128 bit LFSR, which is much cheaper than the 16 syndromes.
+    bool divisible(const u8 *poly)
+    {
+        uint64_t hi = 0, lo = 0;
+        for (int n = 0; n < 204; ++n)
+        {
+            u8 fb = (hi >> 56) ^ poly[n];
+            hi = (hi << 8) | (lo >> 56);
+            lo <<= 8;
+            hi ^= rem_hi[fb];
+            lo ^= rem_lo[fb];
+        }
+        return !hi && !lo;
+    }
+
     u8 eval_poly_rev(const u8 *poly, int n, u8 x)
     {
         // poly[0]*x^(n-1) + .. + poly[n-1]*x^0 with Hörner method.
@@ -309,6 +350,30 @@ struct rs_engine
             return false;
     }
 
+private:
+    u8 synd_mul[16][256];  // synd_mul[i][x] = x*alpha^i
+    uint64_t rem_hi[256];  // x*G(X) without the X^16 term, degrees 15..8
+    uint64_t rem_lo[256];  // and degrees 7..0
+
+    void init_tables()
+    {
+        for (int i = 0; i < 16; ++i)
+            for (int x = 0; x < 256; ++x)
+                synd_mul[i][x] = gf.mul(x, gf.exp(i));
+        for (int x = 0; x < 256; ++x)
+        {
+            rem_hi[x] = rem_lo[x] = 0;
+            for (int i = 1; i <= 16; ++i)
+            {
+                uint64_t c = gf.mul(x, G[i]);
+                if (i <= 8)
+                    rem_hi[x] |= c << (8 * (8 - i));
+                else
+                    rem_lo[x] |= c << (8 * (16 - i));
+            }
+        }
+    }
+
 };
 
 }  // namespace
@@ -5,6 +5,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "dsp/viterbik7kernels.h"
+
 // This is a generic implementation of Viterbi with explicit
 // representation of the trellis.  There is special support for
 // convolutional coding, but the code can handle other schemes.
@@ -305,6 +307,168 @@ private:
     TPM max_tpm;
 };
 
+// Viterbi decoder of punctured codes derived from a K=7 rate 1/2 code.
+// It runs the 64 state trellis of the mother code with the SIMD kernels
+// of ViterbiK7Kernels instead of expanding the trellis to the punctured
+// block. Each coded bit costs [weight] when it differs from the received
+// hard bit and nothing when punctured (weighted Hamming distance).
+// Decisions are traced back in blocks, which gives a constant delay of
+// TRACEBACK+BLOCK uncoded bits between the input and the output.
+
+template<typename TUS, typename TCS, typename TBM, typename TPM>
+struct viterbi_k7_dec: viterbi_dec_interface<TUS, TCS, TBM, TPM>
+{
+    static const int MAX_BITS_IN = 8;
+    static const int TRACEBACK = 64;  // Depth before a bit is decided
+    static const int BLOCK = 32;      // Bits decided by a traceback
+    static const int HISTORY = 256;   // Decisions kept, at least TRACEBACK+BLOCK+MAX_BITS_IN
+
+    // polys[bits_out] are the punctured code polynomials: g1 or g2 shifted by the input bit index.
+    // cost_scale divides the (negative) symbol costs to get bit weights.
+    viterbi_k7_dec(const uint16_t *polys, int _bits_in, int _bits_out, uint16_t g1, uint16_t g2, int _cost_scale = 64) :
+            bits_in(_bits_in), bits_out(_bits_out), cost_scale(_cost_scale), nsteps(0), ndecided(0), out_rd(0), out_wr(0)
+    {
+        ViterbiK7Kernels::makeBranchTable(g1, g2, table);
+        memset(metrics, 0, sizeof(metrics));
+        memset(outbits, 0, sizeof(outbits));
+        out_wr = TRACEBACK + BLOCK; // Output delay
+
+        if ((bits_in > MAX_BITS_IN) || (bits_out > 2 * MAX_BITS_IN))
+        {
+            fail("viterbi_k7_dec::viterbi_k7_dec", "Code rate not supported");
+            bits_in = bits_out = 0;
+            return;
+        }
+
+        for (int g = 0; g < bits_out; ++g)
+        {
+            punct[g] = -1;
+
+            for (int t = 0; t < bits_in; ++t)
+            {
+                if (polys[g] == (g1 << t)) {
+                    punct[g] = 4 * t;
+                } else if (polys[g] == (g2 << t)) {
+                    punct[g] = 4 * t + 2;
+                }
+            }
+
+            if (punct[g] < 0)
+            {
+                fail("viterbi_k7_dec::viterbi_k7_dec", "Not a K=7 punctured code");
+                bits_in = bits_out = 0;
+                return;
+            }
+        }
+    }
+
+    // Update with the hard decided coded symbol cs and its cost (negative).
+    // The quality is minus the increase of the best path metric.
+
+    TUS update(TCS cs, TBM cost, TPM *quality = NULL)
+    {
+        int16_t costs[4 * MAX_BITS_IN];
+        uint64_t decisions[MAX_BITS_IN];
+        // Rounded up so that hard metrics (-1 per symbol) still count
+        int weight = (cost < 0 && bits_out) ? 1 + (-cost - 1) / (cost_scale * bits_out) : 0;
+        weight = weight > ViterbiK7Kernels::maxCost ? ViterbiK7Kernels::maxCost : weight;
+        memset(costs, 0, sizeof(costs));
+
+        for (int g = 0; g < bits_out; ++g)
+        {
+            int bit = (cs >> (bits_out - 1 - g)) & 1;
+            costs[punct[g] + 1 - bit] = weight; // The other value of the bit
+        }
+
+        int growth = ViterbiK7Kernels::acs(metrics, table, costs, bits_in, decisions);
+
+        for (int t = 0; t < bits_in; ++t) {
+            history[(nsteps + t) % HISTORY] = decisions[t];
+        }
+
+        nsteps += bits_in;
+
+        if (nsteps - ndecided >= TRACEBACK + BLOCK) {
+            traceback();
+        }
+
+        if (quality) {
+            *quality = -growth;
+        }
+
+        TUS us = 0;
+
+        for (int i = 0; i < bits_in; ++i)
+        {
+            us = (us << 1) | outbits[out_rd];
+            out_rd = (out_rd + 1) % OUTBITS;
+        }
+
+        return us;
+    }
+
+    // The partial and full metric updates use the best coded symbol only.
+
+    TUS update(int nm, TCS cs[], TBM costs[], TPM *quality = NULL)
+    {
+        int best = 0;
+        for (int im = 1; im < nm; ++im)
+            if (costs[im] < costs[best])
+                best = im;
+        return update(cs[best], costs[best], quality);
+    }
+
+    TUS update(TBM costs[], TPM *quality = NULL)
+    {
+        TCS best = 0;
+        for (int cs = 1; cs < (1 << bits_out); ++cs)
+            if (costs[cs] < costs[best])
+                best = cs;
+        return update(best, costs[best], quality);
+    }
+
+private:
+    static const int OUTBITS = 2 * (TRACEBACK + 2 * BLOCK + MAX_BITS_IN);
+    int bits_in, bits_out;
+    int cost_scale;
+    int punct[2 * MAX_BITS_IN];    // Index in the costs of a step of each coded bit
+    int16_t table[ViterbiK7Kernels::branchTableSize];
+    int16_t metrics[ViterbiK7Kernels::nbStates];
+    uint64_t history[HISTORY];     // Decisions of the last steps
+    unsigned long nsteps;          // Trellis steps run
+    unsigned long ndecided;        // Steps whose input bit is in outbits[]
+    uint8_t outbits[OUTBITS];      // Decided bits waiting to be returned
+    int out_rd, out_wr;
+
+    // Decide the bits of the steps older than TRACEBACK from the best state
+    void traceback()
+    {
+        int state = 0;
+
+        for (int n = 1; n < ViterbiK7Kernels::nbStates; ++n)
+            if (metrics[n] < metrics[state])
+                state = n;
+
+        unsigned long ndecide = nsteps - TRACEBACK;
+        uint8_t bits[TRACEBACK + 2 * BLOCK + MAX_BITS_IN];
+
+        for (unsigned long t = nsteps; t-- > ndecided;)
+        {
+            int d = (history[t % HISTORY] >> state) & 1;
+            bits[t - ndecided] = state & 1;
+            state = (state >> 1) | (d << 5);
+        }
+
+        for (unsigned long t = ndecided; t < ndecide; ++t)
+        {
+            outbits[out_wr] = bits[t - ndecided];
+            out_wr = (out_wr + 1) % OUTBITS;
+        }
+
+        ndecided = ndecide;
+    }
+};
+
 // Paths (sequences of uncoded symbols) represented as bitstreams.
 // NBITS is the number of bits per symbol.
 // DEPTH is the number of symbols stored in the path.
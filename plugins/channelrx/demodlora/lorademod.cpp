@@ -20,10 +20,12 @@
 #include <QTime>
 #include <QDebug>
 #include <stdio.h>
+#include <algorithm>
 
 #include "dsp/downchannelizer.h"
 #include "dsp/threadedbasebandsamplesink.h"
 #include "dsp/dspcommands.h"
+#include "dsp/fftengine.h"
 #include "device/devicesourceapi.h"
 
 #include "lorademod.h"
@@ -38,6 +40,8 @@ const QString LoRaDemod::m_channelId = "LoRaDemod";
 LoRaDemod::LoRaDemod(DeviceSourceAPI* deviceAPI) :
         ChannelSinkAPI(m_channelIdURI),
         m_deviceAPI(deviceAPI),
+        m_spreadFactor(0),
+        m_nbSymbolBins(0),
         m_sampleSink(0),
         m_settingsMutex(QMutex::Recursive)
 {
@@ -50,21 +54,8 @@ LoRaDemod::LoRaDemod(DeviceSourceAPI* deviceAPI) :
 	m_interpolator.create(16, m_sampleRate, m_Bandwidth/1.9);
 	m_sampleDistanceRemain = (Real)m_sampleRate / m_Bandwidth;
 
-	m_chirp = 0;
-	m_angle = 0;
-	m_bin = 0;
-	m_result = 0;
-	m_count = 0;
-	m_header = 0;
-	m_time = 0;
-	m_tune = 0;
-
-	loraFilter = new sfft(LORA_SFFT_LEN);
-	negaFilter = new sfft(LORA_SFFT_LEN);
-
-	mov = new float[4*LORA_SFFT_LEN];
-	history = new short[1024];
-	finetune = new short[16];
+	m_fft = FFTEngine::create();
+	setSpreadFactor(m_settings.m_spreadFactor);
 
     m_channelizer = new DownChannelizer(this);
     m_threadedChannelizer = new ThreadedBasebandSampleSink(m_channelizer);
@@ -74,16 +65,7 @@ LoRaDemod::LoRaDemod(DeviceSourceAPI* deviceAPI) :
 
 LoRaDemod::~LoRaDemod()
 {
-	if (loraFilter)
-		delete loraFilter;
-	if (negaFilter)
-		delete negaFilter;
-	if (mov)
-		delete [] mov;
-	if (history)
-		delete [] history;
-	if (finetune)
-		delete [] finetune;
+	delete m_fft;
 
 	m_deviceAPI->removeChannelAPI(this);
     m_deviceAPI->removeThreadedSink(m_threadedChannelizer);
@@ -91,12 +73,49 @@ LoRaDemod::~LoRaDemod()
     delete m_channelizer;
 }
 
+void LoRaDemod::setSpreadFactor(int spreadFactor)
+{
+	m_spreadFactor = spreadFactor;
+	m_nbSymbolBins = 1 << spreadFactor;
+
+	if (m_fft) {
+		m_fft->configure(m_nbSymbolBins, false);
+	}
+
+	m_downChirp.resize(m_nbSymbolBins);
+	m_upChirp.resize(m_nbSymbolBins);
+	m_toneTable.resize(m_nbSymbolBins);
+	m_symbolBuffer.resize(m_nbSymbolBins);
+
+	// Base up chirp at one sample per chip: phase pi*k^2/N that is periodic modulo 2N in k^2
+	for (unsigned int k = 0; k < m_nbSymbolBins; k++)
+	{
+		double phase = (M_PI * ((k * k) % (2 * m_nbSymbolBins))) / m_nbSymbolBins;
+		m_upChirp[k] = Complex(cos(phase), sin(phase));
+		m_downChirp[k] = std::conj(m_upChirp[k]);
+		phase = (2.0 * M_PI * k) / m_nbSymbolBins;
+		m_toneTable[k] = Complex(cos(phase), sin(phase));
+	}
+
+	m_symbolFill = 0;
+	m_skip = 0;
+	m_state = LoRaStateSearch;
+	m_lastBin = -1;
+	m_repeatCount = 0;
+	m_syncCount = 0;
+	m_tune = 0;
+	m_result = 0;
+	m_bin = 0;
+	m_symbols.clear();
+}
+
 void LoRaDemod::dumpRaw()
 {
-	short bin, j, max;
+	short j, max;
 	char text[256];
+	int symbolMask = (m_nbSymbolBins >> 2) - 1; // low data rate: two bits less than the spreading factor
 
-	max = m_time / 4 - 3;
+	max = m_symbols.size();
 
 	if (max > 140)
 	{
@@ -105,8 +124,21 @@ void LoRaDemod::dumpRaw()
 
 	for ( j=0; j < max; j++)
 	{
-		bin = (history[(j + 1)  * 4] + m_tune ) & (LORA_SFFT_LEN - 1);
-		text[j] = toGray(bin >> 1);
+		text[j] = toGray(((m_symbols[j] + 2) >> 2) & symbolMask);
+	}
+
+	if (m_spreadFactor != 8)
+	{
+		// the payload decoding below is for 6 bits per symbol only
+		printf("SF%d:", m_spreadFactor);
+
+		for ( j=0; j < max; j++)
+		{
+			printf(" %d", toGray(((m_symbols[j] + 2) >> 2) & symbolMask));
+		}
+
+		printf("\n");
+		return;
 	}
 
 	prng6(text, max);
@@ -134,127 +166,119 @@ void LoRaDemod::dumpRaw()
 	printf("%s\n", &text[1]);
 }
 
-short LoRaDemod::synch(short bin)
+int LoRaDemod::demodSymbol(const Complex *chirp)
 {
-	short i, j;
-
-	if (bin < 0)
-	{
-		if (m_time > 70)
-		{
-			dumpRaw();
-		}
-
-		m_time = 0;
+	if (!m_fft) {
 		return -1;
 	}
 
-	history[m_time] = bin;
+	Complex *in = m_fft->in();
 
-	if (m_time > 12)
-	{
-		if (bin == history[m_time - 6])
-		{
-			if (bin == history[m_time - 12])
-			{
-				m_tune = LORA_SFFT_LEN - bin;
-				j = 0;
+	for (unsigned int k = 0; k < m_nbSymbolBins; k++) {
+		in[k] = m_symbolBuffer[k] * chirp[k];
+	}
 
-				for (i=0; i<12; i++)
-				{
-					j += finetune[15 & (m_time - i)];
-				}
+	m_fft->transform();
+	const Complex *out = m_fft->out();
+	Real peak = 0.0f;
+	Real total = 0.0f;
+	int result = 0;
 
-				if (j < 0)
-				{
-					m_tune += 1;
-				}
+	for (unsigned int k = 0; k < m_nbSymbolBins; k++)
+	{
+		Real magsq = std::norm(out[k]);
+		total += magsq;
 
-				m_tune &= (LORA_SFFT_LEN - 1);
-				m_time = 0;
-				return -1;
-			}
+		if (magsq > peak)
+		{
+			peak = magsq;
+			result = k;
 		}
 	}
 
-	m_time++;
-	m_time &= 1023;
+	Real average = (total - peak) / (m_nbSymbolBins - 1);
 
-	if (m_time & 3)
-	{
+	if (!(peak > LORA_SQUELCH_RATIO * average)) {
 		return -1;
 	}
 
-	return (bin + m_tune) & (LORA_SFFT_LEN - 1);
+	return result;
 }
 
-int LoRaDemod::detect(Complex c, Complex a)
+void LoRaDemod::processSymbol()
 {
-	int p, q;
-	short i, result, negresult, movpoint;
-	float peak, negpeak, tfloat;
-	float mag[LORA_SFFT_LEN];
-	float rev[LORA_SFFT_LEN];
+	LoRaState previousState = m_state;
+	int bin = demodSymbol(m_downChirp.data());
+	int nbBins = m_nbSymbolBins;
+	int distance = bin < 0 ? nbBins : abs(bin - (m_state == LoRaStateSearch ? m_lastBin : m_tune));
+	distance = std::min(distance, nbBins - distance); // bins wrap around
 
-	loraFilter->run(c * a);
-	negaFilter->run(c * conj(a));
-
-	// process spectrum twice in FFTLEN
-	if (++m_count & ((1 << DATA_BITS) - 1))
+	switch (m_state)
 	{
-		return m_result;
-	}
-
-	movpoint = 3 & (m_count >> DATA_BITS);
+	case LoRaStateSearch:
+		m_repeatCount = (bin >= 0) && (m_lastBin >= 0) && (distance <= 1) ? m_repeatCount + 1 : 0;
+		m_lastBin = bin;
 
-	loraFilter->fetch(mag);
-	negaFilter->fetch(rev);
-	peak = negpeak = 0.0f;
-	result = negresult = 0;
-
-	for (i = 0; i < LORA_SFFT_LEN; i++)
-	{
-		if (rev[i] > negpeak)
+		if (m_repeatCount >= LORA_PREAMBLE_REPEAT - 1)
 		{
-			negpeak = rev[i];
-			negresult = i;
+			// the chirps started bin samples before the window: move the next window on a chirp start
+			m_skip = (nbBins - bin) % nbBins;
+			m_tune = 0;
+			m_syncCount = 0;
+			m_state = LoRaStatePreamble;
 		}
-
-		tfloat = mov[i] + mov[LORA_SFFT_LEN + i] +mov[2 * LORA_SFFT_LEN + i]
-				+ mov[3 * LORA_SFFT_LEN + i] + mag[i];
-
-		if (tfloat > peak)
+		break;
+	case LoRaStatePreamble:
+		if (bin >= 0)
 		{
-			peak = tfloat;
-			result = i;
+			if ((m_syncCount == 0) && (distance <= 1)) {
+				m_tune = bin; // aligned preamble chirp: the bin left is the frequency offset
+			} else if (++m_syncCount > 2) { // more than the two sync word symbols
+				m_state = LoRaStateSearch;
+			}
+		}
+		else if (demodSymbol(m_upChirp.data()) >= 0) // first down chirp of the start frame delimiter
+		{
+			m_state = LoRaStateSFD;
+		}
+		else
+		{
+			m_state = LoRaStateSearch;
+		}
+		break;
+	case LoRaStateSFD:
+		m_skip = nbBins / 4; // the start frame delimiter is 2.25 down chirps
+		m_symbols.clear();
+		m_state = LoRaStatePayload;
+		break;
+	case LoRaStatePayload:
+		if (bin >= 0)
+		{
+			m_result = (bin - m_tune + nbBins) % nbBins;
+			m_symbols.push_back(m_result);
 		}
 
-		mov[movpoint * LORA_SFFT_LEN + i] = mag[i];
-	}
-
-	p = (result - 1 + LORA_SFFT_LEN) & (LORA_SFFT_LEN -1);
-	q = (result + 1) & (LORA_SFFT_LEN -1);
-	finetune[15 & m_time] = (mag[p] > mag[q]) ? -1 : 1;
+		if ((bin < 0) || ((int) m_symbols.size() >= LORA_MAX_SYMBOLS))
+		{
+			if (m_symbols.size() >= 8) {
+				dumpRaw();
+			}
 
-	if (peak < negpeak * LORA_SQUELCH)
-	{
-		result = -1;
+			m_state = LoRaStateSearch;
+		}
+		break;
 	}
 
-	result = synch(result);
-
-	if (result >= 0)
+	if ((m_state == LoRaStateSearch) && (previousState != LoRaStateSearch))
 	{
-		m_result = result;
+		m_lastBin = -1;
+		m_repeatCount = 0;
 	}
-
-	return m_result;
 }
 
 void LoRaDemod::feed(const SampleVector::const_iterator& begin, const SampleVector::const_iterator& end, bool pO)
 {
     (void) pO;
-	int newangle;
 	Complex ci;
 
 	m_sampleBuffer.clear();
@@ -268,13 +292,23 @@ void LoRaDemod::feed(const SampleVector::const_iterator& begin, const SampleVect
 
 		if(m_interpolator.decimate(&m_sampleDistanceRemain, c, &ci))
 		{
-			m_chirp = (m_chirp + 1) & (SPREADFACTOR - 1);
-                        m_angle = (m_angle + m_chirp) & (SPREADFACTOR - 1);
-			Complex cangle(cos(M_PI*2*m_angle/SPREADFACTOR),-sin(M_PI*2*m_angle/SPREADFACTOR));
-			newangle = detect(ci, cangle);
+			if (m_skip > 0)
+			{
+				m_skip--;
+			}
+			else
+			{
+				m_symbolBuffer[m_symbolFill++] = ci;
 
-			m_bin = (m_bin + newangle) & (LORA_SFFT_LEN - 1);
-			Complex nangle(cos(M_PI*2*m_bin/LORA_SFFT_LEN),sin(M_PI*2*m_bin/LORA_SFFT_LEN));
+				if (m_symbolFill == m_nbSymbolBins)
+				{
+					processSymbol();
+					m_symbolFill = 0;
+				}
+			}
+
+			m_bin = (m_bin + m_result) & (m_nbSymbolBins - 1);
+			const Complex& nangle = m_toneTable[m_bin];
 			m_sampleBuffer.push_back(Sample(nangle.real() * 100, nangle.imag() * 100));
 			m_sampleDistanceRemain += (Real)m_sampleRate / m_Bandwidth;
 		}
@@ -342,10 +376,15 @@ bool LoRaDemod::handleMessage(const Message& cmd)
 		m_Bandwidth = LoRaDemodSettings::bandwidths[settings.m_bandwidthIndex];
 		m_interpolator.create(16, m_sampleRate, m_Bandwidth/1.9);
 
+		if (settings.m_spreadFactor != m_spreadFactor) {
+			setSpreadFactor(settings.m_spreadFactor);
+		}
+
 		m_settingsMutex.unlock();
 
 		m_settings = settings;
-		qDebug() << "LoRaDemod::handleMessage: MsgConfigureLoRaDemod: m_Bandwidth: " << m_Bandwidth;
+		qDebug() << "LoRaDemod::handleMessage: MsgConfigureLoRaDemod: m_Bandwidth: " << m_Bandwidth
+				<< " m_spreadFactor: " << m_spreadFactor;
 
 		return true;
 	}
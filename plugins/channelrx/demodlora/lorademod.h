@@ -26,19 +26,17 @@
 #include "dsp/nco.h"
 #include "dsp/interpolator.h"
 #include "util/message.h"
-#include "dsp/fftfilt.h"
 
 #include "lorademodsettings.h"
 
-#define DATA_BITS (6)
-#define SAMPLEBITS (DATA_BITS + 2)
-#define SPREADFACTOR (1 << SAMPLEBITS)
-#define LORA_SFFT_LEN (SPREADFACTOR / 2)
-#define LORA_SQUELCH (3)
+#define LORA_SQUELCH_RATIO (10.0f) // minimum ratio of the symbol peak to the average bin power
+#define LORA_PREAMBLE_REPEAT (3)   // number of identical up chirps to detect a preamble
+#define LORA_MAX_SYMBOLS (256)     // payload symbols limit
 
 class DeviceSourceAPI;
 class ThreadedBasebandSampleSink;
 class DownChannelizer;
+class FFTEngine;
 
 class LoRaDemod : public BasebandSampleSink, public ChannelSinkAPI {
 public:
@@ -109,9 +107,18 @@ public:
     static const QString m_channelId;
 
 private:
-	int  detect(Complex sample, Complex angle);
+    enum LoRaState
+    {
+        LoRaStateSearch,   //!< looking for a preamble with symbol windows not aligned
+        LoRaStatePreamble, //!< windows aligned on the preamble chirps. Waiting for the start frame delimiter.
+        LoRaStateSFD,      //!< first down chirp of the start frame delimiter seen
+        LoRaStatePayload   //!< collecting payload symbols
+    };
+
+	void setSpreadFactor(int spreadFactor);
+	void processSymbol();
+	int demodSymbol(const Complex *chirp); //!< dechirp and FFT the symbol window. Returns the peak bin or -1 if squelched.
 	void dumpRaw(void);
-	short synch (short bin);
 	short toGray(short bin);
 	void interleave6(char* inout, int size);
 	void hamming6(char* inout, int size);
@@ -125,20 +132,24 @@ private:
 	Real m_Bandwidth;
 	int m_sampleRate;
 	int m_frequency;
-	int m_chirp;
-	int m_angle;
-	int m_bin;
-	int m_result;
-	int m_count;
-	int m_header;
-	int m_time;
-	short m_tune;
-
-	sfft* loraFilter;
-	sfft* negaFilter;
-	float* mov;
-	short* history;
-	short* finetune;
+
+	int m_spreadFactor;
+	unsigned int m_nbSymbolBins;        //!< 2^SF: chips per symbol and FFT size
+	FFTEngine *m_fft;
+	std::vector<Complex> m_downChirp;   //!< conjugate of the base up chirp: dechirps up chirps
+	std::vector<Complex> m_upChirp;     //!< base up chirp: dechirps the down chirps of the start frame delimiter
+	std::vector<Complex> m_toneTable;   //!< one turn in m_nbSymbolBins steps for the symbol display
+	std::vector<Complex> m_symbolBuffer;
+	unsigned int m_symbolFill;          //!< samples in symbol buffer
+	unsigned int m_skip;                //!< samples to drop to align the symbol windows
+	LoRaState m_state;
+	int m_lastBin;
+	int m_repeatCount;
+	int m_syncCount;
+	int m_tune;                         //!< bin of the aligned preamble (frequency offset)
+	int m_result;                       //!< last demodulated symbol
+	unsigned int m_bin;                 //!< symbol display phase
+	std::vector<short> m_symbols;       //!< payload symbols
 
 	NCO m_nco;
 	Interpolator m_interpolator;
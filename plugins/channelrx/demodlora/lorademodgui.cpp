@@ -91,7 +91,7 @@ void LoRaDemodGUI::on_BW_valueChanged(int value)
         m_settings.m_bandwidthIndex = LoRaDemodSettings::nb_bandwidths - 1;
     }
 
-	int thisBW = LoRaDemodSettings::bandwidths[value];
+	int thisBW = LoRaDemodSettings::bandwidths[m_settings.m_bandwidthIndex];
 	ui->BWText->setText(QString("%1 Hz").arg(thisBW));
 	m_channelMarker.setBandwidth(thisBW);
 
@@ -100,7 +100,10 @@ void LoRaDemodGUI::on_BW_valueChanged(int value)
 
 void LoRaDemodGUI::on_Spread_valueChanged(int value)
 {
-    (void) value;
+    m_settings.m_spreadFactor = value;
+    ui->SpreadText->setText(QString("SF%1").arg(value));
+
+	applySettings();
 }
 
 void LoRaDemodGUI::onWidgetRolled(QWidget* widget, bool rollDown)
@@ -191,5 +194,7 @@ void LoRaDemodGUI::displaySettings()
     blockApplySettings(true);
     ui->BWText->setText(QString("%1 Hz").arg(thisBW));
     ui->BW->setValue(m_settings.m_bandwidthIndex);
+    ui->SpreadText->setText(QString("SF%1").arg(m_settings.m_spreadFactor));
+    ui->Spread->setValue(m_settings.m_spreadFactor);
     blockApplySettings(false);
 }
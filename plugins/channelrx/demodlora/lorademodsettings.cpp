@@ -7,8 +7,10 @@
 #include "settings/serializable.h"
 #include "lorademodsettings.h"
 
-const int LoRaDemodSettings::bandwidths[] = {7813,15625,20833,31250,62500};
-const int LoRaDemodSettings::nb_bandwidths = 5;
+const int LoRaDemodSettings::bandwidths[] = {7813,15625,20833,31250,62500,125000,250000,500000};
+const int LoRaDemodSettings::nb_bandwidths = 8;
+const int LoRaDemodSettings::minSpreadFactor = 7;
+const int LoRaDemodSettings::maxSpreadFactor = 12;
 
 LoRaDemodSettings::LoRaDemodSettings() :
     m_centerFrequency(0),
@@ -21,7 +23,7 @@ LoRaDemodSettings::LoRaDemodSettings() :
 void LoRaDemodSettings::resetToDefaults()
 {
     m_bandwidthIndex = 0;
-    m_spread = 0;
+    m_spreadFactor = 8;
     m_rgbColor = QColor(255, 0, 255).rgb();
     m_title = "LoRa Demodulator";
 }
@@ -31,7 +33,6 @@ QByteArray LoRaDemodSettings::serialize() const
     SimpleSerializer s(1);
     s.writeS32(1, m_centerFrequency);
     s.writeS32(2, m_bandwidthIndex);
-    s.writeS32(3, m_spread);
 
     if (m_spectrumGUI) {
         s.writeBlob(4, m_spectrumGUI->serialize());
@@ -42,6 +43,7 @@ QByteArray LoRaDemodSettings::serialize() const
     }
 
     s.writeString(6, m_title);
+    s.writeS32(7, m_spreadFactor);
 
     return s.final();
 }
@@ -62,7 +64,6 @@ bool LoRaDemodSettings::deserialize(const QByteArray& data)
 
         d.readS32(1, &m_centerFrequency, 0);
         d.readS32(2, &m_bandwidthIndex, 0);
-        d.readS32(3, &m_spread, 0);
 
         if (m_spectrumGUI) {
             d.readBlob(4, &bytetmp);
@@ -75,6 +76,15 @@ bool LoRaDemodSettings::deserialize(const QByteArray& data)
         }
 
         d.readString(6, &m_title, "LoRa Demodulator");
+        d.readS32(7, &m_spreadFactor, 8);
+
+        if ((m_spreadFactor < minSpreadFactor) || (m_spreadFactor > maxSpreadFactor)) {
+            m_spreadFactor = 8;
+        }
+
+        if ((m_bandwidthIndex < 0) || (m_bandwidthIndex >= nb_bandwidths)) {
+            m_bandwidthIndex = 0;
+        }
 
         return true;
     }
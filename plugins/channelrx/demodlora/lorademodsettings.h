@@ -13,7 +13,7 @@ struct LoRaDemodSettings
 {
     int m_centerFrequency;
     int m_bandwidthIndex;
-    int m_spread;
+    int m_spreadFactor; //!< 7 to 12: 2^SF chips per symbol
     uint32_t m_rgbColor;
     QString m_title;
 
@@ -22,6 +22,8 @@ struct LoRaDemodSettings
 
     static const int bandwidths[];
     static const int nb_bandwidths;
+    static const int minSpreadFactor;
+    static const int maxSpreadFactor;
 
     LoRaDemodSettings();
     void resetToDefaults();
@@ -310,6 +310,11 @@ void UDPSink::feed(const SampleVector::const_iterator& begin, const SampleVector
 		}
 	}
 
+	// send the datagrams completed with this chunk in one batch
+	m_udpBuffer16->flush();
+	m_udpBufferMono16->flush();
+	m_udpBuffer24->flush();
+
 	//qDebug() << "UDPSink::feed: " << m_sampleBuffer.size() * 4;
 
 	if((m_spectrum != 0) && (m_spectrumEnabled))
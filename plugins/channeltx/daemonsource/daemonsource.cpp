@@ -74,6 +74,13 @@ void DaemonSource::pull(Sample& sample)
     m_dataReadQueue.readSample(sample, true); // true is scale for Tx
 }
 
+void DaemonSource::pullBlock(SampleVector::iterator begin, unsigned int nbSamples)
+{
+    for (unsigned int i = 0; i < nbSamples; i++) {
+        m_dataReadQueue.readSample(begin[i], true);
+    }
+}
+
 void DaemonSource::pullAudio(int nbSamples)
 {
     (void) nbSamples;
@@ -127,7 +127,7 @@ void DaemonSourceThread::handleInputMessages()
 
 void DaemonSourceThread::readPendingDatagrams()
 {
-    SDRDaemonSuperBlock superBlock;
+    char datagram[SDRDaemonMaxDatagramSize];
     qint64 size;
 
     while (m_socket->hasPendingDatagrams())
@@ -135,54 +135,61 @@ void DaemonSourceThread::readPendingDatagrams()
         QHostAddress sender;
         quint16 senderPort = 0;
         //qint64 pendingDataSize = m_socket->pendingDatagramSize();
-        size = m_socket->readDatagram((char *) &superBlock, (long long int) sizeof(SDRDaemonSuperBlock), &sender, &senderPort);
+        size = m_socket->readDatagram(datagram, (long long int) sizeof(datagram), &sender, &senderPort);
 
-        if (size == sizeof(SDRDaemonSuperBlock))
+        if ((size > 0) && (size % sizeof(SDRDaemonSuperBlock) == 0)) // jumbo datagrams carry several consecutive blocks
         {
-            unsigned int dataBlockIndex = superBlock.m_header.m_frameIndex % m_nbDataBlocks;
-
-            // create the first block for this index
-            if (m_dataBlocks[dataBlockIndex] == 0) {
-                m_dataBlocks[dataBlockIndex] = new SDRDaemonDataBlock();
-            }
-
-            if (m_dataBlocks[dataBlockIndex]->m_rxControlBlock.m_frameIndex < 0)
-            {
-                // initialize virgin block with the frame index
-                m_dataBlocks[dataBlockIndex]->m_rxControlBlock.m_frameIndex = superBlock.m_header.m_frameIndex;
-            }
-            else
-            {
-                // if the frame index is not the same for the same slot it means we are starting a new frame
-                uint32_t frameIndex = m_dataBlocks[dataBlockIndex]->m_rxControlBlock.m_frameIndex;
-
-                if (superBlock.m_header.m_frameIndex != frameIndex)
-                {
-                    //qDebug("DaemonSourceThread::readPendingDatagrams: push frame %u", frameIndex);
-                    m_dataQueue->push(m_dataBlocks[dataBlockIndex]);
-                    m_dataBlocks[dataBlockIndex] = new SDRDaemonDataBlock();
-                    m_dataBlocks[dataBlockIndex]->m_rxControlBlock.m_frameIndex = superBlock.m_header.m_frameIndex;
-                }
+            for (qint64 offset = 0; offset < size; offset += sizeof(SDRDaemonSuperBlock)) {
+                processSuperBlock(*((SDRDaemonSuperBlock *) &datagram[offset]));
             }
+        }
+        else
+        {
+            qWarning("DaemonSourceThread::readPendingDatagrams: wrong super block size not processing");
+        }
+    }
+}
 
-            m_dataBlocks[dataBlockIndex]->m_superBlocks[superBlock.m_header.m_blockIndex] = superBlock;
+void DaemonSourceThread::processSuperBlock(const SDRDaemonSuperBlock& superBlock)
+{
+    unsigned int dataBlockIndex = superBlock.m_header.m_frameIndex % m_nbDataBlocks;
 
-            if (superBlock.m_header.m_blockIndex == 0) {
-                m_dataBlocks[dataBlockIndex]->m_rxControlBlock.m_metaRetrieved = true;
-            }
+    // create the first block for this index
+    if (m_dataBlocks[dataBlockIndex] == 0) {
+        m_dataBlocks[dataBlockIndex] = new SDRDaemonDataBlock();
+    }
 
-            if (superBlock.m_header.m_blockIndex < SDRDaemonNbOrginalBlocks) {
-                m_dataBlocks[dataBlockIndex]->m_rxControlBlock.m_originalCount++;
-            } else {
-                m_dataBlocks[dataBlockIndex]->m_rxControlBlock.m_recoveryCount++;
-            }
+    if (m_dataBlocks[dataBlockIndex]->m_rxControlBlock.m_frameIndex < 0)
+    {
+        // initialize virgin block with the frame index
+        m_dataBlocks[dataBlockIndex]->m_rxControlBlock.m_frameIndex = superBlock.m_header.m_frameIndex;
+    }
+    else
+    {
+        // if the frame index is not the same for the same slot it means we are starting a new frame
+        uint32_t frameIndex = m_dataBlocks[dataBlockIndex]->m_rxControlBlock.m_frameIndex;
 
-            m_dataBlocks[dataBlockIndex]->m_rxControlBlock.m_blockCount++;
-        }
-        else
+        if (superBlock.m_header.m_frameIndex != frameIndex)
         {
-            qWarning("DaemonSourceThread::readPendingDatagrams: wrong super block size not processing");
+            //qDebug("DaemonSourceThread::readPendingDatagrams: push frame %u", frameIndex);
+            m_dataQueue->push(m_dataBlocks[dataBlockIndex]);
+            m_dataBlocks[dataBlockIndex] = new SDRDaemonDataBlock();
+            m_dataBlocks[dataBlockIndex]->m_rxControlBlock.m_frameIndex = superBlock.m_header.m_frameIndex;
         }
     }
+
+    m_dataBlocks[dataBlockIndex]->m_superBlocks[superBlock.m_header.m_blockIndex] = superBlock;
+
+    if (superBlock.m_header.m_blockIndex == 0) {
+        m_dataBlocks[dataBlockIndex]->m_rxControlBlock.m_metaRetrieved = true;
+    }
+
+    if (superBlock.m_header.m_blockIndex < SDRDaemonNbOrginalBlocks) {
+        m_dataBlocks[dataBlockIndex]->m_rxControlBlock.m_originalCount++;
+    } else {
+        m_dataBlocks[dataBlockIndex]->m_rxControlBlock.m_recoveryCount++;
+    }
+
+    m_dataBlocks[dataBlockIndex]->m_rxControlBlock.m_blockCount++;
 }
 
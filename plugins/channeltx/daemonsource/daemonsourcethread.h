@@ -98,6 +98,7 @@ private:
     void stopWork();
 
     void run();
+    void processSuperBlock(const SDRDaemonSuperBlock& superBlock);
 
 private slots:
     void handleInputMessages();
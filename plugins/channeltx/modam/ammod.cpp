@@ -96,6 +96,24 @@ AMMod::~AMMod()
 }
 
 void AMMod::pull(Sample& sample)
+{
+    m_settingsMutex.lock();
+    pullOne(sample);
+    m_settingsMutex.unlock();
+}
+
+void AMMod::pullBlock(SampleVector::iterator begin, unsigned int nbSamples)
+{
+    m_settingsMutex.lock(); // once per block rather than once per sample
+
+    for (unsigned int i = 0; i < nbSamples; i++) {
+        pullOne(begin[i]);
+    }
+
+    m_settingsMutex.unlock();
+}
+
+void AMMod::pullOne(Sample& sample)
 {
 	if (m_settings.m_channelMute)
 	{
@@ -106,8 +124,6 @@ void AMMod::pull(Sample& sample)
 
 	Complex ci;
 
-	m_settingsMutex.lock();
-
     if (m_interpolatorDistance > 1.0f) // decimate
     {
     	modulateSample();
@@ -129,8 +145,6 @@ void AMMod::pull(Sample& sample)
 
     ci *= m_carrierNco.nextIQ(); // shift to carrier frequency
 
-    m_settingsMutex.unlock();
-
     double magsq = ci.real() * ci.real() + ci.imag() * ci.imag();
 	magsq /= (SDR_TX_SCALED*SDR_TX_SCALED);
 	m_movingAverage(magsq);
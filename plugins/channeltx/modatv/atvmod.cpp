@@ -122,6 +122,24 @@ void ATVMod::pullAudio(int nbSamples)
 }
 
 void ATVMod::pull(Sample& sample)
+{
+    m_settingsMutex.lock();
+    pullOne(sample);
+    m_settingsMutex.unlock();
+}
+
+void ATVMod::pullBlock(SampleVector::iterator begin, unsigned int nbSamples)
+{
+    m_settingsMutex.lock(); // once per block rather than once per sample
+
+    for (unsigned int i = 0; i < nbSamples; i++) {
+        pullOne(begin[i]);
+    }
+
+    m_settingsMutex.unlock();
+}
+
+void ATVMod::pullOne(Sample& sample)
 {
 	if (m_settings.m_channelMute)
 	{
@@ -132,8 +150,6 @@ void ATVMod::pull(Sample& sample)
 
     Complex ci;
 
-    m_settingsMutex.lock();
-
     if ((m_tvSampleRate == m_outputSampleRate) && (!m_settings.m_forceDecimator)) // no interpolation nor decimation
     {
         modulateSample();
@@ -167,8 +183,6 @@ void ATVMod::pullFinalize(Complex& ci, Sample& sample)
 {
     ci *= m_carrierNco.nextIQ(); // shift to carrier frequency
 
-    m_settingsMutex.unlock();
-
     double magsq = ci.real() * ci.real() + ci.imag() * ci.imag();
     magsq /= (SDR_TX_SCALED*SDR_TX_SCALED);
     m_movingAverage(magsq);
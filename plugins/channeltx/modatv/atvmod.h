@@ -355,6 +355,7 @@ public:
     virtual void destroy() { delete this; }
 
     virtual void pull(Sample& sample);
+    virtual void pullBlock(SampleVector::iterator begin, unsigned int nbSamples);
     virtual void pullAudio(int nbSamples); // this is used for video signal actually
     virtual void start();
     virtual void stop();
@@ -534,6 +535,7 @@ private:
 
     void applyChannelSettings(int outputSampleRate, int inputFrequencyOffset, bool force = false);
     void applySettings(const ATVModSettings& settings, bool force = false);
+    void pullOne(Sample& sample); //!< pull() without locking the settings
     void pullFinalize(Complex& ci, Sample& sample);
     void pullVideo(Real& sample);
     void calculateLevel(Real& sample);
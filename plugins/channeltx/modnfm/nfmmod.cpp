@@ -102,6 +102,24 @@ NFMMod::~NFMMod()
 }
 
 void NFMMod::pull(Sample& sample)
+{
+    m_settingsMutex.lock();
+    pullOne(sample);
+    m_settingsMutex.unlock();
+}
+
+void NFMMod::pullBlock(SampleVector::iterator begin, unsigned int nbSamples)
+{
+    m_settingsMutex.lock(); // once per block rather than once per sample
+
+    for (unsigned int i = 0; i < nbSamples; i++) {
+        pullOne(begin[i]);
+    }
+
+    m_settingsMutex.unlock();
+}
+
+void NFMMod::pullOne(Sample& sample)
 {
 	if (m_settings.m_channelMute)
 	{
@@ -112,8 +130,6 @@ void NFMMod::pull(Sample& sample)
 
 	Complex ci;
 
-	m_settingsMutex.lock();
-
     if (m_interpolatorDistance > 1.0f) // decimate
     {
     	modulateSample();
@@ -135,8 +151,6 @@ void NFMMod::pull(Sample& sample)
 
     ci *= m_carrierNco.nextIQ(); // shift to carrier frequency
 
-    m_settingsMutex.unlock();
-
     double magsq = ci.real() * ci.real() + ci.imag() * ci.imag();
 	magsq /= (SDR_TX_SCALED*SDR_TX_SCALED);
 	m_movingAverage(magsq);
@@ -133,9 +133,25 @@ SSBMod::~SSBMod()
 
 void SSBMod::pull(Sample& sample)
 {
-	Complex ci;
+    m_settingsMutex.lock();
+    pullOne(sample);
+    m_settingsMutex.unlock();
+}
 
-	m_settingsMutex.lock();
+void SSBMod::pullBlock(SampleVector::iterator begin, unsigned int nbSamples)
+{
+    m_settingsMutex.lock(); // once per block rather than once per sample
+
+    for (unsigned int i = 0; i < nbSamples; i++) {
+        pullOne(begin[i]);
+    }
+
+    m_settingsMutex.unlock();
+}
+
+void SSBMod::pullOne(Sample& sample)
+{
+	Complex ci;
 
     if (m_interpolatorDistance > 1.0f) // decimate
     {
@@ -159,8 +175,6 @@ void SSBMod::pull(Sample& sample)
     ci *= m_carrierNco.nextIQ(); // shift to carrier frequency
     ci *= 0.891235351562f * SDR_TX_SCALEF; //scaling at -1 dB to account for possible filter overshoot
 
-    m_settingsMutex.unlock();
-
     double magsq = ci.real() * ci.real() + ci.imag() * ci.imag();
 	magsq /= (SDR_TX_SCALED*SDR_TX_SCALED);
 	m_movingAverage(magsq);
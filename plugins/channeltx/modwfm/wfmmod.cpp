@@ -109,6 +109,24 @@ WFMMod::~WFMMod()
 }
 
 void WFMMod::pull(Sample& sample)
+{
+    m_settingsMutex.lock();
+    pullOne(sample);
+    m_settingsMutex.unlock();
+}
+
+void WFMMod::pullBlock(SampleVector::iterator begin, unsigned int nbSamples)
+{
+    m_settingsMutex.lock(); // once per block rather than once per sample
+
+    for (unsigned int i = 0; i < nbSamples; i++) {
+        pullOne(begin[i]);
+    }
+
+    m_settingsMutex.unlock();
+}
+
+void WFMMod::pullOne(Sample& sample)
 {
 	if (m_settings.m_channelMute)
 	{
@@ -121,8 +139,6 @@ void WFMMod::pull(Sample& sample)
     fftfilt::cmplx *rf;
     int rf_out;
 
-	m_settingsMutex.lock();
-
 	if ((m_settings.m_modAFInput == WFMModSettings::WFMModInputFile)
 	   || (m_settings.m_modAFInput == WFMModSettings::WFMModInputAudio))
 	{
@@ -157,8 +173,6 @@ void WFMMod::pull(Sample& sample)
     ci = m_rfFilterBuffer[m_rfFilterBufferIndex] * m_carrierNco.nextIQ(); // shift to carrier frequency
     m_rfFilterBufferIndex++;
 
-    m_settingsMutex.unlock();
-
     double magsq = ci.real() * ci.real() + ci.imag() * ci.imag();
 	magsq /= (SDR_TX_SCALED*SDR_TX_SCALED);
 	m_movingAverage(magsq);
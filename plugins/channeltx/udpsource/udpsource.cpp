@@ -102,6 +102,24 @@ void UDPSource::stop()
 }
 
 void UDPSource::pull(Sample& sample)
+{
+    m_settingsMutex.lock();
+    pullOne(sample);
+    m_settingsMutex.unlock();
+}
+
+void UDPSource::pullBlock(SampleVector::iterator begin, unsigned int nbSamples)
+{
+    m_settingsMutex.lock(); // once per block rather than once per sample
+
+    for (unsigned int i = 0; i < nbSamples; i++) {
+        pullOne(begin[i]);
+    }
+
+    m_settingsMutex.unlock();
+}
+
+void UDPSource::pullOne(Sample& sample)
 {
     if (m_settings.m_channelMute)
     {
@@ -113,8 +131,6 @@ void UDPSource::pull(Sample& sample)
 
     Complex ci;
 
-    m_settingsMutex.lock();
-
     if (m_interpolatorDistance > 1.0f) // decimate
     {
         modulateSample();
@@ -136,8 +152,6 @@ void UDPSource::pull(Sample& sample)
 
     ci *= m_carrierNco.nextIQ(); // shift to carrier frequency
 
-    m_settingsMutex.unlock();
-
     double magsq = ci.real() * ci.real() + ci.imag() * ci.imag();
     magsq /= (SDR_TX_SCALED*SDR_TX_SCALED);
     m_movingAverage.feed(magsq);
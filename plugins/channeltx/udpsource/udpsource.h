@@ -95,6 +95,7 @@ public:
     virtual void start();
     virtual void stop();
     virtual void pull(Sample& sample);
+    virtual void pullBlock(SampleVector::iterator begin, unsigned int nbSamples);
     virtual bool handleMessage(const Message& cmd);
 
     virtual void getIdentifier(QString& id) { id = objectName(); }
@@ -233,6 +234,7 @@ private:
 
     void applyChannelSettings(int basebandSampleRate, int outputSampleRate, int inputFrequencyOffset, bool force = false);
     void applySettings(const UDPSourceSettings& settings, bool force = false);
+    void pullOne(Sample& sample); //!< pull() without locking the settings
     void modulateSample();
     void calculateLevel(Real sample);
     void calculateLevel(Complex sample);
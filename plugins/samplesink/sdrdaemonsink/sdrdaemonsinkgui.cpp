@@ -234,6 +234,15 @@ void SDRdaemonSinkGui::displaySettings()
     QString s1 = QString::number(m_settings.m_nbFECBlocks, 'f', 0);
     ui->nominalNbBlocksText->setText(tr("%1/%2").arg(s0).arg(s1));
 
+    int nbBlocksPerDatagram = SDRDaemonNbBlocksPerDatagram(m_settings.m_datagramSize);
+    int datagramSizeIndex = 0;
+
+    while ((1 << datagramSizeIndex) < nbBlocksPerDatagram) {
+        datagramSizeIndex++;
+    }
+
+    ui->datagramSize->setCurrentIndex(datagramSizeIndex);
+
     ui->deviceIndex->setText(tr("%1").arg(m_settings.m_deviceIndex));
     ui->channelIndex->setText(tr("%1").arg(m_settings.m_channelIndex));
     ui->apiAddress->setText(m_settings.m_apiAddress);
@@ -315,6 +324,12 @@ void SDRdaemonSinkGui::on_nbFECBlocks_valueChanged(int value)
     sendSettings();
 }
 
+void SDRdaemonSinkGui::on_datagramSize_currentIndexChanged(int index)
+{
+    m_settings.m_datagramSize = SDRDaemonUdpSize << index;
+    sendSettings();
+}
+
 void SDRdaemonSinkGui::on_deviceIndex_returnPressed()
 {
     bool dataOk;
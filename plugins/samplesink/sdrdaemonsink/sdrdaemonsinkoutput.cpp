@@ -88,6 +88,7 @@ bool SDRdaemonSinkOutput::start()
 	m_sdrDaemonSinkThread->setDataAddress(m_settings.m_dataAddress, m_settings.m_dataPort);
 	m_sdrDaemonSinkThread->setSamplerate(m_settings.m_sampleRate);
 	m_sdrDaemonSinkThread->setNbBlocksFEC(m_settings.m_nbFECBlocks);
+	m_sdrDaemonSinkThread->setDatagramSize(m_settings.m_datagramSize);
 	m_sdrDaemonSinkThread->connectTimer(m_masterTimer);
 	m_sdrDaemonSinkThread->startWork();
 
@@ -276,6 +277,13 @@ void SDRdaemonSinkOutput::applySettings(const SDRdaemonSinkSettings& settings, b
         changeTxDelay = true;
     }
 
+    if (force || (m_settings.m_datagramSize != settings.m_datagramSize))
+    {
+        if (m_sdrDaemonSinkThread != 0) {
+            m_sdrDaemonSinkThread->setDatagramSize(settings.m_datagramSize);
+        }
+    }
+
     if (changeTxDelay)
     {
         if (m_sdrDaemonSinkThread != 0) {
@@ -289,6 +297,7 @@ void SDRdaemonSinkOutput::applySettings(const SDRdaemonSinkSettings& settings, b
             << " m_sampleRate: " << settings.m_sampleRate
             << " m_txDelay: " << settings.m_txDelay
             << " m_nbFECBlocks: " << settings.m_nbFECBlocks
+            << " m_datagramSize: " << settings.m_datagramSize
             << " m_apiAddress: " << settings.m_apiAddress
             << " m_apiPort: " << settings.m_apiPort
             << " m_dataAddress: " << settings.m_dataAddress
@@ -360,6 +369,9 @@ int SDRdaemonSinkOutput::webapiSettingsPutPatch(
     if (deviceSettingsKeys.contains("nbFECBlocks")) {
         settings.m_nbFECBlocks = response.getSdrDaemonSinkSettings()->getNbFecBlocks();
     }
+    if (deviceSettingsKeys.contains("datagramSize")) {
+        settings.m_datagramSize = response.getSdrDaemonSinkSettings()->getDatagramSize();
+    }
     if (deviceSettingsKeys.contains("apiAddress")) {
         settings.m_apiAddress = *response.getSdrDaemonSinkSettings()->getApiAddress();
     }
@@ -409,6 +421,7 @@ void SDRdaemonSinkOutput::webapiFormatDeviceSettings(SWGSDRangel::SWGDeviceSetti
     response.getSdrDaemonSinkSettings()->setSampleRate(settings.m_sampleRate);
     response.getSdrDaemonSinkSettings()->setTxDelay(settings.m_txDelay);
     response.getSdrDaemonSinkSettings()->setNbFecBlocks(settings.m_nbFECBlocks);
+    response.getSdrDaemonSinkSettings()->setDatagramSize(settings.m_datagramSize);
     response.getSdrDaemonSinkSettings()->setApiAddress(new QString(settings.m_apiAddress));
     response.getSdrDaemonSinkSettings()->setApiPort(settings.m_apiPort);
     response.getSdrDaemonSinkSettings()->setDataAddress(new QString(settings.m_dataAddress));
@@ -422,6 +435,15 @@ void SDRdaemonSinkOutput::webapiFormatDeviceReport(SWGSDRangel::SWGDeviceReport&
     uint64_t ts_usecs;
     response.getSdrDaemonSinkReport()->setBufferRwBalance(m_sampleSourceFifo.getRWBalance());
     response.getSdrDaemonSinkReport()->setSampleCount(m_sdrDaemonSinkThread ? (int) m_sdrDaemonSinkThread->getSamplesCount(ts_usecs) : 0);
+
+    if (m_sdrDaemonSinkThread)
+    {
+        int nbEncoders, avgEncodeTimeUs, maxEncodeTimeUs;
+        m_sdrDaemonSinkThread->getEncodeStats(nbEncoders, avgEncodeTimeUs, maxEncodeTimeUs);
+        response.getSdrDaemonSinkReport()->setNbFecEncoders(nbEncoders);
+        response.getSdrDaemonSinkReport()->setAvgFecEncodeTimeUs(avgEncodeTimeUs);
+        response.getSdrDaemonSinkReport()->setMaxFecEncodeTimeUs(maxEncodeTimeUs);
+    }
 }
 
 void SDRdaemonSinkOutput::tick()
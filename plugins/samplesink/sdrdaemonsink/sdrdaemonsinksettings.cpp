@@ -28,6 +28,7 @@ void SDRdaemonSinkSettings::resetToDefaults()
     m_sampleRate = 48000;
     m_txDelay = 0.35;
     m_nbFECBlocks = 0;
+    m_datagramSize = 512;
     m_apiAddress = "127.0.0.1";
     m_apiPort = 9091;
     m_dataAddress = "127.0.0.1";
@@ -50,6 +51,7 @@ QByteArray SDRdaemonSinkSettings::serialize() const
     s.writeU32(8, m_dataPort);
     s.writeU32(10, m_deviceIndex);
     s.writeU32(11, m_channelIndex);
+    s.writeU32(12, m_datagramSize);
 
     return s.final();
 }
@@ -80,6 +82,7 @@ bool SDRdaemonSinkSettings::deserialize(const QByteArray& data)
         m_dataPort = uintval % (1<<16);
         d.readU32(10, &m_deviceIndex, 0);
         d.readU32(11, &m_channelIndex, 0);
+        d.readU32(12, &m_datagramSize, 512);
 
         return true;
     }
@@ -24,6 +24,7 @@ struct SDRdaemonSinkSettings {
     quint32 m_sampleRate;
     float   m_txDelay;
     quint32 m_nbFECBlocks;
+    quint32 m_datagramSize; //!< UDP datagram size in bytes: 512 or jumbo frames up to 8192 bytes
     QString m_apiAddress;
     quint16 m_apiPort;
     QString m_dataAddress;
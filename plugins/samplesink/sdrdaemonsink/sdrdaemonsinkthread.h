@@ -51,7 +51,11 @@ public:
 	void setSamplerate(int samplerate);
     void setNbBlocksFEC(uint32_t nbBlocksFEC) { m_udpSinkFEC.setNbBlocksFEC(nbBlocksFEC); };
     void setTxDelay(float txDelay) { m_udpSinkFEC.setTxDelay(txDelay); };
+    void setDatagramSize(uint32_t datagramSize) { m_udpSinkFEC.setDatagramSize(datagramSize); }
     void setDataAddress(const QString& address, uint16_t port) { m_udpSinkFEC.setRemoteAddress(address, port); }
+    void getEncodeStats(int& nbEncoders, int& avgEncodeTimeUs, int& maxEncodeTimeUs) {
+        m_udpSinkFEC.getEncodeStats(nbEncoders, avgEncodeTimeUs, maxEncodeTimeUs);
+    }
 
     bool isRunning() const { return m_running; }
 
@@ -30,6 +30,7 @@ UDPSinkFEC::UDPSinkFEC() :
     m_nbBlocksFEC(0),
     m_txDelayRatio(0.0),
     m_txDelay(0),
+    m_nbBlocksPerDatagram(1),
     m_txBlockIndex(0),
     m_txBlocksIndex(0),
     m_frameCount(0),
@@ -68,6 +69,22 @@ void UDPSinkFEC::stop()
     }
 }
 
+void UDPSinkFEC::getEncodeStats(int& nbEncoders, int& avgEncodeTimeUs, int& maxEncodeTimeUs)
+{
+    if (m_udpWorker)
+    {
+        nbEncoders = m_udpWorker->getNbEncoders();
+        avgEncodeTimeUs = m_udpWorker->getAvgEncodeTimeUs();
+        maxEncodeTimeUs = m_udpWorker->getMaxEncodeTimeUs();
+    }
+    else
+    {
+        nbEncoders = 0;
+        avgEncodeTimeUs = 0;
+        maxEncodeTimeUs = 0;
+    }
+}
+
 void UDPSinkFEC::setTxDelay(float txDelayRatio)
 {
     // delay is calculated from the fraction of the nominal UDP block process time
@@ -81,6 +98,12 @@ void UDPSinkFEC::setTxDelay(float txDelayRatio)
     qDebug() << "UDPSinkFEC::setTxDelay: txDelay: " << txDelayRatio << " m_txDelay: " << m_txDelay << " us";
 }
 
+void UDPSinkFEC::setDatagramSize(uint32_t datagramSize)
+{
+    m_nbBlocksPerDatagram = SDRDaemonNbBlocksPerDatagram(datagramSize);
+    qDebug() << "UDPSinkFEC::setDatagramSize: datagramSize: " << datagramSize << " blocks per datagram: " << m_nbBlocksPerDatagram;
+}
+
 void UDPSinkFEC::setNbBlocksFEC(uint32_t nbBlocksFEC)
 {
     qDebug() << "UDPSinkFEC::setNbBlocksFEC: nbBlocksFEC: " << nbBlocksFEC;
@@ -123,7 +146,7 @@ void UDPSinkFEC::write(const SampleVector::iterator& begin, uint32_t sampleChunk
 
             metaData.m_centerFrequency = 0; // frequency not set by stream
             metaData.m_sampleRate = m_sampleRate;
-            metaData.m_sampleBytes = (SDR_RX_SAMP_SZ <= 16 ? 2 : 4);
+            metaData.setSampleBytes(SDR_RX_SAMP_SZ <= 16 ? 2 : 4, m_nbBlocksPerDatagram);
             metaData.m_sampleBits = SDR_RX_SAMP_SZ;
             metaData.m_nbOriginalBlocks = m_nbOriginalBlocks;
             metaData.m_nbFECBlocks = m_nbBlocksFEC;
@@ -153,6 +176,7 @@ void UDPSinkFEC::write(const SampleVector::iterator& begin, uint32_t sampleChunk
                         << ":" << metaData.m_sampleRate
                         << ":" << (int) (metaData.m_sampleBytes & 0xF)
                         << ":" << (int) metaData.m_sampleBits
+                        << ":" << metaData.getNbBlocksPerDatagram()
                         << "|" << (int) metaData.m_nbOriginalBlocks
                         << ":" << (int) metaData.m_nbFECBlocks
                         << "|" << metaData.m_tv_sec
@@ -196,7 +220,7 @@ void UDPSinkFEC::write(const SampleVector::iterator& begin, uint32_t sampleChunk
                 int txDelay = m_txDelay;
 
                 if (m_udpWorker) {
-                    m_udpWorker->pushTxFrame(m_txBlocks[m_txBlocksIndex], nbBlocksFEC, txDelay, m_frameCount);
+                    m_udpWorker->pushTxFrame(m_txBlocks[m_txBlocksIndex], nbBlocksFEC, txDelay, m_frameCount, m_currentMetaFEC.getNbBlocksPerDatagram());
                 }
 
                 m_txBlocksIndex = (m_txBlocksIndex + 1) % 4;
@@ -66,8 +66,13 @@ public:
 
     void setNbBlocksFEC(uint32_t nbBlocksFEC);
     void setTxDelay(float txDelayRatio);
+    /** Datagram size in bytes. Above 512 bytes consecutive blocks are packed in jumbo datagrams */
+    void setDatagramSize(uint32_t datagramSize);
     void setRemoteAddress(const QString& address, uint16_t port);
 
+    /** FEC encoders statistics. Average and maximum (since last call) encode time of a frame are in microseconds */
+    void getEncodeStats(int& nbEncoders, int& avgEncodeTimeUs, int& maxEncodeTimeUs);
+
     /** Return true if the stream is OK, return false if there is an error. */
     operator bool() const
     {
@@ -89,7 +94,8 @@ private:
     SDRDaemonMetaDataFEC m_currentMetaFEC;  //!< Meta data for current frame
     uint32_t m_nbBlocksFEC;                 //!< Variable number of FEC blocks
     float m_txDelayRatio;                   //!< Delay in ratio of nominal frame period
-    uint32_t m_txDelay;                     //!< Delay in microseconds (usleep) between each sending of an UDP datagram
+    uint32_t m_txDelay;                     //!< Delay in microseconds (usleep) between each sending of an UDP block
+    int m_nbBlocksPerDatagram;              //!< Number of UDP blocks sent in one datagram
     SDRDaemonSuperBlock m_txBlocks[4][256]; //!< UDP blocks to send with original data + FEC
     SDRDaemonSuperBlock m_superBlock;       //!< current super block being built
     int m_txBlockIndex;                     //!< Current index in blocks to transmit in the Tx row
@@ -14,7 +14,7 @@
 // along with this program. If not, see <http://www.gnu.org/licenses/>.          //
 ///////////////////////////////////////////////////////////////////////////////////
 
-#include <QUdpSocket>
+#include "util/udpbatchsocket.h"
 
 #include "udpsinkfecworker.h"
 
@@ -24,15 +24,27 @@ MESSAGE_CLASS_DEFINITION(UDPSinkFECWorker::MsgStartStop, Message)
 
 UDPSinkFECWorker::UDPSinkFECWorker() :
         m_running(false),
+        m_encoderPool(UDPSINKFECWORKER_NBENCODERS),
         m_udpSocket(0),
         m_remotePort(9090)
 {
-    m_cm256Valid = m_cm256.isInitialized();
+    m_cm256Valid = true;
+
+    for (int i = 0; i < UDPSINKFECWORKER_NBENCODERS; i++) {
+        m_cm256Valid = m_cm256Valid && m_cm256[i].isInitialized();
+    }
+
     connect(&m_inputMessageQueue, SIGNAL(messageEnqueued()), this, SLOT(handleInputMessages()), Qt::QueuedConnection);
+    connect(&m_encoderPool, SIGNAL(jobProcessed()), this, SLOT(handleEncodedFrames()), Qt::QueuedConnection);
 }
 
 UDPSinkFECWorker::~UDPSinkFECWorker()
 {
+    OrderedWorkerPool::Job *job;
+
+    while ((job = m_encoderPool.popWait()) != 0) {
+        delete job;
+    }
 }
 
 void UDPSinkFECWorker::startStop(bool start)
@@ -45,7 +57,8 @@ void UDPSinkFECWorker::startWork()
 {
     qDebug("UDPSinkFECWorker::startWork");
     m_startWaitMutex.lock();
-    m_udpSocket = new QUdpSocket(this);
+    m_udpSocket = new UDPBatchSocket(this);
+    m_udpSocket->setBufferSizes(256 * SDRDaemonUdpSize, 0); // room for a full frame with FEC
 
     start();
 
@@ -59,6 +72,13 @@ void UDPSinkFECWorker::startWork()
 void UDPSinkFECWorker::stopWork()
 {
     qDebug("UDPSinkFECWorker::stopWork");
+    OrderedWorkerPool::Job *job;
+
+    while ((job = m_encoderPool.popWait()) != 0) { // flush frames in flight
+        transmit((EncodeJob *) job);
+        delete job;
+    }
+
     delete m_udpSocket;
     m_udpSocket = 0;
     m_running = false;
@@ -84,10 +104,11 @@ void UDPSinkFECWorker::run()
 void UDPSinkFECWorker::pushTxFrame(SDRDaemonSuperBlock *txBlocks,
     uint32_t nbBlocksFEC,
     uint32_t txDelay,
-    uint16_t frameIndex)
+    uint16_t frameIndex,
+    int nbBlocksPerDatagram)
 {
     //qDebug("UDPSinkFECWorker::pushTxFrame. %d", m_inputMessageQueue.size());
-    m_inputMessageQueue.push(MsgUDPFECEncodeAndSend::create(txBlocks, nbBlocksFEC, txDelay, frameIndex));
+    m_inputMessageQueue.push(MsgUDPFECEncodeAndSend::create(txBlocks, nbBlocksFEC, txDelay, frameIndex, nbBlocksPerDatagram));
 }
 
 void UDPSinkFECWorker::setRemoteAddress(const QString& address, uint16_t port)
@@ -104,7 +125,7 @@ void UDPSinkFECWorker::handleInputMessages()
         if (MsgUDPFECEncodeAndSend::match(*message))
         {
             MsgUDPFECEncodeAndSend *sendMsg = (MsgUDPFECEncodeAndSend *) message;
-            encodeAndTransmit(sendMsg->getTxBlocks(), sendMsg->getFrameIndex(), sendMsg->getNbBlocsFEC(), sendMsg->getTxDelay());
+            pushEncode(sendMsg->getTxBlocks(), sendMsg->getFrameIndex(), sendMsg->getNbBlocsFEC(), sendMsg->getTxDelay(), sendMsg->getNbBlocksPerDatagram());
         }
         else if (MsgConfigureRemoteAddress::match(*message))
         {
@@ -130,77 +151,122 @@ void UDPSinkFECWorker::handleInputMessages()
     }
 }
 
-void UDPSinkFECWorker::encodeAndTransmit(SDRDaemonSuperBlock *txBlockx, uint16_t frameIndex, uint32_t nbBlocksFEC, uint32_t txDelay)
+void UDPSinkFECWorker::handleEncodedFrames()
+{
+    OrderedWorkerPool::Job *job;
+
+    while ((job = m_encoderPool.popProcessed()) != 0)
+    {
+        transmit((EncodeJob *) job);
+        delete job;
+    }
+}
+
+void UDPSinkFECWorker::pushEncode(SDRDaemonSuperBlock *txBlockx, uint16_t frameIndex, uint32_t nbBlocksFEC, uint32_t txDelay, int nbBlocksPerDatagram)
+{
+    // do not let the frames in flight be overwritten by the Tx rows being filled
+    while (m_encoderPool.getNbPending() >= UDPSINKFECWORKER_NBPENDINGFRAMES)
+    {
+        EncodeJob *encodeJob = (EncodeJob *) m_encoderPool.popWait();
+        transmit(encodeJob);
+        delete encodeJob;
+    }
+
+    m_encoderPool.push(new EncodeJob(m_cm256Valid ? m_cm256 : 0, txBlockx, frameIndex, nbBlocksFEC, txDelay, nbBlocksPerDatagram));
+}
+
+bool UDPSinkFECWorker::EncodeJob::process(unsigned int workerIndex)
 {
     CM256::cm256_encoder_params cm256Params;  //!< Main interface with CM256 encoder
     CM256::cm256_block descriptorBlocks[256]; //!< Pointers to data for CM256 encoder
     SDRDaemonProtectedBlock fecBlocks[256];   //!< FEC data
 
-    if ((nbBlocksFEC == 0) || !m_cm256Valid)
+    if ((m_nbBlocksFEC == 0) || !m_cm256) { // Do not FEC encode
+        return false;
+    }
+
+    cm256Params.BlockBytes = sizeof(SDRDaemonProtectedBlock);
+    cm256Params.OriginalCount = SDRDaemonNbOrginalBlocks;
+    cm256Params.RecoveryCount = m_nbBlocksFEC;
+
+    // Fill pointers to data
+    for (int i = 0; i < cm256Params.OriginalCount + cm256Params.RecoveryCount; ++i)
     {
-        if (m_udpSocket)
-        {
-            for (unsigned int i = 0; i < SDRDaemonNbOrginalBlocks; i++)
-            {
-                //m_socket.SendDataGram((const void *) &txBlockx[i], SDRDaemonUdpSize, m_remoteAddress.toStdString(), (uint32_t) m_remotePort);
-                m_udpSocket->writeDatagram((const char *) &txBlockx[i], SDRDaemonUdpSize, m_remoteHostAddress, m_remotePort);
-                usleep(txDelay);
-            }
+        if (i >= cm256Params.OriginalCount) {
+            memset((char *) &m_txBlockx[i].m_protectedBlock, 0, sizeof(SDRDaemonProtectedBlock));
         }
+
+        m_txBlockx[i].m_header.m_frameIndex = m_frameIndex;
+        m_txBlockx[i].m_header.m_blockIndex = i;
+        m_txBlockx[i].m_header.m_sampleBytes = (SDR_RX_SAMP_SZ <= 16 ? 2 : 4);
+        m_txBlockx[i].m_header.m_sampleBits = SDR_RX_SAMP_SZ;
+        descriptorBlocks[i].Block = (void *) &(m_txBlockx[i].m_protectedBlock);
+        descriptorBlocks[i].Index = m_txBlockx[i].m_header.m_blockIndex;
     }
-    else
-    {
-        cm256Params.BlockBytes = sizeof(SDRDaemonProtectedBlock);
-        cm256Params.OriginalCount = SDRDaemonNbOrginalBlocks;
-        cm256Params.RecoveryCount = nbBlocksFEC;
 
+    // Encode FEC blocks
+    if (m_cm256[workerIndex].cm256_encode(cm256Params, descriptorBlocks, fecBlocks))
+    {
+        m_encodeFailed = true;
+        return true;
+    }
 
-        // Fill pointers to data
-        for (int i = 0; i < cm256Params.OriginalCount + cm256Params.RecoveryCount; ++i)
-        {
-            if (i >= cm256Params.OriginalCount) {
-                memset((char *) &txBlockx[i].m_protectedBlock, 0, sizeof(SDRDaemonProtectedBlock));
-            }
+    // Merge FEC with data to transmit
+    for (int i = 0; i < cm256Params.RecoveryCount; i++)
+    {
+        m_txBlockx[i + cm256Params.OriginalCount].m_protectedBlock = fecBlocks[i];
+    }
 
-            txBlockx[i].m_header.m_frameIndex = frameIndex;
-            txBlockx[i].m_header.m_blockIndex = i;
-            txBlockx[i].m_header.m_sampleBytes = (SDR_RX_SAMP_SZ <= 16 ? 2 : 4);
-            txBlockx[i].m_header.m_sampleBits = SDR_RX_SAMP_SZ;
-            descriptorBlocks[i].Block = (void *) &(txBlockx[i].m_protectedBlock);
-            descriptorBlocks[i].Index = txBlockx[i].m_header.m_blockIndex;
-        }
+    return true;
+}
 
-        // Encode FEC blocks
-        if (m_cm256.cm256_encode(cm256Params, descriptorBlocks, fecBlocks))
-        {
-            qDebug("UDPSinkFECWorker::encodeAndTransmit: CM256 encode failed. No transmission.");
-            return;
-        }
+void UDPSinkFECWorker::transmit(EncodeJob *encodeJob)
+{
+    const char *txBlockx = (const char *) encodeJob->m_txBlockx;
+    int nbBlocksPerDatagram = encodeJob->m_nbBlocksPerDatagram;
 
-        // Merge FEC with data to transmit
-        for (int i = 0; i < cm256Params.RecoveryCount; i++)
-        {
-            txBlockx[i + cm256Params.OriginalCount].m_protectedBlock = fecBlocks[i];
-        }
+    if (m_udpSocket)
+    {
+        m_udpSocket->setDestination(m_remoteHostAddress, m_remotePort);
+        m_udpSocket->setPacing(nbBlocksPerDatagram * SDRDaemonUdpSize, nbBlocksPerDatagram * encodeJob->m_txDelay);
+    }
 
+    if ((encodeJob->m_nbBlocksFEC == 0) || !encodeJob->m_cm256)
+    {
+        transmitBlocks(txBlockx, SDRDaemonNbOrginalBlocks, nbBlocksPerDatagram);
+    }
+    else if (encodeJob->m_encodeFailed)
+    {
+        qDebug("UDPSinkFECWorker::transmit: CM256 encode failed. No transmission.");
+    }
+    else
+    {
         // Transmit all blocks
-        if (m_udpSocket)
-        {
-            for (int i = 0; i < cm256Params.OriginalCount + cm256Params.RecoveryCount; i++)
-            {
+        int nbBlocks = SDRDaemonNbOrginalBlocks + encodeJob->m_nbBlocksFEC;
     #ifdef SDRDAEMON_PUNCTURE
-                if (i == SDRDAEMON_PUNCTURE) {
-                    continue;
-                }
+        transmitBlocks(txBlockx, SDRDAEMON_PUNCTURE, nbBlocksPerDatagram);
+        transmitBlocks(&txBlockx[(SDRDAEMON_PUNCTURE + 1) * SDRDaemonUdpSize], nbBlocks - SDRDAEMON_PUNCTURE - 1, nbBlocksPerDatagram);
+    #else
+        transmitBlocks(txBlockx, nbBlocks, nbBlocksPerDatagram);
     #endif
-
-                m_udpSocket->writeDatagram((const char *) &txBlockx[i], SDRDaemonUdpSize, m_remoteHostAddress, m_remotePort);
-                usleep(txDelay);
-            }
-        }
     }
 }
 
+void UDPSinkFECWorker::transmitBlocks(const char *txBlocks, int nbBlocks, int nbBlocksPerDatagram)
+{
+    if (!m_udpSocket) {
+        return;
+    }
 
+    // consecutive blocks are packed in datagrams of nbBlocksPerDatagram blocks with a last shorter datagram if necessary
+    int nbFullDatagrams = nbBlocks / nbBlocksPerDatagram;
+    int nbRemainderBlocks = nbBlocks % nbBlocksPerDatagram;
 
+    if (nbFullDatagrams > 0) {
+        m_udpSocket->writeDatagrams(txBlocks, nbBlocksPerDatagram * SDRDaemonUdpSize, nbFullDatagrams);
+    }
 
+    if (nbRemainderBlocks > 0) {
+        m_udpSocket->writeDatagrams(&txBlocks[nbFullDatagrams * nbBlocksPerDatagram * SDRDaemonUdpSize], nbRemainderBlocks * SDRDaemonUdpSize, 1);
+    }
+}
@@ -26,9 +26,13 @@
 
 #include "util/messagequeue.h"
 #include "util/message.h"
+#include "util/orderedworkerpool.h"
 #include "channel/sdrdaemondatablock.h"
 
-class QUdpSocket;
+#define UDPSINKFECWORKER_NBENCODERS 2       // maximum number of concurrent FEC encoders
+#define UDPSINKFECWORKER_NBPENDINGFRAMES 3  // maximum number of frames in flight (UDPSinkFEC has 4 Tx rows of which one is being filled)
+
+class UDPBatchSocket;
 
 class UDPSinkFECWorker : public QThread
 {
@@ -42,14 +46,16 @@ public:
         uint32_t getNbBlocsFEC() const { return m_nbBlocksFEC; }
         uint32_t getTxDelay() const { return m_txDelay; }
         uint16_t getFrameIndex() const { return m_frameIndex; }
+        int getNbBlocksPerDatagram() const { return m_nbBlocksPerDatagram; }
 
         static MsgUDPFECEncodeAndSend* create(
                 SDRDaemonSuperBlock *txBlocks,
                 uint32_t nbBlocksFEC,
                 uint32_t txDelay,
-                uint16_t frameIndex)
+                uint16_t frameIndex,
+                int nbBlocksPerDatagram)
         {
-            return new MsgUDPFECEncodeAndSend(txBlocks, nbBlocksFEC, txDelay, frameIndex);
+            return new MsgUDPFECEncodeAndSend(txBlocks, nbBlocksFEC, txDelay, frameIndex, nbBlocksPerDatagram);
         }
 
     private:
@@ -57,16 +63,19 @@ public:
         uint32_t m_nbBlocksFEC;
         uint32_t m_txDelay;
         uint16_t m_frameIndex;
+        int m_nbBlocksPerDatagram;
 
         MsgUDPFECEncodeAndSend(
                 SDRDaemonSuperBlock *txBlocks,
                 uint32_t nbBlocksFEC,
                 uint32_t txDelay,
-                uint16_t frameIndex) :
+                uint16_t frameIndex,
+                int nbBlocksPerDatagram) :
             m_txBlockx(txBlocks),
             m_nbBlocksFEC(nbBlocksFEC),
             m_txDelay(txDelay),
-            m_frameIndex(frameIndex)
+            m_frameIndex(frameIndex),
+            m_nbBlocksPerDatagram(nbBlocksPerDatagram)
         {}
     };
 
@@ -119,26 +128,60 @@ public:
     void pushTxFrame(SDRDaemonSuperBlock *txBlocks,
         uint32_t nbBlocksFEC,
         uint32_t txDelay,
-        uint16_t frameIndex);
+        uint16_t frameIndex,
+        int nbBlocksPerDatagram = 1);
     void setRemoteAddress(const QString& address, uint16_t port);
 
+    unsigned int getNbEncoders() const { return m_encoderPool.getNbWorkers(); }
+    int getAvgEncodeTimeUs() const { return m_encoderPool.getAvgProcessTimeUs(); }
+    int getMaxEncodeTimeUs() { return m_encoderPool.getMaxProcessTimeUs(); }
+
     MessageQueue m_inputMessageQueue;    //!< Queue for asynchronous inbound communication
 
 private slots:
     void handleInputMessages();
+    void handleEncodedFrames();
 
 private:
+    /** FEC encodes one frame in a pool thread */
+    class EncodeJob : public OrderedWorkerPool::Job
+    {
+    public:
+        EncodeJob(CM256 *cm256, SDRDaemonSuperBlock *txBlockx, uint16_t frameIndex, uint32_t nbBlocksFEC, uint32_t txDelay, int nbBlocksPerDatagram) :
+            m_cm256(cm256),
+            m_txBlockx(txBlockx),
+            m_frameIndex(frameIndex),
+            m_nbBlocksFEC(nbBlocksFEC),
+            m_txDelay(txDelay),
+            m_nbBlocksPerDatagram(nbBlocksPerDatagram),
+            m_encodeFailed(false)
+        {}
+
+        virtual bool process(unsigned int workerIndex);
+
+        CM256 *m_cm256;               //!< CM256 objects one per encoder or null if CM256 is not available
+        SDRDaemonSuperBlock *m_txBlockx;
+        uint16_t m_frameIndex;
+        uint32_t m_nbBlocksFEC;
+        uint32_t m_txDelay;           //!< delay in microseconds between blocks
+        int m_nbBlocksPerDatagram;    //!< number of consecutive blocks sent in one datagram
+        bool m_encodeFailed;
+    };
+
     void startWork();
     void stopWork();
     void run();
-    void encodeAndTransmit(SDRDaemonSuperBlock *txBlockx, uint16_t frameIndex, uint32_t nbBlocksFEC, uint32_t txDelay);
+    void pushEncode(SDRDaemonSuperBlock *txBlockx, uint16_t frameIndex, uint32_t nbBlocksFEC, uint32_t txDelay, int nbBlocksPerDatagram);
+    void transmit(EncodeJob *encodeJob);
+    void transmitBlocks(const char *txBlocks, int nbBlocks, int nbBlocksPerDatagram);
 
     QMutex m_startWaitMutex;
     QWaitCondition m_startWaiter;
     volatile bool m_running;
-    CM256 m_cm256;                       //!< CM256 library object
+    CM256 m_cm256[UDPSINKFECWORKER_NBENCODERS]; //!< CM256 library objects one per encoder
     bool m_cm256Valid;                   //!< true if CM256 library is initialized correctly
-    QUdpSocket   *m_udpSocket;
+    OrderedWorkerPool m_encoderPool;     //!< FEC encoders handing back frames in order
+    UDPBatchSocket *m_udpSocket;
     QString      m_remoteAddress;
     uint16_t     m_remotePort;
     QHostAddress m_remoteHostAddress;
@@ -712,6 +712,8 @@ int AirspyInput::webapiReportGet(
     response.setAirspyReport(new SWGSDRangel::SWGAirspyReport());
     response.getAirspyReport()->init();
     webapiFormatDeviceReport(response);
+    response.setFileRecordReport(new SWGSDRangel::SWGFileRecordReport());
+    m_fileSink->webapiFormatReport(*response.getFileRecordReport());
     return 200;
 }
 
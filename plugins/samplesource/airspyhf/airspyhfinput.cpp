@@ -578,6 +578,8 @@ int AirspyHFInput::webapiReportGet(
     response.setAirspyHfReport(new SWGSDRangel::SWGAirspyHFReport());
     response.getAirspyHfReport()->init();
     webapiFormatDeviceReport(response);
+    response.setFileRecordReport(new SWGSDRangel::SWGFileRecordReport());
+    m_fileSink->webapiFormatReport(*response.getFileRecordReport());
     return 200;
 }
 
@@ -1057,6 +1057,8 @@ int BladeRF2Input::webapiReportGet(SWGSDRangel::SWGDeviceReport& response, QStri
     response.setBladeRf2InputReport(new SWGSDRangel::SWGBladeRF2InputReport());
     response.getBladeRf2InputReport()->init();
     webapiFormatDeviceReport(response);
+    response.setFileRecordReport(new SWGSDRangel::SWGFileRecordReport());
+    m_fileSink->webapiFormatReport(*response.getFileRecordReport());
     return 200;
 }
 
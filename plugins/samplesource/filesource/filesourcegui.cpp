@@ -182,6 +182,11 @@ bool FileSourceGui::handleMessage(const Message& message)
 		updateWithStreamData();
 		return true;
 	}
+	else if (FileSourceInput::MsgReportFileSourceMarkers::match(message))
+	{
+		updateMarkers(((FileSourceInput::MsgReportFileSourceMarkers&)message).getMarkers());
+		return true;
+	}
 	else if (FileSourceInput::MsgReportFileSourceStreamTiming::match(message))
 	{
 		m_samplesCount = ((FileSourceInput::MsgReportFileSourceStreamTiming&)message).getSamplesCount();
@@ -236,7 +241,9 @@ void FileSourceGui::displaySettings()
 {
     blockApplySettings(true);
     ui->playLoop->setChecked(m_settings.m_loop);
-    ui->acceleration->setCurrentIndex(FileSourceSettings::getAccelerationIndex(m_settings.m_accelerationFactor));
+    ui->acceleration->setCurrentIndex(m_settings.m_halfSpeed ?
+            FileSourceSettings::getHalfSpeedIndex() :
+            FileSourceSettings::getAccelerationIndex(m_settings.m_accelerationFactor));
     blockApplySettings(false);
 }
 
@@ -314,7 +321,7 @@ void FileSourceGui::on_showFileDialog_clicked(bool checked)
 {
     (void) checked;
 	QString fileName = QFileDialog::getOpenFileName(this,
-	    tr("Open I/Q record file"), ".", tr("SDR I/Q Files (*.sdriq)"), 0, QFileDialog::DontUseNativeDialog);
+	    tr("Open I/Q record file"), ".", tr("SDR I/Q Files (*.sdriq *.sigmf-meta)"), 0, QFileDialog::DontUseNativeDialog);
 
 	if (fileName != "")
 	{
@@ -329,12 +336,19 @@ void FileSourceGui::on_acceleration_currentIndexChanged(int index)
 {
     if (m_doApplySettings)
     {
-        m_settings.m_accelerationFactor = FileSourceSettings::getAccelerationValue(index);
+        m_settings.m_halfSpeed = (index == FileSourceSettings::getHalfSpeedIndex());
+        m_settings.m_accelerationFactor = m_settings.m_halfSpeed ? 1 : FileSourceSettings::getAccelerationValue(index);
         FileSourceInput::MsgConfigureFileSource *message = FileSourceInput::MsgConfigureFileSource::create(m_settings, false);
         m_sampleSource->getInputMessageQueue()->push(message);
     }
 }
 
+void FileSourceGui::on_markers_activated(int index)
+{
+    FileSourceInput::MsgConfigureFileSourceSeekMarker* message = FileSourceInput::MsgConfigureFileSourceSeekMarker::create(index);
+    m_sampleSource->getInputMessageQueue()->push(message);
+}
+
 void FileSourceGui::configureFileName()
 {
 	qDebug() << "FileSourceGui::configureFileName: " << m_fileName.toStdString().c_str();
@@ -392,6 +406,23 @@ void FileSourceGui::updateWithStreamTime()
 	}
 }
 
+void FileSourceGui::updateMarkers(const std::vector<SigMFFile::Annotation>& markers)
+{
+    ui->markers->clear();
+
+    for (std::vector<SigMFFile::Annotation>::const_iterator it = markers.begin(); it != markers.end(); ++it)
+    {
+        QString label = it->m_label.isEmpty() ? it->m_comment : it->m_label;
+        ui->markers->addItem(tr("%1 %2").arg(it->m_sampleStart).arg(label));
+
+        if (!it->m_comment.isEmpty()) {
+            ui->markers->setItemData(ui->markers->count() - 1, it->m_comment, Qt::ToolTipRole);
+        }
+    }
+
+    ui->markers->setEnabled(markers.size() != 0);
+}
+
 void FileSourceGui::tick()
 {
 	if ((++m_tickCount & 0xf) == 0) {
@@ -421,6 +452,8 @@ void FileSourceGui::setAccelerationCombo()
         ui->acceleration->addItem(s);
     }
 
+    ui->acceleration->addItem(QString("max")); // as fast as the DSP chain goes
+    ui->acceleration->addItem(QString("0.5")); // half speed, after the integer factors so that their indexes do not change
     ui->acceleration->blockSignals(false);
 }
 
@@ -84,6 +84,7 @@ private:
 	void updateWithAcquisition();
 	void updateWithStreamData();
 	void updateWithStreamTime();
+	void updateMarkers(const std::vector<SigMFFile::Annotation>& markers);
     void setAccelerationCombo();
     void setNumberStr(int n, QString& s);
 
@@ -95,6 +96,7 @@ private slots:
 	void on_navTimeSlider_valueChanged(int value);
 	void on_showFileDialog_clicked(bool checked);
 	void on_acceleration_currentIndexChanged(int index);
+	void on_markers_activated(int index);
     void updateStatus();
 	void tick();
 };
@@ -29,6 +29,7 @@
 #include "dsp/dspcommands.h"
 #include "dsp/dspengine.h"
 #include "dsp/filerecord.h"
+#include "channel/sdrdaemondatablock.h"
 #include "device/devicesourceapi.h"
 
 #include "filesourceinput.h"
@@ -38,6 +39,7 @@ MESSAGE_CLASS_DEFINITION(FileSourceInput::MsgConfigureFileSource, Message)
 MESSAGE_CLASS_DEFINITION(FileSourceInput::MsgConfigureFileSourceName, Message)
 MESSAGE_CLASS_DEFINITION(FileSourceInput::MsgConfigureFileSourceWork, Message)
 MESSAGE_CLASS_DEFINITION(FileSourceInput::MsgConfigureFileSourceSeek, Message)
+MESSAGE_CLASS_DEFINITION(FileSourceInput::MsgConfigureFileSourceSeekMarker, Message)
 MESSAGE_CLASS_DEFINITION(FileSourceInput::MsgConfigureFileSourceStreamTiming, Message)
 MESSAGE_CLASS_DEFINITION(FileSourceInput::MsgStartStop, Message)
 MESSAGE_CLASS_DEFINITION(FileSourceInput::MsgPlayPause, Message)
@@ -45,6 +47,7 @@ MESSAGE_CLASS_DEFINITION(FileSourceInput::MsgReportFileSourceAcquisition, Messag
 MESSAGE_CLASS_DEFINITION(FileSourceInput::MsgReportFileSourceStreamData, Message)
 MESSAGE_CLASS_DEFINITION(FileSourceInput::MsgReportFileSourceStreamTiming, Message)
 MESSAGE_CLASS_DEFINITION(FileSourceInput::MsgReportHeaderCRC, Message)
+MESSAGE_CLASS_DEFINITION(FileSourceInput::MsgReportFileSourceMarkers, Message)
 
 FileSourceInput::FileSourceInput(DeviceSourceAPI *deviceAPI) :
     m_deviceAPI(deviceAPI),
@@ -56,6 +59,7 @@ FileSourceInput::FileSourceInput(DeviceSourceAPI *deviceAPI) :
 	m_sampleSize(0),
 	m_centerFrequency(0),
 	m_recordLength(0),
+	m_recordSamples(0),
     m_startingTimeStamp(0),
     m_masterTimer(deviceAPI->getMasterTimer())
 {
@@ -78,18 +82,36 @@ void FileSourceInput::openFileStream()
 {
 	//stopInput();
 
-	if (m_ifstream.is_open()) {
-		m_ifstream.close();
-	}
+	bool sigMF = SigMFFile::isSigMFFileName(m_fileName);
+	m_mappedFile.open(sigMF ? SigMFFile::getDataFileName(m_fileName) : m_fileName);
+	quint64 fileSize = m_mappedFile.size();
+	m_chunks.clear();
+	m_markers.clear();
 
-	m_ifstream.open(m_fileName.toStdString().c_str(), std::ios::binary | std::ios::ate);
-	quint64 fileSize = m_ifstream.tellg();
+	if (sigMF)
+	{
+	    bool ok = openFileStreamSigMF();
 
-	if (fileSize > sizeof(FileRecord::Header))
+	    if (getMessageQueueToGUI()) {
+	        MsgReportHeaderCRC *report = MsgReportHeaderCRC::create(ok);
+	        getMessageQueueToGUI()->push(report);
+	    }
+	}
+	else if ((fileSize > sizeof(FileRecord::HeaderV2)) && FileRecord::isHeaderV2(m_mappedFile.map(0, sizeof(FileRecord::HeaderV2))))
+	{
+	    bool ok = openFileStreamV2();
+
+	    if (getMessageQueueToGUI()) {
+	        MsgReportHeaderCRC *report = MsgReportHeaderCRC::create(ok);
+	        getMessageQueueToGUI()->push(report);
+	    }
+	}
+	else if (fileSize > sizeof(FileRecord::Header))
 	{
 	    FileRecord::Header header;
-	    m_ifstream.seekg(0,std::ios_base::beg);
-		bool crcOK = FileRecord::readHeader(m_ifstream, header);
+	    const quint8 *headerBuf = m_mappedFile.map(0, sizeof(FileRecord::Header));
+	    memset((void *) &header, 0, sizeof(FileRecord::Header));
+		bool crcOK = headerBuf ? FileRecord::readHeader(headerBuf, header) : false;
 		m_sampleRate = header.sampleRate;
 		m_centerFrequency = header.centerFrequency;
 		m_startingTimeStamp = header.startTimeStamp;
@@ -99,12 +121,14 @@ void FileSourceInput::openFileStream()
 	    if (crcOK)
 	    {
 	        qDebug("FileSourceInput::openFileStream: CRC32 OK for header: %s", qPrintable(crcHex));
-	        m_recordLength = (fileSize - sizeof(FileRecord::Header)) / ((m_sampleSize == 24 ? 8 : 4) * m_sampleRate);
+	        m_recordSamples = (fileSize - sizeof(FileRecord::Header)) / (m_sampleSize == 24 ? 8 : 4);
+	        m_recordLength = m_sampleRate == 0 ? 0 : m_recordSamples / m_sampleRate;
 	    }
 	    else
 	    {
 	        qCritical("FileSourceInput::openFileStream: bad CRC32 for header: %s", qPrintable(crcHex));
 	        m_recordLength = 0;
+	        m_recordSamples = 0;
 	    }
 
 		if (getMessageQueueToGUI()) {
@@ -115,6 +139,7 @@ void FileSourceInput::openFileStream()
 	else
 	{
 		m_recordLength = 0;
+		m_recordSamples = 0;
 	}
 
 	qDebug() << "FileSourceInput::openFileStream: " << m_fileName.toStdString().c_str()
@@ -133,25 +158,175 @@ void FileSourceInput::openFileStream()
 	    getMessageQueueToGUI()->push(report);
 	}
 
+	if (getMessageQueueToGUI()) {
+	    MsgReportFileSourceMarkers *report = MsgReportFileSourceMarkers::create(m_markers);
+	    getMessageQueueToGUI()->push(report);
+	}
+
 	if (m_recordLength == 0) {
-	    m_ifstream.close();
+	    m_mappedFile.close();
 	}
 }
 
+bool FileSourceInput::openFileStreamV2()
+{
+    FileRecord::HeaderV2 header;
+    bool indexed;
+    m_recordLength = 0;
+    m_recordSamples = 0;
+
+    if (!FileRecord::readHeaderV2(m_mappedFile.map(0, sizeof(FileRecord::HeaderV2)), header))
+    {
+        qCritical("FileSourceInput::openFileStreamV2: bad CRC32 for header");
+        return false;
+    }
+
+    m_sampleSize = header.sampleSize;
+    m_startingTimeStamp = header.startTimeStampUs / 1000000;
+    m_sampleRate = header.sampleRate;
+    m_centerFrequency = header.centerFrequency;
+    m_codec.setCodec((SDRDaemonCodec::CodecType) header.codec, header.codecBits, m_sampleSize > 16 ? 4 : 2);
+
+    if ((m_codec.getCodecType() != SDRDaemonCodec::CodecNone) && (header.codecBlockSize != (quint32) SDRDaemonNbBytesPerBlock))
+    {
+        qCritical("FileSourceInput::openFileStreamV2: unsupported compressed block size %u", header.codecBlockSize);
+        return false;
+    }
+
+    if (!FileRecord::readChunkTable(m_mappedFile, m_chunks, indexed))
+    {
+        qCritical("FileSourceInput::openFileStreamV2: no valid data chunk");
+        return false;
+    }
+
+    const FileRecord::IndexEntry& first = m_chunks.front();
+    const FileRecord::IndexEntry& last = m_chunks.back();
+    m_sampleRate = first.sampleRate;
+    m_centerFrequency = first.centerFrequency;
+    m_recordSamples = last.sampleIndex + last.nbSamples;
+    quint64 endUs = last.timeStampUs + (last.sampleRate == 0 ? 0 : ((quint64) last.nbSamples * 1000000ULL) / last.sampleRate);
+    m_recordLength = (endUs - first.timeStampUs) / 1000000;
+
+    qDebug("FileSourceInput::openFileStreamV2: %u chunks %s file sequence: %u codec: %d",
+        (unsigned int) m_chunks.size(), indexed ? "from index" : "from scan (not closed properly)",
+        header.fileSequence, (int) m_codec.getCodecType());
+
+    return true;
+}
+
+bool FileSourceInput::openFileStreamSigMF()
+{
+    SigMFFile::Meta meta;
+    QString errorMessage;
+    m_recordLength = 0;
+    m_recordSamples = 0;
+
+    if (!SigMFFile::readMeta(SigMFFile::getMetaFileName(m_fileName), meta, errorMessage))
+    {
+        qCritical("FileSourceInput::openFileStreamSigMF: %s", qPrintable(errorMessage));
+        return false;
+    }
+
+    m_sampleSize = meta.m_sampleBits;
+    int sampleBytes = m_sampleSize > 16 ? 4 : 2;
+    m_codec.setCodec(SDRDaemonCodec::CodecNone, 8 * sampleBytes, sampleBytes);
+    quint64 dataSamples = m_mappedFile.size() / (2 * sampleBytes);
+
+    if (meta.m_captures.size() == 0) // then the whole file is a single segment
+    {
+        SigMFFile::Capture capture;
+        capture.m_sampleRate = meta.m_sampleRate;
+        meta.m_captures.push_back(capture);
+    }
+
+    // capture segments are played as chunks with no header so that samples come directly from the mapping
+    quint64 timeStampUs = meta.m_captures.front().m_timeStampUs;
+
+    for (unsigned int i = 0; i < meta.m_captures.size(); i++)
+    {
+        const SigMFFile::Capture& capture = meta.m_captures[i];
+        quint64 start = i == 0 ? 0 : capture.m_sampleStart; // chunks must cover the file
+        quint64 end = i + 1 < meta.m_captures.size() ? meta.m_captures[i+1].m_sampleStart : dataSamples;
+        end = std::min(end, dataSamples);
+
+        if (capture.m_timeStampUs != 0) {
+            timeStampUs = capture.m_timeStampUs;
+        }
+
+        while (start < end) // chunk size is limited to 32 bits
+        {
+            FileRecord::IndexEntry entry;
+            memset((void *) &entry, 0, sizeof(FileRecord::IndexEntry));
+            entry.offset = start * 2 * sampleBytes;
+            entry.sampleIndex = start;
+            entry.timeStampUs = timeStampUs;
+            entry.centerFrequency = capture.m_frequency;
+            entry.sampleRate = capture.m_sampleRate;
+            entry.nbSamples = std::min(end - start, (quint64) (1U<<30));
+            entry.payloadSize = entry.nbSamples * 2 * sampleBytes;
+            m_chunks.push_back(entry);
+
+            start += entry.nbSamples;
+            timeStampUs += entry.sampleRate == 0 ? 0 : ((quint64) entry.nbSamples * 1000000ULL) / entry.sampleRate;
+        }
+    }
+
+    if (m_chunks.size() == 0)
+    {
+        qCritical("FileSourceInput::openFileStreamSigMF: no samples in data file");
+        return false;
+    }
+
+    const FileRecord::IndexEntry& first = m_chunks.front();
+    m_sampleRate = first.sampleRate;
+    m_centerFrequency = first.centerFrequency;
+    m_startingTimeStamp = first.timeStampUs / 1000000;
+    m_recordSamples = dataSamples;
+    m_recordLength = (timeStampUs - first.timeStampUs) / 1000000;
+    m_markers = meta.m_annotations;
+
+    qDebug("FileSourceInput::openFileStreamSigMF: %u capture segments %u annotations datatype: ci%u_le (%u bits)",
+        (unsigned int) meta.m_captures.size(), (unsigned int) m_markers.size(), sampleBytes * 8, m_sampleSize);
+
+    return true;
+}
+
+quint64 FileSourceInput::getSampleAtMs(quint64 ms) const
+{
+    if (m_chunks.size() == 0) {
+        return (ms * m_sampleRate) / 1000;
+    }
+
+    // chunks are time stamped so that time is exact across sample rate changes
+    quint64 timeStampUs = m_chunks.front().timeStampUs + ms * 1000;
+    std::vector<FileRecord::IndexEntry>::const_iterator it = m_chunks.begin();
+
+    for (std::vector<FileRecord::IndexEntry>::const_iterator next = it + 1; (next != m_chunks.end()) && (next->timeStampUs <= timeStampUs); ++next) {
+        it = next;
+    }
+
+    quint64 chunkSample = ((timeStampUs - it->timeStampUs) * it->sampleRate) / 1000000;
+    return it->sampleIndex + std::min(chunkSample, (quint64) it->nbSamples);
+}
+
 void FileSourceInput::seekFileStream(int seekMillis)
 {
 	QMutexLocker mutexLocker(&m_mutex);
 
-	if ((m_ifstream.is_open()) && m_fileSourceThread && !m_fileSourceThread->isRunning())
+	if (m_mappedFile.isOpen() && m_fileSourceThread) // memory mapped: seeking is immediate even when running
 	{
-        quint64 seekPoint = ((m_recordLength * seekMillis) / 1000) * m_sampleRate;
+        quint64 seekPoint = m_chunks.size() == 0 ? (m_recordSamples * seekMillis) / 1000 : getSampleAtMs(m_recordLength * seekMillis);
 		m_fileSourceThread->setSamplesCount(seekPoint);
-        seekPoint *= (m_sampleSize == 24 ? 8 : 4); // + sizeof(FileSink::Header)
-		m_ifstream.clear();
-		m_ifstream.seekg(seekPoint + sizeof(FileRecord::Header), std::ios::beg);
 	}
 }
 
+void FileSourceInput::setThreadLoop(const FileSourceSettings& settings)
+{
+    quint64 loopStart = getSampleAtMs(settings.m_loopStartMs);
+    quint64 loopEnd = settings.m_loopEndMs == 0 ? 0 : getSampleAtMs(settings.m_loopEndMs);
+    m_fileSourceThread->setLoop(settings.m_loop, loopStart, loopEnd);
+}
+
 void FileSourceInput::init()
 {
     DSPSignalNotification *notif = new DSPSignalNotification(m_settings.m_sampleRate, m_settings.m_centerFrequency);
@@ -160,7 +335,7 @@ void FileSourceInput::init()
 
 bool FileSourceInput::start()
 {
-    if (!m_ifstream.is_open())
+    if (!m_mappedFile.isOpen())
     {
         qWarning("FileSourceInput::start: file not open. not starting");
         return false;
@@ -169,18 +344,26 @@ bool FileSourceInput::start()
 	QMutexLocker mutexLocker(&m_mutex);
 	qDebug() << "FileSourceInput::start";
 
-	if (m_ifstream.tellg() != 0) {
-		m_ifstream.clear();
-		m_ifstream.seekg(sizeof(FileRecord::Header), std::ios::beg);
-	}
-
-	if(!m_sampleFifo.setSize(m_settings.m_accelerationFactor * m_sampleRate * sizeof(Sample))) {
+	if(!m_sampleFifo.setSize(getFifoAccelerationFactor(m_settings) * m_sampleRate * sizeof(Sample))) {
 		qCritical("Could not allocate SampleFifo");
 		return false;
 	}
 
-	m_fileSourceThread = new FileSourceThread(&m_ifstream, &m_sampleFifo, m_masterTimer, &m_inputMessageQueue);
-	m_fileSourceThread->setSampleRateAndSize(m_settings.m_accelerationFactor * m_sampleRate, m_sampleSize); // Fast Forward: 1 corresponds to live. 1/2 is half speed, 2 is double speed
+	m_fileSourceThread = new FileSourceThread(&m_mappedFile, sizeof(FileRecord::Header), &m_sampleFifo, m_masterTimer, &m_inputMessageQueue);
+	m_fileSourceThread->setThrottled(isThrottled(m_settings));
+
+	if (m_chunks.size() != 0)
+	{
+	    m_fileSourceThread->setChunks(m_chunks, m_codec, m_sampleRate, m_centerFrequency,
+	        SigMFFile::isSigMFFileName(m_fileName) ? 0 : sizeof(FileRecord::ChunkHeader));
+	}
+
+	m_fileSourceThread->setSampleRateAndSize(getPlaybackSampleRate(m_settings), m_sampleSize); // Fast Forward: 1 corresponds to live. 1/2 is half speed, 2 is double speed
+	setThreadLoop(m_settings);
+
+	if (m_settings.m_loop && (m_settings.m_loopStartMs != 0)) { // start at the beginning of the loop range
+	    m_fileSourceThread->setSamplesCount(getSampleAtMs(m_settings.m_loopStartMs));
+	}
 	m_fileSourceThread->startWork();
 	m_deviceDescription = "FileSource";
 
@@ -317,6 +500,18 @@ bool FileSourceInput::handleMessage(const Message& message)
 
 		return true;
 	}
+	else if (MsgConfigureFileSourceSeekMarker::match(message))
+	{
+		MsgConfigureFileSourceSeekMarker& conf = (MsgConfigureFileSourceSeekMarker&) message;
+		int markerIndex = conf.getMarkerIndex();
+		QMutexLocker mutexLocker(&m_mutex);
+
+		if (m_mappedFile.isOpen() && m_fileSourceThread && (markerIndex >= 0) && (markerIndex < (int) m_markers.size())) {
+			m_fileSourceThread->setSamplesCount(m_markers[markerIndex].m_sampleStart);
+		}
+
+		return true;
+	}
 	else if (MsgConfigureFileSourceStreamTiming::match(message))
 	{
 		MsgReportFileSourceStreamTiming *report;
@@ -351,6 +546,29 @@ bool FileSourceInput::handleMessage(const Message& message)
 
         return true;
     }
+    else if (FileSourceThread::MsgReportChunkChange::match(message))
+    {
+        FileSourceThread::MsgReportChunkChange& chunkChange = (FileSourceThread::MsgReportChunkChange&) message;
+        qDebug("FileSourceInput::handleMessage: MsgReportChunkChange: sample rate: %u center frequency: %llu",
+            chunkChange.getSampleRate(), chunkChange.getCenterFrequency());
+
+        m_sampleRate = chunkChange.getSampleRate();
+        m_centerFrequency = chunkChange.getCenterFrequency();
+        DSPSignalNotification *notif = new DSPSignalNotification(m_sampleRate, m_centerFrequency);
+        m_deviceAPI->getDeviceEngineInputMessageQueue()->push(notif);
+
+        if (getMessageQueueToGUI())
+        {
+            MsgReportFileSourceStreamData *report = MsgReportFileSourceStreamData::create(m_sampleRate,
+                    m_sampleSize,
+                    m_centerFrequency,
+                    m_startingTimeStamp,
+                    m_recordLength);
+            getMessageQueueToGUI()->push(report);
+        }
+
+        return true;
+    }
     else if (FileSourceThread::MsgReportEOF::match(message))
     {
         qDebug() << "FileSourceInput::handleMessage: MsgReportEOF";
@@ -386,20 +604,48 @@ bool FileSourceInput::handleMessage(const Message& message)
 
 bool FileSourceInput::applySettings(const FileSourceSettings& settings, bool force)
 {
+    if (m_settings.m_fileName != settings.m_fileName) // file name given through the API
+    {
+        m_fileName = settings.m_fileName;
+        openFileStream();
+    }
+
     if ((m_settings.m_centerFrequency != settings.m_centerFrequency) || force) {
         m_centerFrequency = settings.m_centerFrequency;
     }
 
-    if ((m_settings.m_accelerationFactor != settings.m_accelerationFactor) || force)
+    if ((m_settings.m_loop != settings.m_loop)
+     || (m_settings.m_loopStartMs != settings.m_loopStartMs)
+     || (m_settings.m_loopEndMs != settings.m_loopEndMs) || force)
+    {
+        if (m_fileSourceThread) {
+            setThreadLoop(settings);
+        }
+    }
+
+    if ((m_settings.m_accelerationFactor != settings.m_accelerationFactor)
+     || (m_settings.m_halfSpeed != settings.m_halfSpeed) || force)
     {
         if (m_fileSourceThread)
         {
             QMutexLocker mutexLocker(&m_mutex);
-            if (!m_sampleFifo.setSize(m_settings.m_accelerationFactor * m_sampleRate * sizeof(Sample))) {
+            bool working = m_fileSourceThread->isRunning();
+
+            if (working) {
+                m_fileSourceThread->stopWork(); // the FIFO must not be resized while the thread writes to it
+            }
+
+            if (!m_sampleFifo.setSize(getFifoAccelerationFactor(settings) * m_sampleRate * sizeof(Sample))) {
                 qCritical("FileSourceInput::applySettings: could not reallocate sample FIFO size to %lu",
-                        m_settings.m_accelerationFactor * m_sampleRate * sizeof(Sample));
+                        getFifoAccelerationFactor(settings) * m_sampleRate * sizeof(Sample));
+            }
+
+            m_fileSourceThread->setThrottled(isThrottled(settings));
+            m_fileSourceThread->setSampleRateAndSize(getPlaybackSampleRate(settings), m_sampleSize); // Fast Forward: 1 corresponds to live. 1/2 is half speed, 2 is double speed
+
+            if (working) {
+                m_fileSourceThread->startWork();
             }
-            m_fileSourceThread->setSampleRateAndSize(settings.m_accelerationFactor * m_sampleRate, m_sampleSize); // Fast Forward: 1 corresponds to live. 1/2 is half speed, 2 is double speed
         }
     }
 
@@ -433,9 +679,18 @@ int FileSourceInput::webapiSettingsPutPatch(
     if (deviceSettingsKeys.contains("accelerationFactor")) {
         settings.m_accelerationFactor = response.getFileSourceSettings()->getAccelerationFactor();
     }
+    if (deviceSettingsKeys.contains("halfSpeed")) {
+        settings.m_halfSpeed = response.getFileSourceSettings()->getHalfSpeed() != 0;
+    }
     if (deviceSettingsKeys.contains("loop")) {
         settings.m_loop = response.getFileSourceSettings()->getLoop() != 0;
     }
+    if (deviceSettingsKeys.contains("loopStartMs")) {
+        settings.m_loopStartMs = response.getFileSourceSettings()->getLoopStartMs();
+    }
+    if (deviceSettingsKeys.contains("loopEndMs")) {
+        settings.m_loopEndMs = response.getFileSourceSettings()->getLoopEndMs();
+    }
 
     MsgConfigureFileSource *msg = MsgConfigureFileSource::create(settings, force);
     m_inputMessageQueue.push(msg);
@@ -493,7 +748,10 @@ void FileSourceInput::webapiFormatDeviceSettings(SWGSDRangel::SWGDeviceSettings&
 {
     response.getFileSourceSettings()->setFileName(new QString(settings.m_fileName));
     response.getFileSourceSettings()->setAccelerationFactor(settings.m_accelerationFactor);
+    response.getFileSourceSettings()->setHalfSpeed(settings.m_halfSpeed ? 1 : 0);
     response.getFileSourceSettings()->setLoop(settings.m_loop ? 1 : 0);
+    response.getFileSourceSettings()->setLoopStartMs(settings.m_loopStartMs);
+    response.getFileSourceSettings()->setLoopEndMs(settings.m_loopEndMs);
 
 }
 
@@ -21,10 +21,13 @@
 #include <QByteArray>
 #include <QTimer>
 #include <ctime>
-#include <iostream>
-#include <fstream>
+#include <vector>
 
 #include <dsp/devicesamplesource.h>
+#include "dsp/filerecord.h"
+#include "dsp/sigmffile.h"
+#include "channel/sdrdaemoncodec.h"
+#include "util/mappedfile.h"
 #include "filesourcesettings.h"
 
 class FileSourceThread;
@@ -132,6 +135,26 @@ public:
 		{ }
 	};
 
+	class MsgConfigureFileSourceSeekMarker : public Message {
+		MESSAGE_CLASS_DECLARATION
+
+	public:
+		int getMarkerIndex() const { return m_markerIndex; }
+
+		static MsgConfigureFileSourceSeekMarker* create(int markerIndex)
+		{
+			return new MsgConfigureFileSourceSeekMarker(markerIndex);
+		}
+
+	protected:
+		int m_markerIndex; //!< index in the list of markers (SigMF annotations)
+
+		MsgConfigureFileSourceSeekMarker(int markerIndex) :
+			Message(),
+			m_markerIndex(markerIndex)
+		{ }
+	};
+
 	class MsgReportFileSourceAcquisition : public Message {
 		MESSAGE_CLASS_DECLARATION
 
@@ -269,6 +292,25 @@ public:
 		{ }
 	};
 
+	class MsgReportFileSourceMarkers : public Message {
+		MESSAGE_CLASS_DECLARATION
+
+	public:
+		const std::vector<SigMFFile::Annotation>& getMarkers() const { return m_markers; }
+
+		static MsgReportFileSourceMarkers* create(const std::vector<SigMFFile::Annotation>& markers) {
+			return new MsgReportFileSourceMarkers(markers);
+		}
+
+	protected:
+		std::vector<SigMFFile::Annotation> m_markers;
+
+		MsgReportFileSourceMarkers(const std::vector<SigMFFile::Annotation>& markers) :
+			Message(),
+			m_markers(markers)
+		{ }
+	};
+
 	FileSourceInput(DeviceSourceAPI *deviceAPI);
 	virtual ~FileSourceInput();
 	virtual void destroy();
@@ -316,7 +358,7 @@ public:
 	DeviceSourceAPI *m_deviceAPI;
 	QMutex m_mutex;
 	FileSourceSettings m_settings;
-	std::ifstream m_ifstream;
+	MappedFile m_mappedFile;
 	FileSourceThread* m_fileSourceThread;
 	QString m_deviceDescription;
 	QString m_fileName;
@@ -324,14 +366,33 @@ public:
 	quint32 m_sampleSize;
 	quint64 m_centerFrequency;
     quint64 m_recordLength; //!< record length in seconds computed from file size
+    quint64 m_recordSamples; //!< record length in I/Q samples computed from file size
     quint64 m_startingTimeStamp;
+    std::vector<FileRecord::IndexEntry> m_chunks; //!< data chunks of a .sdriq v2 file. Empty for v1 files.
+    SDRDaemonCodec m_codec; //!< v2 files compression
+    std::vector<SigMFFile::Annotation> m_markers; //!< annotations of a SigMF file
 	const QTimer& m_masterTimer;
 
 	void openFileStream();
+	bool openFileStreamV2(); //!< Read header and chunk table of a v2 file. Returns true if valid.
+	bool openFileStreamSigMF(); //!< Read metadata of a SigMF file and map its data file. Returns true if valid.
+	quint64 getSampleAtMs(quint64 ms) const; //!< Index of the sample played at ms from the start of the record
 	void seekFileStream(int seekMillis);
+	void setThreadLoop(const FileSourceSettings& settings);
 	bool applySettings(const FileSourceSettings& settings, bool force = false);
     void webapiFormatDeviceSettings(SWGSDRangel::SWGDeviceSettings& response, const FileSourceSettings& settings);
     void webapiFormatDeviceReport(SWGSDRangel::SWGDeviceReport& response);
+    /** FIFO and chunk sizing factor. Acceleration 0 (free running) and half speed are sized as live. */
+    static quint32 getFifoAccelerationFactor(const FileSourceSettings& settings) {
+        return (settings.m_accelerationFactor == 0) || settings.m_halfSpeed ? 1 : settings.m_accelerationFactor;
+    }
+    /** Rate at which the thread plays the samples */
+    int getPlaybackSampleRate(const FileSourceSettings& settings) const {
+        return settings.m_halfSpeed ? m_sampleRate / 2 : getFifoAccelerationFactor(settings) * m_sampleRate;
+    }
+    static bool isThrottled(const FileSourceSettings& settings) { //!< acceleration 0 is as fast as possible
+        return settings.m_halfSpeed || (settings.m_accelerationFactor != 0);
+    }
 };
 
 #endif // INCLUDE_FILESOURCEINPUT_H
@@ -31,7 +31,10 @@ void FileSourceSettings::resetToDefaults()
     m_sampleRate = 48000;
     m_fileName = "./test.sdriq";
     m_accelerationFactor = 1;
+    m_halfSpeed = false;
     m_loop = true;
+    m_loopStartMs = 0;
+    m_loopEndMs = 0;
 }
 
 QByteArray FileSourceSettings::serialize() const
@@ -40,6 +43,9 @@ QByteArray FileSourceSettings::serialize() const
     s.writeString(1, m_fileName);
     s.writeU32(2, m_accelerationFactor);
     s.writeBool(3, m_loop);
+    s.writeU32(4, m_loopStartMs);
+    s.writeU32(5, m_loopEndMs);
+    s.writeBool(6, m_halfSpeed);
     return s.final();
 }
 
@@ -56,6 +62,9 @@ bool FileSourceSettings::deserialize(const QByteArray& data)
         d.readString(1, &m_fileName, "./test.sdriq");
         d.readU32(2, &m_accelerationFactor, 1);
         d.readBool(3, &m_loop, true);
+        d.readU32(4, &m_loopStartMs, 0);
+        d.readU32(5, &m_loopEndMs, 0);
+        d.readBool(6, &m_halfSpeed, false);
         return true;
     } else {
         resetToDefaults();
@@ -65,6 +74,10 @@ bool FileSourceSettings::deserialize(const QByteArray& data)
 
 int FileSourceSettings::getAccelerationIndex(int accelerationValue)
 {
+    if (accelerationValue == 0) { // as fast as possible is last
+        return 3*m_accelerationMaxScale + 4;
+    }
+
     if (accelerationValue <= 1) {
         return 0;
     }
@@ -101,6 +114,10 @@ int FileSourceSettings::getAccelerationValue(int accelerationIndex)
         return 1;
     }
 
+    if (accelerationIndex > (int) (3*m_accelerationMaxScale + 3)) { // as fast as possible
+        return 0;
+    }
+
     unsigned int v = accelerationIndex - 1;
     int m = pow(10.0, v/3 > m_accelerationMaxScale ? m_accelerationMaxScale : v/3);
     int x = 1;
@@ -116,6 +133,10 @@ int FileSourceSettings::getAccelerationValue(int accelerationIndex)
     return x * m;
 }
 
+int FileSourceSettings::getHalfSpeedIndex()
+{
+    return 3*m_accelerationMaxScale + 5;
+}
 
 
 
@@ -25,7 +25,10 @@ struct FileSourceSettings {
     qint32  m_sampleRate;
     QString m_fileName;
     quint32 m_accelerationFactor;
+    bool m_halfSpeed;      //!< play at half the record rate (0.5x). Takes precedence over the acceleration factor.
     bool m_loop;
+    quint32 m_loopStartMs; //!< start of loop range in milliseconds from start of record
+    quint32 m_loopEndMs;   //!< end of loop range in milliseconds from start of record. 0 is end of record.
     static const unsigned int m_accelerationMaxScale; //!< Max power of 10 multiplier to 2,5,10 base ex: 2 -> 2,5,10,20,50,100,200,500,1000
 
     FileSourceSettings();
@@ -36,6 +39,7 @@ struct FileSourceSettings {
     bool deserialize(const QByteArray& data);
     static int getAccelerationIndex(int averaging);
     static int getAccelerationValue(int averagingIndex);
+    static int getHalfSpeedIndex(); //!< combo index of the 0.5x entry placed after the integer factors and "max"
 };
 
 #endif /* PLUGINS_SAMPLESOURCE_FILESOURCE_FILESOURCESETTINGS_H_ */
@@ -17,38 +17,55 @@
 #include <stdio.h>
 #include <errno.h>
 #include <assert.h>
+#include <algorithm>
 #include <QDebug>
 
 #include "dsp/filerecord.h"
 #include "filesourcethread.h"
 #include "dsp/samplesinkfifo.h"
+#include "channel/sdrdaemondatablock.h"
 #include "util/messagequeue.h"
+#include "util/mappedfile.h"
 
 MESSAGE_CLASS_DEFINITION(FileSourceThread::MsgReportEOF, Message)
+MESSAGE_CLASS_DEFINITION(FileSourceThread::MsgReportChunkChange, Message)
 
-FileSourceThread::FileSourceThread(std::ifstream *samplesStream,
+FileSourceThread::FileSourceThread(MappedFile *mappedFile,
+        qint64 dataOffset,
         SampleSinkFifo* sampleFifo,
         const QTimer& timer,
         MessageQueue *fileInputMessageQueue,
         QObject* parent) :
 	QThread(parent),
 	m_running(false),
-	m_ifstream(samplesStream),
-	m_fileBuf(0),
+	m_mappedFile(mappedFile),
+	m_dataOffset(dataOffset),
+	m_fileSamples(0),
 	m_convertBuf(0),
 	m_bufsize(0),
 	m_chunksize(0),
 	m_sampleFifo(sampleFifo),
 	m_samplesCount(0),
+	m_seekRequest(-1),
+	m_loop(false),
+	m_loopStart(0),
+	m_loopEnd(0),
 	m_timer(timer),
 	m_fileInputMessageQueue(fileInputMessageQueue),
+	m_chunkHeaderSize(0),
+	m_chunkIndex(0),
+	m_decodedBlockOffset(-1),
+	m_chunkSampleRate(0),
+	m_chunkCenterFrequency(0),
     m_samplerate(0),
 	m_samplesize(0),
 	m_samplebytes(0),
     m_throttlems(FILESOURCE_THROTTLE_MS),
-    m_throttleToggle(false)
+    m_throttleToggle(false),
+    m_throttled(true),
+    m_eof(false)
 {
-    assert(m_ifstream != 0);
+    assert(m_mappedFile != 0);
 }
 
 FileSourceThread::~FileSourceThread()
@@ -57,10 +74,6 @@ FileSourceThread::~FileSourceThread()
 		stopWork();
 	}
 
-	if (m_fileBuf != 0) {
-		free(m_fileBuf);
-	}
-
 	if (m_convertBuf != 0) {
 		free(m_convertBuf);
 	}
@@ -70,16 +83,20 @@ void FileSourceThread::startWork()
 {
 	qDebug() << "FileSourceThread::startWork: ";
 
-    if (m_ifstream->is_open())
+    if (m_mappedFile->isOpen())
     {
         qDebug() << "FileSourceThread::startWork: file stream open, starting...";
         m_startWaitMutex.lock();
+        m_eof = false;
         m_elapsedTimer.start();
         start();
         while(!m_running)
             m_startWaiter.wait(&m_startWaitMutex, 100);
         m_startWaitMutex.unlock();
-        connect(&m_timer, SIGNAL(timeout()), this, SLOT(tick()));
+
+        if (m_throttled) {
+            connect(&m_timer, SIGNAL(timeout()), this, SLOT(tick()));
+        }
     }
     else
     {
@@ -93,6 +110,7 @@ void FileSourceThread::stopWork()
 	disconnect(&m_timer, SIGNAL(timeout()), this, SLOT(tick()));
 	m_running = false;
 	wait();
+	m_sampleFifo->flush(); // signal a partial batch left below the wakeup threshold
 }
 
 void FileSourceThread::setSampleRateAndSize(int samplerate, quint32 samplesize)
@@ -112,6 +130,11 @@ void FileSourceThread::setSampleRateAndSize(int samplerate, quint32 samplesize)
 		m_samplerate = samplerate;
 		m_samplesize = samplesize;
 		m_samplebytes = m_samplesize > 16 ? sizeof(int32_t) : sizeof(int16_t);
+
+		if (m_chunks.size() == 0) {
+		    m_fileSamples = (m_mappedFile->size() - m_dataOffset) / (2 * m_samplebytes);
+		}
+
         m_chunksize = (m_samplerate * 2 * m_samplebytes * m_throttlems) / 1000;
 
         setBuffers(m_chunksize);
@@ -120,26 +143,144 @@ void FileSourceThread::setSampleRateAndSize(int samplerate, quint32 samplesize)
 	//m_samplerate = samplerate;
 }
 
-void FileSourceThread::setBuffers(std::size_t chunksize)
+void FileSourceThread::setChunks(const std::vector<FileRecord::IndexEntry>& chunks, const SDRDaemonCodec& codec,
+        quint32 sampleRate, quint64 centerFrequency, quint32 chunkHeaderSize)
 {
-    if (chunksize > m_bufsize)
+    m_chunks = chunks;
+    m_chunkHeaderSize = chunkHeaderSize;
+    m_chunkIndex = 0;
+    m_codec = codec;
+    m_decodeBuf.resize(m_codec.getDecodedBlockSize());
+    m_decodedBlockOffset = -1;
+    m_chunkSampleRate = sampleRate;
+    m_chunkCenterFrequency = centerFrequency;
+    m_fileSamples = m_chunks.size() == 0 ? 0 : m_chunks.back().sampleIndex + m_chunks.back().nbSamples;
+}
+
+unsigned int FileSourceThread::findChunk(quint64 sampleIndex)
+{
+    if ((m_chunkIndex < m_chunks.size())
+     && (sampleIndex >= m_chunks[m_chunkIndex].sampleIndex)
+     && (sampleIndex < m_chunks[m_chunkIndex].sampleIndex + m_chunks[m_chunkIndex].nbSamples))
     {
-        m_bufsize = chunksize;
-        int nbSamples = m_bufsize/(2 * m_samplebytes);
+        return m_chunkIndex; // most of the time
+    }
 
-        if (m_fileBuf == 0)
-        {
-            qDebug() << "FileSourceThread::setBuffers: Allocate file buffer";
-            m_fileBuf = (quint8*) malloc(m_bufsize);
+    unsigned int low = 0;
+    unsigned int high = m_chunks.size();
+
+    while (high - low > 1) // last chunk starting at or before sampleIndex
+    {
+        unsigned int mid = (low + high) / 2;
+
+        if (m_chunks[mid].sampleIndex <= sampleIndex) {
+            low = mid;
+        } else {
+            high = mid;
         }
-        else
+    }
+
+    return low;
+}
+
+qint64 FileSourceThread::getFileOffset(quint64 sampleIndex)
+{
+    if (m_chunks.size() == 0) {
+        return m_dataOffset + sampleIndex * 2 * m_samplebytes;
+    }
+
+    const FileRecord::IndexEntry& chunk = m_chunks[findChunk(sampleIndex)];
+    quint64 chunkSample = sampleIndex - chunk.sampleIndex;
+
+    if (m_codec.getCodecType() == SDRDaemonCodec::CodecNone) {
+        return chunk.offset + m_chunkHeaderSize + chunkSample * 2 * m_samplebytes;
+    } else {
+        return chunk.offset + m_chunkHeaderSize + (chunkSample / m_codec.getNbSamplesPerBlock()) * SDRDaemonNbBytesPerBlock;
+    }
+}
+
+const quint8 *FileSourceThread::getSamples(quint64 sampleIndex, qint64& nbSamples)
+{
+    if (m_chunks.size() == 0) {
+        return m_mappedFile->map(m_dataOffset + sampleIndex * 2 * m_samplebytes, nbSamples * 2 * m_samplebytes);
+    }
+
+    m_chunkIndex = findChunk(sampleIndex);
+    const FileRecord::IndexEntry& chunk = m_chunks[m_chunkIndex];
+
+    if ((chunk.sampleRate != m_chunkSampleRate) || (chunk.centerFrequency != m_chunkCenterFrequency))
+    {
+        if ((m_chunkSampleRate != 0) && (chunk.sampleRate != 0) && (chunk.sampleRate != m_chunkSampleRate)) // keep pace with the new rate
         {
-            qDebug() << "FileSourceThread::setBuffers: Re-allocate file buffer";
-            quint8 *buf = m_fileBuf;
-            m_fileBuf = (quint8*) realloc((void*) m_fileBuf, m_bufsize);
-            if (!m_fileBuf) free(buf);
+            m_samplerate = ((quint64) m_samplerate * chunk.sampleRate) / m_chunkSampleRate;
+            m_chunksize = (m_samplerate * 2 * m_samplebytes * m_throttlems) / 1000;
+            setBuffers(m_chunksize);
         }
 
+        m_chunkSampleRate = chunk.sampleRate;
+        m_chunkCenterFrequency = chunk.centerFrequency;
+        MsgReportChunkChange *message = MsgReportChunkChange::create(m_chunkSampleRate, m_chunkCenterFrequency);
+        m_fileInputMessageQueue->push(message);
+    }
+
+    quint64 chunkSample = sampleIndex - chunk.sampleIndex;
+    nbSamples = std::min((quint64) nbSamples, chunk.nbSamples - chunkSample);
+
+    if (m_codec.getCodecType() == SDRDaemonCodec::CodecNone) {
+        return m_mappedFile->map(chunk.offset + m_chunkHeaderSize + chunkSample * 2 * m_samplebytes, nbSamples * 2 * m_samplebytes);
+    }
+
+    // compressed chunk: decode one block at a time
+    int samplesPerBlock = m_codec.getNbSamplesPerBlock();
+    qint64 blockOffset = chunk.offset + m_chunkHeaderSize + (chunkSample / samplesPerBlock) * SDRDaemonNbBytesPerBlock;
+
+    if (blockOffset != m_decodedBlockOffset)
+    {
+        const quint8 *block = m_mappedFile->map(blockOffset, SDRDaemonNbBytesPerBlock);
+
+        if (!block) {
+            return 0;
+        }
+
+        m_codec.decode(block, m_decodeBuf.data());
+        m_decodedBlockOffset = blockOffset;
+    }
+
+    quint64 blockSample = chunkSample % samplesPerBlock;
+    nbSamples = std::min((quint64) nbSamples, samplesPerBlock - blockSample);
+    return &m_decodeBuf[blockSample * 2 * m_samplebytes];
+}
+
+void FileSourceThread::setSamplesCount(quint64 samplesCount)
+{
+    if (m_running) // the mapped file is used by the reading thread only
+    {
+        m_seekRequest.storeRelease(samplesCount);
+    }
+    else
+    {
+        m_samplesCount = samplesCount;
+        m_seekRequest.storeRelease(-1);
+        m_mappedFile->willNeed(getFileOffset(samplesCount), m_chunksize);
+    }
+}
+
+void FileSourceThread::setLoop(bool loop, quint64 startSample, quint64 endSample)
+{
+    QMutexLocker mutexLocker(&m_loopMutex);
+    m_loop = loop;
+    m_loopStart = startSample;
+    m_loopEnd = endSample;
+}
+
+void FileSourceThread::setBuffers(std::size_t chunksize)
+{
+    // samples are taken directly from the mapped file. A buffer is needed only for sample size conversion.
+    if (chunksize > m_bufsize)
+    {
+        m_bufsize = chunksize;
+        int nbSamples = m_bufsize/(2 * m_samplebytes);
+
         if (m_convertBuf == 0)
         {
             qDebug() << "FileSourceThread::setBuffers: Allocate conversion buffer";
@@ -163,9 +304,20 @@ void FileSourceThread::run()
 	m_running = true;
 	m_startWaiter.wakeAll();
 
-	while(m_running) // actual work is in the tick() function
+	while(m_running)
 	{
-		sleep(1);
+	    if (m_throttled) // actual work is in the tick() function
+	    {
+	        sleep(1);
+	    }
+	    else if (!m_eof && (m_sampleFifo->size() - m_sampleFifo->fill() >= m_chunksize / (2 * m_samplebytes)))
+	    {
+	        readChunk(); // free running: read as long as the FIFO has room for a full chunk
+	    }
+	    else
+	    {
+	        usleep(1000);
+	    }
 	}
 
 	m_running = false;
@@ -185,21 +337,65 @@ void FileSourceThread::tick()
             setBuffers(m_chunksize);
         }
 
-		// read samples directly feeding the SampleFifo (no callback)
-		m_ifstream->read(reinterpret_cast<char*>(m_fileBuf), m_chunksize);
+        readChunk();
+	}
+}
+
+void FileSourceThread::readChunk()
+{
+    qint64 seekRequest = m_seekRequest.fetchAndStoreAcquire(-1); // a request made meanwhile is kept for the next read
 
-        if (m_ifstream->eof())
+    if (seekRequest >= 0)
+    {
+        m_samplesCount = seekRequest;
+        m_mappedFile->willNeed(getFileOffset(m_samplesCount), m_chunksize);
+    }
+
+    // consistent snapshot of the loop settings for this read
+    m_loopMutex.lock();
+    bool loop = m_loop;
+    quint64 loopStart = m_loopStart;
+    quint64 loopEnd = m_loopEnd;
+    m_loopMutex.unlock();
+
+    // feed the SampleFifo directly from the mapped file (no callback)
+    quint64 endSample = loop && (loopEnd != 0) && (loopEnd < m_fileSamples) ? loopEnd : m_fileSamples;
+    loopStart = loopStart < endSample ? loopStart : 0;
+    qint64 nbSamples = m_chunksize / (2 * m_samplebytes);
+
+    while (nbSamples > 0)
+    {
+        if (m_samplesCount >= endSample)
         {
-        	writeToSampleFifo(m_fileBuf, (qint32) m_ifstream->gcount());
-        	MsgReportEOF *message = MsgReportEOF::create();
-        	m_fileInputMessageQueue->push(message);
+            if (loop && (endSample > loopStart)) // wrap around without leaving the thread
+            {
+                m_samplesCount = loopStart;
+                m_mappedFile->willNeed(getFileOffset(m_samplesCount), m_chunksize);
+            }
+            else
+            {
+                m_eof = true;
+                MsgReportEOF *message = MsgReportEOF::create();
+                m_fileInputMessageQueue->push(message);
+                break;
+            }
         }
-        else
+
+        qint64 chunkSamples = std::min((quint64) nbSamples, endSample - m_samplesCount);
+        const quint8 *buf = getSamples(m_samplesCount, chunkSamples); // may give less samples at a chunk or block boundary
+
+        if (!buf) // mapping failed: handle as end of file
         {
-        	writeToSampleFifo(m_fileBuf, (qint32) m_chunksize);
-    		m_samplesCount += m_chunksize / (2 * m_samplebytes);
+            m_eof = true;
+            MsgReportEOF *message = MsgReportEOF::create();
+            m_fileInputMessageQueue->push(message);
+            break;
         }
-	}
+
+        writeToSampleFifo(buf, (qint32) (chunkSamples * 2 * m_samplebytes));
+        m_samplesCount += chunkSamples;
+        nbSamples -= chunkSamples;
+    }
 }
 
 void FileSourceThread::writeToSampleFifo(const quint8* buf, qint32 nbBytes)
@@ -246,4 +442,18 @@ void FileSourceThread::writeToSampleFifo(const quint8* buf, qint32 nbBytes)
 			m_sampleFifo->write((quint8*) convertBuf, nbSamples*sizeof(Sample));
 		}
 	}
+	else if (m_samplesize == 32) // full scale 32 bit samples from other tools
+	{
+		FixReal *convertBuf = (FixReal *) m_convertBuf;
+		const int32_t *fileBuf = (int32_t *) buf;
+		int nbSamples = nbBytes / (2 * m_samplebytes);
+
+		for (int is = 0; is < nbSamples; is++)
+		{
+			convertBuf[2*is]   = fileBuf[2*is] >> (32 - SDR_RX_SAMP_SZ);
+			convertBuf[2*is+1] = fileBuf[2*is+1] >> (32 - SDR_RX_SAMP_SZ);
+		}
+
+		m_sampleFifo->write((quint8*) convertBuf, nbSamples*sizeof(Sample));
+	}
 }
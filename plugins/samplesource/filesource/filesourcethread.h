@@ -22,17 +22,20 @@
 #include <QWaitCondition>
 #include <QTimer>
 #include <QElapsedTimer>
-#include <iostream>
-#include <fstream>
+#include <QAtomicInteger>
 #include <cstdlib>
+#include <vector>
 
 #include "dsp/inthalfbandfilter.h"
+#include "dsp/filerecord.h"
+#include "channel/sdrdaemoncodec.h"
 #include "util/message.h"
 
 #define FILESOURCE_THROTTLE_MS 50
 
 class SampleSinkFifo;
 class MessageQueue;
+class MappedFile;
 
 class FileSourceThread : public QThread {
 	Q_OBJECT
@@ -55,7 +58,32 @@ public:
         { }
     };
 
-	FileSourceThread(std::ifstream *samplesStream,
+    /** Playback entered a chunk with a different sample rate or center frequency (.sdriq v2) */
+    class MsgReportChunkChange : public Message {
+        MESSAGE_CLASS_DECLARATION
+
+    public:
+        quint32 getSampleRate() const { return m_sampleRate; }
+        quint64 getCenterFrequency() const { return m_centerFrequency; }
+
+        static MsgReportChunkChange* create(quint32 sampleRate, quint64 centerFrequency)
+        {
+            return new MsgReportChunkChange(sampleRate, centerFrequency);
+        }
+
+    private:
+        quint32 m_sampleRate;
+        quint64 m_centerFrequency;
+
+        MsgReportChunkChange(quint32 sampleRate, quint64 centerFrequency) :
+            Message(),
+            m_sampleRate(sampleRate),
+            m_centerFrequency(centerFrequency)
+        { }
+    };
+
+	FileSourceThread(MappedFile *mappedFile,
+	        qint64 dataOffset,
 	        SampleSinkFifo* sampleFifo,
 	        const QTimer& timer,
 	        MessageQueue *fileInputMessageQueue,
@@ -65,36 +93,66 @@ public:
 	void startWork();
 	void stopWork();
 	void setSampleRateAndSize(int samplerate, quint32 samplesize);
+    /** Play a .sdriq v2 file made of these data chunks. Sample rate and center frequency are the ones
+     *  currently in use so that a change is reported when playback enters a chunk with different values.
+     *  Chunk samples start chunkHeaderSize bytes after the chunk offset (0 for SigMF capture segments). */
+    void setChunks(const std::vector<FileRecord::IndexEntry>& chunks, const SDRDaemonCodec& codec,
+            quint32 sampleRate, quint64 centerFrequency, quint32 chunkHeaderSize = sizeof(FileRecord::ChunkHeader));
     void setBuffers(std::size_t chunksize);
+    void setThrottled(bool throttled) { m_throttled = throttled; } //!< when false read as fast as the FIFO drains (takes effect at next start)
 	bool isRunning() const { return m_running; }
     quint64 getSamplesCount() const { return m_samplesCount; }
-    void setSamplesCount(quint64 samplesCount) { m_samplesCount = samplesCount; }
+    void setSamplesCount(quint64 samplesCount); //!< seek to this sample. Takes effect at next read when running.
+    /** Play samples [startSample, endSample[ in loop. endSample 0 is the end of file. */
+    void setLoop(bool loop, quint64 startSample, quint64 endSample);
 
 private:
 	QMutex m_startWaitMutex;
 	QWaitCondition m_startWaiter;
 	volatile bool m_running;
 
-	std::ifstream* m_ifstream;
-	quint8  *m_fileBuf;
+	MappedFile *m_mappedFile;
+	qint64 m_dataOffset;   //!< file offset of the first sample
+	quint64 m_fileSamples; //!< number of I/Q samples in the file
 	quint8  *m_convertBuf;
 	std::size_t m_bufsize;
     qint64 m_chunksize;
 	SampleSinkFifo* m_sampleFifo;
-    quint64 m_samplesCount;
+    quint64 m_samplesCount; //!< current I/Q sample position in file
+    QAtomicInteger<qint64> m_seekRequest; //!< sample position to seek to at next read or -1
+    QMutex m_loopMutex;    //!< loop settings are changed from the input thread while reading
+    bool m_loop;
+    quint64 m_loopStart;   //!< first I/Q sample played in loop
+    quint64 m_loopEnd;     //!< I/Q sample after the last one played in loop. 0 is end of file.
     const QTimer& m_timer;
     MessageQueue *m_fileInputMessageQueue;
 
+    // .sdriq v2 and SigMF files
+    std::vector<FileRecord::IndexEntry> m_chunks; //!< data chunks or capture segments. Empty for v1 files.
+    quint32 m_chunkHeaderSize;        //!< bytes before the samples of a chunk
+    unsigned int m_chunkIndex;        //!< chunk being played
+    SDRDaemonCodec m_codec;           //!< compressed chunks decoder
+    std::vector<quint8> m_decodeBuf;  //!< decoded block of a compressed chunk
+    qint64 m_decodedBlockOffset;      //!< file offset of the block in decode buffer or -1
+    quint32 m_chunkSampleRate;        //!< sample rate currently in use
+    quint64 m_chunkCenterFrequency;   //!< center frequency currently in use
+
 	int m_samplerate;      //!< File I/Q stream original sample rate
-    quint64 m_samplesize;  //!< File effective sample size in bits (I or Q). Ex: 16, 24.
+    quint64 m_samplesize;  //!< File effective sample size in bits (I or Q). Ex: 16, 24, 32.
     quint64 m_samplebytes; //!< Number of bytes used to store a I or Q sample. Ex: 2. 4.
     qint64 m_throttlems;
     QElapsedTimer m_elapsedTimer;
     bool m_throttleToggle;
+    bool m_throttled;      //!< Paced by the master timer else free running
+    volatile bool m_eof;
 
 	void run();
 	//void decimate1(SampleVector::iterator* it, const qint16* buf, qint32 len);
 	void writeToSampleFifo(const quint8* buf, qint32 nbBytes);
+	void readChunk();
+	const quint8 *getSamples(quint64 sampleIndex, qint64& nbSamples);
+	unsigned int findChunk(quint64 sampleIndex);
+	qint64 getFileOffset(quint64 sampleIndex);
 private slots:
 	void tick();
 };
@@ -1500,6 +1500,8 @@ int LimeSDRInput::webapiReportGet(
     response.setLimeSdrInputReport(new SWGSDRangel::SWGLimeSdrInputReport());
     response.getLimeSdrInputReport()->init();
     webapiFormatDeviceReport(response);
+    response.setFileRecordReport(new SWGSDRangel::SWGFileRecordReport());
+    m_fileSink->webapiFormatReport(*response.getFileRecordReport());
     return 200;
 }
 
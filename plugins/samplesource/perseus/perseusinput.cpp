@@ -505,6 +505,8 @@ int PerseusInput::webapiReportGet(
     response.setPerseusReport(new SWGSDRangel::SWGPerseusReport());
     response.getPerseusReport()->init();
     webapiFormatDeviceReport(response);
+    response.setFileRecordReport(new SWGSDRangel::SWGFileRecordReport());
+    m_fileSink->webapiFormatReport(*response.getFileRecordReport());
     return 200;
 }
 
@@ -747,6 +747,8 @@ int PlutoSDRInput::webapiReportGet(
     response.setPlutoSdrInputReport(new SWGSDRangel::SWGPlutoSdrInputReport());
     response.getPlutoSdrInputReport()->init();
     webapiFormatDeviceReport(response);
+    response.setFileRecordReport(new SWGSDRangel::SWGFileRecordReport());
+    m_fileSink->webapiFormatReport(*response.getFileRecordReport());
     return 200;
 }
 
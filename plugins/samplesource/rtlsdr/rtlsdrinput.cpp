@@ -689,6 +689,8 @@ int RTLSDRInput::webapiReportGet(
     response.setRtlSdrReport(new SWGSDRangel::SWGRtlSdrReport());
     response.getRtlSdrReport()->init();
     webapiFormatDeviceReport(response);
+    response.setFileRecordReport(new SWGSDRangel::SWGFileRecordReport());
+    m_fileSink->webapiFormatReport(*response.getFileRecordReport());
     return 200;
 }
 
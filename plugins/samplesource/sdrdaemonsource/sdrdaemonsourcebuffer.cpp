@@ -15,6 +15,7 @@
 ///////////////////////////////////////////////////////////////////////////////////
 
 #include <QDebug>
+#include <QElapsedTimer>
 #include <cassert>
 #include <cstring>
 #include <cmath>
@@ -26,6 +27,8 @@
 
 
 SDRdaemonSourceBuffer::SDRdaemonSourceBuffer() :
+        m_decodedFrames(0),
+        m_frameNbBytes(sizeof(BufferFrame)),
         m_decoderIndexHead(nbDecoderSlots/2),
         m_frameHead(0),
         m_curNbBlocks(0),
@@ -42,22 +45,34 @@ SDRdaemonSourceBuffer::SDRdaemonSourceBuffer() :
         m_nbReads(0),
         m_nbWrites(0),
         m_balCorrection(0),
-	    m_balCorrLimit(0)
+	    m_balCorrLimit(0),
+        m_decoderPool(SDRDAEMONSOURCE_NBDECODERS)
 {
 	m_currentMeta.init();
-	m_framesNbBytes = nbDecoderSlots * sizeof(BufferFrame);
+	m_framesNbBytes = nbDecoderSlots * m_frameNbBytes;
 	m_wrDeltaEstimate = m_framesNbBytes / 2;
 	m_tvOut_sec = 0;
 	m_tvOut_usec = 0;
 	m_readNbBytes = 1;
-    m_paramsCM256.BlockBytes = sizeof(SDRDaemonProtectedBlock); // never changes
-    m_paramsCM256.OriginalCount = SDRDaemonNbOrginalBlocks;  // never changes
+    m_cm256_OK = true;
 
-    if (!m_cm256.isInitialized()) {
-        m_cm256_OK = false;
+    for (int i = 0; i < SDRDAEMONSOURCE_NBDECODERS; i++)
+    {
+        if (!m_cm256[i].isInitialized()) {
+            m_cm256_OK = false;
+        }
+    }
+
+    if (!m_cm256_OK) {
         qDebug() << "SDRdaemonSourceBuffer::SDRdaemonSourceBuffer: cannot initialize CM256 library";
-    } else {
-        m_cm256_OK = true;
+    }
+
+    for (int i = 0; i < nbDecoderSlots; i++)
+    {
+        m_decodeJobs[i].m_buffer = this;
+        m_decodeJobs[i].m_slotIndex = i;
+        m_decodeJobs[i].m_paramsCM256.BlockBytes = sizeof(SDRDaemonProtectedBlock); // never changes
+        m_decodeJobs[i].m_paramsCM256.OriginalCount = SDRDaemonNbOrginalBlocks;  // never changes
     }
 
     std::fill(m_decoderSlots, m_decoderSlots + nbDecoderSlots, DecoderSlot());
@@ -69,10 +84,16 @@ SDRdaemonSourceBuffer::~SDRdaemonSourceBuffer()
 	if (m_readBuffer) {
 		delete[] m_readBuffer;
 	}
+
+	delete[] m_decodedFrames;
 }
 
 void SDRdaemonSourceBuffer::initDecodeAllSlots()
 {
+    for (int i = 0; i < nbDecoderSlots; i++) {
+        waitDecodedSlot(i);
+    }
+
     for (int i = 0; i < nbDecoderSlots; i++)
     {
         m_decoderSlots[i].m_blockCount = 0;
@@ -123,7 +144,7 @@ void SDRdaemonSourceBuffer::initDecodeSlot(int slotIndex)
 
 void SDRdaemonSourceBuffer::initReadIndex()
 {
-    m_readIndex = ((m_decoderIndexHead + (nbDecoderSlots/2)) % nbDecoderSlots) * sizeof(BufferFrame);
+    m_readIndex = ((m_decoderIndexHead + (nbDecoderSlots/2)) % nbDecoderSlots) * m_frameNbBytes;
     m_wrDeltaEstimate = m_framesNbBytes / 2;
     m_nbReads = 0;
     m_nbWrites = 0;
@@ -134,22 +155,22 @@ void SDRdaemonSourceBuffer::rwCorrectionEstimate(int slotIndex)
 	if (m_nbReads >= 40) // check every ~1s as tick is ~50ms
 	{
 		int targetPivotSlot = (slotIndex + (nbDecoderSlots/2))  % nbDecoderSlots; // slot at half buffer opposite of current write slot
-		int targetPivotIndex = targetPivotSlot * sizeof(BufferFrame);             // buffer index corresponding to start of above slot
-		int normalizedReadIndex = (m_readIndex < targetPivotIndex ? m_readIndex + nbDecoderSlots * sizeof(BufferFrame) :  m_readIndex)
-				- (targetPivotSlot * sizeof(BufferFrame)); // normalize read index so it is positive and zero at start of pivot slot
+		int targetPivotIndex = targetPivotSlot * m_frameNbBytes;                  // buffer index corresponding to start of above slot
+		int normalizedReadIndex = (m_readIndex < targetPivotIndex ? m_readIndex + nbDecoderSlots * m_frameNbBytes :  m_readIndex)
+				- (targetPivotSlot * m_frameNbBytes); // normalize read index so it is positive and zero at start of pivot slot
 		int dBytes;
-        int rwDelta = (m_nbReads * m_readNbBytes) - (m_nbWrites * sizeof(BufferFrame));
+        int rwDelta = (m_nbReads * m_readNbBytes) - (m_nbWrites * m_frameNbBytes);
 
-		if (normalizedReadIndex < (nbDecoderSlots/ 2) * (int) sizeof(BufferFrame)) // read leads
+		if (normalizedReadIndex < (nbDecoderSlots/ 2) * m_frameNbBytes) // read leads
 		{
 			dBytes = - normalizedReadIndex - rwDelta;
 		}
 		else // read lags
 		{
-			dBytes = (nbDecoderSlots * sizeof(BufferFrame)) - normalizedReadIndex - rwDelta;
+			dBytes = (nbDecoderSlots * m_frameNbBytes) - normalizedReadIndex - rwDelta;
 		}
 
-        m_balCorrection = (m_balCorrection / 4) + (dBytes / (int) (m_currentMeta.m_sampleBytes * 2 * m_nbReads)); // correction is in number of samples. Alpha = 0.25
+        m_balCorrection = (m_balCorrection / 4) + (dBytes / (int) (m_currentMeta.getSampleBytes() * 2 * m_nbReads)); // correction is in number of samples. Alpha = 0.25
 
         if (m_balCorrection < -m_balCorrLimit) {
             m_balCorrection = -m_balCorrLimit;
@@ -164,17 +185,17 @@ void SDRdaemonSourceBuffer::rwCorrectionEstimate(int slotIndex)
 
 void SDRdaemonSourceBuffer::checkSlotData(int slotIndex)
 {
-    int pseudoWriteIndex = slotIndex * sizeof(BufferFrame);
+    int pseudoWriteIndex = slotIndex * m_frameNbBytes;
     m_wrDeltaEstimate = pseudoWriteIndex - m_readIndex;
     m_nbWrites++;
 
-    int rwDelayBytes = (m_wrDeltaEstimate > 0 ? m_wrDeltaEstimate : sizeof(BufferFrame) * nbDecoderSlots + m_wrDeltaEstimate);
+    int rwDelayBytes = (m_wrDeltaEstimate > 0 ? m_wrDeltaEstimate : m_framesNbBytes + m_wrDeltaEstimate);
     int sampleRate = m_currentMeta.m_sampleRate;
 
     if (sampleRate > 0)
     {
         int64_t ts = m_currentMeta.m_tv_sec * 1000000LL + m_currentMeta.m_tv_usec;
-        ts -= (rwDelayBytes * 1000000LL) / (sampleRate * 2 * m_currentMeta.m_sampleBytes);
+        ts -= (rwDelayBytes * 1000000LL) / (sampleRate * 2 * m_currentMeta.getSampleBytes());
         m_tvOut_sec = ts / 1000000LL;
         m_tvOut_usec = ts - (m_tvOut_sec * 1000000LL);
     }
@@ -194,6 +215,23 @@ void SDRdaemonSourceBuffer::writeData(char *array)
     int frameIndex = superBlock->m_header.m_frameIndex;
     int decoderIndex = frameIndex % nbDecoderSlots;
 
+    collectDecodedSlots(); // hand over the frames decoded so far in frame order
+
+    // sample codec change
+
+    SDRDaemonCodec codec;
+    codec.setCodec((SDRDaemonCodec::CodecType) superBlock->m_header.m_codec, superBlock->m_header.m_codecBits, superBlock->m_header.m_sampleBytes);
+
+    if (codec != m_codec) // samples buffer geometry changes => restart from initial state
+    {
+        for (int i = 0; i < nbDecoderSlots; i++) {
+            waitDecodedSlot(i);
+        }
+
+        setCodec(codec);
+        m_frameHead = -1;
+    }
+
     // frame break
 
     if (m_frameHead == -1) // initial state
@@ -205,8 +243,22 @@ void SDRdaemonSourceBuffer::writeData(char *array)
     }
     else if (m_frameHead != frameIndex) // frame break => new frame starts
     {
+        if ((m_codec.getCodecType() != SDRDaemonCodec::CodecNone) && !m_decoderSlots[m_decoderIndexHead].m_decoded)
+        {
+            // previous frame is incomplete and was not pushed to the decoders: decompress blocks received so far
+            const SDRDaemonProtectedBlock *blocks[SDRDaemonNbOrginalBlocks];
+
+            for (int i = 1; i < SDRDaemonNbOrginalBlocks; i++) {
+                blocks[i] = &m_frames[m_decoderIndexHead].m_blocks[i - 1];
+            }
+
+            qint64 decompressNs = decompressSlot(m_decoderIndexHead, blocks);
+            m_avgDecompressNs(decompressNs / (double) ((SDRDaemonNbOrginalBlocks - 1) * m_codec.getNbSamplesPerBlock()));
+        }
+
         m_decoderIndexHead = decoderIndex; // new decoder slot head
         m_frameHead = frameIndex;          // new frame head
+        waitDecodedSlot(decoderIndex);     // slot must be out of the decoders before re-use
         checkSlotData(decoderIndex);       // check slot before re-init
         rwCorrectionEstimate(decoderIndex);
         initDecodeSlot(decoderIndex);      // collect stats and re-initialize current slot
@@ -244,98 +296,216 @@ void SDRdaemonSourceBuffer::writeData(char *array)
     if (m_decoderSlots[decoderIndex].m_blockCount == SDRDaemonNbOrginalBlocks) // ready to decode
     {
         m_decoderSlots[decoderIndex].m_decoded = true;
+        pushDecodeSlot(decoderIndex);
+    }
+}
+
+void SDRdaemonSourceBuffer::pushDecodeSlot(int slotIndex)
+{
+    DecodeJob& decodeJob = m_decodeJobs[slotIndex];
+    decodeJob.m_fec = m_cm256_OK && (m_decoderSlots[slotIndex].m_recoveryCount > 0); // recovery data used => need to decode FEC
 
-        if (m_cm256_OK && (m_decoderSlots[decoderIndex].m_recoveryCount > 0)) // recovery data used => need to decode FEC
+    if (decodeJob.m_fec)
+    {
+        if (m_decoderSlots[slotIndex].m_metaRetrieved) {
+            decodeJob.m_paramsCM256.RecoveryCount = getMetaData(slotIndex)->m_nbFECBlocks;
+        } else {
+            decodeJob.m_paramsCM256.RecoveryCount = m_decoderSlots[slotIndex].m_recoveryCount;
+        }
+    }
+
+    m_decoderSlots[slotIndex].m_decodePending = true;
+    m_decoderPool.push(&decodeJob);
+}
+
+bool SDRdaemonSourceBuffer::DecodeJob::process(unsigned int workerIndex)
+{
+    DecoderSlot& decoderSlot = m_buffer->m_decoderSlots[m_slotIndex];
+    m_decompressNs = 0;
+
+    if (m_fec) {
+        m_result = m_buffer->m_cm256[workerIndex].cm256_decode(m_paramsCM256, decoderSlot.m_cm256DescriptorBlocks);
+    }
+
+    if (m_buffer->m_codec.getCodecType() == SDRDaemonCodec::CodecNone) {
+        return m_fec;
+    }
+
+    // recovered blocks are taken in place from the recovery blocks. They are stored in the frame later on.
+    const SDRDaemonProtectedBlock *blocks[SDRDaemonNbOrginalBlocks];
+
+    for (int i = 1; i < SDRDaemonNbOrginalBlocks; i++) {
+        blocks[i] = &m_buffer->m_frames[m_slotIndex].m_blocks[i - 1];
+    }
+
+    if (m_fec && (m_result == 0))
+    {
+        for (int ir = 0; ir < decoderSlot.m_recoveryCount; ir++)
         {
-            m_paramsCM256.BlockBytes = sizeof(SDRDaemonProtectedBlock); // never changes
-            m_paramsCM256.OriginalCount = SDRDaemonNbOrginalBlocks;  // never changes
+            int recoveryIndex = SDRDaemonNbOrginalBlocks - decoderSlot.m_recoveryCount + ir;
+            int blockIndex = decoderSlot.m_cm256DescriptorBlocks[recoveryIndex].Index;
 
-            if (m_decoderSlots[decoderIndex].m_metaRetrieved) {
-                m_paramsCM256.RecoveryCount = m_currentMeta.m_nbFECBlocks;
-            } else {
-                m_paramsCM256.RecoveryCount = m_decoderSlots[decoderIndex].m_recoveryCount;
+            if ((blockIndex > 0) && (blockIndex < SDRDaemonNbOrginalBlocks)) {
+                blocks[blockIndex] = (const SDRDaemonProtectedBlock *) decoderSlot.m_cm256DescriptorBlocks[recoveryIndex].Block;
             }
+        }
+    }
 
-            if (m_cm256.cm256_decode(m_paramsCM256, m_decoderSlots[decoderIndex].m_cm256DescriptorBlocks)) // CM256 decode
-            {
-                qDebug() << "SDRdaemonSourceBuffer::writeData: decode CM256 error:"
-                        << " decoderIndex: " << decoderIndex
-                        << " m_blockCount: " << m_decoderSlots[decoderIndex].m_blockCount
-                        << " m_originalCount: " << m_decoderSlots[decoderIndex].m_originalCount
-                        << " m_recoveryCount: " << m_decoderSlots[decoderIndex].m_recoveryCount;
-            }
-            else
-            {
-                qDebug() << "SDRdaemonSourceBuffer::writeData: decode CM256 success:"
-                        << " decoderIndex: " << decoderIndex
-                        << " m_blockCount: " << m_decoderSlots[decoderIndex].m_blockCount
-                        << " m_originalCount: " << m_decoderSlots[decoderIndex].m_originalCount
-                        << " m_recoveryCount: " << m_decoderSlots[decoderIndex].m_recoveryCount;
+    m_decompressNs = m_buffer->decompressSlot(m_slotIndex, blocks);
+    return true;
+}
 
-                for (int ir = 0; ir < m_decoderSlots[decoderIndex].m_recoveryCount; ir++) // restore missing blocks
-                {
-                    int recoveryIndex = SDRDaemonNbOrginalBlocks - m_decoderSlots[decoderIndex].m_recoveryCount + ir;
-                    int blockIndex = m_decoderSlots[decoderIndex].m_cm256DescriptorBlocks[recoveryIndex].Index;
-                    SDRDaemonProtectedBlock *recoveredBlock = (SDRDaemonProtectedBlock *) m_decoderSlots[decoderIndex].m_cm256DescriptorBlocks[recoveryIndex].Block;
+qint64 SDRdaemonSourceBuffer::decompressSlot(int slotIndex, const SDRDaemonProtectedBlock **blocks)
+{
+    QElapsedTimer timer;
+    timer.start();
+    int decodedBlockSize = m_codec.getDecodedBlockSize();
+    uint8_t *frame = &m_decodedFrames[slotIndex * m_frameNbBytes];
 
-                    if (blockIndex == 0) // first block with meta
-                    {
-                        SDRDaemonMetaDataFEC *metaData = (SDRDaemonMetaDataFEC *) recoveredBlock;
-
-                        boost::crc_32_type crc32;
-                        crc32.process_bytes(metaData, 20);
-
-                        if (crc32.checksum() == metaData->m_crc32)
-                        {
-                            m_decoderSlots[decoderIndex].m_metaRetrieved = true;
-                            printMeta("SDRdaemonSourceBuffer::writeData: recovered meta", metaData);
-                        }
-                        else
-                        {
-                            qDebug() << "SDRdaemonSourceBuffer::writeData: recovered meta: invalid CRC32";
-                        }
-                    }
+    for (int i = 1; i < SDRDaemonNbOrginalBlocks; i++) {
+        m_codec.decode(blocks[i]->buf, &frame[(i - 1) * decodedBlockSize]);
+    }
 
-                    storeOriginalBlock(decoderIndex, blockIndex, *recoveredBlock);
+    return timer.nsecsElapsed();
+}
 
-                    qDebug() << "SDRdaemonSourceBuffer::writeData: recovered block #" << blockIndex;
-                } // restore missing blocks
-            } // CM256 decode
-        } // recovery
+void SDRdaemonSourceBuffer::setCodec(const SDRDaemonCodec& codec)
+{
+    m_codec = codec;
+    delete[] m_decodedFrames;
+    m_decodedFrames = 0;
+
+    if (m_codec.getCodecType() == SDRDaemonCodec::CodecNone)
+    {
+        m_frameNbBytes = sizeof(BufferFrame);
+    }
+    else
+    {
+        m_frameNbBytes = (SDRDaemonNbOrginalBlocks - 1) * m_codec.getDecodedBlockSize();
+        m_decodedFrames = new uint8_t[nbDecoderSlots * m_frameNbBytes];
+        std::fill(m_decodedFrames, m_decodedFrames + nbDecoderSlots * m_frameNbBytes, 0);
+    }
 
-        if (m_decoderSlots[decoderIndex].m_metaRetrieved) // block zero with its meta data has been received
+    m_framesNbBytes = nbDecoderSlots * m_frameNbBytes;
+    m_avgDecompressNs.reset();
+
+    if (m_currentMeta.m_sampleRate != 0) {
+        m_bufferLenSec = (float) m_framesNbBytes / (float) (m_currentMeta.m_sampleRate * m_codec.getSampleBytes() * 2);
+    }
+
+    qDebug() << "SDRdaemonSourceBuffer::setCodec:"
+            << " codec: " << (int) m_codec.getCodecType()
+            << " nbBits: " << m_codec.getNbBits()
+            << " sampleBytes: " << m_codec.getSampleBytes()
+            << " compression ratio: " << m_codec.getCompressionRatio()
+            << " m_framesNbBytes: " << m_framesNbBytes;
+}
+
+void SDRdaemonSourceBuffer::collectDecodedSlots()
+{
+    OrderedWorkerPool::Job *job;
+
+    while ((job = m_decoderPool.popProcessed()) != 0) {
+        finalizeDecodeSlot(((DecodeJob *) job)->m_slotIndex);
+    }
+}
+
+void SDRdaemonSourceBuffer::waitDecodedSlot(int slotIndex)
+{
+    while (m_decoderSlots[slotIndex].m_decodePending) {
+        finalizeDecodeSlot(((DecodeJob *) m_decoderPool.popWait())->m_slotIndex);
+    }
+}
+
+void SDRdaemonSourceBuffer::finalizeDecodeSlot(int decoderIndex)
+{
+    m_decoderSlots[decoderIndex].m_decodePending = false;
+
+    if (m_decodeJobs[decoderIndex].m_decompressNs > 0) {
+        m_avgDecompressNs(m_decodeJobs[decoderIndex].m_decompressNs / (double) ((SDRDaemonNbOrginalBlocks - 1) * m_codec.getNbSamplesPerBlock()));
+    }
+
+    if (m_decodeJobs[decoderIndex].m_fec) // recovery data used => FEC decoded
+    {
+        if (m_decodeJobs[decoderIndex].m_result) // CM256 decode
+        {
+            qDebug() << "SDRdaemonSourceBuffer::finalizeDecodeSlot: decode CM256 error:"
+                    << " decoderIndex: " << decoderIndex
+                    << " m_blockCount: " << m_decoderSlots[decoderIndex].m_blockCount
+                    << " m_originalCount: " << m_decoderSlots[decoderIndex].m_originalCount
+                    << " m_recoveryCount: " << m_decoderSlots[decoderIndex].m_recoveryCount;
+        }
+        else
         {
-            SDRDaemonMetaDataFEC *metaData = getMetaData(decoderIndex);
+            qDebug() << "SDRdaemonSourceBuffer::finalizeDecodeSlot: decode CM256 success:"
+                    << " decoderIndex: " << decoderIndex
+                    << " m_blockCount: " << m_decoderSlots[decoderIndex].m_blockCount
+                    << " m_originalCount: " << m_decoderSlots[decoderIndex].m_originalCount
+                    << " m_recoveryCount: " << m_decoderSlots[decoderIndex].m_recoveryCount;
 
-            if (!(*metaData == m_currentMeta))
+            for (int ir = 0; ir < m_decoderSlots[decoderIndex].m_recoveryCount; ir++) // restore missing blocks
             {
-                uint32_t sampleRate =  metaData->m_sampleRate;
+                int recoveryIndex = SDRDaemonNbOrginalBlocks - m_decoderSlots[decoderIndex].m_recoveryCount + ir;
+                int blockIndex = m_decoderSlots[decoderIndex].m_cm256DescriptorBlocks[recoveryIndex].Index;
+                SDRDaemonProtectedBlock *recoveredBlock = (SDRDaemonProtectedBlock *) m_decoderSlots[decoderIndex].m_cm256DescriptorBlocks[recoveryIndex].Block;
 
-                if (sampleRate != 0)
+                if (blockIndex == 0) // first block with meta
                 {
-                    m_bufferLenSec = (float) m_framesNbBytes / (float) (sampleRate * metaData->m_sampleBytes * 2);
-                    m_balCorrLimit = sampleRate / 1000; // +/- 1 ms correction max per read
-                    m_readNbBytes = (sampleRate * metaData->m_sampleBytes * 2) / 20;
+                    SDRDaemonMetaDataFEC *metaData = (SDRDaemonMetaDataFEC *) recoveredBlock;
+
+                    boost::crc_32_type crc32;
+                    crc32.process_bytes(metaData, 20);
+
+                    if (crc32.checksum() == metaData->m_crc32)
+                    {
+                        m_decoderSlots[decoderIndex].m_metaRetrieved = true;
+                        printMeta("SDRdaemonSourceBuffer::finalizeDecodeSlot: recovered meta", metaData);
+                    }
+                    else
+                    {
+                        qDebug() << "SDRdaemonSourceBuffer::finalizeDecodeSlot: recovered meta: invalid CRC32";
+                    }
                 }
 
-                printMeta("SDRdaemonSourceBuffer::writeData: new meta", metaData); // print for change other than timestamp
+                storeOriginalBlock(decoderIndex, blockIndex, *recoveredBlock);
+
+                qDebug() << "SDRdaemonSourceBuffer::finalizeDecodeSlot: recovered block #" << blockIndex;
+            } // restore missing blocks
+        } // CM256 decode
+    } // recovery
+
+    if (m_decoderSlots[decoderIndex].m_metaRetrieved) // block zero with its meta data has been received
+    {
+        SDRDaemonMetaDataFEC *metaData = getMetaData(decoderIndex);
+
+        if (!(*metaData == m_currentMeta))
+        {
+            uint32_t sampleRate =  metaData->m_sampleRate;
+
+            if (sampleRate != 0)
+            {
+                m_bufferLenSec = (float) m_framesNbBytes / (float) (sampleRate * metaData->getSampleBytes() * 2);
+                m_balCorrLimit = sampleRate / 1000; // +/- 1 ms correction max per read
+                m_readNbBytes = (sampleRate * metaData->getSampleBytes() * 2) / 20;
             }
 
-            m_currentMeta = *metaData; // renew current meta
-        } // check block 0
-    } // decode
+            printMeta("SDRdaemonSourceBuffer::finalizeDecodeSlot: new meta", metaData); // print for change other than timestamp
+        }
+
+        m_currentMeta = *metaData; // renew current meta
+    } // check block 0
 }
 
 uint8_t *SDRdaemonSourceBuffer::readData(int32_t length)
 {
-    uint8_t *buffer = (uint8_t *) m_frames;
+    uint8_t *buffer = m_decodedFrames ? m_decodedFrames : (uint8_t *) m_frames;
     uint32_t readIndex = m_readIndex;
 
     m_nbReads++;
 
     // SEGFAULT FIX: arbitratily truncate so that it does not exceed buffer length
-    if (length > framesSize) {
-        length = framesSize;
+    if (length > m_framesNbBytes) {
+        length = m_framesNbBytes;
     }
 
     if (m_readIndex + length < m_framesNbBytes) // ends before buffer bound
@@ -375,6 +545,7 @@ void SDRdaemonSourceBuffer::printMeta(const QString& header, SDRDaemonMetaDataFE
             << ":" << metaData->m_sampleRate
             << ":" << (int) (metaData->m_sampleBytes & 0xF)
             << ":" << (int) metaData->m_sampleBits
+            << ":" << metaData->getNbBlocksPerDatagram()
             << ":" << (int) metaData->m_nbOriginalBlocks
             << ":" << (int) metaData->m_nbFECBlocks
             << "|" << metaData->m_tv_sec
@@ -22,12 +22,15 @@
 #include <cstdlib>
 #include "cm256.h"
 #include "util/movingaverage.h"
+#include "util/orderedworkerpool.h"
 #include "channel/sdrdaemondatablock.h"
+#include "channel/sdrdaemoncodec.h"
 
 
 #define SDRDAEMONSOURCE_UDPSIZE 512               // UDP payload size
 #define SDRDAEMONSOURCE_NBORIGINALBLOCKS 128      // number of sample blocks per frame excluding FEC blocks
 #define SDRDAEMONSOURCE_NBDECODERSLOTS 16         // power of two sub multiple of uint16_t size. A too large one is superfluous.
+#define SDRDAEMONSOURCE_NBDECODERS 4              // maximum number of concurrent FEC decoders
 
 class SDRdaemonSourceBuffer
 {
@@ -77,6 +80,10 @@ public:
         return maxNbRecovery;
     }
 
+    unsigned int getNbDecoders() const { return m_decoderPool.getNbWorkers(); }
+    int getAvgDecodeTimeUs() const { return m_decoderPool.getAvgProcessTimeUs(); }
+    int getMaxDecodeTimeUs() { return m_decoderPool.getMaxProcessTimeUs(); }
+
     bool allFramesDecoded()
     {
         bool framesDecoded = m_framesDecoded;
@@ -84,6 +91,9 @@ public:
         return framesDecoded;
     }
 
+    float getCompressionRatio() const { return m_codec.getCompressionRatio(); }
+    double getAvgDecompressNsPerSample() const { return m_avgDecompressNs.asDouble(); }
+
     float getBufferLengthInSecs() const { return m_bufferLenSec; }
     int32_t getRWBalanceCorrection() const { return m_balCorrection; }
 
@@ -105,8 +115,6 @@ public:
         }
     }
 
-    static const int framesSize = SDRDAEMONSOURCE_NBDECODERSLOTS * (SDRDaemonNbOrginalBlocks - 1) * SDRDaemonNbBytesPerBlock;
-
 private:
     static const int nbDecoderSlots = SDRDAEMONSOURCE_NBDECODERSLOTS;
 
@@ -128,13 +136,31 @@ private:
         int                     m_recoveryCount;      //!< number of recovery blocks received
         bool                    m_decoded;            //!< true if decoded
         bool                    m_metaRetrieved;      //!< true if meta data (block zero) was retrieved
+        bool                    m_decodePending;      //!< true if the frame is in the decoder pool
+    };
+
+    /** FEC decodes and decompresses a complete frame of a decoder slot in a pool thread */
+    class DecodeJob : public OrderedWorkerPool::Job
+    {
+    public:
+        DecodeJob() : m_buffer(0), m_slotIndex(0), m_fec(false), m_result(0), m_decompressNs(0) {}
+        virtual bool process(unsigned int workerIndex);
+
+        SDRdaemonSourceBuffer      *m_buffer;
+        int                         m_slotIndex;
+        bool                        m_fec;          //!< true if recovery data was used and FEC decoding is needed
+        CM256::cm256_encoder_params m_paramsCM256;  //!< CM256 decoder parameters block
+        int                         m_result;       //!< CM256 decoder return code
+        qint64                      m_decompressNs; //!< time spent decompressing the frame samples in nanoseconds
     };
 
     SDRDaemonMetaDataFEC m_currentMeta;          //!< Stored current meta data
-    CM256::cm256_encoder_params m_paramsCM256;          //!< CM256 decoder parameters block
     DecoderSlot          m_decoderSlots[nbDecoderSlots]; //!< CM256 decoding control/buffer slots
-    BufferFrame          m_frames[nbDecoderSlots];       //!< Samples buffer
-    int                  m_framesNbBytes;                //!< Number of bytes in samples buffer
+    BufferFrame          m_frames[nbDecoderSlots];       //!< Samples buffer. Holds coded blocks when a codec is used.
+    SDRDaemonCodec       m_codec;                //!< Current sample codec
+    uint8_t             *m_decodedFrames;        //!< Decompressed samples buffer when a codec is used
+    int                  m_frameNbBytes;         //!< Number of bytes of samples of one frame in samples buffer
+    int                  m_framesNbBytes;        //!< Number of bytes in samples buffer
     int                  m_decoderIndexHead;     //!< index of the current head frame slot in decoding slots
     int                  m_frameHead;            //!< index of the current head frame sent
     int                  m_curNbBlocks;          //!< (stats) instantaneous number of blocks received
@@ -146,6 +172,7 @@ private:
     MovingAverageUtil<int, int, 10> m_avgNbBlocks;   //!< (stats) average number of blocks received
     MovingAverageUtil<int, int, 10> m_avgOrigBlocks; //!< (stats) average number of original blocks received
     MovingAverageUtil<int, int, 10> m_avgNbRecovery; //!< (stats) average number of recovery blocks used
+    MovingAverageUtil<double, double, 10> m_avgDecompressNs; //!< (stats) average decompression time per sample in nanoseconds
     bool                 m_framesDecoded;        //!< [stats] true if all frames were decoded since last poll
     int                  m_readIndex;            //!< current byte read index in frames buffer
     int                  m_wrDeltaEstimate;      //!< Sampled estimate of write to read indexes difference
@@ -162,8 +189,10 @@ private:
     int      m_nbWrites;      //!< Number of buffer writes since start of auto R/W balance correction period
     int      m_balCorrection; //!< R/W balance correction in number of samples
     int      m_balCorrLimit;  //!< Correction absolute value limit in number of samples
-    CM256    m_cm256;         //!< CM256 library
+    CM256    m_cm256[SDRDAEMONSOURCE_NBDECODERS]; //!< CM256 library objects one per decoder
     bool     m_cm256_OK;      //!< CM256 library initialized OK
+    DecodeJob m_decodeJobs[nbDecoderSlots];       //!< decoding jobs one per decoder slot
+    OrderedWorkerPool m_decoderPool;              //!< FEC decoders handing back frames in order
 
     inline SDRDaemonProtectedBlock* storeOriginalBlock(int slotIndex, int blockIndex, const SDRDaemonProtectedBlock& protectedBlock)
     {
@@ -209,6 +238,12 @@ private:
     void rwCorrectionEstimate(int slotIndex);
     void checkSlotData(int slotIndex);
     void initDecodeSlot(int slotIndex);
+    void pushDecodeSlot(int slotIndex);
+    void finalizeDecodeSlot(int slotIndex);
+    void collectDecodedSlots();
+    void waitDecodedSlot(int slotIndex);
+    void setCodec(const SDRDaemonCodec& codec);
+    qint64 decompressSlot(int slotIndex, const SDRDaemonProtectedBlock **blocks);
 
     static void printMeta(const QString& header, SDRDaemonMetaDataFEC *metaData);
 };
@@ -346,6 +346,8 @@ int SDRdaemonSourceInput::webapiReportGet(
     response.setSdrDaemonSourceReport(new SWGSDRangel::SWGSDRdaemonSourceReport());
     response.getSdrDaemonSourceReport()->init();
     webapiFormatDeviceReport(response);
+    response.setFileRecordReport(new SWGSDRangel::SWGFileRecordReport());
+    m_fileSink->webapiFormatReport(*response.getFileRecordReport());
     return 200;
 }
 
@@ -360,4 +362,9 @@ void SDRdaemonSourceInput::webapiFormatDeviceReport(SWGSDRangel::SWGDeviceReport
 
     response.getSdrDaemonSourceReport()->setMinNbBlocks(m_SDRdaemonUDPHandler->getMinNbBlocks());
     response.getSdrDaemonSourceReport()->setMaxNbRecovery(m_SDRdaemonUDPHandler->getMaxNbRecovery());
+    response.getSdrDaemonSourceReport()->setNbFecDecoders(m_SDRdaemonUDPHandler->getNbDecoders());
+    response.getSdrDaemonSourceReport()->setAvgFecDecodeTimeUs(m_SDRdaemonUDPHandler->getAvgDecodeTimeUs());
+    response.getSdrDaemonSourceReport()->setMaxFecDecodeTimeUs(m_SDRdaemonUDPHandler->getMaxDecodeTimeUs());
+    response.getSdrDaemonSourceReport()->setCompressionRatio(m_SDRdaemonUDPHandler->getCompressionRatio());
+    response.getSdrDaemonSourceReport()->setAvgDecompressNsPerSample(m_SDRdaemonUDPHandler->getAvgDecompressNsPerSample());
 }
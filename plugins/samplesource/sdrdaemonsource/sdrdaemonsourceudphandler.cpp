@@ -14,12 +14,12 @@
 // along with this program. If not, see <http://www.gnu.org/licenses/>.          //
 ///////////////////////////////////////////////////////////////////////////////////
 
-#include <QUdpSocket>
 #include <QDebug>
 #include <QTimer>
 
 #include "dsp/dspcommands.h"
 #include "dsp/dspengine.h"
+#include "util/udpbatchsocket.h"
 #include <device/devicesourceapi.h>
 
 #include "sdrdaemonsourceinput.h"
@@ -37,7 +37,7 @@ SDRdaemonSourceUDPHandler::SDRdaemonSourceUDPHandler(SampleSinkFifo *sampleFifo,
 	m_dataPort(9090),
 	m_dataConnected(false),
 	m_udpBuf(0),
-	m_udpReadBytes(0),
+	m_udpSizes(0),
 	m_sampleFifo(sampleFifo),
 	m_samplerate(0),
 	m_centerFrequency(0),
@@ -54,7 +54,8 @@ SDRdaemonSourceUDPHandler::SDRdaemonSourceUDPHandler(SampleSinkFifo *sampleFifo,
     m_throttleToggle(false),
 	m_autoCorrBuffer(true)
 {
-    m_udpBuf = new char[SDRDaemonUdpSize];
+    m_udpBuf = new char[UDPBatchSocket::m_maxBatchSize * SDRDaemonMaxDatagramSize];
+    m_udpSizes = new int[UDPBatchSocket::m_maxBatchSize];
 
 #ifdef USE_INTERNAL_TIMER
 #warning "Uses internal timer"
@@ -71,6 +72,7 @@ SDRdaemonSourceUDPHandler::~SDRdaemonSourceUDPHandler()
 {
 	stop();
 	delete[] m_udpBuf;
+	delete[] m_udpSizes;
 	if (m_converterBuffer) { delete[] m_converterBuffer; }
 #ifdef USE_INTERNAL_TIMER
     if (m_timer) {
@@ -89,7 +91,8 @@ void SDRdaemonSourceUDPHandler::start()
 
 	if (!m_dataSocket)
 	{
-		m_dataSocket = new QUdpSocket(this);
+		m_dataSocket = new UDPBatchSocket(this);
+		m_dataSocket->setBufferSizes(0, SDRDAEMONSOURCE_RCVBUFSIZE);
 	}
 
     if (!m_dataConnected)
@@ -158,23 +161,28 @@ void SDRdaemonSourceUDPHandler::configureUDPLink(const QString& address, quint16
 
 void SDRdaemonSourceUDPHandler::dataReadyRead()
 {
-    m_udpReadBytes = 0;
+    int nbRead;
 
-	while (m_dataSocket->hasPendingDatagrams() && m_dataConnected)
+	while (m_dataConnected && ((nbRead = m_dataSocket->readDatagrams(m_udpBuf, SDRDaemonMaxDatagramSize, UDPBatchSocket::m_maxBatchSize, m_udpSizes, &m_remoteAddress)) > 0))
 	{
-		qint64 pendingDataSize = m_dataSocket->pendingDatagramSize();
-		m_udpReadBytes += m_dataSocket->readDatagram(&m_udpBuf[m_udpReadBytes], pendingDataSize, &m_remoteAddress, 0);
-
-		if (m_udpReadBytes == SDRDaemonUdpSize) {
-		    processData();
-		    m_udpReadBytes = 0;
-		}
+	    for (int i = 0; i < nbRead; i++)
+	    {
+	        // jumbo datagrams carry several consecutive blocks
+	        if ((m_udpSizes[i] > 0) && (m_udpSizes[i] % SDRDaemonUdpSize == 0))
+	        {
+	            char *datagram = &m_udpBuf[i * SDRDaemonMaxDatagramSize];
+
+	            for (int offset = 0; offset < m_udpSizes[i]; offset += SDRDaemonUdpSize) {
+	                processData(&datagram[offset]);
+	            }
+	        }
+	    }
 	}
 }
 
-void SDRdaemonSourceUDPHandler::processData()
+void SDRdaemonSourceUDPHandler::processData(char *udpBuf)
 {
-    m_sdrDaemonBuffer.writeData(m_udpBuf);
+    m_sdrDaemonBuffer.writeData(udpBuf);
     const SDRDaemonMetaDataFEC& metaData =  m_sdrDaemonBuffer.getCurrentMeta();
     bool change = false;
 
@@ -328,7 +336,7 @@ void SDRdaemonSourceUDPHandler::tick()
 	        int nbOriginalBlocks = m_sdrDaemonBuffer.getCurrentMeta().m_nbOriginalBlocks;
 	        int nbFECblocks = m_sdrDaemonBuffer.getCurrentMeta().m_nbFECBlocks;
 	        int sampleBits = m_sdrDaemonBuffer.getCurrentMeta().m_sampleBits;
-	        int sampleBytes = m_sdrDaemonBuffer.getCurrentMeta().m_sampleBytes;
+	        int sampleBytes = m_sdrDaemonBuffer.getCurrentMeta().getSampleBytes();
 
 	        //framesDecodingStatus = (minNbOriginalBlocks == nbOriginalBlocks ? 2 : (minNbOriginalBlocks < nbOriginalBlocks - nbFECblocks ? 0 : 1));
 	        if (minNbBlocks < nbOriginalBlocks) {
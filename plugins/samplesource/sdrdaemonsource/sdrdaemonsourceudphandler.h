@@ -18,7 +18,6 @@
 #define PLUGINS_SAMPLESOURCE_SDRDAEMONSOURCE_SDRDAEMONSOURCEUDPHANDLER_H_
 
 #include <QObject>
-#include <QUdpSocket>
 #include <QHostAddress>
 #include <QMutex>
 #include <QElapsedTimer>
@@ -26,11 +25,13 @@
 #include "sdrdaemonsourcebuffer.h"
 
 #define SDRDAEMONSOURCE_THROTTLE_MS 50
+#define SDRDAEMONSOURCE_RCVBUFSIZE (1<<21) // socket receive buffer of about 16 frames with FEC
 
 class SampleSinkFifo;
 class MessageQueue;
 class QTimer;
 class DeviceSourceAPI;
+class UDPBatchSocket;
 
 class SDRdaemonSourceUDPHandler : public QObject
 {
@@ -51,6 +52,11 @@ public:
     uint64_t getTVmSec() const { return m_tv_msec; }
     int getMinNbBlocks() { return m_sdrDaemonBuffer.getMinNbBlocks(); }
     int getMaxNbRecovery() { return m_sdrDaemonBuffer.getMaxNbRecovery(); }
+    int getNbDecoders() const { return m_sdrDaemonBuffer.getNbDecoders(); }
+    int getAvgDecodeTimeUs() const { return m_sdrDaemonBuffer.getAvgDecodeTimeUs(); }
+    int getMaxDecodeTimeUs() { return m_sdrDaemonBuffer.getMaxDecodeTimeUs(); }
+    float getCompressionRatio() const { return m_sdrDaemonBuffer.getCompressionRatio(); }
+    double getAvgDecompressNsPerSample() const { return m_sdrDaemonBuffer.getAvgDecompressNsPerSample(); }
 public slots:
 	void dataReadyRead();
 
@@ -61,13 +67,13 @@ private:
 	bool m_running;
     uint32_t m_rateDivider;
 	SDRdaemonSourceBuffer m_sdrDaemonBuffer;
-	QUdpSocket *m_dataSocket;
+	UDPBatchSocket *m_dataSocket;
 	QHostAddress m_dataAddress;
 	QHostAddress m_remoteAddress;
 	quint16 m_dataPort;
 	bool m_dataConnected;
-	char *m_udpBuf;
-	qint64 m_udpReadBytes;
+	char *m_udpBuf;                      //!< batch of datagrams read at once
+	int *m_udpSizes;                     //!< sizes of datagrams in batch
 	SampleSinkFifo *m_sampleFifo;
 	uint32_t m_samplerate;
 	uint32_t m_centerFrequency;
@@ -88,7 +94,7 @@ private:
 
 	void connectTimer();
     void disconnectTimer();
-	void processData();
+	void processData(char *udpBuf);
 
 private slots:
 	void tick();
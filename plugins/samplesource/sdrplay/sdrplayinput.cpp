@@ -769,6 +769,8 @@ int SDRPlayInput::webapiReportGet(
     response.setSdrPlayReport(new SWGSDRangel::SWGSDRPlayReport());
     response.getSdrPlayReport()->init();
     webapiFormatDeviceReport(response);
+    response.setFileRecordReport(new SWGSDRangel::SWGFileRecordReport());
+    m_fileSink->webapiFormatReport(*response.getFileRecordReport());
     return 200;
 }
 
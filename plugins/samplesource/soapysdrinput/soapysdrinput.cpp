@@ -1472,6 +1472,8 @@ int SoapySDRInput::webapiReportGet(SWGSDRangel::SWGDeviceReport& response, QStri
     response.setSoapySdrInputReport(new SWGSDRangel::SWGSoapySDRReport());
     response.getSoapySdrInputReport()->init();
     webapiFormatDeviceReport(response);
+    response.setFileRecordReport(new SWGSDRangel::SWGFileRecordReport());
+    m_fileSink->webapiFormatReport(*response.getFileRecordReport());
     return 200;
 }
 
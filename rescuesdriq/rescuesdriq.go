@@ -21,6 +21,61 @@ type HeaderStd struct {
 	CRC32           uint32
 }
 
+// Version 2 (chunked) file header
+type HeaderV2 struct {
+	Magic            [8]byte
+	Version          uint32
+	SampleSize       uint32
+	StartTimestampUs uint64
+	CenterFrequency  uint64
+	SampleRate       uint32
+	Codec            uint32
+	CodecBits        uint32
+	CodecBlockSize   uint32
+	FileSequence     uint32
+	ChunksPerIndex   uint32
+	Reserved         uint32
+	CRC32            uint32
+}
+
+// Version 2 chunk header
+type ChunkHeader struct {
+	Magic               uint32
+	PayloadSize         uint32
+	SampleIndex         uint64
+	TimestampUs         uint64
+	CenterFrequency     uint64
+	SampleRate          uint32
+	NbSamples           uint32
+	Sequence            uint32
+	Flags               uint32
+	PreviousIndexOffset uint64
+	PayloadCRC32        uint32
+	CRC32               uint32
+}
+
+// Version 2 index chunk payload entry
+type IndexEntry struct {
+	Offset          uint64
+	SampleIndex     uint64
+	TimestampUs     uint64
+	CenterFrequency uint64
+	SampleRate      uint32
+	NbSamples       uint32
+	PayloadSize     uint32
+	Flags           uint32
+}
+
+const (
+	HeaderV2Size    = 64
+	ChunkHeaderSize = 64
+	ChunkData       = 0x44524453 // "SDRD"
+	ChunkIndex      = 0x58524453 // "SDRX"
+	ChunkEnd        = 0x45524453 // "SDRE"
+	FlagPayloadCRC  = 1 << 16    // data chunk payload CRC32 is set
+	MaxPayloadSize  = 1 << 26    // well above the largest chunk written (1M samples of 8 bytes)
+)
+
 func check(e error) {
 	if e != nil {
 		panic(e)
@@ -104,6 +159,183 @@ func copyContent(reader *bufio.Reader, writer *bufio.Writer, blockSize uint) {
 	fmt.Printf("Wrote %d bytes\r", sz)
 }
 
+func isV2(r *bufio.Reader) bool {
+	magic, err := r.Peek(8)
+	return err == nil && bytes.Equal(magic, []byte("SDRIQv2\x00"))
+}
+
+func crcOf(v interface{}, size int) uint32 {
+	var bin_buf bytes.Buffer
+	binary.Write(&bin_buf, binary.LittleEndian, v)
+	return crc32.ChecksumIEEE(bin_buf.Bytes()[0:size])
+}
+
+func GetCRCV2(header *HeaderV2) uint32 {
+	return crcOf(header, HeaderV2Size-4)
+}
+
+func GetChunkCRC(chunk *ChunkHeader) uint32 {
+	return crcOf(chunk, ChunkHeaderSize-4)
+}
+
+func printHeaderV2(header *HeaderV2) {
+	fmt.Println("Format     : sdriq v2")
+	fmt.Println("Sample rate:", header.SampleRate)
+	fmt.Println("Frequency  :", header.CenterFrequency)
+	fmt.Println("Sample Size:", header.SampleSize)
+	tm := time.Unix(0, int64(header.StartTimestampUs)*1000)
+	fmt.Println("Start      :", tm)
+	fmt.Println("Codec      :", header.Codec, "bits:", header.CodecBits)
+	fmt.Println("File seq   :", header.FileSequence)
+	fmt.Println("CRC32      :", header.CRC32)
+	fmt.Println("CRC32 OK   :", GetCRCV2(header))
+}
+
+// Check that the payload size of a data chunk matches its number of samples
+func dataPayloadSizeOK(header *HeaderV2, chunk *ChunkHeader) bool {
+	if chunk.PayloadSize == 0 || chunk.PayloadSize > MaxPayloadSize {
+		return false
+	}
+
+	if chunk.Flags&0xFF == 0 { // not compressed: samples are I and Q of SampleSize bits each padded to 16 or 32 bits
+		sampleBytes := uint32(4)
+
+		if header.SampleSize > 16 {
+			sampleBytes = 8
+		}
+
+		return chunk.PayloadSize == chunk.NbSamples*sampleBytes
+	}
+
+	return header.CodecBlockSize != 0 && chunk.PayloadSize%header.CodecBlockSize == 0
+}
+
+// Read the valid data chunks of a v2 file in order and pass them to the callback.
+// Stops at the end chunk or at the first damaged or truncated chunk.
+func walkChunksV2(r *bufio.Reader, header *HeaderV2, callback func(chunk *ChunkHeader, payload []byte)) (nbChunks int, nbSamples uint64, ended bool) {
+	headerbuf := make([]byte, ChunkHeaderSize)
+
+	for {
+		if _, err := io.ReadFull(r, headerbuf); err != nil {
+			return
+		}
+
+		var chunk ChunkHeader
+		binary.Read(bytes.NewReader(headerbuf), binary.LittleEndian, &chunk)
+
+		if chunk.CRC32 != GetChunkCRC(&chunk) {
+			fmt.Printf("Damaged chunk header after %d samples\n", nbSamples)
+			return
+		}
+
+		if chunk.Magic == ChunkEnd {
+			ended = true
+			return
+		}
+
+		if chunk.Magic == ChunkData && !dataPayloadSizeOK(header, &chunk) {
+			fmt.Printf("Bad data chunk size after %d samples\n", nbSamples)
+			return
+		}
+
+		if chunk.PayloadSize > MaxPayloadSize {
+			fmt.Printf("Bad chunk size after %d samples\n", nbSamples)
+			return
+		}
+
+		payload := make([]byte, chunk.PayloadSize)
+
+		if _, err := io.ReadFull(r, payload); err != nil {
+			fmt.Printf("Truncated chunk after %d samples\n", nbSamples)
+			return
+		}
+
+		if (chunk.Magic != ChunkData || chunk.Flags&FlagPayloadCRC != 0) && chunk.PayloadCRC32 != crc32.ChecksumIEEE(payload) {
+			fmt.Printf("Damaged chunk payload after %d samples\n", nbSamples)
+			return
+		}
+
+		if chunk.Magic == ChunkData {
+			if chunk.SampleIndex != nbSamples {
+				fmt.Printf("Chunk out of sequence after %d samples\n", nbSamples)
+				return
+			}
+
+			if callback != nil {
+				callback(&chunk, payload)
+			}
+
+			nbChunks++
+			nbSamples += uint64(chunk.NbSamples)
+		}
+	}
+}
+
+func writeChunkV2(writer *bufio.Writer, chunk *ChunkHeader, payload []byte) {
+	chunk.CRC32 = GetChunkCRC(chunk)
+	binary.Write(writer, binary.LittleEndian, chunk)
+	writer.Write(payload)
+}
+
+// Copy the valid data chunks of a v2 file and rebuild its index and end chunks
+func repairV2(reader *bufio.Reader, writer *bufio.Writer, header *HeaderV2) {
+	var offset uint64 = HeaderV2Size
+	var sequence uint32 = 0
+	var lastIndexOffset uint64 = 0
+	var nbSamples uint64 = 0
+	var timestampUs uint64 = 0
+	var entries []IndexEntry
+
+	chunksPerIndex := int(header.ChunksPerIndex)
+
+	if chunksPerIndex == 0 {
+		chunksPerIndex = 64
+	}
+
+	binary.Write(writer, binary.LittleEndian, header)
+
+	writeIndex := func() {
+		if len(entries) == 0 {
+			return
+		}
+
+		var bin_buf bytes.Buffer
+		binary.Write(&bin_buf, binary.LittleEndian, entries)
+		index := ChunkHeader{Magic: ChunkIndex, PayloadSize: uint32(bin_buf.Len()), SampleIndex: nbSamples,
+			TimestampUs: timestampUs, NbSamples: uint32(len(entries)), Sequence: sequence,
+			PreviousIndexOffset: lastIndexOffset, PayloadCRC32: crc32.ChecksumIEEE(bin_buf.Bytes())}
+		writeChunkV2(writer, &index, bin_buf.Bytes())
+		sequence++
+		lastIndexOffset = offset
+		offset += ChunkHeaderSize + uint64(bin_buf.Len())
+		entries = entries[:0]
+	}
+
+	nbChunks, _, _ := walkChunksV2(reader, header, func(chunk *ChunkHeader, payload []byte) {
+		chunk.Sequence = sequence
+		sequence++
+		entries = append(entries, IndexEntry{offset, chunk.SampleIndex, chunk.TimestampUs, chunk.CenterFrequency,
+			chunk.SampleRate, chunk.NbSamples, chunk.PayloadSize, chunk.Flags})
+		writeChunkV2(writer, chunk, payload)
+		offset += ChunkHeaderSize + uint64(chunk.PayloadSize)
+		nbSamples += uint64(chunk.NbSamples)
+
+		if chunk.SampleRate != 0 {
+			timestampUs = chunk.TimestampUs + (uint64(chunk.NbSamples)*1000000)/uint64(chunk.SampleRate)
+		}
+
+		if len(entries) >= chunksPerIndex {
+			writeIndex()
+		}
+	})
+
+	writeIndex()
+	end := ChunkHeader{Magic: ChunkEnd, SampleIndex: nbSamples, TimestampUs: timestampUs, Sequence: sequence,
+		PreviousIndexOffset: lastIndexOffset}
+	writeChunkV2(writer, &end, nil)
+	fmt.Printf("Wrote %d data chunks %d samples\n", nbChunks, nbSamples)
+}
+
 func main() {
 	inFileStr := flag.String("in", "foo", "input file")
 	outFileStr := flag.String("out", "foo", "output file")
@@ -131,6 +363,12 @@ func main() {
 		}()
 		// make a read buffer
 		reader := bufio.NewReader(fi)
+
+		if isV2(reader) {
+			mainV2(reader, flagSeen["out"], *outFileStr)
+			return
+		}
+
 		var headerOrigin HeaderStd = analyze(reader)
 		printHeader(&headerOrigin)
 
@@ -185,3 +423,36 @@ func main() {
 		fmt.Println("No input file given")
 	}
 }
+
+func mainV2(reader *bufio.Reader, repair bool, outFileStr string) {
+	var header HeaderV2
+	err := binary.Read(reader, binary.LittleEndian, &header)
+	check(err)
+	printHeaderV2(&header)
+
+	if header.CRC32 != GetCRCV2(&header) {
+		fmt.Println("Bad header CRC: cannot repair")
+		return
+	}
+
+	if !repair {
+		nbChunks, nbSamples, ended := walkChunksV2(reader, &header, nil)
+		fmt.Println("Data chunks:", nbChunks)
+		fmt.Println("Samples    :", nbSamples)
+		fmt.Println("Closed     :", ended)
+		return
+	}
+
+	fmt.Println("Output file:", outFileStr)
+	fo, err := os.Create(outFileStr)
+	check(err)
+
+	defer func() {
+		err := fo.Close()
+		check(err)
+	}()
+
+	writer := bufio.NewWriter(fo)
+	repairV2(reader, writer, &header)
+	writer.Flush()
+}
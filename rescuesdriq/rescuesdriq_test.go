@@ -23,4 +23,23 @@ func TestSpec(t *testing.T) {
 			So(crc32, ShouldEqual, 2294957931)
 		})
 	})
+
+	Convey("Given a version 2 header structure", t, func() {
+		var header HeaderV2
+		copy(header.Magic[:], "SDRIQv2")
+		header.Version = 2
+		header.SampleSize = 16
+		header.StartTimestampUs = 1539083921000000
+		header.CenterFrequency = 435000000
+		header.SampleRate = 75000
+		header.Codec = 1
+		header.CodecBits = 12
+		header.ChunksPerIndex = 64
+
+		crc32 := GetCRCV2(&header)
+
+		Convey("The CRC32 value should be 1242211508", func() {
+			So(crc32, ShouldEqual, 1242211508)
+		})
+	})
 }
@@ -0,0 +1,273 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+
+#include <algorithm>
+
+#include "sdrdaemondatablock.h"
+#include "sdrdaemoncodec.h"
+
+const int SDRDaemonCodec::m_bfpGroupSize;
+const int SDRDaemonCodec::m_minBits;
+
+SDRDaemonCodec::SDRDaemonCodec() :
+    m_codecType(CodecNone),
+    m_nbBits(16),
+    m_sampleBytes(2),
+    m_nbSamplesPerBlock(SDRDaemonNbBytesPerBlock / 4)
+{}
+
+void SDRDaemonCodec::setCodec(CodecType codecType, int nbBits, int sampleBytes)
+{
+    m_codecType = codecType;
+    m_sampleBytes = sampleBytes == 4 ? 4 : 2;
+
+    switch (m_codecType)
+    {
+    case CodecPacked:
+        m_nbBits = std::max(m_minBits, std::min(nbBits, m_sampleBytes == 2 ? 16 : 24));
+        m_nbSamplesPerBlock = (SDRDaemonNbBytesPerBlock * 8) / (2 * m_nbBits);
+        break;
+    case CodecBFP:
+        m_nbBits = std::max(m_minBits, std::min(nbBits, m_sampleBytes == 2 ? 14 : 16)); // no gain above
+        m_nbSamplesPerBlock = (SDRDaemonNbBytesPerBlock / (1 + (2 * m_bfpGroupSize * m_nbBits) / 8)) * m_bfpGroupSize;
+        break;
+    case CodecNone:
+    default:
+        m_codecType = CodecNone;
+        m_nbBits = 8 * m_sampleBytes;
+        m_nbSamplesPerBlock = SDRDaemonNbBytesPerBlock / (2 * m_sampleBytes);
+        break;
+    }
+}
+
+float SDRDaemonCodec::getCompressionRatio() const
+{
+    return (float) getDecodedBlockSize() / (float) SDRDaemonNbBytesPerBlock;
+}
+
+bool SDRDaemonCodec::operator==(const SDRDaemonCodec& rhs) const
+{
+    return (m_codecType == rhs.m_codecType)
+        && (m_nbBits == rhs.m_nbBits)
+        && (m_sampleBytes == rhs.m_sampleBytes);
+}
+
+int SDRDaemonCodec::encode(const uint8_t *samples, uint8_t *block) const
+{
+    switch (m_codecType)
+    {
+    case CodecPacked:
+        return encodePacked(samples, block);
+    case CodecBFP:
+        return encodeBFP(samples, block);
+    case CodecNone:
+    default:
+        std::copy(samples, samples + getDecodedBlockSize(), block);
+        return 0;
+    }
+}
+
+void SDRDaemonCodec::decode(const uint8_t *block, uint8_t *samples) const
+{
+    switch (m_codecType)
+    {
+    case CodecPacked:
+        decodePacked(block, samples);
+        break;
+    case CodecBFP:
+        decodeBFP(block, samples);
+        break;
+    case CodecNone:
+    default:
+        std::copy(block, block + getDecodedBlockSize(), samples);
+        break;
+    }
+}
+
+int SDRDaemonCodec::encodePacked(const uint8_t *samples, uint8_t *block) const
+{
+    const int32_t maxValue = (1 << (m_nbBits - 1)) - 1;
+    const int32_t minValue = -maxValue - 1;
+    const uint64_t mask = (1ULL << m_nbBits) - 1;
+    uint8_t *p = block;
+    uint64_t acc = 0;
+    int accBits = 0;
+    int nbSaturated = 0;
+
+    for (int i = 0; i < 2 * m_nbSamplesPerBlock; i++)
+    {
+        int32_t v = getSample(samples, i);
+
+        if (v > maxValue)
+        {
+            v = maxValue;
+            nbSaturated++;
+        }
+        else if (v < minValue)
+        {
+            v = minValue;
+            nbSaturated++;
+        }
+
+        acc |= ((uint64_t) (uint32_t) v & mask) << accBits;
+        accBits += m_nbBits;
+
+        while (accBits >= 8)
+        {
+            *p++ = acc & 0xFF;
+            acc >>= 8;
+            accBits -= 8;
+        }
+    }
+
+    if (accBits > 0) {
+        *p++ = acc & 0xFF;
+    }
+
+    std::fill(p, block + SDRDaemonNbBytesPerBlock, 0);
+    return nbSaturated;
+}
+
+void SDRDaemonCodec::decodePacked(const uint8_t *block, uint8_t *samples) const
+{
+    const uint64_t mask = (1ULL << m_nbBits) - 1;
+    const int shift = 32 - m_nbBits;
+    const uint8_t *p = block;
+    uint64_t acc = 0;
+    int accBits = 0;
+
+    for (int i = 0; i < 2 * m_nbSamplesPerBlock; i++)
+    {
+        while (accBits < m_nbBits)
+        {
+            acc |= ((uint64_t) *p++) << accBits;
+            accBits += 8;
+        }
+
+        uint32_t u = acc & mask;
+        acc >>= m_nbBits;
+        accBits -= m_nbBits;
+        setSample(samples, i, ((int32_t) (u << shift)) >> shift); // sign extension
+    }
+}
+
+int SDRDaemonCodec::encodeBFP(const uint8_t *samples, uint8_t *block) const
+{
+    const int32_t maxValue = (1 << (m_nbBits - 1)) - 1;
+    const int32_t minValue = -maxValue - 1;
+    const uint64_t mask = (1ULL << m_nbBits) - 1;
+    const int nbGroups = m_nbSamplesPerBlock / m_bfpGroupSize;
+    uint8_t *p = block;
+    int nbSaturated = 0;
+
+    for (int g = 0; g < nbGroups; g++)
+    {
+        int first = 2 * g * m_bfpGroupSize;
+        int last = first + 2 * m_bfpGroupSize;
+        uint32_t magnitudes = 0;
+        int32_t maxSample = 0;
+
+        for (int i = first; i < last; i++)
+        {
+            int32_t v = getSample(samples, i);
+            magnitudes |= v < 0 ? ~v : v;
+            maxSample = std::max(maxSample, v);
+        }
+
+        int nbSignificantBits = 1; // sign bit
+
+        while ((magnitudes >> (nbSignificantBits - 1)) != 0) {
+            nbSignificantBits++;
+        }
+
+        int exponent = std::max(0, nbSignificantBits - m_nbBits);
+        int32_t rounding = exponent > 0 ? 1 << (exponent - 1) : 0;
+
+        if ((((int64_t) maxSample + rounding) >> exponent) > maxValue) // rounding of the largest sample would saturate
+        {
+            exponent++;
+            rounding = 1 << (exponent - 1);
+        }
+        uint64_t acc = 0;
+        int accBits = 0;
+        *p++ = exponent;
+
+        for (int i = first; i < last; i++)
+        {
+            int32_t v = (int32_t) (((int64_t) getSample(samples, i) + rounding) >> exponent);
+
+            if (v > maxValue)
+            {
+                v = maxValue;
+                nbSaturated++;
+            }
+            else if (v < minValue)
+            {
+                v = minValue;
+                nbSaturated++;
+            }
+
+            acc |= ((uint64_t) (uint32_t) v & mask) << accBits;
+            accBits += m_nbBits;
+
+            while (accBits >= 8)
+            {
+                *p++ = acc & 0xFF;
+                acc >>= 8;
+                accBits -= 8;
+            }
+        }
+    }
+
+    std::fill(p, block + SDRDaemonNbBytesPerBlock, 0);
+    return nbSaturated;
+}
+
+void SDRDaemonCodec::decodeBFP(const uint8_t *block, uint8_t *samples) const
+{
+    const uint64_t mask = (1ULL << m_nbBits) - 1;
+    const int shift = 32 - m_nbBits;
+    const int nbGroups = m_nbSamplesPerBlock / m_bfpGroupSize;
+    const int64_t maxSample = m_sampleBytes == 2 ? INT16_MAX : INT32_MAX;
+    const int64_t minSample = m_sampleBytes == 2 ? INT16_MIN : INT32_MIN;
+    const uint8_t *p = block;
+
+    for (int g = 0; g < nbGroups; g++)
+    {
+        int first = 2 * g * m_bfpGroupSize;
+        int last = first + 2 * m_bfpGroupSize;
+        int exponent = *p++;
+        uint64_t acc = 0;
+        int accBits = 0;
+
+        for (int i = first; i < last; i++)
+        {
+            while (accBits < m_nbBits)
+            {
+                acc |= ((uint64_t) *p++) << accBits;
+                accBits += 8;
+            }
+
+            uint32_t u = acc & mask;
+            acc >>= m_nbBits;
+            accBits -= m_nbBits;
+            int64_t v = (int64_t) (((int32_t) (u << shift)) >> shift) * (1 << exponent);
+            setSample(samples, i, (int32_t) std::max(minSample, std::min(v, maxSample))); // rounding may overflow raw sample size
+        }
+    }
+}
@@ -0,0 +1,99 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef SDRDAEMON_CHANNEL_SDRDAEMONCODEC_H_
+#define SDRDAEMON_CHANNEL_SDRDAEMONCODEC_H_
+
+#include <stdint.h>
+
+#include "dsp/dsptypes.h"
+#include "export.h"
+
+/**
+ * Fixed rate I/Q sample codec applied to the payload of each protected block of a SDRdaemon frame.
+ * Each coded block carries a constant number of samples for a given codec setting so the frame
+ * geometry and the CM256 FEC protection are unchanged. Codec type and number of bits are carried
+ * in the header of every block.
+ */
+class SDRBASE_API SDRDaemonCodec
+{
+public:
+    enum CodecType
+    {
+        CodecNone,   //!< Raw I/Q samples
+        CodecPacked, //!< Lossless bit packing of samples fitting in the number of bits (ex: 12 bit ADC data). Saturates otherwise.
+        CodecBFP     //!< Lossy block floating point with a shared exponent per group of samples. The error is at most
+                     //!< 2^(s - nbBits) where s is the number of significant bits with sign of the largest sample of the group.
+    };
+
+    SDRDaemonCodec();
+
+    /** Set codec type, number of bits per I or Q sample and number of bytes of each I or Q raw sample (2 or 4).
+     *  Number of bits is bounded to the valid range for the codec. */
+    void setCodec(CodecType codecType, int nbBits, int sampleBytes);
+
+    CodecType getCodecType() const { return m_codecType; }
+    int getNbBits() const { return m_nbBits; }
+    int getSampleBytes() const { return m_sampleBytes; }
+    int getNbSamplesPerBlock() const { return m_nbSamplesPerBlock; }
+    /** Size in bytes of the raw I/Q samples carried by one block */
+    int getDecodedBlockSize() const { return m_nbSamplesPerBlock * 2 * m_sampleBytes; }
+    float getCompressionRatio() const;
+    bool operator==(const SDRDaemonCodec& rhs) const;
+    bool operator!=(const SDRDaemonCodec& rhs) const { return !(*this == rhs); }
+
+    /** Encode getNbSamplesPerBlock() samples in a protected block payload. Samples are taken from
+     *  I/Q pairs of sampleBytes bytes each like the raw stream. Returns the number of saturated I or Q samples. */
+    int encode(const uint8_t *samples, uint8_t *block) const;
+    /** Decode a protected block payload in getNbSamplesPerBlock() I/Q pairs of sampleBytes bytes each */
+    void decode(const uint8_t *block, uint8_t *samples) const;
+
+    static const int m_bfpGroupSize = 16; //!< Number of I/Q samples sharing the same exponent in BFP codec
+    static const int m_minBits = 4;
+
+private:
+    CodecType m_codecType;
+    int m_nbBits;
+    int m_sampleBytes;
+    int m_nbSamplesPerBlock;
+
+    inline int32_t getSample(const uint8_t *samples, int index) const
+    {
+        if (m_sampleBytes == 2) {
+            return ((const int16_t *) samples)[index];
+        } else {
+            return ((const int32_t *) samples)[index];
+        }
+    }
+
+    inline void setSample(uint8_t *samples, int index, int32_t value) const
+    {
+        if (m_sampleBytes == 2) {
+            ((int16_t *) samples)[index] = value;
+        } else {
+            ((int32_t *) samples)[index] = value;
+        }
+    }
+
+    int encodePacked(const uint8_t *samples, uint8_t *block) const;
+    void decodePacked(const uint8_t *block, uint8_t *samples) const;
+    int encodeBFP(const uint8_t *samples, uint8_t *block) const;
+    void decodeBFP(const uint8_t *block, uint8_t *samples) const;
+};
+
+#endif /* SDRDAEMON_CHANNEL_SDRDAEMONCODEC_H_ */
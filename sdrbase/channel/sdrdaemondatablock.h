@@ -31,6 +31,7 @@
 
 #define UDPSINKFEC_UDPSIZE 512
 #define UDPSINKFEC_NBORIGINALBLOCKS 128
+#define UDPSINKFEC_MAXBLOCKSPERDATAGRAM 16 // jumbo frames: up to 16 blocks of 512 bytes in one datagram
 //#define UDPSINKFEC_NBTXBLOCKS 8
 
 #pragma pack(push, 1)
@@ -38,7 +39,7 @@ struct SDRDaemonMetaDataFEC
 {
     uint32_t m_centerFrequency;   //!<  4 center frequency in kHz
     uint32_t m_sampleRate;        //!<  8 sample rate in Hz
-    uint8_t  m_sampleBytes;       //!<  9 4 LSB: number of bytes per sample (2 or 4)
+    uint8_t  m_sampleBytes;       //!<  9 4 LSB: number of bytes per sample (2 or 4) 4 MSB: log2 of number of blocks per UDP datagram
     uint8_t  m_sampleBits;        //!< 10 number of effective bits per sample (deprecated)
     uint8_t  m_nbOriginalBlocks;  //!< 11 number of blocks with original (protected) data
     uint8_t  m_nbFECBlocks;       //!< 12 number of blocks carrying FEC
@@ -70,6 +71,21 @@ struct SDRDaemonMetaDataFEC
         m_tv_usec = 0;
         m_crc32 = 0;
     }
+
+    int getSampleBytes() const { return m_sampleBytes & 0xF; }
+    int getNbBlocksPerDatagram() const { return 1 << (m_sampleBytes >> 4); }
+
+    /** Number of blocks per datagram must be a power of two. 1 is understood by all peers */
+    void setSampleBytes(int sampleBytes, int nbBlocksPerDatagram)
+    {
+        int log2BlocksPerDatagram = 0;
+
+        while ((1 << (log2BlocksPerDatagram + 1)) <= nbBlocksPerDatagram) {
+            log2BlocksPerDatagram++;
+        }
+
+        m_sampleBytes = (sampleBytes & 0xF) | (log2BlocksPerDatagram << 4);
+    }
 };
 
 struct SDRDaemonHeader
@@ -78,8 +94,9 @@ struct SDRDaemonHeader
     uint8_t  m_blockIndex;
     uint8_t  m_sampleBytes; //!<  number of bytes per sample (2 or 4) for this block
     uint8_t  m_sampleBits;  //!<  number of bits per sample
+    uint8_t  m_codec;       //!<  sample codec of the frame (SDRDaemonCodec::CodecType). 0: raw samples
+    uint8_t  m_codecBits;   //!<  number of bits per I or Q sample of the codec
     uint8_t  m_filler;
-    uint16_t m_filler2;
 
     void init()
     {
@@ -87,14 +104,29 @@ struct SDRDaemonHeader
         m_blockIndex = 0;
         m_sampleBytes = 2;
         m_sampleBits = 16;
+        m_codec = 0;
+        m_codecBits = 0;
         m_filler = 0;
-        m_filler2 = 0;
     }
 };
 
 static const int SDRDaemonUdpSize = UDPSINKFEC_UDPSIZE;
 static const int SDRDaemonNbOrginalBlocks = UDPSINKFEC_NBORIGINALBLOCKS;
 static const int SDRDaemonNbBytesPerBlock = UDPSINKFEC_UDPSIZE - sizeof(SDRDaemonHeader);
+static const int SDRDaemonMaxBlocksPerDatagram = UDPSINKFEC_MAXBLOCKSPERDATAGRAM;
+static const int SDRDaemonMaxDatagramSize = UDPSINKFEC_UDPSIZE * UDPSINKFEC_MAXBLOCKSPERDATAGRAM;
+
+/** Number of consecutive blocks packed in one datagram of the given size in bytes (from 512 to 8192 bytes) */
+inline int SDRDaemonNbBlocksPerDatagram(int datagramSize)
+{
+    int nbBlocks = 1;
+
+    while ((nbBlocks < SDRDaemonMaxBlocksPerDatagram) && (2 * nbBlocks * SDRDaemonUdpSize <= datagramSize)) {
+        nbBlocks *= 2;
+    }
+
+    return nbBlocks;
+}
 
 struct SDRDaemonProtectedBlock
 {
@@ -125,6 +157,7 @@ struct SDRDaemonTxControlBlock
     uint16_t m_frameIndex;
     int m_nbBlocksFEC;
     int m_txDelay;
+    int m_nbBlocksPerDatagram;
     QString m_dataAddress;
     uint16_t m_dataPort;
 
@@ -134,6 +167,7 @@ struct SDRDaemonTxControlBlock
         m_frameIndex = 0;
         m_nbBlocksFEC = 0;
         m_txDelay = 100;
+        m_nbBlocksPerDatagram = 1;
         m_dataAddress = "127.0.0.1";
         m_dataPort = 9090;
     }
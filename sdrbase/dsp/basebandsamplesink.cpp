@@ -1,6 +1,7 @@
 #include "basebandsamplesink.h"
 
 MESSAGE_CLASS_DEFINITION(BasebandSampleSink::MsgThreadedSink, Message)
+MESSAGE_CLASS_DEFINITION(BasebandSampleSink::MsgSamplesSkipped, Message)
 
 BasebandSampleSink::BasebandSampleSink() :
     m_guiMessageQueue(0)
@@ -50,6 +50,27 @@ public:
         { }
     };
 
+    /** Used to notify that samples were skipped just before the next feed (with ThreadedSampleSink skip ahead) */
+    class SDRBASE_API MsgSamplesSkipped : public Message {
+        MESSAGE_CLASS_DECLARATION
+
+    public:
+        quint32 getNbSamples() const { return m_nbSamples; }
+
+        static MsgSamplesSkipped* create(quint32 nbSamples)
+        {
+            return new MsgSamplesSkipped(nbSamples);
+        }
+
+    private:
+        quint32 m_nbSamples;
+
+        MsgSamplesSkipped(quint32 nbSamples) :
+            Message(),
+            m_nbSamples(nbSamples)
+        { }
+    };
+
 	BasebandSampleSink();
 	virtual ~BasebandSampleSink();
 
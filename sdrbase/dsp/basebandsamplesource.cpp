@@ -15,6 +15,8 @@
 // along with this program. If not, see <http://www.gnu.org/licenses/>.          //
 ///////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+
 #include "dsp/basebandsamplesource.h"
 #include "util/message.h"
 
@@ -56,14 +58,16 @@ void BasebandSampleSource::handleWriteToDeviceFifo(int nbSamples)
 
 void BasebandSampleSource::handleWriteToFifo(SampleSourceFifo *sampleFifo, int nbSamples)
 {
-    SampleVector::iterator writeAt;
-    sampleFifo->getWriteIterator(writeAt);
     pullAudio(nbSamples); // Pre-fetch input audio samples this is mandatory to keep things running smoothly
+    unsigned int remainder = nbSamples;
 
-    for (int i = 0; i < nbSamples; i++)
+    while (remainder > 0) // at most two spans as the FIFO wraps around
     {
-        pull((*writeAt));
-        sampleFifo->bumpIndex(writeAt);
+        SampleVector::iterator writeAt;
+        unsigned int count = std::min(remainder, sampleFifo->getWriteSpan(writeAt));
+        pullBlock(writeAt, count);
+        sampleFifo->bumpIndex(count);
+        remainder -= count;
     }
 }
 
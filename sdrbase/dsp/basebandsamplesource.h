@@ -37,18 +37,18 @@ public:
 	virtual void pull(Sample& sample) = 0;
     virtual void pullAudio(int nbSamples) { (void) nbSamples; }
 
+    /** Pull a block of contiguous samples. Sources should override it to process the whole block at once. */
+    virtual void pullBlock(SampleVector::iterator begin, unsigned int nbSamples)
+    {
+        for (unsigned int i = 0; i < nbSamples; i++) {
+            pull(begin[i]);
+        }
+    }
+
     /** direct feeding of sample source FIFO */
 	void feed(SampleSourceFifo* sampleFifo, int nbSamples)
 	{
-	    SampleVector::iterator writeAt;
-	    sampleFifo->getWriteIterator(writeAt);
-	    pullAudio(nbSamples); // Pre-fetch input audio samples this is mandatory to keep things running smoothly
-
-	    for (int i = 0; i < nbSamples; i++)
-	    {
-	        pull((*writeAt));
-	        sampleFifo->bumpIndex(writeAt);
-	    }
+	    handleWriteToFifo(sampleFifo, nbSamples);
 	}
 
 	SampleSourceFifo& getSampleSourceFifo() { return m_sampleFifo; }
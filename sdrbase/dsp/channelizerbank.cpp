@@ -0,0 +1,218 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+
+#include <algorithm>
+#include <cmath>
+
+#include "dsp/fftengine.h"
+#include "channelizerbank.h"
+
+ChannelizerBank::ChannelizerBank(unsigned int log2NbChannels, unsigned int tapsPerPhase) :
+    m_nbChannels(1 << log2NbChannels),
+    m_decimation(1 << (log2NbChannels - 1)),
+    m_tapsPerPhase(tapsPerPhase),
+    m_filterLength(m_nbChannels * tapsPerPhase),
+    m_sampleRate(0),
+    m_historyIndex(0),
+    m_phase(0),
+    m_oddOutput(false),
+    m_refCounts(m_nbChannels, 0),
+    m_channelSamples(m_nbChannels)
+{
+    m_fft = FFTEngine::create();
+
+    if (m_fft) {
+        m_fft->configure(m_nbChannels, true);
+    }
+
+    m_history.resize(2*m_filterLength);
+    computeTaps();
+}
+
+ChannelizerBank::~ChannelizerBank()
+{
+    delete m_fft;
+}
+
+void ChannelizerBank::computeTaps()
+{
+    // Blackman windowed sinc with cutoff at the channel spacing (fs/M). The transition band
+    // spans about 0.75 to 1.25 fs/M so that the +/-0.75 fs/M part of each channel is not
+    // aliased after decimation by M/2.
+    m_taps.resize(m_filterLength);
+    double fc = 1.0 / m_nbChannels;
+    double mid = (m_filterLength - 1) / 2.0;
+    double sum = 0.0;
+
+    for (unsigned int i = 0; i < m_filterLength; i++)
+    {
+        double t = i - mid;
+        double sinc = t == 0.0 ? 2.0*fc : std::sin(2.0*M_PI*fc*t) / (M_PI*t);
+        double w = 0.42
+            - 0.5 * std::cos((2.0*M_PI*i) / (m_filterLength - 1))
+            + 0.08 * std::cos((4.0*M_PI*i) / (m_filterLength - 1));
+        m_taps[i] = sinc * w;
+        sum += m_taps[i];
+    }
+
+    for (unsigned int i = 0; i < m_filterLength; i++) {
+        m_taps[i] /= sum; // unity gain at channel center
+    }
+}
+
+void ChannelizerBank::setSampleRate(int sampleRate)
+{
+    if (sampleRate != m_sampleRate)
+    {
+        m_sampleRate = sampleRate;
+        reset();
+    }
+}
+
+int ChannelizerBank::getChannelSampleRate() const
+{
+    return (2 * m_sampleRate) / (int) m_nbChannels;
+}
+
+qint64 ChannelizerBank::getChannelFrequency(int channel) const
+{
+    int k = channel < (int) (m_nbChannels/2) ? channel : channel - (int) m_nbChannels;
+    return ((qint64) k * m_sampleRate) / m_nbChannels;
+}
+
+int ChannelizerBank::getChannelIndex(qint64 centerFrequency, int bandwidth) const
+{
+    // channel rates and frequencies must be exact
+    if ((m_fft == 0) || (m_sampleRate <= 0) || (m_sampleRate % m_nbChannels != 0) || (bandwidth <= 0)) {
+        return -1;
+    }
+
+    qint64 spacing = m_sampleRate / m_nbChannels;
+    qint64 k = centerFrequency >= 0 ?
+            (centerFrequency + spacing/2) / spacing :
+            -((-centerFrequency + spacing/2) / spacing);
+
+    // the channel straddling the Nyquist frequency is not usable
+    if ((k <= -(qint64) (m_nbChannels/2)) || (k >= (qint64) (m_nbChannels/2))) {
+        return -1;
+    }
+
+    qint64 distance = centerFrequency - k*spacing;
+    distance = distance < 0 ? -distance : distance;
+
+    if (distance + bandwidth/2 > (3*spacing)/4) {
+        return -1;
+    }
+
+    return k < 0 ? k + m_nbChannels : k;
+}
+
+void ChannelizerBank::addChannel(int channel)
+{
+    if ((channel < 0) || (channel >= (int) m_nbChannels)) {
+        return;
+    }
+
+    if (m_refCounts[channel]++ == 0)
+    {
+        m_activeChannels.push_back(channel);
+        m_channelSamples[channel].reserve(m_decimation);
+    }
+}
+
+void ChannelizerBank::removeChannel(int channel)
+{
+    if ((channel < 0) || (channel >= (int) m_nbChannels) || (m_refCounts[channel] == 0)) {
+        return;
+    }
+
+    if (--m_refCounts[channel] == 0)
+    {
+        m_activeChannels.erase(std::find(m_activeChannels.begin(), m_activeChannels.end(), channel));
+        m_channelSamples[channel].clear();
+    }
+}
+
+void ChannelizerBank::reset()
+{
+    std::fill(m_history.begin(), m_history.end(), Complex{0.0f, 0.0f});
+    m_historyIndex = 0;
+    m_phase = 0;
+    m_oddOutput = false;
+}
+
+void ChannelizerBank::feed(const SampleVector::const_iterator& begin, const SampleVector::const_iterator& end)
+{
+    for (std::vector<int>::const_iterator it = m_activeChannels.begin(); it != m_activeChannels.end(); ++it) {
+        m_channelSamples[*it].clear();
+    }
+
+    if ((m_fft == 0) || m_activeChannels.empty()) {
+        return;
+    }
+
+    for (SampleVector::const_iterator it = begin; it != end; ++it)
+    {
+        // history is stored newest first and mirrored so that a whole filter length can be read from m_historyIndex
+        m_historyIndex = m_historyIndex == 0 ? m_filterLength - 1 : m_historyIndex - 1;
+        Complex c(it->m_real, it->m_imag);
+        m_history[m_historyIndex] = c;
+        m_history[m_historyIndex + m_filterLength] = c;
+
+        if (++m_phase == m_decimation)
+        {
+            m_phase = 0;
+            produce();
+        }
+    }
+}
+
+void ChannelizerBank::produce()
+{
+    // polyphase partial sums: v[r] = sum over p of h[pM+r] * x[n-pM-r]
+    const Complex *x = &m_history[m_historyIndex];
+    const Real *h = &m_taps[0];
+    Complex *v = m_fft->in();
+
+    for (unsigned int r = 0; r < m_nbChannels; r++) {
+        v[r] = Complex{0.0f, 0.0f};
+    }
+
+    for (unsigned int p = 0; p < m_tapsPerPhase; p++)
+    {
+        for (unsigned int r = 0; r < m_nbChannels; r++) {
+            v[r] += h[r] * x[r];
+        }
+
+        x += m_nbChannels;
+        h += m_nbChannels;
+    }
+
+    // the inverse DFT brings each channel to baseband. With a decimation of M/2 the remaining
+    // modulation term is (-1)^(k*m) that only affects odd channels on odd outputs.
+    m_fft->transform();
+    const Complex *y = m_fft->out();
+
+    for (std::vector<int>::const_iterator it = m_activeChannels.begin(); it != m_activeChannels.end(); ++it)
+    {
+        Complex s = (m_oddOutput && (*it & 1)) ? -y[*it] : y[*it];
+        m_channelSamples[*it].push_back(Sample((FixReal) s.real(), (FixReal) s.imag()));
+    }
+
+    m_oddOutput = !m_oddOutput;
+}
@@ -0,0 +1,81 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef SDRBASE_DSP_CHANNELIZERBANK_H_
+#define SDRBASE_DSP_CHANNELIZERBANK_H_
+
+#include <vector>
+
+#include "dsp/dsptypes.h"
+#include "export.h"
+
+class FFTEngine;
+
+/**
+ * Polyphase filter bank channelizer. The baseband is split into M channels spaced by fs/M
+ * with one FFT of size M every M/2 input samples (2x oversampled so that each channel
+ * output at 2fs/M has no gap between adjacent channels). Only the channels that have been
+ * added produce samples. A channel plugin whose band fits in one of these channels can
+ * start its own DownChannelizer chain at the channel rate instead of the device rate.
+ */
+class SDRBASE_API ChannelizerBank
+{
+public:
+    ChannelizerBank(unsigned int log2NbChannels = 6, unsigned int tapsPerPhase = 12);
+    ~ChannelizerBank();
+
+    void setSampleRate(int sampleRate);
+    int getSampleRate() const { return m_sampleRate; }
+    unsigned int getNbChannels() const { return m_nbChannels; }
+    int getChannelSampleRate() const;                 //!< output sample rate of one channel
+    unsigned int getDecimation() const { return m_decimation; } //!< input samples per channel output sample
+    qint64 getChannelFrequency(int channel) const;    //!< center frequency of the channel relative to the baseband center
+    int getChannelIndex(qint64 centerFrequency, int bandwidth) const; //!< channel that contains the band or -1 if none
+
+    void addChannel(int channel);    //!< channels are reference counted
+    void removeChannel(int channel);
+    bool isChannelActive(int channel) const { return m_refCounts[channel] > 0; }
+    bool hasActiveChannels() const { return m_activeChannels.size() > 0; }
+    void reset();                    //!< clear history
+
+    void feed(const SampleVector::const_iterator& begin, const SampleVector::const_iterator& end);
+    const SampleVector& getChannelSamples(int channel) const { return m_channelSamples[channel]; } //!< samples produced by the last feed
+
+private:
+    unsigned int m_nbChannels;    //!< M (FFT size)
+    unsigned int m_decimation;    //!< M/2
+    unsigned int m_tapsPerPhase;
+    unsigned int m_filterLength;  //!< M * taps per phase
+    int m_sampleRate;
+    FFTEngine *m_fft;
+
+    std::vector<Real> m_taps;     //!< prototype low pass filter
+    std::vector<Complex> m_history; //!< twice the filter length so that the newest samples are always contiguous
+    unsigned int m_historyIndex;
+    unsigned int m_phase;         //!< input samples since last output
+    bool m_oddOutput;
+
+    std::vector<int> m_refCounts;
+    std::vector<int> m_activeChannels;
+    std::vector<SampleVector> m_channelSamples;
+
+    void computeTaps();
+    void produce();
+};
+
+#endif /* SDRBASE_DSP_CHANNELIZERBANK_H_ */
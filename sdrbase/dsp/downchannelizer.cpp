@@ -18,11 +18,17 @@
 #include <dsp/downchannelizer.h>
 #include "dsp/inthalfbandfilter.h"
 #include "dsp/dspcommands.h"
+#include "util/messagequeue.h"
+
+#include <algorithm>
 
 #include <QString>
 #include <QDebug>
 
 MESSAGE_CLASS_DEFINITION(DownChannelizer::MsgChannelizerNotification, Message)
+MESSAGE_CLASS_DEFINITION(DownChannelizer::MsgChannelizerBankAttach, Message)
+MESSAGE_CLASS_DEFINITION(DownChannelizer::MsgChannelizerBankRequest, Message)
+MESSAGE_CLASS_DEFINITION(DownChannelizer::MsgChannelizerBankInput, Message)
 
 DownChannelizer::DownChannelizer(BasebandSampleSink* sampleSink) :
 	m_sampleSink(sampleSink),
@@ -30,7 +36,11 @@ DownChannelizer::DownChannelizer(BasebandSampleSink* sampleSink) :
 	m_requestedOutputSampleRate(0),
 	m_requestedCenterFrequency(0),
 	m_currentOutputSampleRate(0),
-	m_currentCenterFrequency(0)
+	m_currentCenterFrequency(0),
+	m_bankEngineQueue(0),
+	m_bankThreadedSink(0),
+	m_bankSampleRate(0),
+	m_bankFrequencyOffset(0)
 {
 	QString name = "DownChannelizer(" + m_sampleSink->objectName() + ")";
 	setObjectName(name);
@@ -50,7 +60,6 @@ void DownChannelizer::configure(MessageQueue* messageQueue, int sampleRate, int
 void DownChannelizer::feed(const SampleVector::const_iterator& begin, const SampleVector::const_iterator& end, bool positiveOnly)
 {
 	if(m_sampleSink == 0) {
-		m_sampleBuffer.clear();
 		return;
 	}
 
@@ -60,33 +69,40 @@ void DownChannelizer::feed(const SampleVector::const_iterator& begin, const Samp
 	}
 	else
 	{
-		m_mutex.lock();
+		// The first stage reads the input block and writes half of it in the scratch buffer.
+		// Next stages work in place in the scratch buffer.
+		SampleVector::const_iterator chunkBegin = begin;
 
-		for(SampleVector::const_iterator sample = begin; sample != end; ++sample)
+		while (chunkBegin < end)
 		{
-			Sample s(*sample);
+			int count = std::min((int) (end - chunkBegin), 2*DOWNCHANNELIZER_BUFFER_SIZE);
+
+			m_mutex.lock();
+
 			FilterStages::iterator stage = m_filterStages.begin();
+			Sample *buffer = &m_sampleBuffer[0];
+			int nbSamples = (*stage)->work(&(*chunkBegin), buffer, count);
 
-			for (; stage != m_filterStages.end(); ++stage)
-			{
-				if(!(*stage)->work(&s))
-				{
-					break;
-				}
+			for (++stage; (stage != m_filterStages.end()) && (nbSamples > 0); ++stage) {
+				nbSamples = (*stage)->work(buffer, buffer, nbSamples);
 			}
 
-			if(stage == m_filterStages.end())
+			unsigned int nbStages = m_filterStages.size();
+
+			for (int i = 0; i < nbSamples; i++)
 			{
-			    s.m_real /= (1<<(m_filterStages.size()));
-			    s.m_imag /= (1<<(m_filterStages.size()));
-				m_sampleBuffer.push_back(s);
+				buffer[i].m_real /= (1<<nbStages);
+				buffer[i].m_imag /= (1<<nbStages);
 			}
-		}
 
-		m_mutex.unlock();
+			m_mutex.unlock();
 
-		m_sampleSink->feed(m_sampleBuffer.begin(), m_sampleBuffer.end(), positiveOnly);
-		m_sampleBuffer.clear();
+			if (nbSamples > 0) {
+				m_sampleSink->feed(m_sampleBuffer.begin(), m_sampleBuffer.begin() + nbSamples, positiveOnly);
+			}
+
+			chunkBegin += count;
+		}
 	}
 }
 
@@ -140,6 +156,33 @@ bool DownChannelizer::handleMessage(const Message& cmd)
 
 		applyConfiguration();
 
+		return true;
+	}
+	else if (MsgChannelizerBankAttach::match(cmd))
+	{
+		MsgChannelizerBankAttach& attach = (MsgChannelizerBankAttach&) cmd;
+		m_bankEngineQueue = attach.getEngineQueue();
+		m_bankThreadedSink = attach.getThreadedSink();
+		m_bankSampleRate = 0;
+		m_bankFrequencyOffset = 0;
+
+		qDebug() << "DownChannelizer::handleMessage: MsgChannelizerBankAttach:"
+				<< " engine queue: " << (m_bankEngineQueue != 0);
+
+		return true;
+	}
+	else if (MsgChannelizerBankInput::match(cmd))
+	{
+		MsgChannelizerBankInput& input = (MsgChannelizerBankInput&) cmd;
+		m_bankSampleRate = input.getSampleRate();
+		m_bankFrequencyOffset = input.getFrequencyOffset();
+
+		qDebug() << "DownChannelizer::handleMessage: MsgChannelizerBankInput:"
+				<< " m_bankSampleRate: " << m_bankSampleRate
+				<< " m_bankFrequencyOffset: " << m_bankFrequencyOffset;
+
+		applyConfiguration();
+
 		return true;
 	}
     else if (BasebandSampleSink::MsgThreadedSink::match(cmd))
@@ -162,21 +205,27 @@ void DownChannelizer::applyConfiguration()
 		return;
 	}
 
+	// when fed by a channel of the device engine filter bank the chain starts from that channel
+	int inputSampleRate = m_bankSampleRate > 0 ? m_bankSampleRate : m_inputSampleRate;
+	qint64 inputFrequencyOffset = m_bankSampleRate > 0 ? m_bankFrequencyOffset : 0;
+
 	m_mutex.lock();
 
 	freeFilterChain();
+	m_sampleBuffer.resize(DOWNCHANNELIZER_BUFFER_SIZE);
 
 	m_currentCenterFrequency = createFilterChain(
-		m_inputSampleRate / -2, m_inputSampleRate / 2,
+		inputFrequencyOffset - inputSampleRate / 2, inputFrequencyOffset + inputSampleRate / 2,
 		m_requestedCenterFrequency - m_requestedOutputSampleRate / 2, m_requestedCenterFrequency + m_requestedOutputSampleRate / 2);
 
 	m_mutex.unlock();
 
 	//debugFilterChain();
 
-	m_currentOutputSampleRate = m_inputSampleRate / (1 << m_filterStages.size());
+	m_currentOutputSampleRate = inputSampleRate / (1 << m_filterStages.size());
 
-	qDebug() << "DownChannelizer::applyConfiguration in=" << m_inputSampleRate
+	qDebug() << "DownChannelizer::applyConfiguration in=" << inputSampleRate
+			<< ", bank=" << (m_bankSampleRate > 0)
 			<< ", req=" << m_requestedOutputSampleRate
 			<< ", out=" << m_currentOutputSampleRate
 			<< ", fc=" << m_currentCenterFrequency;
@@ -186,6 +235,13 @@ void DownChannelizer::applyConfiguration()
 		MsgChannelizerNotification *notif = MsgChannelizerNotification::create(m_currentOutputSampleRate, m_currentCenterFrequency);
 		m_sampleSink->getInputMessageQueue()->push(notif);
 	}
+
+	if (m_bankEngineQueue && (m_requestedOutputSampleRate > 0))
+	{
+		MsgChannelizerBankRequest *request = MsgChannelizerBankRequest::create(
+				m_bankThreadedSink, m_requestedCenterFrequency, m_requestedOutputSampleRate);
+		m_bankEngineQueue->push(request);
+	}
 }
 
 #ifdef SDR_RX_SAMPLE_24BIT
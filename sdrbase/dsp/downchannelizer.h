@@ -26,8 +26,10 @@
 #include "dsp/inthalfbandfiltereo.h"
 
 #define DOWNCHANNELIZER_HB_FILTER_ORDER 48
+#define DOWNCHANNELIZER_BUFFER_SIZE (1<<14) //!< scratch buffer size in samples (input is processed by chunks of twice this size)
 
 class MessageQueue;
+class ThreadedBasebandSampleSink;
 
 class SDRBASE_API DownChannelizer : public BasebandSampleSink {
 	Q_OBJECT
@@ -55,6 +57,78 @@ public:
 		qint64 m_frequencyOffset;
 	};
 
+    /**
+     * Sent by the device engine so that the channelizer can ask for a channel of the engine filter bank
+     */
+    class SDRBASE_API MsgChannelizerBankAttach : public Message {
+        MESSAGE_CLASS_DECLARATION
+
+    public:
+        MessageQueue *getEngineQueue() const { return m_engineQueue; }
+        ThreadedBasebandSampleSink *getThreadedSink() const { return m_threadedSink; }
+
+        MsgChannelizerBankAttach(MessageQueue *engineQueue, ThreadedBasebandSampleSink *threadedSink) :
+            Message(),
+            m_engineQueue(engineQueue),
+            m_threadedSink(threadedSink)
+        { }
+
+    private:
+        MessageQueue *m_engineQueue;
+        ThreadedBasebandSampleSink *m_threadedSink;
+    };
+
+    /**
+     * Sent to the device engine when the channel band changes
+     */
+    class SDRBASE_API MsgChannelizerBankRequest : public Message {
+        MESSAGE_CLASS_DECLARATION
+
+    public:
+        ThreadedBasebandSampleSink *getThreadedSink() const { return m_threadedSink; }
+        qint64 getCenterFrequency() const { return m_centerFrequency; }
+        int getBandwidth() const { return m_bandwidth; }
+
+        static MsgChannelizerBankRequest* create(ThreadedBasebandSampleSink *threadedSink, qint64 centerFrequency, int bandwidth)
+        {
+            return new MsgChannelizerBankRequest(threadedSink, centerFrequency, bandwidth);
+        }
+
+    private:
+        ThreadedBasebandSampleSink *m_threadedSink;
+        qint64 m_centerFrequency;
+        int m_bandwidth;
+
+        MsgChannelizerBankRequest(ThreadedBasebandSampleSink *threadedSink, qint64 centerFrequency, int bandwidth) :
+            Message(),
+            m_threadedSink(threadedSink),
+            m_centerFrequency(centerFrequency),
+            m_bandwidth(bandwidth)
+        { }
+    };
+
+    /**
+     * Sent by the device engine when the input switches to a filter bank channel
+     * (sample rate and frequency offset of that channel) or back to the baseband (sample rate 0)
+     */
+    class SDRBASE_API MsgChannelizerBankInput : public Message {
+        MESSAGE_CLASS_DECLARATION
+
+    public:
+        int getSampleRate() const { return m_sampleRate; }
+        qint64 getFrequencyOffset() const { return m_frequencyOffset; }
+
+        MsgChannelizerBankInput(int sampleRate, qint64 frequencyOffset) :
+            Message(),
+            m_sampleRate(sampleRate),
+            m_frequencyOffset(frequencyOffset)
+        { }
+
+    private:
+        int m_sampleRate;
+        qint64 m_frequencyOffset;
+    };
+
 	DownChannelizer(BasebandSampleSink* sampleSink);
 	virtual ~DownChannelizer();
 
@@ -76,10 +150,10 @@ protected:
 		};
 
 #ifdef SDR_RX_SAMPLE_24BIT
-        typedef bool (IntHalfbandFilterEO<qint64, qint64, DOWNCHANNELIZER_HB_FILTER_ORDER>::*WorkFunction)(Sample* s);
+        typedef int (IntHalfbandFilterEO<qint64, qint64, DOWNCHANNELIZER_HB_FILTER_ORDER>::*WorkFunction)(const Sample* in, Sample* out, int count);
         IntHalfbandFilterEO<qint64, qint64, DOWNCHANNELIZER_HB_FILTER_ORDER>* m_filter;
 #else
-        typedef bool (IntHalfbandFilterEO<qint32, qint32, DOWNCHANNELIZER_HB_FILTER_ORDER>::*WorkFunction)(Sample* s);
+        typedef int (IntHalfbandFilterEO<qint32, qint32, DOWNCHANNELIZER_HB_FILTER_ORDER>::*WorkFunction)(const Sample* in, Sample* out, int count);
         IntHalfbandFilterEO<qint32, qint32, DOWNCHANNELIZER_HB_FILTER_ORDER>* m_filter;
 #endif
 
@@ -90,9 +164,9 @@ protected:
 		FilterStage(Mode mode);
 		~FilterStage();
 
-		bool work(Sample* sample)
+		int work(const Sample* in, Sample* out, int count) //!< decimate a block by 2, returns output count
 		{
-			return (m_filter->*m_workFunction)(sample);
+			return (m_filter->*m_workFunction)(in, out, count);
 		}
 	};
 	typedef std::list<FilterStage*> FilterStages;
@@ -103,7 +177,11 @@ protected:
 	int m_requestedCenterFrequency;
 	int m_currentOutputSampleRate;
 	int m_currentCenterFrequency;
-	SampleVector m_sampleBuffer;
+	MessageQueue *m_bankEngineQueue;            //!< device engine queue for filter bank requests
+	ThreadedBasebandSampleSink *m_bankThreadedSink;
+	int m_bankSampleRate;                       //!< input is a filter bank channel at this rate (0 for the baseband)
+	qint64 m_bankFrequencyOffset;               //!< center of the filter bank channel in the baseband
+	SampleVector m_sampleBuffer; //!< scratch buffer shared by all stages (allocated once)
 	QMutex m_mutex;
 
 	void applyConfiguration();
@@ -37,6 +37,9 @@ MESSAGE_CLASS_DEFINITION(DSPRemoveBasebandSampleSource, Message)
 MESSAGE_CLASS_DEFINITION(DSPAddThreadedBasebandSampleSink, Message)
 MESSAGE_CLASS_DEFINITION(DSPAddThreadedBasebandSampleSource, Message)
 MESSAGE_CLASS_DEFINITION(DSPRemoveThreadedBasebandSampleSink, Message)
+MESSAGE_CLASS_DEFINITION(DSPAddThreadedSpectrumSink, Message)
+MESSAGE_CLASS_DEFINITION(DSPRemoveThreadedSpectrumSink, Message)
+MESSAGE_CLASS_DEFINITION(DSPGetThreadedBasebandSampleSinks, Message)
 MESSAGE_CLASS_DEFINITION(DSPRemoveThreadedBasebandSampleSource, Message)
 MESSAGE_CLASS_DEFINITION(DSPAddAudioSink, Message)
 MESSAGE_CLASS_DEFINITION(DSPRemoveAudioSink, Message)
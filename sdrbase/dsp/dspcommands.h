@@ -19,6 +19,7 @@
 #define INCLUDE_DSPCOMMANDS_H
 
 #include <QString>
+#include <vector>
 #include "util/message.h"
 #include "fftwindow.h"
 #include "export.h"
@@ -220,6 +221,44 @@ private:
 	ThreadedBasebandSampleSink* m_threadedSampleSink;
 };
 
+class SDRBASE_API DSPAddThreadedSpectrumSink : public Message {
+	MESSAGE_CLASS_DECLARATION
+
+public:
+	DSPAddThreadedSpectrumSink(ThreadedBasebandSampleSink* threadedSampleSink) : Message(), m_threadedSampleSink(threadedSampleSink) { }
+
+	ThreadedBasebandSampleSink* getThreadedSampleSink() const { return m_threadedSampleSink; }
+
+private:
+	ThreadedBasebandSampleSink* m_threadedSampleSink;
+};
+
+class SDRBASE_API DSPRemoveThreadedSpectrumSink : public Message {
+	MESSAGE_CLASS_DECLARATION
+
+public:
+	DSPRemoveThreadedSpectrumSink(BasebandSampleSink* sampleSink) : Message(), m_sampleSink(sampleSink), m_threadedSampleSink(0) { }
+
+	BasebandSampleSink* getSampleSink() const { return m_sampleSink; }
+	void setThreadedSampleSink(ThreadedBasebandSampleSink* threadedSampleSink) { m_threadedSampleSink = threadedSampleSink; }
+	ThreadedBasebandSampleSink* getThreadedSampleSink() const { return m_threadedSampleSink; } //!< detached by the engine or null if it was not the spectrum sink
+
+private:
+	BasebandSampleSink* m_sampleSink;
+	ThreadedBasebandSampleSink* m_threadedSampleSink;
+};
+
+class SDRBASE_API DSPGetThreadedBasebandSampleSinks : public Message {
+	MESSAGE_CLASS_DECLARATION
+
+public:
+	void setThreadedSampleSinks(const std::vector<ThreadedBasebandSampleSink*>& threadedSampleSinks) { m_threadedSampleSinks = threadedSampleSinks; }
+	const std::vector<ThreadedBasebandSampleSink*>& getThreadedSampleSinks() const { return m_threadedSampleSinks; }
+
+private:
+	std::vector<ThreadedBasebandSampleSink*> m_threadedSampleSinks;
+};
+
 class SDRBASE_API DSPRemoveThreadedBasebandSampleSource : public Message {
 	MESSAGE_CLASS_DECLARATION
 
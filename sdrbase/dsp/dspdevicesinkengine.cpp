@@ -16,6 +16,7 @@
 ///////////////////////////////////////////////////////////////////////////////////
 
 #include <stdio.h>
+#include <algorithm>
 #include <QDebug>
 #include <QThread>
 
@@ -25,6 +26,7 @@
 #include "dsp/basebandsamplesink.h"
 #include "dsp/devicesamplesink.h"
 #include "dsp/dspcommands.h"
+#include "dsp/samplemixerkernels.h"
 #include "samplesourcefifo.h"
 #include "threadedbasebandsamplesource.h"
 
@@ -38,7 +40,7 @@ DSPDeviceSinkEngine::DSPDeviceSinkEngine(uint32_t uid, QObject* parent) :
 	m_spectrumSink(0),
 	m_sampleRate(0),
 	m_centerFrequency(0),
-	m_multipleSourcesDivisionFactor(1)
+	m_multipleSourcesDivisionShift(0)
 {
 	connect(&m_inputMessageQueue, SIGNAL(messageEnqueued()), this, SLOT(handleInputMessages()), Qt::QueuedConnection);
 	connect(&m_syncMessenger, SIGNAL(messageSent()), this, SLOT(handleSynchronousMessages()), Qt::QueuedConnection);
@@ -175,46 +177,42 @@ void DSPDeviceSinkEngine::work(int nbWriteSamples)
 	// multiple channel sources handling
 	if ((m_threadedBasebandSampleSources.size() + m_basebandSampleSources.size()) > 1)
 	{
-//	    qDebug("DSPDeviceSinkEngine::work: multiple channel sources handling: %u", m_multipleSourcesDivisionFactor);
+//	    qDebug("DSPDeviceSinkEngine::work: multiple channel sources handling: %u", m_multipleSourcesDivisionShift);
 
-	    SampleVector::iterator writeBegin;
 	    SampleSourceFifo* sampleFifo = m_deviceSampleSink->getSampleFifo();
-	    sampleFifo->getWriteIterator(writeBegin);
-	    SampleVector::iterator writeAt = writeBegin;
-	    std::vector<SampleVector::iterator> sampleSourceIterators;
+	    std::vector<const Sample*> sampleSourceSpans;
 
+	    // the sources FIFOs are double buffered so the last nbWriteSamples read are contiguous
 	    for (ThreadedBasebandSampleSources::iterator it = m_threadedBasebandSampleSources.begin(); it != m_threadedBasebandSampleSources.end(); ++it)
 	    {
-	        sampleSourceIterators.push_back(SampleVector::iterator());
-	        (*it)->getSampleSourceFifo().readAdvance(sampleSourceIterators.back(), nbWriteSamples);
-	        sampleSourceIterators.back() -= nbWriteSamples;
+	        SampleVector::iterator readUntil;
+	        (*it)->getSampleSourceFifo().readAdvance(readUntil, nbWriteSamples);
+	        sampleSourceSpans.push_back(&(*(readUntil - nbWriteSamples)));
 	    }
 
 	    for (BasebandSampleSources::iterator it = m_basebandSampleSources.begin(); it != m_basebandSampleSources.end(); ++it)
 	    {
-            sampleSourceIterators.push_back(SampleVector::iterator());
-            (*it)->getSampleSourceFifo().readAdvance(sampleSourceIterators.back(), nbWriteSamples);
-            sampleSourceIterators.back() -= nbWriteSamples;
+	        SampleVector::iterator readUntil;
+	        (*it)->getSampleSourceFifo().readAdvance(readUntil, nbWriteSamples);
+	        sampleSourceSpans.push_back(&(*(readUntil - nbWriteSamples)));
 	    }
 
-	    for (int is = 0; is < nbWriteSamples; is++)
-		{
-			// pull data from sources FIFOs and merge them in the device sample FIFO
-	        for (std::vector<SampleVector::iterator>::iterator it = sampleSourceIterators.begin(); it != sampleSourceIterators.end(); ++it)
-	        {
-	            Sample s = (**it);
-	            s /= m_multipleSourcesDivisionFactor;
-	            ++(*it);
-
-	            if (it == sampleSourceIterators.begin()) {
-	                (*writeAt) = s;
-	            } else {
-	                (*writeAt) += s;
-	            }
+	    unsigned int remainder = nbWriteSamples;
+
+	    while (remainder > 0) // at most two spans as the device FIFO wraps around
+	    {
+	        // mix the sources directly in the device sample FIFO
+	        SampleVector::iterator writeAt;
+	        unsigned int count = std::min(remainder, sampleFifo->getWriteSpan(writeAt));
+	        SampleMixerKernels::mix(sampleSourceSpans.data(), sampleSourceSpans.size(), &(*writeAt), count, m_multipleSourcesDivisionShift);
+	        sampleFifo->bumpIndex(count);
+
+	        for (std::vector<const Sample*>::iterator it = sampleSourceSpans.begin(); it != sampleSourceSpans.end(); ++it) {
+	            *it += count;
 	        }
 
-			sampleFifo->bumpIndex(writeAt);
-		}
+	        remainder -= count;
+	    }
 	}
 }
 
@@ -595,7 +593,7 @@ void DSPDeviceSinkEngine::checkNumberOfBasebandSources()
             m_basebandSampleSources.back()->setDeviceSampleSourceFifo(sampleFifo);
         }
 
-        m_multipleSourcesDivisionFactor = 1; // for consistency but it is not used in this case
+        m_multipleSourcesDivisionShift = 0; // for consistency but it is not used in this case
     }
     // null or multiple channel sources handling
     else
@@ -614,12 +612,12 @@ void DSPDeviceSinkEngine::checkNumberOfBasebandSources()
             nbSources++;
         }
 
-        if (nbSources == 0) {
-            m_multipleSourcesDivisionFactor = 1;
+        if (nbSources < 2) {
+            m_multipleSourcesDivisionShift = 0;
         } else if (nbSources < 3) {
-            m_multipleSourcesDivisionFactor = nbSources;
+            m_multipleSourcesDivisionShift = 1;
         } else {
-            m_multipleSourcesDivisionFactor = 1<<nbSources;
+            m_multipleSourcesDivisionShift = nbSources;
         }
 
         if (nbSources > 1) {
@@ -114,7 +114,7 @@ private:
 
 	uint32_t m_sampleRate;
 	quint64 m_centerFrequency;
-	uint32_t m_multipleSourcesDivisionFactor;
+	uint32_t m_multipleSourcesDivisionShift; //!< each source is divided by 2^shift before mixing
 
 	void run();
 	void work(int nbWriteSamples); //!< transfer samples from beseband sources to sink if in running state
@@ -21,12 +21,15 @@
 #include <dsp/devicesamplesource.h>
 #include <dsp/downchannelizer.h>
 #include <stdio.h>
+#include <algorithm>
 #include <QDebug>
 #include "dsp/dspcommands.h"
 #include "util/fixed.h"
 #include "samplesinkfifo.h"
 #include "threadedbasebandsamplesink.h"
 
+QAtomicInt DSPDeviceSourceEngine::m_useChannelizerBank(0);
+
 DSPDeviceSourceEngine::DSPDeviceSourceEngine(uint uid, QObject* parent) :
 	QThread(parent),
     m_uid(uid),
@@ -34,6 +37,8 @@ DSPDeviceSourceEngine::DSPDeviceSourceEngine(uint uid, QObject* parent) :
 	m_deviceSampleSource(0),
 	m_sampleSourceSequence(0),
 	m_basebandSampleSinks(),
+	m_threadedSinksFifo(1<<19),
+	m_threadedSpectrumSink(0),
 	m_sampleRate(0),
 	m_centerFrequency(0),
 	m_dcOffsetCorrection(false),
@@ -54,6 +59,10 @@ DSPDeviceSourceEngine::~DSPDeviceSourceEngine()
 {
     stop();
     wait();
+
+    for (ChannelizerBankFifos::iterator it = m_channelizerBankFifos.begin(); it != m_channelizerBankFifos.end(); ++it) {
+        delete it->second;
+    }
 }
 
 void DSPDeviceSourceEngine::run()
@@ -135,6 +144,26 @@ void DSPDeviceSourceEngine::removeSink(BasebandSampleSink* sink)
 	m_syncMessenger.sendWait(cmd);
 }
 
+void DSPDeviceSourceEngine::addSpectrumSink(BasebandSampleSink* spectrumSink)
+{
+	qDebug() << "DSPDeviceSourceEngine::addSpectrumSink: " << spectrumSink->objectName().toStdString().c_str();
+	// created here because the sink can only be moved to its thread from the thread it belongs to
+	ThreadedBasebandSampleSink *threadedSpectrumSink = new ThreadedBasebandSampleSink(spectrumSink);
+	threadedSpectrumSink->setFifoPolicy(SampleSinkBroadcastFifoReader::PolicyDrop);
+	threadedSpectrumSink->setMaxLag(m_threadedSinksFifo.size() / 8); // the display only needs recent samples
+	DSPAddThreadedSpectrumSink cmd(threadedSpectrumSink);
+	m_syncMessenger.sendWait(cmd);
+}
+
+void DSPDeviceSourceEngine::removeSpectrumSink(BasebandSampleSink* spectrumSink)
+{
+	qDebug() << "DSPDeviceSourceEngine::removeSpectrumSink: " << spectrumSink->objectName().toStdString().c_str();
+	// the threaded spectrum sink is looked up and detached in the engine thread that uses it
+	DSPRemoveThreadedSpectrumSink cmd(spectrumSink);
+	m_syncMessenger.sendWait(cmd);
+	delete cmd.getThreadedSampleSink();
+}
+
 void DSPDeviceSourceEngine::addThreadedSink(ThreadedBasebandSampleSink* sink)
 {
 	qDebug() << "DSPDeviceSourceEngine::addThreadedSink: " << sink->objectName().toStdString().c_str();
@@ -142,6 +171,13 @@ void DSPDeviceSourceEngine::addThreadedSink(ThreadedBasebandSampleSink* sink)
 	m_syncMessenger.sendWait(cmd);
 }
 
+void DSPDeviceSourceEngine::getThreadedSinks(std::vector<ThreadedBasebandSampleSink*>& sinks)
+{
+	DSPGetThreadedBasebandSampleSinks cmd;
+	m_syncMessenger.sendWait(cmd);
+	sinks = cmd.getThreadedSampleSinks();
+}
+
 void DSPDeviceSourceEngine::removeThreadedSink(ThreadedBasebandSampleSink* sink)
 {
 	qDebug() << "DSPDeviceSourceEngine::removeThreadedSink: " << sink->objectName().toStdString().c_str();
@@ -335,7 +371,16 @@ void DSPDeviceSourceEngine::work()
 		SampleVector::iterator part2begin;
 		SampleVector::iterator part2end;
 
-		std::size_t count = sampleFifo->readBegin(sampleFifo->fill(), &part1begin, &part1end, &part2begin, &part2end);
+		// threaded sinks with a back pressure policy leave unread samples in the device FIFO until they catch up
+		uint writable = channelizersWritable();
+
+		if (writable == 0)
+		{
+			QTimer::singleShot(1, this, SLOT(handleData())); // retry without blocking the message loop
+			break;
+		}
+
+		std::size_t count = sampleFifo->readBegin(std::min(sampleFifo->fill(), writable), &part1begin, &part1end, &part2begin, &part2end);
 
 		// first part of FIFO data
 		if (part1begin != part1end)
@@ -362,10 +407,11 @@ void DSPDeviceSourceEngine::work()
 				(*it)->feed(part1begin, part1end, positiveOnly);
 			}
 
-			// feed data to threaded sinks
-			for (ThreadedBasebandSampleSinks::const_iterator it = m_threadedBasebandSampleSinks.begin(); it != m_threadedBasebandSampleSinks.end(); ++it)
-			{
-				(*it)->feed(part1begin, part1end, positiveOnly);
+			// feed data to threaded sinks (written once and read by each sink thread)
+			m_threadedSinksFifo.write(part1begin, part1end);
+
+			if (m_channelizerBank.hasActiveChannels()) {
+				feedChannelizerBank(part1begin, part1end);
 			}
 		}
 
@@ -394,10 +440,11 @@ void DSPDeviceSourceEngine::work()
 				(*it)->feed(part2begin, part2end, positiveOnly);
 			}
 
-			// feed data to threaded sinks
-			for (ThreadedBasebandSampleSinks::const_iterator it = m_threadedBasebandSampleSinks.begin(); it != m_threadedBasebandSampleSinks.end(); ++it)
-			{
-				(*it)->feed(part2begin, part2end, positiveOnly);
+			// feed data to threaded sinks (written once and read by each sink thread)
+			m_threadedSinksFifo.write(part2begin, part2end);
+
+			if (m_channelizerBank.hasActiveChannels()) {
+				feedChannelizerBank(part2begin, part2end);
 			}
 		}
 
@@ -407,6 +454,128 @@ void DSPDeviceSourceEngine::work()
 	}
 }
 
+uint DSPDeviceSourceEngine::channelizersWritable() const
+{
+	uint writable = m_threadedSinksFifo.writable();
+	uint decimation = m_channelizerBank.getDecimation();
+
+	// a filter bank channel gets one sample every decimation input samples
+	for (ChannelizerBankFifos::const_iterator it = m_channelizerBankFifos.begin(); it != m_channelizerBankFifos.end(); ++it)
+	{
+		uint channelWritable = it->second->writable();
+		writable = std::min(writable, channelWritable == 0 ? 0 : (channelWritable - 1) * decimation);
+	}
+
+	return writable;
+}
+
+void DSPDeviceSourceEngine::feedChannelizerBank(const SampleVector::const_iterator& begin, const SampleVector::const_iterator& end)
+{
+	m_channelizerBank.feed(begin, end);
+
+	for (ChannelizerBankFifos::const_iterator it = m_channelizerBankFifos.begin(); it != m_channelizerBankFifos.end(); ++it)
+	{
+		const SampleVector& samples = m_channelizerBank.getChannelSamples(it->first);
+		it->second->write(samples.begin(), samples.end());
+	}
+}
+
+void DSPDeviceSourceEngine::setChannelizerBankSampleRate(int sampleRate)
+{
+	if (sampleRate == m_channelizerBank.getSampleRate()) {
+		return;
+	}
+
+	// channels change with the sample rate: go back to the baseband and let the
+	// channelizers request a channel again when they apply the new sample rate
+	for (ChannelizerBankAssignments::iterator it = m_channelizerBankAssignments.begin(); it != m_channelizerBankAssignments.end(); ++it) {
+		switchThreadedSinkChannel(it->first, -1);
+	}
+
+	m_channelizerBank.setSampleRate(sampleRate);
+}
+
+void DSPDeviceSourceEngine::attachThreadedSinkReader(ThreadedBasebandSampleSink *threadedSink, int channel)
+{
+	if (channel < 0)
+	{
+		threadedSink->setFifoReader(m_threadedSinksFifo.addReader(threadedSink->getFifoPolicy()));
+	}
+	else
+	{
+		ChannelizerBankFifos::iterator it = m_channelizerBankFifos.find(channel);
+
+		if (it == m_channelizerBankFifos.end()) {
+			it = m_channelizerBankFifos.insert(ChannelizerBankFifos::value_type(channel, new SampleSinkBroadcastFifo(1<<16))).first;
+		}
+
+		m_channelizerBank.addChannel(channel);
+		threadedSink->setFifoReader(it->second->addReader(threadedSink->getFifoPolicy()));
+	}
+
+	m_channelizerBankAssignments[threadedSink] = channel;
+}
+
+void DSPDeviceSourceEngine::detachThreadedSinkReader(ThreadedBasebandSampleSink *threadedSink)
+{
+	SampleSinkBroadcastFifoReader *reader = threadedSink->getFifoReader();
+	threadedSink->setFifoReader(0);
+	int channel = m_channelizerBankAssignments[threadedSink];
+
+	if (channel < 0)
+	{
+		m_threadedSinksFifo.removeReader(reader);
+	}
+	else
+	{
+		ChannelizerBankFifos::iterator it = m_channelizerBankFifos.find(channel);
+		it->second->removeReader(reader);
+		m_channelizerBank.removeChannel(channel);
+
+		if (!m_channelizerBank.isChannelActive(channel))
+		{
+			delete it->second;
+			m_channelizerBankFifos.erase(it);
+		}
+	}
+}
+
+void DSPDeviceSourceEngine::switchThreadedSinkChannel(ThreadedBasebandSampleSink *threadedSink, int channel)
+{
+	if (m_channelizerBankAssignments[threadedSink] == channel) {
+		return;
+	}
+
+	qDebug() << "DSPDeviceSourceEngine::switchThreadedSinkChannel: ThreadedSampleSink("
+		<< threadedSink->getSampleSinkObjectName().toStdString().c_str() << ") channel: " << channel;
+
+	// the sink thread is paused while its read cursor moves to the other FIFO
+	bool running = m_state == StRunning;
+
+	if (running) {
+		threadedSink->stop();
+	}
+
+	detachThreadedSinkReader(threadedSink);
+	attachThreadedSinkReader(threadedSink, channel);
+
+	// the channelizer rebuilds its chain for the new input
+	if (channel < 0)
+	{
+		DownChannelizer::MsgChannelizerBankInput msg(0, 0);
+		threadedSink->handleSinkMessage(msg);
+	}
+	else
+	{
+		DownChannelizer::MsgChannelizerBankInput msg(m_channelizerBank.getChannelSampleRate(), m_channelizerBank.getChannelFrequency(channel));
+		threadedSink->handleSinkMessage(msg);
+	}
+
+	if (running) {
+		threadedSink->start();
+	}
+}
+
 // notStarted -> idle -> init -> running -+
 //                ^                       |
 //                +-----------------------+
@@ -445,6 +614,10 @@ DSPDeviceSourceEngine::State DSPDeviceSourceEngine::gotoIdle()
         (*it)->stop();
     }
 
+    if (m_threadedSpectrumSink) {
+        m_threadedSpectrumSink->stop();
+    }
+
 	m_deviceSampleSource->stop();
 	m_deviceDescription.clear();
 	m_sampleRate = 0;
@@ -491,6 +664,7 @@ DSPDeviceSourceEngine::State DSPDeviceSourceEngine::gotoInit()
 			<< " centerFrequency: " << m_centerFrequency;
 
 	DSPSignalNotification notif(m_sampleRate, m_centerFrequency);
+	setChannelizerBankSampleRate(m_sampleRate);
 
 	for (BasebandSampleSinks::const_iterator it = m_basebandSampleSinks.begin(); it != m_basebandSampleSinks.end(); ++it)
 	{
@@ -504,6 +678,10 @@ DSPDeviceSourceEngine::State DSPDeviceSourceEngine::gotoInit()
 		(*it)->handleSinkMessage(notif);
 	}
 
+	if (m_threadedSpectrumSink) {
+		m_threadedSpectrumSink->handleSinkMessage(notif);
+	}
+
 	// pass data to listeners
 	if (m_deviceSampleSource->getMessageQueueToGUI())
 	{
@@ -553,12 +731,23 @@ DSPDeviceSourceEngine::State DSPDeviceSourceEngine::gotoRunning()
 		(*it)->start();
 	}
 
+	m_threadedSinksFifo.reset(); // threaded sinks are stopped here
+	m_channelizerBank.reset();
+
+	for (ChannelizerBankFifos::const_iterator it = m_channelizerBankFifos.begin(); it != m_channelizerBankFifos.end(); ++it) {
+		it->second->reset();
+	}
+
 	for (ThreadedBasebandSampleSinks::const_iterator it = m_threadedBasebandSampleSinks.begin(); it != m_threadedBasebandSampleSinks.end(); ++it)
 	{
 		qDebug() << "DSPDeviceSourceEngine::gotoRunning: starting ThreadedSampleSink(" << (*it)->getSampleSinkObjectName().toStdString().c_str() << ")";
 		(*it)->start();
 	}
 
+	if (m_threadedSpectrumSink) {
+		m_threadedSpectrumSink->start();
+	}
+
 	qDebug() << "DSPDeviceSourceEngine::gotoRunning:input message queue pending: " << m_inputMessageQueue.size();
 
 	return StRunning;
@@ -663,7 +852,15 @@ void DSPDeviceSourceEngine::handleSynchronousMessages()
 	else if (DSPAddThreadedBasebandSampleSink::match(*message))
 	{
 		ThreadedBasebandSampleSink *threadedSink = ((DSPAddThreadedBasebandSampleSink*) message)->getThreadedSampleSink();
+		attachThreadedSinkReader(threadedSink, -1);
 		m_threadedBasebandSampleSinks.push_back(threadedSink);
+
+		if (getUseChannelizerBank()) // let the channelizer request a filter bank channel
+		{
+			DownChannelizer::MsgChannelizerBankAttach attach(&m_inputMessageQueue, threadedSink);
+			threadedSink->handleSinkMessage(attach);
+		}
+
 		// initialize sample rate and center frequency in the sink:
 		DSPSignalNotification msg(m_sampleRate, m_centerFrequency);
 		threadedSink->handleSinkMessage(msg);
@@ -672,10 +869,44 @@ void DSPDeviceSourceEngine::handleSynchronousMessages()
             threadedSink->start();
         }
 	}
+	else if (DSPAddThreadedSpectrumSink::match(*message))
+	{
+		m_threadedSpectrumSink = ((DSPAddThreadedSpectrumSink*) message)->getThreadedSampleSink();
+		m_threadedSpectrumSink->setFifoReader(m_threadedSinksFifo.addReader(m_threadedSpectrumSink->getFifoPolicy()));
+		DSPSignalNotification msg(m_sampleRate, m_centerFrequency);
+		m_threadedSpectrumSink->handleSinkMessage(msg);
+
+		if(m_state == StRunning) {
+			m_threadedSpectrumSink->start();
+		}
+	}
+	else if (DSPRemoveThreadedSpectrumSink::match(*message))
+	{
+		DSPRemoveThreadedSpectrumSink *cmd = (DSPRemoveThreadedSpectrumSink*) message;
+
+		if (m_threadedSpectrumSink && (m_threadedSpectrumSink->getSink() == cmd->getSampleSink()))
+		{
+			m_threadedSpectrumSink->stop();
+			SampleSinkBroadcastFifoReader *reader = m_threadedSpectrumSink->getFifoReader();
+			m_threadedSpectrumSink->setFifoReader(0);
+			m_threadedSinksFifo.removeReader(reader);
+			cmd->setThreadedSampleSink(m_threadedSpectrumSink); // deleted by the caller
+			m_threadedSpectrumSink = 0;
+		}
+	}
+	else if (DSPGetThreadedBasebandSampleSinks::match(*message))
+	{
+		std::vector<ThreadedBasebandSampleSink*> threadedSinks(m_threadedBasebandSampleSinks.begin(), m_threadedBasebandSampleSinks.end());
+		((DSPGetThreadedBasebandSampleSinks*) message)->setThreadedSampleSinks(threadedSinks);
+	}
 	else if (DSPRemoveThreadedBasebandSampleSink::match(*message))
 	{
 		ThreadedBasebandSampleSink* threadedSink = ((DSPRemoveThreadedBasebandSampleSink*) message)->getThreadedSampleSink();
 		threadedSink->stop();
+		detachThreadedSinkReader(threadedSink);
+		m_channelizerBankAssignments.erase(threadedSink);
+		DownChannelizer::MsgChannelizerBankAttach detach(0, 0);
+		threadedSink->handleSinkMessage(detach);
 		m_threadedBasebandSampleSinks.remove(threadedSink);
 	}
 
@@ -734,6 +965,8 @@ void DSPDeviceSourceEngine::handleInputMessages()
 
 			qDebug() << "DSPDeviceSourceEngine::handleInputMessages: DSPSignalNotification(" << m_sampleRate << "," << m_centerFrequency << ")";
 
+			setChannelizerBankSampleRate(m_sampleRate);
+
 			// forward source changes to channel sinks with immediate execution (no queuing)
 
 			for(BasebandSampleSinks::const_iterator it = m_basebandSampleSinks.begin(); it != m_basebandSampleSinks.end(); it++)
@@ -748,6 +981,10 @@ void DSPDeviceSourceEngine::handleInputMessages()
 				(*it)->handleSinkMessage(*message);
 			}
 
+			if (m_threadedSpectrumSink) {
+				m_threadedSpectrumSink->handleSinkMessage(*message);
+			}
+
 			// forward changes to source GUI input queue
 
 			MessageQueue *guiMessageQueue = m_deviceSampleSource->getMessageQueueToGUI();
@@ -760,6 +997,29 @@ void DSPDeviceSourceEngine::handleInputMessages()
 
 			//m_outputMessageQueue.push(rep);
 
+			delete message;
+		}
+		else if (DownChannelizer::MsgChannelizerBankRequest::match(*message))
+		{
+			DownChannelizer::MsgChannelizerBankRequest *request = (DownChannelizer::MsgChannelizerBankRequest *) message;
+			ChannelizerBankAssignments::iterator it = m_channelizerBankAssignments.find(request->getThreadedSink());
+
+			if (it != m_channelizerBankAssignments.end()) // sink may have been removed since
+			{
+				// channels that do not fit in one filter bank channel are fed by the baseband
+				int channel = m_channelizerBank.getChannelIndex(request->getCenterFrequency(), request->getBandwidth());
+
+				if (channel != it->second)
+				{
+					qDebug() << "DSPDeviceSourceEngine::handleInputMessages: ThreadedSampleSink("
+						<< it->first->getSampleSinkObjectName().toStdString().c_str() << ") band: "
+						<< request->getBandwidth() << " Hz at " << request->getCenterFrequency() << " Hz"
+						<< (channel < 0 ? " does not fit in a filter bank channel: fed by the baseband" : " fits in filter bank channel: fed by the channelizer bank");
+				}
+
+				switchThreadedSinkChannel(it->first, channel);
+			}
+
 			delete message;
 		}
 	}
@@ -22,8 +22,12 @@
 #include <QTimer>
 #include <QMutex>
 #include <QWaitCondition>
+#include <map>
+#include <vector>
 #include "dsp/dsptypes.h"
 #include "dsp/fftwindow.h"
+#include "dsp/samplesinkbroadcastfifo.h"
+#include "dsp/channelizerbank.h"
 #include "util/messagequeue.h"
 #include "util/syncmessenger.h"
 #include "export.h"
@@ -68,11 +72,20 @@ public:
 
 	void addThreadedSink(ThreadedBasebandSampleSink* sink); //!< Add a sample sink that will run on its own thread
 	void removeThreadedSink(ThreadedBasebandSampleSink* sink); //!< Remove a sample sink that runs on its own thread
+	void getThreadedSinks(std::vector<ThreadedBasebandSampleSink*>& sinks); //!< Current list of sinks running on their own thread
+
+	void addSpectrumSink(BasebandSampleSink* spectrumSink);    //!< Add the main spectrum sink that runs on its own thread
+	void removeSpectrumSink(BasebandSampleSink* spectrumSink); //!< Remove the main spectrum sink
 
 	void configureCorrections(bool dcOffsetCorrection, bool iqImbalanceCorrection); //!< Configure DSP corrections
 
 	State state() const { return m_state; } //!< Return DSP engine current state
 
+	/** Feed the threaded sinks whose band fits in a filter bank channel by the channelizer bank
+	 *  instead of the baseband. Off by default. Applies to the sinks added afterwards. */
+	static void setUseChannelizerBank(bool useChannelizerBank) { m_useChannelizerBank.storeRelease(useChannelizerBank ? 1 : 0); }
+	static bool getUseChannelizerBank() { return m_useChannelizerBank.loadAcquire() != 0; }
+
 	QString errorMessage(); //!< Return the current error message
 	QString sourceDeviceDescription(); //!< Return the source device description
 
@@ -95,6 +108,15 @@ private:
 
 	typedef std::list<ThreadedBasebandSampleSink*> ThreadedBasebandSampleSinks;
 	ThreadedBasebandSampleSinks m_threadedBasebandSampleSinks; //!< sample sinks on their own threads (usually channels)
+	SampleSinkBroadcastFifo m_threadedSinksFifo; //!< samples written once and read in place by all threaded sinks
+	ThreadedBasebandSampleSink *m_threadedSpectrumSink; //!< main spectrum on its own thread. It drops samples rather than holding the baseband. Engine thread only.
+
+	typedef std::map<ThreadedBasebandSampleSink*, int> ChannelizerBankAssignments;
+	typedef std::map<int, SampleSinkBroadcastFifo*> ChannelizerBankFifos;
+	ChannelizerBank m_channelizerBank; //!< splits the baseband once for all threaded sinks whose band fits in a channel
+	ChannelizerBankAssignments m_channelizerBankAssignments; //!< filter bank channel feeding each threaded sink or -1 for the baseband
+	ChannelizerBankFifos m_channelizerBankFifos; //!< one FIFO per active filter bank channel
+	static QAtomicInt m_useChannelizerBank;
 
 	uint m_sampleRate;
 	quint64 m_centerFrequency;
@@ -135,6 +157,12 @@ private:
 	void dcOffset(SampleVector::iterator begin, SampleVector::iterator end);
 	void imbalance(SampleVector::iterator begin, SampleVector::iterator end);
 	void work(); //!< transfer samples from source to sinks if in running state
+	uint channelizersWritable() const; //!< input samples that can be written without overwriting a back pressure sink
+	void feedChannelizerBank(const SampleVector::const_iterator& begin, const SampleVector::const_iterator& end);
+	void setChannelizerBankSampleRate(int sampleRate);
+	void attachThreadedSinkReader(ThreadedBasebandSampleSink *threadedSink, int channel); //!< read from the baseband (-1) or a filter bank channel
+	void detachThreadedSinkReader(ThreadedBasebandSampleSink *threadedSink);
+	void switchThreadedSinkChannel(ThreadedBasebandSampleSink *threadedSink, int channel);
 
 	State gotoIdle();     //!< Go to the idle state
 	State gotoInit();     //!< Go to the acquisition init state from idle
@@ -23,3 +23,33 @@ FFTEngine* FFTEngine::create()
 	return 0;
 #endif
 }
+
+void FFTEngine::prewarm(int n)
+{
+#ifdef USE_FFTW
+	FFTWEngine::prewarm(n, false);
+	FFTWEngine::prewarm(n, true);
+#else
+	(void) n;
+#endif
+}
+
+bool FFTEngine::importWisdom(const QString& fileName)
+{
+#ifdef USE_FFTW
+	return FFTWEngine::importWisdom(fileName);
+#else
+	(void) fileName;
+	return false;
+#endif
+}
+
+bool FFTEngine::exportWisdom(const QString& fileName)
+{
+#ifdef USE_FFTW
+	return FFTWEngine::exportWisdom(fileName);
+#else
+	(void) fileName;
+	return false;
+#endif
+}
@@ -1,6 +1,8 @@
 #ifndef INCLUDE_FFTENGINE_H
 #define INCLUDE_FFTENGINE_H
 
+#include <QString>
+
 #include "dsp/dsptypes.h"
 #include "export.h"
 
@@ -15,6 +17,11 @@ public:
 	virtual Complex* out() = 0;
 
 	static FFTEngine* create();
+
+	// process wide planner state. These do nothing if the engine has no planner.
+	static void prewarm(int n);                        //!< Plan forward and inverse transforms of size n ahead of use
+	static bool importWisdom(const QString& fileName); //!< Reuse the planner measurements of a previous run
+	static bool exportWisdom(const QString& fileName); //!< Save the planner measurements for the next run
 };
 
 #endif // INCLUDE_FFTENGINE_H
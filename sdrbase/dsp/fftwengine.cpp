@@ -1,4 +1,7 @@
 #include <QTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
 #include "dsp/fftwengine.h"
 
 FFTWEngine::FFTWEngine() :
@@ -24,21 +27,17 @@ void FFTWEngine::configure(int n, bool inverse)
 	m_currentPlan = new Plan;
 	m_currentPlan->n = n;
 	m_currentPlan->inverse = inverse;
+	// fftwf_malloc gives the same alignment as the planning buffers which is required by fftwf_execute_dft
 	m_currentPlan->in = (fftwf_complex*)fftwf_malloc(sizeof(fftwf_complex) * n);
 	m_currentPlan->out = (fftwf_complex*)fftwf_malloc(sizeof(fftwf_complex) * n);
-	QTime t;
-	t.start();
-	m_globalPlanMutex.lock();
-	m_currentPlan->plan = fftwf_plan_dft_1d(n, m_currentPlan->in, m_currentPlan->out, inverse ? FFTW_BACKWARD : FFTW_FORWARD, FFTW_PATIENT);
-	m_globalPlanMutex.unlock();
-	qDebug("FFT: creating FFTW plan (n=%d,%s) took %dms", n, inverse ? "inverse" : "forward", t.elapsed());
+	m_currentPlan->plan = getPlan(n, inverse);
 	m_plans.push_back(m_currentPlan);
 }
 
 void FFTWEngine::transform()
 {
 	if(m_currentPlan != NULL)
-		fftwf_execute(m_currentPlan->plan);
+		fftwf_execute_dft(m_currentPlan->plan, m_currentPlan->in, m_currentPlan->out);
 }
 
 Complex* FFTWEngine::in()
@@ -56,11 +55,78 @@ Complex* FFTWEngine::out()
 }
 
 QMutex FFTWEngine::m_globalPlanMutex;
+FFTWEngine::PlanCache FFTWEngine::m_globalPlanCache;
+
+fftwf_plan FFTWEngine::getPlan(int n, bool inverse)
+{
+	QMutexLocker mutexLocker(&m_globalPlanMutex);
+	PlanCache::const_iterator it = m_globalPlanCache.find(std::pair<int, bool>(n, inverse));
+
+	if (it != m_globalPlanCache.end()) {
+		return it->second;
+	}
+
+	// planning with FFTW_PATIENT overwrites the arrays so use scratch ones
+	fftwf_complex *in = (fftwf_complex*)fftwf_malloc(sizeof(fftwf_complex) * n);
+	fftwf_complex *out = (fftwf_complex*)fftwf_malloc(sizeof(fftwf_complex) * n);
+	QTime t;
+	t.start();
+	fftwf_plan plan = fftwf_plan_dft_1d(n, in, out, inverse ? FFTW_BACKWARD : FFTW_FORWARD, FFTW_PATIENT);
+	qDebug("FFT: creating FFTW plan (n=%d,%s) took %dms", n, inverse ? "inverse" : "forward", t.elapsed());
+	fftwf_free(in);
+	fftwf_free(out);
+	m_globalPlanCache[std::pair<int, bool>(n, inverse)] = plan;
+
+	return plan;
+}
+
+void FFTWEngine::prewarm(int n, bool inverse)
+{
+	getPlan(n, inverse);
+}
+
+bool FFTWEngine::importWisdom(const QString& fileName)
+{
+	if (!QFileInfo(fileName).exists())
+	{
+		qDebug("FFTWEngine::importWisdom: no wisdom file %s", qPrintable(fileName));
+		return false;
+	}
+
+	QMutexLocker mutexLocker(&m_globalPlanMutex);
+
+	if (fftwf_import_wisdom_from_filename(QFile::encodeName(fileName).constData()))
+	{
+		qDebug("FFTWEngine::importWisdom: imported %s", qPrintable(fileName));
+		return true;
+	}
+	else
+	{
+		qWarning("FFTWEngine::importWisdom: cannot import %s", qPrintable(fileName));
+		return false;
+	}
+}
+
+bool FFTWEngine::exportWisdom(const QString& fileName)
+{
+	QDir().mkpath(QFileInfo(fileName).absolutePath());
+	QMutexLocker mutexLocker(&m_globalPlanMutex);
+
+	if (fftwf_export_wisdom_to_filename(QFile::encodeName(fileName).constData()))
+	{
+		qDebug("FFTWEngine::exportWisdom: exported %s", qPrintable(fileName));
+		return true;
+	}
+	else
+	{
+		qWarning("FFTWEngine::exportWisdom: cannot export %s", qPrintable(fileName));
+		return false;
+	}
+}
 
 void FFTWEngine::freeAll()
 {
 	for(Plans::iterator it = m_plans.begin(); it != m_plans.end(); ++it) {
-		fftwf_destroy_plan((*it)->plan);
 		fftwf_free((*it)->in);
 		fftwf_free((*it)->out);
 		delete *it;
@@ -2,8 +2,10 @@
 #define INCLUDE_FFTWENGINE_H
 
 #include <QMutex>
+#include <QString>
 #include <fftw3.h>
 #include <list>
+#include <map>
 #include "dsp/fftengine.h"
 #include "export.h"
 
@@ -18,13 +20,22 @@ public:
 	Complex* in();
 	Complex* out();
 
+	static void prewarm(int n, bool inverse);           //!< Create the plan in the process wide cache ahead of use
+	static bool importWisdom(const QString& fileName); //!< Reuse the planner measurements of a previous run
+	static bool exportWisdom(const QString& fileName); //!< Save the planner measurements for the next run
+
 protected:
-	static QMutex m_globalPlanMutex;
+	static QMutex m_globalPlanMutex; //!< the FFTW planner is not thread safe
+
+	/** Plans are shared by all engines of the process and are never destroyed.
+	 *  Each engine executes them on its own buffers with the new-array execute interface. */
+	typedef std::map<std::pair<int, bool>, fftwf_plan> PlanCache;
+	static PlanCache m_globalPlanCache;
 
 	struct Plan {
 		int n;
 		bool inverse;
-		fftwf_plan plan;
+		fftwf_plan plan; //!< from the global cache
 		fftwf_complex* in;
 		fftwf_complex* out;
 	};
@@ -32,6 +43,7 @@ protected:
 	Plans m_plans;
 	Plan* m_currentPlan;
 
+	static fftwf_plan getPlan(int n, bool inverse);
 	void freeAll();
 };
 
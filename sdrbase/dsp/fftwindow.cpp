@@ -16,6 +16,7 @@
 ///////////////////////////////////////////////////////////////////////////////////
 
 #include "dsp/fftwindow.h"
+#include "dsp/spectrumpowerkernels.h"
 
 void FFTWindow::create(Function function, int n)
 {
@@ -71,3 +72,8 @@ void FFTWindow::apply(const Complex* in, Complex* out)
 	for(size_t i = 0; i < m_window.size(); i++)
 		out[i] = in[i] * m_window[i];
 }
+
+void FFTWindow::apply(const Sample* in, Complex* out, Real scale)
+{
+	SpectrumPowerKernels::windowSamples(in, &m_window[0], scale, out, m_window.size());
+}
@@ -42,6 +42,7 @@ public:
 	void apply(const std::vector<Real>& in, std::vector<Real>* out);
 	void apply(const std::vector<Complex>& in, std::vector<Complex>* out);
 	void apply(const Complex* in, Complex* out);
+	void apply(const Sample* in, Complex* out, Real scale); //!< converts to float, scales and applies window in one pass
 
 private:
 	std::vector<float> m_window;
@@ -14,18 +14,29 @@
 // along with this program. If not, see <http://www.gnu.org/licenses/>.          //
 ///////////////////////////////////////////////////////////////////////////////////
 
+#include <cstring>
 #include <boost/crc.hpp>
 #include <boost/cstdint.hpp>
 
 #include <QDebug>
 #include <QDateTime>
 
+#include "SWGFileRecordReport.h"
+
 #include "dsp/dspcommands.h"
+#include "channel/sdrdaemondatablock.h"
 #include "util/simpleserializer.h"
 #include "util/message.h"
+#include "util/mappedfile.h"
 
 #include "filerecord.h"
 
+const qint64 FileRecord::m_preallocateStep = 1LL<<28; // 256 MB
+const quint32 FileRecord::m_chunksPerIndex = 64;
+const quint32 FileRecord::m_maxChunkSamples = 1<<20;
+FileRecord::Options FileRecord::m_defaultOptions;
+QMutex FileRecord::m_defaultOptionsMutex;
+
 FileRecord::FileRecord() :
 	BasebandSampleSink(),
     m_fileName("test.sdriq"),
@@ -33,7 +44,18 @@ FileRecord::FileRecord() :
     m_centerFrequency(0),
 	m_recordOn(false),
     m_recordStart(false),
-    m_byteCount(0)
+    m_byteCount(0),
+    m_chunkMaxSamples(0),
+    m_chunkFill(0),
+    m_chunkSampleRate(0),
+    m_chunkCenterFrequency(0),
+    m_timeStampUs(0),
+    m_fileStartUs(0),
+    m_fileOffset(0),
+    m_fileSamples(0),
+    m_chunkSequence(0),
+    m_fileSequence(0),
+    m_lastIndexOffset(0)
 {
 	setObjectName("FileSink");
 }
@@ -45,7 +67,18 @@ FileRecord::FileRecord(const QString& filename) :
     m_centerFrequency(0),
     m_recordOn(false),
     m_recordStart(false),
-    m_byteCount(0)
+    m_byteCount(0),
+    m_chunkMaxSamples(0),
+    m_chunkFill(0),
+    m_chunkSampleRate(0),
+    m_chunkCenterFrequency(0),
+    m_timeStampUs(0),
+    m_fileStartUs(0),
+    m_fileOffset(0),
+    m_fileSamples(0),
+    m_chunkSequence(0),
+    m_fileSequence(0),
+    m_lastIndexOffset(0)
 {
     setObjectName("FileRecord");
 }
@@ -57,6 +90,8 @@ FileRecord::~FileRecord()
 
 void FileRecord::setFileName(const QString& filename)
 {
+    QMutexLocker mutexLocker(&m_recordMutex);
+
     if (!m_recordOn)
     {
         m_fileName = filename;
@@ -71,6 +106,8 @@ void FileRecord::genUniqueFileName(uint deviceUID)
 void FileRecord::feed(const SampleVector::const_iterator& begin, const SampleVector::const_iterator& end, bool positiveOnly)
 {
     (void) positiveOnly;
+    QMutexLocker mutexLocker(&m_recordMutex);
+
     // if no recording is active, send the samples to /dev/null
     if(!m_recordOn)
         return;
@@ -79,12 +116,34 @@ void FileRecord::feed(const SampleVector::const_iterator& begin, const SampleVec
     {
         if (m_recordStart)
         {
-            writeHeader();
+            m_timeStampUs = QDateTime::currentMSecsSinceEpoch() * 1000;
+
+            if (m_options.m_format == FormatV2) {
+                writeHeaderV2();
+            } else if (m_options.m_format == FormatSigMF) {
+                startSigMF();
+            } else {
+                writeHeader();
+            }
+
             m_recordStart = false;
         }
 
-        m_sampleFile.write(reinterpret_cast<const char*>(&*(begin)), (end - begin)*sizeof(Sample));
-        m_byteCount += end - begin;
+        // copied to the writer buffers only: the disk is accessed from the writer thread
+        if (m_options.m_format == FormatV2)
+        {
+            feedV2(reinterpret_cast<const quint8*>(&*(begin)), end - begin);
+        }
+        else
+        {
+            if (m_options.m_format == FormatSigMF) {
+                feedSigMF();
+            }
+
+            m_writer.write(reinterpret_cast<const char*>(&*(begin)), (end - begin)*sizeof(Sample));
+        }
+
+        m_byteCount += (end - begin)*sizeof(Sample);
     }
 }
 
@@ -99,10 +158,36 @@ void FileRecord::stop()
 
 void FileRecord::startRecording()
 {
-    if (!m_sampleFile.is_open())
+    QMutexLocker writerLocker(&m_writerMutex);
+    QMutexLocker mutexLocker(&m_recordMutex);
+
+    if (!m_writer.isOpen())
     {
     	qDebug() << "FileRecord::startRecording";
-        m_sampleFile.open(m_fileName.toStdString().c_str(), std::ios::binary);
+        m_options = getDefaultOptions();
+        QString fileName = m_fileName;
+
+        if (m_options.m_format == FormatSigMF)
+        {
+            fileName = SigMFFile::getDataFileNameFromRecordName(m_fileName);
+            m_sigMFMetaFileName = SigMFFile::getMetaFileName(fileName);
+        }
+
+        if (!m_writer.open(fileName, m_options.m_directIO, m_preallocateStep)) {
+            return;
+        }
+
+        if (m_options.m_format == FormatV2)
+        {
+            m_codec.setCodec((SDRDaemonCodec::CodecType) m_options.m_codec, m_options.m_codecBits, sizeof(FixReal));
+            int samplesPerBlock = m_codec.getNbSamplesPerBlock();
+            int nbBlocks = (m_maxChunkSamples + samplesPerBlock - 1) / samplesPerBlock;
+            m_chunkBuffer.resize(nbBlocks * samplesPerBlock * sizeof(Sample));
+            m_codedBuffer.resize(m_codec.getCodecType() == SDRDaemonCodec::CodecNone ? 0 : nbBlocks * SDRDaemonNbBytesPerBlock);
+            m_chunkFill = 0;
+            m_fileSequence = 0;
+        }
+
         m_recordOn = true;
         m_recordStart = true;
         m_byteCount = 0;
@@ -111,12 +196,26 @@ void FileRecord::startRecording()
 
 void FileRecord::stopRecording()
 {
-    if (m_sampleFile.is_open())
+    QMutexLocker writerLocker(&m_writerMutex);
+
+    if (m_writer.isOpen())
     {
     	qDebug() << "FileRecord::stopRecording";
-        m_sampleFile.close();
+        QMutexLocker mutexLocker(&m_recordMutex);
+        bool started = m_recordOn && !m_recordStart; // header was written
+        // feed() drops samples from now on so this thread is the only writer
         m_recordOn = false;
         m_recordStart = false;
+
+        if ((m_options.m_format == FormatV2) && started) {
+            finishFileV2();
+        } else if ((m_options.m_format == FormatSigMF) && started) {
+            m_writer.writeSideFile(m_sigMFMetaFileName, SigMFFile::serializeMeta(m_sigMFMeta));
+        }
+
+        // the engine thread must not wait for the flush to disk
+        mutexLocker.unlock();
+        m_writer.close();
     }
 }
 
@@ -144,6 +243,7 @@ void FileRecord::handleConfigure(const QString& fileName)
         stopRecording();
     }
 
+    QMutexLocker mutexLocker(&m_recordMutex);
 	m_fileName = fileName;
 }
 
@@ -157,7 +257,10 @@ void FileRecord::writeHeader()
     header.sampleSize = SDR_RX_SAMP_SZ;
     header.filler = 0;
 
-    writeHeader(m_sampleFile, header);
+    boost::crc_32_type crc32;
+    crc32.process_bytes(&header, 28);
+    header.crc32 = crc32.checksum();
+    m_writer.write((const char *) &header, sizeof(Header));
 }
 
 bool FileRecord::readHeader(std::ifstream& sampleFile, Header& header)
@@ -168,6 +271,14 @@ bool FileRecord::readHeader(std::ifstream& sampleFile, Header& header)
     return header.crc32 == crc32.checksum();
 }
 
+bool FileRecord::readHeader(const quint8 *buf, Header& header)
+{
+    memcpy((void *) &header, (const void *) buf, sizeof(Header));
+    boost::crc_32_type crc32;
+    crc32.process_bytes(&header, 28);
+    return header.crc32 == crc32.checksum();
+}
+
 void FileRecord::writeHeader(std::ofstream& sampleFile, Header& header)
 {
     boost::crc_32_type crc32;
@@ -175,3 +286,442 @@ void FileRecord::writeHeader(std::ofstream& sampleFile, Header& header)
     header.crc32 = crc32.checksum();
     sampleFile.write((const char *) &header, sizeof(Header));
 }
+
+void FileRecord::startSigMF()
+{
+    m_sigMFMeta = SigMFFile::Meta();
+    m_sigMFMeta.m_sampleBits = SDR_RX_SAMP_SZ;
+    m_sigMFMeta.m_sampleRate = m_sampleRate;
+    m_sigMFMeta.m_recorder = "SDRangel";
+
+    SigMFFile::Capture capture;
+    capture.m_sampleStart = 0;
+    capture.m_frequency = m_centerFrequency;
+    capture.m_sampleRate = m_sampleRate;
+    capture.m_timeStampUs = m_timeStampUs;
+    m_sigMFMeta.m_captures.push_back(capture);
+
+    // written at start so that the data file is usable even if the recording is not stopped properly
+    // the file is written by the writer thread so that the engine thread does not wait for the disk
+    m_writer.writeSideFile(m_sigMFMetaFileName, SigMFFile::serializeMeta(m_sigMFMeta));
+}
+
+void FileRecord::feedSigMF()
+{
+    const SigMFFile::Capture& last = m_sigMFMeta.m_captures.back();
+
+    if ((last.m_frequency == m_centerFrequency) && (last.m_sampleRate == m_sampleRate)) {
+        return;
+    }
+
+    // new capture segment at the first sample with the new settings
+    SigMFFile::Capture capture;
+    capture.m_sampleStart = m_byteCount / sizeof(Sample);
+    capture.m_frequency = m_centerFrequency;
+    capture.m_sampleRate = m_sampleRate;
+    capture.m_timeStampUs = last.m_sampleRate == 0 ? last.m_timeStampUs :
+        last.m_timeStampUs + ((capture.m_sampleStart - last.m_sampleStart) * 1000000ULL) / last.m_sampleRate;
+
+    if (capture.m_sampleStart == last.m_sampleStart) { // nothing recorded with the previous settings
+        m_sigMFMeta.m_captures.back() = capture;
+    } else {
+        m_sigMFMeta.m_captures.push_back(capture);
+    }
+
+    m_writer.writeSideFile(m_sigMFMetaFileName, SigMFFile::serializeMeta(m_sigMFMeta));
+}
+
+void FileRecord::setDefaultOptions(const Options& options)
+{
+    QMutexLocker mutexLocker(&m_defaultOptionsMutex);
+    m_defaultOptions = options;
+}
+
+FileRecord::Options FileRecord::getDefaultOptions()
+{
+    QMutexLocker mutexLocker(&m_defaultOptionsMutex);
+    return m_defaultOptions;
+}
+
+void FileRecord::webapiFormatReport(SWGSDRangel::SWGFileRecordReport& report)
+{
+    report.setBytesPending(getBytesPending());
+    report.setBytesDropped(getBytesDropped());
+    report.setAvgWriteLatencyUs(getAvgWriteLatencyUs());
+    report.setMaxWriteLatencyUs(getMaxWriteLatencyUs());
+}
+
+QString FileRecord::getFileName(quint32 fileSequence) const
+{
+    if (fileSequence == 0) {
+        return m_fileName;
+    }
+
+    QString baseName = m_fileName.endsWith(".sdriq") ? m_fileName.left(m_fileName.size() - 6) : m_fileName;
+    return QString("%1_%2.sdriq").arg(baseName).arg(fileSequence, 3, 10, QChar('0'));
+}
+
+void FileRecord::writeHeaderV2()
+{
+    HeaderV2 header;
+    memset((void *) &header, 0, sizeof(HeaderV2));
+    strcpy(header.magic, "SDRIQv2");
+    header.version = 2;
+    header.sampleSize = SDR_RX_SAMP_SZ;
+    header.startTimeStampUs = m_timeStampUs;
+    header.centerFrequency = m_centerFrequency;
+    header.sampleRate = m_sampleRate;
+    header.codec = m_codec.getCodecType();
+    header.codecBits = m_codec.getNbBits();
+    header.codecBlockSize = SDRDaemonNbBytesPerBlock;
+    header.fileSequence = m_fileSequence;
+    header.chunksPerIndex = m_chunksPerIndex;
+
+    boost::crc_32_type crc32;
+    crc32.process_bytes(&header, sizeof(HeaderV2) - 4);
+    header.crc32 = crc32.checksum();
+    m_writer.write((const char *) &header, sizeof(HeaderV2));
+
+    m_fileOffset = sizeof(HeaderV2);
+    m_fileSamples = 0;
+    m_fileStartUs = m_timeStampUs;
+    m_chunkSequence = 0;
+    m_lastIndexOffset = 0;
+    m_index.clear();
+}
+
+void FileRecord::feedV2(const quint8 *samples, quint32 nbSamples)
+{
+    while (nbSamples > 0)
+    {
+        if ((m_chunkFill > 0) && ((m_sampleRate != m_chunkSampleRate) || (m_centerFrequency != m_chunkCenterFrequency))) {
+            writeDataChunk(); // retune: new chunk with new metadata
+        }
+
+        if (m_chunkFill == 0)
+        {
+            // chunks last one second at most so that little is lost if the recording is not stopped properly
+            quint32 samplesPerBlock = m_codec.getNbSamplesPerBlock();
+            quint32 maxSamples = m_sampleRate == 0 ? m_maxChunkSamples : std::min(m_maxChunkSamples, m_sampleRate);
+            m_chunkMaxSamples = std::max(samplesPerBlock, (maxSamples / samplesPerBlock) * samplesPerBlock);
+            m_chunkSampleRate = m_sampleRate;
+            m_chunkCenterFrequency = m_centerFrequency;
+        }
+
+        quint32 chunkSamples = std::min(nbSamples, m_chunkMaxSamples - m_chunkFill);
+        std::copy(samples, samples + chunkSamples * sizeof(Sample), &m_chunkBuffer[m_chunkFill * sizeof(Sample)]);
+        m_chunkFill += chunkSamples;
+        samples += chunkSamples * sizeof(Sample);
+        nbSamples -= chunkSamples;
+
+        if (m_chunkFill == m_chunkMaxSamples) {
+            writeDataChunk();
+        }
+    }
+}
+
+void FileRecord::writeChunkHeader(ChunkHeader& chunkHeader)
+{
+    boost::crc_32_type crc32;
+    crc32.process_bytes(&chunkHeader, sizeof(ChunkHeader) - 4);
+    chunkHeader.crc32 = crc32.checksum();
+    m_writer.write((const char *) &chunkHeader, sizeof(ChunkHeader));
+}
+
+void FileRecord::writeDataChunk()
+{
+    if (m_chunkFill == 0) {
+        return;
+    }
+
+    const quint8 *payload = m_chunkBuffer.data();
+    quint32 payloadSize = m_chunkFill * sizeof(Sample);
+
+    if (m_codec.getCodecType() != SDRDaemonCodec::CodecNone)
+    {
+        int samplesPerBlock = m_codec.getNbSamplesPerBlock();
+        int nbBlocks = (m_chunkFill + samplesPerBlock - 1) / samplesPerBlock;
+        std::fill(m_chunkBuffer.begin() + m_chunkFill * sizeof(Sample), m_chunkBuffer.begin() + nbBlocks * samplesPerBlock * sizeof(Sample), 0);
+
+        for (int i = 0; i < nbBlocks; i++) {
+            m_codec.encode(&m_chunkBuffer[i * samplesPerBlock * sizeof(Sample)], &m_codedBuffer[i * SDRDaemonNbBytesPerBlock]);
+        }
+
+        payload = m_codedBuffer.data();
+        payloadSize = nbBlocks * SDRDaemonNbBytesPerBlock;
+    }
+
+    if (!m_writer.reserve(sizeof(ChunkHeader) + payloadSize))
+    {
+        // the disk does not keep up: leave the whole chunk out so that the file and its index stay consistent.
+        // The gap shows in the time stamps of the next chunk.
+        m_timeStampUs += m_chunkSampleRate == 0 ? 0 : ((quint64) m_chunkFill * 1000000ULL) / m_chunkSampleRate;
+        m_chunkFill = 0;
+        return;
+    }
+
+    boost::crc_32_type payloadCrc32;
+    payloadCrc32.process_bytes(payload, payloadSize);
+
+    ChunkHeader chunkHeader;
+    memset((void *) &chunkHeader, 0, sizeof(ChunkHeader));
+    chunkHeader.magic = ChunkData;
+    chunkHeader.payloadSize = payloadSize;
+    chunkHeader.sampleIndex = m_fileSamples;
+    chunkHeader.timeStampUs = m_timeStampUs;
+    chunkHeader.centerFrequency = m_chunkCenterFrequency;
+    chunkHeader.sampleRate = m_chunkSampleRate;
+    chunkHeader.nbSamples = m_chunkFill;
+    chunkHeader.sequence = m_chunkSequence++;
+    chunkHeader.flags = (m_codec.getCodecType() & 0xFF) | ((m_codec.getNbBits() & 0xFF) << 8) | FlagPayloadCrc;
+    chunkHeader.payloadCrc32 = payloadCrc32.checksum();
+
+    IndexEntry entry;
+    entry.offset = m_fileOffset;
+    entry.sampleIndex = chunkHeader.sampleIndex;
+    entry.timeStampUs = chunkHeader.timeStampUs;
+    entry.centerFrequency = chunkHeader.centerFrequency;
+    entry.sampleRate = chunkHeader.sampleRate;
+    entry.nbSamples = chunkHeader.nbSamples;
+    entry.payloadSize = chunkHeader.payloadSize;
+    entry.flags = chunkHeader.flags;
+    m_index.push_back(entry);
+
+    writeChunkHeader(chunkHeader);
+    m_writer.write((const char *) payload, payloadSize);
+    m_fileOffset += sizeof(ChunkHeader) + payloadSize;
+    m_fileSamples += m_chunkFill;
+    m_timeStampUs += m_chunkSampleRate == 0 ? 0 : ((quint64) m_chunkFill * 1000000ULL) / m_chunkSampleRate;
+    m_chunkFill = 0;
+
+    if (m_index.size() >= m_chunksPerIndex) {
+        writeIndexChunk();
+    }
+
+    if (((m_options.m_rotateMB > 0) && (m_fileOffset >= ((quint64) m_options.m_rotateMB << 20)))
+     || ((m_options.m_rotateMinutes > 0) && (m_timeStampUs - m_fileStartUs >= m_options.m_rotateMinutes * 60000000ULL)))
+    {
+        rotateFile();
+    }
+}
+
+void FileRecord::writeIndexChunk()
+{
+    if (m_index.size() == 0) {
+        return;
+    }
+
+    quint32 payloadSize = m_index.size() * sizeof(IndexEntry);
+
+    if (!m_writer.reserve(sizeof(ChunkHeader) + payloadSize)) { // entries are kept for the next index chunk
+        return;
+    }
+
+    boost::crc_32_type payloadCrc32;
+    payloadCrc32.process_bytes(m_index.data(), payloadSize);
+
+    ChunkHeader chunkHeader;
+    memset((void *) &chunkHeader, 0, sizeof(ChunkHeader));
+    chunkHeader.magic = ChunkIndex;
+    chunkHeader.payloadSize = payloadSize;
+    chunkHeader.sampleIndex = m_fileSamples;
+    chunkHeader.timeStampUs = m_timeStampUs;
+    chunkHeader.nbSamples = m_index.size();
+    chunkHeader.sequence = m_chunkSequence++;
+    chunkHeader.previousIndexOffset = m_lastIndexOffset;
+    chunkHeader.payloadCrc32 = payloadCrc32.checksum();
+
+    writeChunkHeader(chunkHeader);
+    m_writer.write((const char *) m_index.data(), payloadSize);
+    m_lastIndexOffset = m_fileOffset;
+    m_fileOffset += sizeof(ChunkHeader) + payloadSize;
+    m_index.clear();
+}
+
+void FileRecord::writeEndChunk()
+{
+    if (!m_writer.reserve(sizeof(ChunkHeader))) {
+        return;
+    }
+
+    ChunkHeader chunkHeader;
+    memset((void *) &chunkHeader, 0, sizeof(ChunkHeader));
+    chunkHeader.magic = ChunkEnd;
+    chunkHeader.sampleIndex = m_fileSamples;
+    chunkHeader.timeStampUs = m_timeStampUs;
+    chunkHeader.sequence = m_chunkSequence++;
+    chunkHeader.previousIndexOffset = m_lastIndexOffset;
+
+    writeChunkHeader(chunkHeader);
+    m_fileOffset += sizeof(ChunkHeader);
+}
+
+void FileRecord::finishFileV2()
+{
+    writeDataChunk();
+    writeIndexChunk();
+    writeEndChunk();
+}
+
+void FileRecord::rotateFile()
+{
+    // stopRecording() cannot run meanwhile so the trailer of this file is written once and before the switch
+    finishFileV2();
+    m_fileSequence++;
+    QString fileName = getFileName(m_fileSequence);
+    qDebug("FileRecord::rotateFile: continue in %s", qPrintable(fileName));
+    m_writer.rotate(fileName);
+    writeHeaderV2();
+}
+
+bool FileRecord::isHeaderV2(const quint8 *buf)
+{
+    return buf && (memcmp(buf, "SDRIQv2", 8) == 0);
+}
+
+bool FileRecord::readHeaderV2(const quint8 *buf, HeaderV2& header)
+{
+    if (!buf) {
+        return false;
+    }
+
+    memcpy((void *) &header, (const void *) buf, sizeof(HeaderV2));
+    boost::crc_32_type crc32;
+    crc32.process_bytes(&header, sizeof(HeaderV2) - 4);
+    return (header.crc32 == crc32.checksum()) && (header.version == 2);
+}
+
+bool FileRecord::readChunkHeader(const quint8 *buf, ChunkHeader& chunkHeader)
+{
+    memcpy((void *) &chunkHeader, (const void *) buf, sizeof(ChunkHeader));
+
+    if ((chunkHeader.magic != ChunkData) && (chunkHeader.magic != ChunkIndex) && (chunkHeader.magic != ChunkEnd)) {
+        return false;
+    }
+
+    boost::crc_32_type crc32;
+    crc32.process_bytes(&chunkHeader, sizeof(ChunkHeader) - 4);
+    return chunkHeader.crc32 == crc32.checksum();
+}
+
+bool FileRecord::readChunkTable(MappedFile& file, std::vector<IndexEntry>& entries, bool& indexed)
+{
+    qint64 size = file.size();
+    const quint8 *buf;
+    ChunkHeader chunkHeader;
+    entries.clear();
+    indexed = false;
+
+    // properly closed file: follow the index chunks backwards from the end chunk
+    buf = size >= (qint64) (sizeof(HeaderV2) + sizeof(ChunkHeader)) ? file.map(size - sizeof(ChunkHeader), sizeof(ChunkHeader)) : 0;
+
+    if (buf && readChunkHeader(buf, chunkHeader) && (chunkHeader.magic == ChunkEnd))
+    {
+        std::vector<quint64> indexOffsets;
+        quint64 offset = chunkHeader.previousIndexOffset;
+        bool valid = true;
+
+        while (valid && (offset != 0))
+        {
+            buf = file.map(offset, sizeof(ChunkHeader));
+            valid = buf && readChunkHeader(buf, chunkHeader) && (chunkHeader.magic == ChunkIndex) && (chunkHeader.previousIndexOffset < offset);
+
+            if (valid)
+            {
+                indexOffsets.push_back(offset);
+                offset = chunkHeader.previousIndexOffset;
+            }
+        }
+
+        for (std::vector<quint64>::reverse_iterator it = indexOffsets.rbegin(); valid && (it != indexOffsets.rend()); ++it)
+        {
+            buf = file.map(*it, sizeof(ChunkHeader));
+            valid = buf && readChunkHeader(buf, chunkHeader) && (chunkHeader.payloadSize == chunkHeader.nbSamples * sizeof(IndexEntry));
+            buf = valid ? file.map(*it + sizeof(ChunkHeader), chunkHeader.payloadSize) : 0;
+
+            if (buf)
+            {
+                boost::crc_32_type payloadCrc32;
+                payloadCrc32.process_bytes(buf, chunkHeader.payloadSize);
+                valid = payloadCrc32.checksum() == chunkHeader.payloadCrc32;
+            }
+            else
+            {
+                valid = false;
+            }
+
+            std::vector<IndexEntry> indexEntries(chunkHeader.nbSamples);
+
+            if (valid) {
+                memcpy((void *) indexEntries.data(), (const void *) buf, chunkHeader.payloadSize);
+            }
+
+            for (quint32 i = 0; valid && (i < indexEntries.size()); i++)
+            {
+                const IndexEntry& entry = indexEntries[i];
+                quint64 expectedIndex = entries.size() == 0 ? 0 : entries.back().sampleIndex + entries.back().nbSamples;
+                valid = (entry.sampleIndex == expectedIndex) && (entry.offset >= sizeof(HeaderV2))
+                    && (entry.offset + sizeof(ChunkHeader) + entry.payloadSize <= (quint64) size);
+
+                // the data chunk must be where the index says it is
+                ChunkHeader dataChunkHeader;
+                buf = valid ? file.map(entry.offset, sizeof(ChunkHeader)) : 0;
+                valid = buf && readChunkHeader(buf, dataChunkHeader) && (dataChunkHeader.magic == ChunkData)
+                    && (dataChunkHeader.sampleIndex == entry.sampleIndex) && (dataChunkHeader.nbSamples == entry.nbSamples)
+                    && (dataChunkHeader.payloadSize == entry.payloadSize);
+
+                if (valid) {
+                    entries.push_back(entry);
+                }
+            }
+        }
+
+        if (valid && (entries.size() > 0))
+        {
+            indexed = true;
+            return true;
+        }
+
+        entries.clear();
+    }
+
+    // index not available: walk through the chunks until the end or the first damaged one
+    qint64 offset = sizeof(HeaderV2);
+    quint64 nbSamples = 0;
+
+    while (offset + (qint64) sizeof(ChunkHeader) <= size)
+    {
+        buf = file.map(offset, sizeof(ChunkHeader));
+
+        if (!buf || !readChunkHeader(buf, chunkHeader) || (chunkHeader.magic == ChunkEnd)) {
+            break;
+        }
+
+        if (offset + (qint64) sizeof(ChunkHeader) + chunkHeader.payloadSize > size) { // truncated
+            break;
+        }
+
+        if (chunkHeader.magic == ChunkData)
+        {
+            if (chunkHeader.sampleIndex != nbSamples) {
+                break;
+            }
+
+            IndexEntry entry;
+            entry.offset = offset;
+            entry.sampleIndex = chunkHeader.sampleIndex;
+            entry.timeStampUs = chunkHeader.timeStampUs;
+            entry.centerFrequency = chunkHeader.centerFrequency;
+            entry.sampleRate = chunkHeader.sampleRate;
+            entry.nbSamples = chunkHeader.nbSamples;
+            entry.payloadSize = chunkHeader.payloadSize;
+            entry.flags = chunkHeader.flags;
+            entries.push_back(entry);
+            nbSamples += chunkHeader.nbSamples;
+        }
+
+        offset += sizeof(ChunkHeader) + chunkHeader.payloadSize;
+    }
+
+    return entries.size() > 0;
+}
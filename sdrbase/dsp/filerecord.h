@@ -23,9 +23,22 @@
 #include <fstream>
 
 #include <ctime>
+#include <vector>
+
+#include <QMutex>
+
+#include "channel/sdrdaemoncodec.h"
+#include "dsp/sigmffile.h"
+#include "util/asyncfilewriter.h"
 #include "export.h"
 
 class Message;
+class MappedFile;
+
+namespace SWGSDRangel
+{
+    class SWGFileRecordReport;
+}
 
 class SDRBASE_API FileRecord : public BasebandSampleSink {
 public:
@@ -40,13 +53,97 @@ public:
         quint32 filler;
         quint32 crc32;
     };
+
+    /** Version 2 file header. The file is then a sequence of chunks each starting with a ChunkHeader. */
+    struct HeaderV2
+    {
+        char magic[8];            //!< "SDRIQv2" zero terminated
+        quint32 version;          //!< 2
+        quint32 sampleSize;       //!< 16 or 24
+        quint64 startTimeStampUs; //!< Unix epoch in microseconds of the first sample
+        quint64 centerFrequency;  //!< at start
+        quint32 sampleRate;       //!< at start
+        quint32 codec;            //!< SDRDaemonCodec::CodecType used for all data chunks
+        quint32 codecBits;
+        quint32 codecBlockSize;   //!< bytes per coded block (compressed files)
+        quint32 fileSequence;     //!< 0 for the first file of a recording then incremented at each rotation
+        quint32 chunksPerIndex;   //!< an index chunk follows this many data chunks
+        quint32 reserved;
+        quint32 crc32;            //!< of the 60 bytes above
+    };
+
+    struct ChunkHeader
+    {
+        quint32 magic;               //!< ChunkData, ChunkIndex or ChunkEnd
+        quint32 payloadSize;         //!< bytes following this header
+        quint64 sampleIndex;         //!< data: index of the first sample in file. index, end: number of samples in file so far
+        quint64 timeStampUs;         //!< data: Unix epoch in microseconds of the first sample
+        quint64 centerFrequency;     //!< data: center frequency of the samples
+        quint32 sampleRate;          //!< data: sample rate of the samples
+        quint32 nbSamples;           //!< data: number of samples. index: number of entries.
+        quint32 sequence;            //!< chunk number in file
+        quint32 flags;               //!< data: codec type (bits 0..7), codec bits (8..15) and FlagPayloadCrc
+        quint64 previousIndexOffset; //!< index, end: file offset of the previous index chunk or 0
+        quint32 payloadCrc32;        //!< index: CRC32 of the payload. data: same if FlagPayloadCrc is set else 0
+        quint32 crc32;               //!< of the 60 bytes above
+    };
+
+    /** Index chunks payload entry. Describes a data chunk. */
+    struct IndexEntry
+    {
+        quint64 offset;              //!< file offset of the data chunk header
+        quint64 sampleIndex;
+        quint64 timeStampUs;
+        quint64 centerFrequency;
+        quint32 sampleRate;
+        quint32 nbSamples;
+        quint32 payloadSize;
+        quint32 flags;
+    };
 #pragma pack(pop)
 
+    enum RecordFormat
+    {
+        FormatV1, //!< Single header then raw samples
+        FormatV2, //!< Chunked with periodic index, per chunk metadata, compression and rotation
+        FormatSigMF //!< SigMF .sigmf-data and .sigmf-meta pair with a capture segment per retune
+    };
+
+    static const quint32 ChunkData  = 0x44524453; //!< "SDRD" little endian
+    static const quint32 ChunkIndex = 0x58524453; //!< "SDRX" little endian
+    static const quint32 ChunkEnd   = 0x45524453; //!< "SDRE" little endian
+    static const quint32 FlagPayloadCrc = 1<<16;  //!< data chunk flag: payloadCrc32 is set
+
+    /** Recording options shared by all recorders. Taken at recording start. */
+    struct Options
+    {
+        RecordFormat m_format;
+        int m_codec;         //!< SDRDaemonCodec::CodecType (v2 only)
+        int m_codecBits;     //!< bits per I or Q sample for the codec
+        int m_rotateMB;      //!< v2 only: continue in a new file after this size in MB. 0 for no rotation.
+        int m_rotateMinutes; //!< v2 only: continue in a new file after this duration in minutes. 0 for no rotation.
+        bool m_directIO;     //!< bypass the page cache if the file system supports it (O_DIRECT on Linux, F_NOCACHE on Mac)
+
+        Options() :
+            m_format(FormatV1),
+            m_codec(SDRDaemonCodec::CodecNone),
+            m_codecBits(12),
+            m_rotateMB(0),
+            m_rotateMinutes(0),
+            m_directIO(false)
+        {}
+    };
+
 	FileRecord();
     FileRecord(const QString& filename);
 	virtual ~FileRecord();
 
     quint64 getByteCount() const { return m_byteCount; }
+    quint64 getBytesPending() const { return m_writer.getBytesPending(); }   //!< Bytes waiting for the disk
+    quint64 getBytesDropped() const { return m_writer.getBytesDropped(); }   //!< Bytes lost because the disk did not keep up
+    int getAvgWriteLatencyUs() const { return m_writer.getAvgWriteLatencyUs(); }
+    int getMaxWriteLatencyUs() { return m_writer.getMaxWriteLatencyUs(); }   //!< Since last call
+    void webapiFormatReport(SWGSDRangel::SWGFileRecordReport& report); //!< Write statistics for the device report of any Rx device
 
     void setFileName(const QString& filename);
     void genUniqueFileName(uint deviceUID);
@@ -58,19 +155,73 @@ public:
     void startRecording();
     void stopRecording();
     static bool readHeader(std::ifstream& samplefile, Header& header); //!< returns true if CRC checksum is correct else false
+    static bool readHeader(const quint8 *buf, Header& header);         //!< same from memory (ex: memory mapped file)
     static void writeHeader(std::ofstream& samplefile, Header& header);
 
+    static void setDefaultOptions(const Options& options);
+    static Options getDefaultOptions();
+
+    static bool isHeaderV2(const quint8 *buf);                         //!< buf points to at least sizeof(HeaderV2) bytes
+    static bool readHeaderV2(const quint8 *buf, HeaderV2& header);     //!< returns true if CRC checksum is correct else false
+    static bool readChunkHeader(const quint8 *buf, ChunkHeader& chunkHeader); //!< returns true if magic and CRC are correct
+    /** Build the list of data chunks of a v2 file from its index chunks if the file was closed properly
+     *  else by walking through the chunks until the first damaged one. Returns false if no data chunk is found.
+     *  The index is only used if the chunk header found at each of its entries matches it.
+     *  indexed is set to true if the index was used. */
+    static bool readChunkTable(MappedFile& file, std::vector<IndexEntry>& entries, bool& indexed);
+
 private:
 	QString m_fileName;
 	quint32 m_sampleRate;
 	quint64 m_centerFrequency;
 	bool m_recordOn;
     bool m_recordStart;
-    std::ofstream m_sampleFile;
+    AsyncFileWriter m_writer; //!< samples are written to disk from the writer thread
     quint64 m_byteCount;
+    Options m_options;        //!< options of the current recording
+    QMutex m_recordMutex;     //!< serializes feed() in the engine thread with recording start and stop from other threads
+    QMutex m_writerMutex;     //!< serializes opening and closing the writer. Not taken by feed() so that closing does not hold the engine thread
+
+    // v2 format
+    SDRDaemonCodec m_codec;
+    std::vector<quint8> m_chunkBuffer;  //!< samples of the chunk being built
+    std::vector<quint8> m_codedBuffer;  //!< compressed chunk payload
+    quint32 m_chunkMaxSamples;
+    quint32 m_chunkFill;                //!< samples in chunk buffer
+    quint32 m_chunkSampleRate;
+    quint64 m_chunkCenterFrequency;
+    quint64 m_timeStampUs;              //!< time of the next sample
+    quint64 m_fileStartUs;              //!< time of the first sample of the current file
+    quint64 m_fileOffset;               //!< bytes written in current file
+    quint64 m_fileSamples;              //!< samples written in current file
+    quint32 m_chunkSequence;
+    quint32 m_fileSequence;
+    quint64 m_lastIndexOffset;
+    std::vector<IndexEntry> m_index;    //!< data chunks since last index chunk
+
+    // SigMF format
+    SigMFFile::Meta m_sigMFMeta;
+    QString m_sigMFMetaFileName;
+
+    static const qint64 m_preallocateStep; //!< disk space is reserved by chunks of this size
+    static const quint32 m_chunksPerIndex;
+    static const quint32 m_maxChunkSamples;
+    static Options m_defaultOptions;
+    static QMutex m_defaultOptionsMutex;
 
 	void handleConfigure(const QString& fileName);
     void writeHeader();
+    void writeHeaderV2();
+    void feedV2(const quint8 *samples, quint32 nbSamples);
+    void writeDataChunk();
+    void writeIndexChunk();
+    void writeEndChunk();
+    void finishFileV2();      //!< flush the last data chunk, the index and the end chunk. Called with m_recordMutex held
+    void rotateFile();        //!< finish current file and continue in the next one. Called from feed() with m_recordMutex held
+    QString getFileName(quint32 fileSequence) const;
+    void writeChunkHeader(ChunkHeader& chunkHeader);
+    void startSigMF();
+    void feedSigMF();
 };
 
 #endif // INCLUDE_FILERECORD_H
@@ -26,6 +26,62 @@
 #include <cstdlib>
 #include "dsp/dsptypes.h"
 #include "dsp/hbfiltertraits.h"
+#include "dsp/inthalfbandfilterkernels.h"
+
+/**
+ * Symmetric FIR inner product. Generic version is plain scalar code. With 32 bit storage
+ * and accumulator (16 bit sample builds) it uses the CPU specific kernel selected at run time.
+ */
+template<typename EOStorageType, typename AccuType>
+struct IntHalfbandFilterEOFIR
+{
+    static void work(
+            const EOStorageType *iTip, const EOStorageType *iTail,
+            const EOStorageType *qTip, const EOStorageType *qTail,
+            const int32_t *coeffs, int nbTaps,
+            AccuType& iAcc, AccuType& qAcc)
+    {
+        for (int i = 0; i < nbTaps; i++)
+        {
+            iAcc += (iTip[-i] + iTail[i]) * coeffs[i];
+            qAcc += (qTip[-i] + qTail[i]) * coeffs[i];
+        }
+    }
+
+    /** Output k in [0, nbOutputs) uses the tip and tail pointers advanced by k */
+    static void workBlock(
+            const EOStorageType *iTip, const EOStorageType *iTail,
+            const EOStorageType *qTip, const EOStorageType *qTail,
+            const int32_t *coeffs, int nbTaps,
+            AccuType *iAcc, AccuType *qAcc, int nbOutputs)
+    {
+        for (int k = 0; k < nbOutputs; k++) {
+            work(iTip + k, iTail + k, qTip + k, qTail + k, coeffs, nbTaps, iAcc[k], qAcc[k]);
+        }
+    }
+};
+
+template<>
+struct IntHalfbandFilterEOFIR<qint32, qint32>
+{
+    static void work(
+            const qint32 *iTip, const qint32 *iTail,
+            const qint32 *qTip, const qint32 *qTail,
+            const int32_t *coeffs, int nbTaps,
+            qint32& iAcc, qint32& qAcc)
+    {
+        IntHalfbandFilterKernels::symmetricFIR(iTip, iTail, qTip, qTail, coeffs, nbTaps, iAcc, qAcc);
+    }
+
+    static void workBlock(
+            const qint32 *iTip, const qint32 *iTail,
+            const qint32 *qTip, const qint32 *qTail,
+            const int32_t *coeffs, int nbTaps,
+            qint32 *iAcc, qint32 *qAcc, int nbOutputs)
+    {
+        IntHalfbandFilterKernels::symmetricFIRBlock(iTip, iTail, qTip, qTail, coeffs, nbTaps, iAcc, qAcc, nbOutputs);
+    }
+};
 
 template<typename EOStorageType, typename AccuType, uint32_t HBFilterOrder>
 class IntHalfbandFilterEO {
@@ -567,6 +623,29 @@ public:
         }
     }
 
+    /**
+     * Block variants of the decimators: count samples are read from in and the decimated
+     * samples are written to out. Work can be done in place (out == in). Returns the number
+     * of output samples. The filter state is shared with the sample by sample decimators.
+     */
+    int workDecimateCenter(const Sample* in, Sample* out, int count)
+    {
+        static const int rotations[2] = {0, 0};
+        return workDecimateBlock(in, out, count, rotations, 2);
+    }
+
+    int workDecimateLowerHalf(const Sample* in, Sample* out, int count)
+    {
+        static const int rotations[4] = {1, 2, 3, 0}; // j, -1, -j, 1
+        return workDecimateBlock(in, out, count, rotations, 4);
+    }
+
+    int workDecimateUpperHalf(const Sample* in, Sample* out, int count)
+    {
+        static const int rotations[4] = {3, 2, 1, 0}; // -j, -1, j, 1
+        return workDecimateBlock(in, out, count, rotations, 4);
+    }
+
     void myDecimate(const Sample* sample1, Sample* sample2)
     {
         storeSample((FixReal) sample1->real(), (FixReal) sample1->imag());
@@ -763,6 +842,120 @@ protected:
     int m_size;
     int m_state;
 
+    static const int m_blockSize = 256; //!< input samples per block kernel call in the block decimators
+
+    int workDecimateBlock(const Sample* in, Sample* out, int count, const int *rotations, int nbStates)
+    {
+        int n = 0;
+
+        // outputs never overtake the inputs of the current block so it also works in place
+        for (int i = 0; i < count; i += m_blockSize) {
+            n += decimateBlock(&in[i], &out[n], count - i < m_blockSize ? count - i : m_blockSize, rotations, nbStates);
+        }
+
+        return n;
+    }
+
+    /**
+     * Runs the decimator over up to m_blockSize samples. The ring buffer history and the input
+     * are laid out linearly by sample parity so that the outputs of the block, which all have
+     * the same parity, are obtained with consecutive tip and tail pointers in one kernel call.
+     * Sample n (history is negative) is at index (n + hbOrder)/2 of the (n + hbOrder)%2 buffer.
+     */
+    int decimateBlock(const Sample* in, Sample* out, int count, const int *rotations, int nbStates)
+    {
+        const int hbOrder = HBFIRFilterTraits<HBFilterOrder>::hbOrder; // ring size 2*m_size
+        EOStorageType x[2][2][HBFIRFilterTraits<HBFilterOrder>::hbOrder/2 + m_blockSize/2 + 1]; // [parity][I/Q][index]
+        AccuType iAcc[m_blockSize/2];
+        AccuType qAcc[m_blockSize/2];
+
+        for (int a = 0, r = m_ptr; a < hbOrder; a++)
+        {
+            const EOStorageType (*ring)[hbOrder] = (r % 2) == 0 ? m_even : m_odd;
+            x[a % 2][0][a / 2] = ring[0][r / 2];
+            x[a % 2][1][a / 2] = ring[1][r / 2];
+            r = r + 1 < hbOrder ? r + 1 : 0;
+        }
+
+        for (int n = 0, state = m_state; n < count; n++)
+        {
+            int a = n + hbOrder;
+
+            switch (rotations[state])
+            {
+            case 1:
+                x[a % 2][0][a / 2] = (FixReal) -in[n].imag();
+                x[a % 2][1][a / 2] = (FixReal) in[n].real();
+                break;
+            case 2:
+                x[a % 2][0][a / 2] = (FixReal) -in[n].real();
+                x[a % 2][1][a / 2] = (FixReal) -in[n].imag();
+                break;
+            case 3:
+                x[a % 2][0][a / 2] = (FixReal) in[n].imag();
+                x[a % 2][1][a / 2] = (FixReal) -in[n].real();
+                break;
+            default:
+                x[a % 2][0][a / 2] = (FixReal) in[n].real();
+                x[a % 2][1][a / 2] = (FixReal) in[n].imag();
+                break;
+            }
+
+            state = state + 1 < nbStates ? state + 1 : 0;
+        }
+
+        // samples in odd states give an output
+        int n0 = (m_state % 2) == 1 ? 0 : 1;
+        int nbOutputs = count > n0 ? (count - n0 + 1) / 2 : 0;
+
+        if (nbOutputs > 0)
+        {
+            int a0 = n0 + hbOrder;
+            int p = a0 % 2;
+            int tip = a0 / 2;
+            int tail = tip - (m_size - 1);
+            int center = (a0 - (m_size - 1)) / 2; // opposite parity
+
+            for (int k = 0; k < nbOutputs; k++)
+            {
+                iAcc[k] = 0;
+                qAcc[k] = 0;
+            }
+
+            IntHalfbandFilterEOFIR<EOStorageType, AccuType>::workBlock(
+                    &x[p][0][tip], &x[p][0][tail],
+                    &x[p][1][tip], &x[p][1][tail],
+                    HBFIRFilterTraits<HBFilterOrder>::hbCoeffs,
+                    HBFIRFilterTraits<HBFilterOrder>::hbOrder / 4,
+                    iAcc, qAcc, nbOutputs);
+
+            for (int k = 0; k < nbOutputs; k++)
+            {
+                iAcc[k] += ((int32_t)x[1-p][0][center + k]) << (HBFIRFilterTraits<HBFilterOrder>::hbShift - 1);
+                qAcc[k] += ((int32_t)x[1-p][1][center + k]) << (HBFIRFilterTraits<HBFilterOrder>::hbShift - 1);
+                out[k].setReal(iAcc[k] >> (HBFIRFilterTraits<HBFilterOrder>::hbShift -1));
+                out[k].setImag(qAcc[k] >> (HBFIRFilterTraits<HBFilterOrder>::hbShift -1));
+            }
+        }
+
+        // write the newest samples back to the ring buffer
+        for (int n = count < hbOrder ? 0 : count - hbOrder; n < count; n++)
+        {
+            int a = n + hbOrder;
+            int r = (m_ptr + n) % hbOrder;
+            EOStorageType (*ring)[hbOrder] = (r % 2) == 0 ? m_even : m_odd;
+            ring[0][r/2] = x[a % 2][0][a / 2];
+            ring[1][r/2] = x[a % 2][1][a / 2];
+            ring[0][r/2 + m_size] = x[a % 2][0][a / 2];
+            ring[1][r/2 + m_size] = x[a % 2][1][a / 2];
+        }
+
+        m_ptr = (m_ptr + count) % hbOrder;
+        m_state = (m_state + count) % nbStates;
+
+        return nbOutputs;
+    }
+
     void storeSample(const FixReal& sampleI, const FixReal& sampleQ)
     {
         if ((m_ptr % 2) == 0)
@@ -809,25 +1002,19 @@ protected:
         AccuType iAcc = 0;
         AccuType qAcc = 0;
 
-        int a = m_ptr/2 + m_size; // tip pointer
-        int b = m_ptr/2 + 1; // tail pointer
-
-        for (int i = 0; i < HBFIRFilterTraits<HBFilterOrder>::hbOrder / 4; i++)
-        {
-            if ((m_ptr % 2) == 0)
-            {
-                iAcc += (m_even[0][a] + m_even[0][b]) * HBFIRFilterTraits<HBFilterOrder>::hbCoeffs[i];
-                qAcc += (m_even[1][a] + m_even[1][b]) * HBFIRFilterTraits<HBFilterOrder>::hbCoeffs[i];
-            }
-            else
-            {
-                iAcc += (m_odd[0][a] + m_odd[0][b]) * HBFIRFilterTraits<HBFilterOrder>::hbCoeffs[i];
-                qAcc += (m_odd[1][a] + m_odd[1][b]) * HBFIRFilterTraits<HBFilterOrder>::hbCoeffs[i];
-            }
+        // select the buffer once so that the inner product has no branch
+        const EOStorageType *iBuf = (m_ptr % 2) == 0 ? m_even[0] : m_odd[0];
+        const EOStorageType *qBuf = (m_ptr % 2) == 0 ? m_even[1] : m_odd[1];
+        const EOStorageType *iTip = &iBuf[m_ptr/2 + m_size]; // tip pointer
+        const EOStorageType *qTip = &qBuf[m_ptr/2 + m_size];
+        const EOStorageType *iTail = &iBuf[m_ptr/2 + 1];     // tail pointer
+        const EOStorageType *qTail = &qBuf[m_ptr/2 + 1];
 
-            a -= 1;
-            b += 1;
-        }
+        IntHalfbandFilterEOFIR<EOStorageType, AccuType>::work(
+                iTip, iTail, qTip, qTail,
+                HBFIRFilterTraits<HBFilterOrder>::hbCoeffs,
+                HBFIRFilterTraits<HBFilterOrder>::hbOrder / 4,
+                iAcc, qAcc);
 
         if ((m_ptr % 2) == 0)
         {
@@ -849,25 +1036,15 @@ protected:
         AccuType iAcc = 0;
         AccuType qAcc = 0;
 
-        int a = m_ptr/2 + m_size; // tip pointer
-        int b = m_ptr/2 + 1; // tail pointer
-
-        for (int i = 0; i < HBFIRFilterTraits<HBFilterOrder>::hbOrder / 4; i++)
-        {
-            if ((m_ptr % 2) == 0)
-            {
-                iAcc += (m_even[0][a] + m_even[0][b]) * HBFIRFilterTraits<HBFilterOrder>::hbCoeffs[i];
-                qAcc += (m_even[1][a] + m_even[1][b]) * HBFIRFilterTraits<HBFilterOrder>::hbCoeffs[i];
-            }
-            else
-            {
-                iAcc += (m_odd[0][a] + m_odd[0][b]) * HBFIRFilterTraits<HBFilterOrder>::hbCoeffs[i];
-                qAcc += (m_odd[1][a] + m_odd[1][b]) * HBFIRFilterTraits<HBFilterOrder>::hbCoeffs[i];
-            }
+        const EOStorageType *iBuf = (m_ptr % 2) == 0 ? m_even[0] : m_odd[0];
+        const EOStorageType *qBuf = (m_ptr % 2) == 0 ? m_even[1] : m_odd[1];
 
-            a -= 1;
-            b += 1;
-        }
+        IntHalfbandFilterEOFIR<EOStorageType, AccuType>::work(
+                &iBuf[m_ptr/2 + m_size], &iBuf[m_ptr/2 + 1], // tip and tail pointers
+                &qBuf[m_ptr/2 + m_size], &qBuf[m_ptr/2 + 1],
+                HBFIRFilterTraits<HBFilterOrder>::hbCoeffs,
+                HBFIRFilterTraits<HBFilterOrder>::hbOrder / 4,
+                iAcc, qAcc);
 
         if ((m_ptr % 2) == 0)
         {
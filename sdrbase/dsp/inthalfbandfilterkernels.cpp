@@ -0,0 +1,327 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HBKERNELS_X86
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define HBKERNELS_NEON
+#include <arm_neon.h>
+#if defined(__linux__) && defined(__arm__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+#endif
+
+#include "inthalfbandfilterkernels.h"
+
+namespace
+{
+
+inline void symmetricFIRGeneric(
+        const int32_t *iTip, const int32_t *iTail,
+        const int32_t *qTip, const int32_t *qTail,
+        const int32_t *coeffs, int nbTaps,
+        int32_t& iAcc, int32_t& qAcc)
+{
+    int32_t i0 = 0, q0 = 0;
+
+    for (int i = 0; i < nbTaps; i++)
+    {
+        i0 += (iTip[-i] + iTail[i]) * coeffs[i];
+        q0 += (qTip[-i] + qTail[i]) * coeffs[i];
+    }
+
+    iAcc += i0;
+    qAcc += q0;
+}
+
+void symmetricFIRGenericBlock(
+        const int32_t *iTip, const int32_t *iTail,
+        const int32_t *qTip, const int32_t *qTail,
+        const int32_t *coeffs, int nbTaps,
+        int32_t *iAcc, int32_t *qAcc, int nbOutputs)
+{
+    for (int k = 0; k < nbOutputs; k++) {
+        symmetricFIRGeneric(iTip + k, iTail + k, qTip + k, qTail + k, coeffs, nbTaps, iAcc[k], qAcc[k]);
+    }
+}
+
+#ifdef HBKERNELS_X86
+__attribute__((target("sse4.1")))
+inline void symmetricFIRSSE41(
+        const int32_t *iTip, const int32_t *iTail,
+        const int32_t *qTip, const int32_t *qTail,
+        const int32_t *coeffs, int nbTaps,
+        int32_t& iAcc, int32_t& qAcc)
+{
+    __m128i sumI = _mm_setzero_si128();
+    __m128i sumQ = _mm_setzero_si128();
+    int i = 0;
+
+    for (; i + 4 <= nbTaps; i += 4)
+    {
+        __m128i h = _mm_loadu_si128((const __m128i*) &coeffs[i]);
+        __m128i ta = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*) &iTip[-i-3]), _MM_SHUFFLE(0,1,2,3));
+        __m128i tb = _mm_loadu_si128((const __m128i*) &iTail[i]);
+        sumI = _mm_add_epi32(sumI, _mm_mullo_epi32(_mm_add_epi32(ta, tb), h));
+        ta = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*) &qTip[-i-3]), _MM_SHUFFLE(0,1,2,3));
+        tb = _mm_loadu_si128((const __m128i*) &qTail[i]);
+        sumQ = _mm_add_epi32(sumQ, _mm_mullo_epi32(_mm_add_epi32(ta, tb), h));
+    }
+
+    // horizontal add of four 32 bit partial sums
+    sumI = _mm_add_epi32(sumI, _mm_srli_si128(sumI, 8));
+    sumI = _mm_add_epi32(sumI, _mm_srli_si128(sumI, 4));
+    sumQ = _mm_add_epi32(sumQ, _mm_srli_si128(sumQ, 8));
+    sumQ = _mm_add_epi32(sumQ, _mm_srli_si128(sumQ, 4));
+    iAcc += _mm_cvtsi128_si32(sumI);
+    qAcc += _mm_cvtsi128_si32(sumQ);
+
+    if (i < nbTaps) {
+        symmetricFIRGeneric(iTip - i, iTail + i, qTip - i, qTail + i, coeffs + i, nbTaps - i, iAcc, qAcc);
+    }
+}
+
+__attribute__((target("avx2")))
+inline void symmetricFIRAVX2(
+        const int32_t *iTip, const int32_t *iTail,
+        const int32_t *qTip, const int32_t *qTail,
+        const int32_t *coeffs, int nbTaps,
+        int32_t& iAcc, int32_t& qAcc)
+{
+    const __m256i reverse = _mm256_set_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    __m256i sumI = _mm256_setzero_si256();
+    __m256i sumQ = _mm256_setzero_si256();
+    int i = 0;
+
+    for (; i + 8 <= nbTaps; i += 8)
+    {
+        __m256i h = _mm256_loadu_si256((const __m256i*) &coeffs[i]);
+        __m256i ta = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i*) &iTip[-i-7]), reverse);
+        __m256i tb = _mm256_loadu_si256((const __m256i*) &iTail[i]);
+        sumI = _mm256_add_epi32(sumI, _mm256_mullo_epi32(_mm256_add_epi32(ta, tb), h));
+        ta = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i*) &qTip[-i-7]), reverse);
+        tb = _mm256_loadu_si256((const __m256i*) &qTail[i]);
+        sumQ = _mm256_add_epi32(sumQ, _mm256_mullo_epi32(_mm256_add_epi32(ta, tb), h));
+    }
+
+    // fold to 128 bits then horizontal add of four 32 bit partial sums
+    __m128i sI = _mm_add_epi32(_mm256_castsi256_si128(sumI), _mm256_extracti128_si256(sumI, 1));
+    __m128i sQ = _mm_add_epi32(_mm256_castsi256_si128(sumQ), _mm256_extracti128_si256(sumQ, 1));
+    sI = _mm_add_epi32(sI, _mm_srli_si128(sI, 8));
+    sI = _mm_add_epi32(sI, _mm_srli_si128(sI, 4));
+    sQ = _mm_add_epi32(sQ, _mm_srli_si128(sQ, 8));
+    sQ = _mm_add_epi32(sQ, _mm_srli_si128(sQ, 4));
+    iAcc += _mm_cvtsi128_si32(sI);
+    qAcc += _mm_cvtsi128_si32(sQ);
+
+    if (i < nbTaps) {
+        symmetricFIRGeneric(iTip - i, iTail + i, qTip - i, qTail + i, coeffs + i, nbTaps - i, iAcc, qAcc);
+    }
+}
+
+__attribute__((target("sse4.1")))
+void symmetricFIRSSE41Block(
+        const int32_t *iTip, const int32_t *iTail,
+        const int32_t *qTip, const int32_t *qTail,
+        const int32_t *coeffs, int nbTaps,
+        int32_t *iAcc, int32_t *qAcc, int nbOutputs)
+{
+    for (int k = 0; k < nbOutputs; k++) {
+        symmetricFIRSSE41(iTip + k, iTail + k, qTip + k, qTail + k, coeffs, nbTaps, iAcc[k], qAcc[k]);
+    }
+}
+
+__attribute__((target("avx2")))
+void symmetricFIRAVX2Block(
+        const int32_t *iTip, const int32_t *iTail,
+        const int32_t *qTip, const int32_t *qTail,
+        const int32_t *coeffs, int nbTaps,
+        int32_t *iAcc, int32_t *qAcc, int nbOutputs)
+{
+    for (int k = 0; k < nbOutputs; k++) {
+        symmetricFIRAVX2(iTip + k, iTail + k, qTip + k, qTail + k, coeffs, nbTaps, iAcc[k], qAcc[k]);
+    }
+}
+#endif // HBKERNELS_X86
+
+#ifdef HBKERNELS_NEON
+inline int32x4_t reverse4(int32x4_t v)
+{
+    int32x4_t r = vrev64q_s32(v); // (1,0,3,2)
+    return vcombine_s32(vget_high_s32(r), vget_low_s32(r));
+}
+
+inline void symmetricFIRNEON(
+        const int32_t *iTip, const int32_t *iTail,
+        const int32_t *qTip, const int32_t *qTail,
+        const int32_t *coeffs, int nbTaps,
+        int32_t& iAcc, int32_t& qAcc)
+{
+    int32x4_t sumI = vdupq_n_s32(0);
+    int32x4_t sumQ = vdupq_n_s32(0);
+    int i = 0;
+
+    for (; i + 4 <= nbTaps; i += 4)
+    {
+        int32x4_t h = vld1q_s32(&coeffs[i]);
+        sumI = vmlaq_s32(sumI, vaddq_s32(reverse4(vld1q_s32(&iTip[-i-3])), vld1q_s32(&iTail[i])), h);
+        sumQ = vmlaq_s32(sumQ, vaddq_s32(reverse4(vld1q_s32(&qTip[-i-3])), vld1q_s32(&qTail[i])), h);
+    }
+
+    int32x2_t sI = vadd_s32(vget_low_s32(sumI), vget_high_s32(sumI));
+    int32x2_t sQ = vadd_s32(vget_low_s32(sumQ), vget_high_s32(sumQ));
+    iAcc += vget_lane_s32(vpadd_s32(sI, sI), 0);
+    qAcc += vget_lane_s32(vpadd_s32(sQ, sQ), 0);
+
+    if (i < nbTaps) {
+        symmetricFIRGeneric(iTip - i, iTail + i, qTip - i, qTail + i, coeffs + i, nbTaps - i, iAcc, qAcc);
+    }
+}
+
+void symmetricFIRNEONBlock(
+        const int32_t *iTip, const int32_t *iTail,
+        const int32_t *qTip, const int32_t *qTail,
+        const int32_t *coeffs, int nbTaps,
+        int32_t *iAcc, int32_t *qAcc, int nbOutputs)
+{
+    for (int k = 0; k < nbOutputs; k++) {
+        symmetricFIRNEON(iTip + k, iTail + k, qTip + k, qTail + k, coeffs, nbTaps, iAcc[k], qAcc[k]);
+    }
+}
+#endif // HBKERNELS_NEON
+
+IntHalfbandFilterKernels::SymmetricFIR getKernel(IntHalfbandFilterKernels::ISA isa)
+{
+    switch (isa)
+    {
+#ifdef HBKERNELS_X86
+    case IntHalfbandFilterKernels::ISASSE41:
+        return symmetricFIRSSE41;
+    case IntHalfbandFilterKernels::ISAAVX2:
+        return symmetricFIRAVX2;
+#endif
+#ifdef HBKERNELS_NEON
+    case IntHalfbandFilterKernels::ISANEON:
+        return symmetricFIRNEON;
+#endif
+    default:
+        return symmetricFIRGeneric;
+    }
+}
+
+IntHalfbandFilterKernels::SymmetricFIRBlock getBlockKernel(IntHalfbandFilterKernels::ISA isa)
+{
+    switch (isa)
+    {
+#ifdef HBKERNELS_X86
+    case IntHalfbandFilterKernels::ISASSE41:
+        return symmetricFIRSSE41Block;
+    case IntHalfbandFilterKernels::ISAAVX2:
+        return symmetricFIRAVX2Block;
+#endif
+#ifdef HBKERNELS_NEON
+    case IntHalfbandFilterKernels::ISANEON:
+        return symmetricFIRNEONBlock;
+#endif
+    default:
+        return symmetricFIRGenericBlock;
+    }
+}
+
+} // namespace
+
+IntHalfbandFilterKernels::ISA IntHalfbandFilterKernels::m_isa = IntHalfbandFilterKernels::getBestISA();
+IntHalfbandFilterKernels::SymmetricFIR IntHalfbandFilterKernels::m_symmetricFIR = getKernel(IntHalfbandFilterKernels::m_isa);
+IntHalfbandFilterKernels::SymmetricFIRBlock IntHalfbandFilterKernels::m_symmetricFIRBlock = getBlockKernel(IntHalfbandFilterKernels::m_isa);
+
+bool IntHalfbandFilterKernels::isSupported(ISA isa)
+{
+#ifdef HBKERNELS_X86
+    __builtin_cpu_init(); // may run from a static initializer before the CPU model is known
+#endif
+
+    switch (isa)
+    {
+    case ISAGeneric:
+        return true;
+#ifdef HBKERNELS_X86
+    case ISASSE41:
+        return __builtin_cpu_supports("sse4.1");
+    case ISAAVX2:
+        return __builtin_cpu_supports("avx2");
+#endif
+#ifdef HBKERNELS_NEON
+    case ISANEON:
+#if defined(__aarch64__)
+        return true; // always present on 64 bit ARM
+#elif defined(__linux__)
+        return (getauxval(AT_HWCAP) & HWCAP_NEON) != 0;
+#else
+        return true; // built with NEON enabled
+#endif
+#endif
+    default:
+        return false;
+    }
+}
+
+IntHalfbandFilterKernels::ISA IntHalfbandFilterKernels::getBestISA()
+{
+    if (isSupported(ISAAVX2)) {
+        return ISAAVX2;
+    } else if (isSupported(ISANEON)) {
+        return ISANEON;
+    } else if (isSupported(ISASSE41)) {
+        return ISASSE41;
+    } else {
+        return ISAGeneric;
+    }
+}
+
+bool IntHalfbandFilterKernels::setISA(ISA isa)
+{
+    if (!isSupported(isa)) {
+        return false;
+    }
+
+    m_isa = isa;
+    m_symmetricFIR = getKernel(isa);
+    m_symmetricFIRBlock = getBlockKernel(isa);
+    return true;
+}
+
+const char *IntHalfbandFilterKernels::getISAName(ISA isa)
+{
+    switch (isa)
+    {
+    case ISAGeneric:
+        return "generic";
+    case ISASSE41:
+        return "sse4.1";
+    case ISAAVX2:
+        return "avx2";
+    case ISANEON:
+        return "neon";
+    default:
+        return "unknown";
+    }
+}
@@ -0,0 +1,91 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef SDRBASE_DSP_INTHALFBANDFILTERKERNELS_H_
+#define SDRBASE_DSP_INTHALFBANDFILTERKERNELS_H_
+
+#include <stdint.h>
+#include "export.h"
+
+/**
+ * Symmetric FIR inner products of the even/odd half band filters with 32 bit storage.
+ * The implementation is selected at run time from the instruction sets the CPU supports
+ * so that the same binary can use AVX2 or NEON when available.
+ */
+class SDRBASE_API IntHalfbandFilterKernels
+{
+public:
+    enum ISA
+    {
+        ISAGeneric,
+        ISASSE41,
+        ISAAVX2,
+        ISANEON,
+        ISAEnd
+    };
+
+    /**
+     * Sum over i in [0, nbTaps) of (tip[-i] + tail[i]) * coeffs[i] for I and Q
+     */
+    typedef void (*SymmetricFIR)(
+            const int32_t *iTip, const int32_t *iTail,
+            const int32_t *qTip, const int32_t *qTail,
+            const int32_t *coeffs, int nbTaps,
+            int32_t& iAcc, int32_t& qAcc);
+
+    /**
+     * Block version: output k in [0, nbOutputs) uses iTip + k, iTail + k, qTip + k, qTail + k
+     * and adds its sums to iAcc[k], qAcc[k]. The kernel is dispatched once for the whole block.
+     */
+    typedef void (*SymmetricFIRBlock)(
+            const int32_t *iTip, const int32_t *iTail,
+            const int32_t *qTip, const int32_t *qTail,
+            const int32_t *coeffs, int nbTaps,
+            int32_t *iAcc, int32_t *qAcc, int nbOutputs);
+
+    static void symmetricFIR(
+            const int32_t *iTip, const int32_t *iTail,
+            const int32_t *qTip, const int32_t *qTail,
+            const int32_t *coeffs, int nbTaps,
+            int32_t& iAcc, int32_t& qAcc)
+    {
+        m_symmetricFIR(iTip, iTail, qTip, qTail, coeffs, nbTaps, iAcc, qAcc);
+    }
+
+    static void symmetricFIRBlock(
+            const int32_t *iTip, const int32_t *iTail,
+            const int32_t *qTip, const int32_t *qTail,
+            const int32_t *coeffs, int nbTaps,
+            int32_t *iAcc, int32_t *qAcc, int nbOutputs)
+    {
+        m_symmetricFIRBlock(iTip, iTail, qTip, qTail, coeffs, nbTaps, iAcc, qAcc, nbOutputs);
+    }
+
+    static bool isSupported(ISA isa); //!< ISA is compiled in and supported by this CPU
+    static bool setISA(ISA isa);      //!< Force an ISA (benchmarks). Returns false if not supported.
+    static ISA getISA() { return m_isa; }
+    static ISA getBestISA();
+    static const char *getISAName(ISA isa);
+
+private:
+    static ISA m_isa;
+    static SymmetricFIR m_symmetricFIR;
+    static SymmetricFIRBlock m_symmetricFIRBlock;
+};
+
+#endif /* SDRBASE_DSP_INTHALFBANDFILTERKERNELS_H_ */
@@ -0,0 +1,213 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SMKERNELS_X86
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define SMKERNELS_NEON
+#include <arm_neon.h>
+#endif
+
+#include "samplemixerkernels.h"
+
+namespace
+{
+
+// Samples are processed as flat arrays of 2*n I/Q components
+
+#if SDR_RX_SAMP_SZ == 24
+inline FixReal addComponents(FixReal a, FixReal b)
+{
+    return a + b;
+}
+#else
+inline FixReal addComponents(FixReal a, FixReal b)
+{
+    int32_t s = (int32_t) a + (int32_t) b;
+    return s > 32767 ? 32767 : s < -32768 ? -32768 : s;
+}
+#endif
+
+void mixGenericRange(const Sample * const *in, unsigned int nbSources, Sample *out, unsigned int begin, unsigned int n, unsigned int shift)
+{
+    const FixReal *src = (const FixReal *) in[0];
+    FixReal *o = (FixReal *) out;
+
+    for (unsigned int j = 2*begin; j < 2*n; j++) {
+        o[j] = src[j] >> shift;
+    }
+
+    for (unsigned int is = 1; is < nbSources; is++)
+    {
+        src = (const FixReal *) in[is];
+
+        for (unsigned int j = 2*begin; j < 2*n; j++) {
+            o[j] = addComponents(o[j], src[j] >> shift);
+        }
+    }
+}
+
+void mixGeneric(const Sample * const *in, unsigned int nbSources, Sample *out, unsigned int n, unsigned int shift)
+{
+    mixGenericRange(in, nbSources, out, 0, n, shift);
+}
+
+#ifdef SMKERNELS_X86
+__attribute__((target("sse4.1")))
+void mixSSE41(const Sample * const *in, unsigned int nbSources, Sample *out, unsigned int n, unsigned int shift)
+{
+    const __m128i cnt = _mm_cvtsi32_si128(shift);
+    const unsigned int nbComponents = 2*n;
+#if SDR_RX_SAMP_SZ == 24
+    const unsigned int step = 4; // components per vector
+#else
+    const unsigned int step = 8;
+#endif
+    unsigned int j = 0;
+
+    for (; j + step <= nbComponents; j += step)
+    {
+        __m128i acc = _mm_setzero_si128();
+
+        for (unsigned int is = 0; is < nbSources; is++)
+        {
+            const FixReal *src = (const FixReal *) in[is];
+            __m128i v = _mm_loadu_si128((const __m128i *) &src[j]);
+#if SDR_RX_SAMP_SZ == 24
+            acc = _mm_add_epi32(acc, _mm_sra_epi32(v, cnt));
+#else
+            acc = _mm_adds_epi16(acc, _mm_sra_epi16(v, cnt));
+#endif
+        }
+
+        _mm_storeu_si128((__m128i *) &((FixReal *) out)[j], acc);
+    }
+
+    mixGenericRange(in, nbSources, out, j/2, n, shift);
+}
+
+__attribute__((target("avx2")))
+void mixAVX2(const Sample * const *in, unsigned int nbSources, Sample *out, unsigned int n, unsigned int shift)
+{
+    const __m128i cnt = _mm_cvtsi32_si128(shift);
+    const unsigned int nbComponents = 2*n;
+#if SDR_RX_SAMP_SZ == 24
+    const unsigned int step = 8; // components per vector
+#else
+    const unsigned int step = 16;
+#endif
+    unsigned int j = 0;
+
+    for (; j + step <= nbComponents; j += step)
+    {
+        __m256i acc = _mm256_setzero_si256();
+
+        for (unsigned int is = 0; is < nbSources; is++)
+        {
+            const FixReal *src = (const FixReal *) in[is];
+            __m256i v = _mm256_loadu_si256((const __m256i *) &src[j]);
+#if SDR_RX_SAMP_SZ == 24
+            acc = _mm256_add_epi32(acc, _mm256_sra_epi32(v, cnt));
+#else
+            acc = _mm256_adds_epi16(acc, _mm256_sra_epi16(v, cnt));
+#endif
+        }
+
+        _mm256_storeu_si256((__m256i *) &((FixReal *) out)[j], acc);
+    }
+
+    mixGenericRange(in, nbSources, out, j/2, n, shift);
+}
+#endif // SMKERNELS_X86
+
+#ifdef SMKERNELS_NEON
+void mixNEON(const Sample * const *in, unsigned int nbSources, Sample *out, unsigned int n, unsigned int shift)
+{
+    const unsigned int nbComponents = 2*n;
+#if SDR_RX_SAMP_SZ == 24
+    const int32x4_t cnt = vdupq_n_s32(-(int32_t) shift); // negative count is a right shift
+    const unsigned int step = 4; // components per vector
+#else
+    const int16x8_t cnt = vdupq_n_s16(-(int16_t) shift);
+    const unsigned int step = 8;
+#endif
+    unsigned int j = 0;
+
+    for (; j + step <= nbComponents; j += step)
+    {
+#if SDR_RX_SAMP_SZ == 24
+        int32x4_t acc = vdupq_n_s32(0);
+
+        for (unsigned int is = 0; is < nbSources; is++) {
+            acc = vaddq_s32(acc, vshlq_s32(vld1q_s32((const int32_t *) in[is] + j), cnt));
+        }
+
+        vst1q_s32((int32_t *) out + j, acc);
+#else
+        int16x8_t acc = vdupq_n_s16(0);
+
+        for (unsigned int is = 0; is < nbSources; is++) {
+            acc = vqaddq_s16(acc, vshlq_s16(vld1q_s16((const int16_t *) in[is] + j), cnt));
+        }
+
+        vst1q_s16((int16_t *) out + j, acc);
+#endif
+    }
+
+    mixGenericRange(in, nbSources, out, j/2, n, shift);
+}
+#endif // SMKERNELS_NEON
+
+SampleMixerKernels::Mix getKernel(SampleMixerKernels::ISA isa)
+{
+    switch (isa)
+    {
+#ifdef SMKERNELS_X86
+    case IntHalfbandFilterKernels::ISASSE41:
+        return mixSSE41;
+    case IntHalfbandFilterKernels::ISAAVX2:
+        return mixAVX2;
+#endif
+#ifdef SMKERNELS_NEON
+    case IntHalfbandFilterKernels::ISANEON:
+        return mixNEON;
+#endif
+    default:
+        return mixGeneric;
+    }
+}
+
+} // namespace
+
+// IntHalfbandFilterKernels initializes the CPU detection so this is safe from a static initializer
+SampleMixerKernels::ISA SampleMixerKernels::m_isa = IntHalfbandFilterKernels::getBestISA();
+SampleMixerKernels::Mix SampleMixerKernels::m_mix = getKernel(SampleMixerKernels::m_isa);
+
+bool SampleMixerKernels::setISA(ISA isa)
+{
+    if (!IntHalfbandFilterKernels::isSupported(isa)) {
+        return false;
+    }
+
+    m_isa = isa;
+    m_mix = getKernel(isa);
+    return true;
+}
@@ -0,0 +1,60 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef SDRBASE_DSP_SAMPLEMIXERKERNELS_H_
+#define SDRBASE_DSP_SAMPLEMIXERKERNELS_H_
+
+#include <algorithm>
+
+#include "dsp/dsptypes.h"
+#include "dsp/inthalfbandfilterkernels.h"
+#include "export.h"
+
+/**
+ * Mixing of several channel sources into the device sample FIFO. Each source is divided
+ * by the same power of two then sources are summed with saturation in the 16 bit build.
+ * In the 24 bit build samples are 32 bit wide and the sums cannot overflow.
+ * Like the half band filter kernels the implementation is selected at run time
+ * from the instruction sets the CPU supports.
+ */
+class SDRBASE_API SampleMixerKernels
+{
+public:
+    typedef IntHalfbandFilterKernels::ISA ISA;
+
+    typedef void (*Mix)(const Sample * const *in, unsigned int nbSources, Sample *out, unsigned int n, unsigned int shift);
+
+    /** out[i] = sum over sources of (in[source][i] >> shift). Shift is arithmetic i.e. rounds toward minus infinity. */
+    static void mix(const Sample * const *in, unsigned int nbSources, Sample *out, unsigned int n, unsigned int shift)
+    {
+        if (shift < 8*sizeof(FixReal)) {
+            m_mix(in, nbSources, out, n, shift);
+        } else {
+            std::fill(out, out + n, Sample(0, 0)); // shifting by the sample size is undefined
+        }
+    }
+
+    static bool setISA(ISA isa); //!< Force an ISA (benchmarks). Returns false if not supported.
+    static ISA getISA() { return m_isa; }
+
+private:
+    static ISA m_isa;
+    static Mix m_mix;
+};
+
+#endif /* SDRBASE_DSP_SAMPLEMIXERKERNELS_H_ */
@@ -0,0 +1,262 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+
+#include "samplesinkbroadcastfifo.h"
+
+SampleSinkBroadcastFifoReader::SampleSinkBroadcastFifoReader(SampleSinkBroadcastFifo *fifo, Policy policy) :
+    m_fifo(fifo),
+    m_busy(false),
+    m_dropping(false),
+    m_blockBegin(0),
+    m_head(fifo->m_tail.loadAcquire()),
+    m_notified(0),
+    m_policy((int) policy),
+    m_droppedSamples(0)
+{
+}
+
+SampleSinkBroadcastFifoReader::~SampleSinkBroadcastFifoReader()
+{
+}
+
+uint SampleSinkBroadcastFifoReader::fill() const
+{
+    return m_fifo->m_tail.loadAcquire() - m_head.loadAcquire();
+}
+
+uint SampleSinkBroadcastFifoReader::readBegin(uint count,
+    SampleVector::iterator* part1Begin, SampleVector::iterator* part1End,
+    SampleVector::iterator* part2Begin, SampleVector::iterator* part2End)
+{
+    quint32 head;
+    quint32 tail;
+    uint maxLag = m_fifo->m_size / 2;
+
+    *part1Begin = m_fifo->m_data.end();
+    *part1End = m_fifo->m_data.end();
+    *part2Begin = m_fifo->m_data.end();
+    *part2End = m_fifo->m_data.end();
+
+    m_notified.fetchAndStoreOrdered(0);
+
+    {
+        SpinlockHolder spinlockHolder(&m_lock);
+        head = m_head.load();
+        tail = m_fifo->m_tail.loadAcquire();
+
+        // a dropping reader starts at most half of the ring behind so that the writer has room before it overwrites the block
+        if ((getPolicy() == PolicyDrop) && (tail - head > maxLag))
+        {
+            m_droppedSamples.fetchAndAddRelaxed(tail - head - maxLag);
+            head = tail - maxLag;
+            m_head.storeRelease(head);
+        }
+
+        m_dropping = (getPolicy() == PolicyDrop);
+        m_blockBegin = head;
+        m_busy = true;
+    }
+
+    uint total = std::min(count, (uint) (tail - head));
+    total = std::min(total, maxLag);
+    uint index = head & m_fifo->m_mask;
+    uint len = std::min(total, m_fifo->m_size - index);
+
+    if (total > 0)
+    {
+        *part1Begin = m_fifo->m_data.begin() + index;
+        *part1End = m_fifo->m_data.begin() + index + len;
+
+        if (len < total)
+        {
+            *part2Begin = m_fifo->m_data.begin();
+            *part2End = m_fifo->m_data.begin() + (total - len);
+        }
+    }
+
+    return total;
+}
+
+uint SampleSinkBroadcastFifoReader::readCommit(uint count)
+{
+    SpinlockHolder spinlockHolder(&m_lock);
+    quint32 tail = m_fifo->m_tail.loadAcquire();
+    uint fill = tail - m_blockBegin; // the writer does not move the head while a block is read
+
+    if (count > fill)
+    {
+        qCritical("SampleSinkBroadcastFifoReader: cannot commit more than available samples");
+        count = fill;
+    }
+
+    if (m_dropping && (fill > m_fifo->m_size))
+    {
+        // the writer wrapped around over the start of the block while it was processed
+        m_droppedSamples.fetchAndAddRelaxed(std::min(count, fill - m_fifo->m_size));
+    }
+
+    m_head.storeRelease(m_blockBegin + count);
+    m_busy = false;
+    m_dropping = false;
+
+    return count;
+}
+
+uint SampleSinkBroadcastFifoReader::skip(uint count)
+{
+    SpinlockHolder spinlockHolder(&m_lock);
+    quint32 head = m_head.load();
+    count = std::min(count, (uint) (m_fifo->m_tail.loadAcquire() - head));
+    m_head.storeRelease(head + count);
+
+    return count;
+}
+
+SampleSinkBroadcastFifo::SampleSinkBroadcastFifo(uint size) :
+    m_size(0),
+    m_mask(0),
+    m_tail(0),
+    m_overflowCount(0),
+    m_overflowSamples(0)
+{
+    uint ringSize = 1;
+
+    while (ringSize < size) {
+        ringSize <<= 1;
+    }
+
+    m_data.resize(ringSize);
+    m_size = m_data.size();
+    m_mask = m_size - 1;
+}
+
+SampleSinkBroadcastFifo::~SampleSinkBroadcastFifo()
+{
+    for (std::vector<SampleSinkBroadcastFifoReader*>::iterator it = m_readers.begin(); it != m_readers.end(); ++it) {
+        delete *it;
+    }
+}
+
+SampleSinkBroadcastFifoReader *SampleSinkBroadcastFifo::addReader(SampleSinkBroadcastFifoReader::Policy policy)
+{
+    SampleSinkBroadcastFifoReader *reader = new SampleSinkBroadcastFifoReader(this, policy);
+    m_readers.push_back(reader);
+    return reader;
+}
+
+void SampleSinkBroadcastFifo::removeReader(SampleSinkBroadcastFifoReader *reader)
+{
+    std::vector<SampleSinkBroadcastFifoReader*>::iterator it = std::find(m_readers.begin(), m_readers.end(), reader);
+
+    if (it != m_readers.end())
+    {
+        m_readers.erase(it);
+        delete reader;
+    }
+}
+
+void SampleSinkBroadcastFifo::reset()
+{
+    quint32 tail = m_tail.load();
+
+    for (std::vector<SampleSinkBroadcastFifoReader*>::iterator it = m_readers.begin(); it != m_readers.end(); ++it)
+    {
+        SpinlockHolder spinlockHolder(&(*it)->m_lock);
+        (*it)->m_head.storeRelease(tail);
+        (*it)->m_busy = false;
+        (*it)->m_dropping = false;
+    }
+}
+
+uint SampleSinkBroadcastFifo::writable() const
+{
+    quint32 tail = m_tail.load(); // only the writer thread calls this
+    uint room = m_size;
+
+    for (std::vector<SampleSinkBroadcastFifoReader*>::const_iterator it = m_readers.begin(); it != m_readers.end(); ++it)
+    {
+        if ((*it)->getPolicy() == SampleSinkBroadcastFifoReader::PolicyBackPressure) {
+            room = std::min(room, m_size - (tail - (*it)->m_head.loadAcquire()));
+        }
+    }
+
+    return room;
+}
+
+uint SampleSinkBroadcastFifo::write(SampleVector::const_iterator begin, SampleVector::const_iterator end)
+{
+    uint count = end - begin;
+
+    if ((count == 0) || (m_readers.size() == 0)) {
+        return count;
+    }
+
+    quint32 tail = m_tail.load(); // only this thread moves the tail
+    uint maxLag = 0;
+
+    for (std::vector<SampleSinkBroadcastFifoReader*>::iterator it = m_readers.begin(); it != m_readers.end(); ++it)
+    {
+        SampleSinkBroadcastFifoReader *reader = *it;
+        SpinlockHolder spinlockHolder(&reader->m_lock);
+        quint32 head = reader->m_head.load();
+        uint lag = tail - head;
+
+        if (reader->getPolicy() == SampleSinkBroadcastFifoReader::PolicyDrop)
+        {
+            // a dropping reader never holds the writer back: skip it ahead if it is idle
+            // else the block it reads is overwritten and readCommit() accounts for it
+            if (!reader->m_busy && (lag + count > m_size))
+            {
+                uint skip = std::min(lag + count - m_size, lag);
+                reader->m_head.storeRelease(head + skip);
+                reader->m_droppedSamples.fetchAndAddRelaxed(skip);
+            }
+
+            continue;
+        }
+
+        maxLag = std::max(maxLag, lag);
+    }
+
+    uint total = std::min(count, m_size - maxLag);
+
+    if (total < count)
+    {
+        m_overflowCount++;
+        m_overflowSamples += count - total;
+    }
+
+    uint index = tail & m_mask;
+    uint len = std::min(total, m_size - index);
+    std::copy(begin, begin + len, m_data.begin() + index);
+    std::copy(begin + len, begin + total, m_data.begin());
+    m_tail.storeRelease(tail + total);
+
+    if (total > 0)
+    {
+        for (std::vector<SampleSinkBroadcastFifoReader*>::iterator it = m_readers.begin(); it != m_readers.end(); ++it)
+        {
+            if ((*it)->m_notified.testAndSetOrdered(0, 1)) {
+                emit (*it)->dataReady();
+            }
+        }
+    }
+
+    return total;
+}
@@ -0,0 +1,120 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SDRBASE_DSP_SAMPLESINKBROADCASTFIFO_H_
+#define SDRBASE_DSP_SAMPLESINKBROADCASTFIFO_H_
+
+#include <vector>
+
+#include <QObject>
+#include <QAtomicInteger>
+
+#include "dsp/dsptypes.h"
+#include "util/spinlock.h"
+#include "export.h"
+
+class SampleSinkBroadcastFifo;
+
+/**
+ * Read cursor on a SampleSinkBroadcastFifo. Each reader is used by a single consumer thread.
+ * Blocks are read in place and there must be exactly one readCommit() per readBegin().
+ *
+ * A block of a back pressure reader stays valid until readCommit() is called. The writer does
+ * not wait for a dropping reader: a slow consumer does not pin the ring so the writer may
+ * overwrite the block it is still processing. readCommit() detects this from the write index
+ * and counts the overwritten samples as dropped. A dropping reader is never more than half the
+ * ring behind at readBegin() so this only happens if it holds a block for that long.
+ */
+class SDRBASE_API SampleSinkBroadcastFifoReader : public QObject {
+    Q_OBJECT
+
+public:
+    enum Policy
+    {
+        PolicyDrop,         //!< when this reader lags too much it skips samples (other readers are not affected)
+        PolicyBackPressure  //!< the writer never overwrites unread samples of this reader (see SampleSinkBroadcastFifo::writable())
+    };
+
+    uint fill() const;
+    uint readBegin(uint count,
+        SampleVector::iterator* part1Begin, SampleVector::iterator* part1End,
+        SampleVector::iterator* part2Begin, SampleVector::iterator* part2End);
+    uint readCommit(uint count);
+    uint skip(uint count); //!< discard up to count unread samples without reading them
+
+    void setPolicy(Policy policy) { m_policy.storeRelease((int) policy); }
+    Policy getPolicy() const { return (Policy) m_policy.loadAcquire(); }
+    quint64 getDroppedSamples() const { return m_droppedSamples.load(); }
+
+signals:
+    void dataReady();
+
+private:
+    friend class SampleSinkBroadcastFifo;
+
+    SampleSinkBroadcastFifoReader(SampleSinkBroadcastFifo *fifo, Policy policy);
+    ~SampleSinkBroadcastFifoReader();
+
+    SampleSinkBroadcastFifo *m_fifo;
+    Spinlock m_lock;                  //!< protects head moves by the writer against a block in use
+    bool m_busy;                      //!< a block is being read: the writer does not move the head
+    bool m_dropping;                  //!< the current block was taken with the drop policy
+    quint32 m_blockBegin;             //!< index of the first sample of the current block
+    QAtomicInteger<quint32> m_head;   //!< free running read index
+    QAtomicInteger<quint32> m_notified;
+    QAtomicInt m_policy;
+    QAtomicInteger<quint64> m_droppedSamples;
+};
+
+/**
+ * Single producer / multiple consumers ring buffer of samples. The producer writes each block
+ * once and every consumer reads it through its own SampleSinkBroadcastFifoReader cursor.
+ * This replaces one FIFO per consumer and takes the copies off the producer thread.
+ *
+ * Readers are added and removed from the producer thread.
+ */
+class SDRBASE_API SampleSinkBroadcastFifo {
+public:
+    SampleSinkBroadcastFifo(uint size);
+    ~SampleSinkBroadcastFifo();
+
+    uint size() const { return m_size; }
+    uint nbReaders() const { return m_readers.size(); }
+
+    SampleSinkBroadcastFifoReader *addReader(SampleSinkBroadcastFifoReader::Policy policy);
+    void removeReader(SampleSinkBroadcastFifoReader *reader);
+    void reset(); //!< discard unread samples of all readers (readers must be idle)
+
+    uint write(SampleVector::const_iterator begin, SampleVector::const_iterator end);
+    uint writable() const; //!< samples that can be written without dropping for a back pressure reader
+
+    quint32 getOverflowCount() const { return m_overflowCount; }
+    quint64 getOverflowSamples() const { return m_overflowSamples; }
+
+private:
+    friend class SampleSinkBroadcastFifoReader;
+
+    SampleVector m_data;
+    uint m_size;
+    uint m_mask;
+    QAtomicInteger<quint32> m_tail;   //!< free running write index
+    std::vector<SampleSinkBroadcastFifoReader*> m_readers;
+    quint32 m_overflowCount;
+    quint64 m_overflowSamples;
+};
+
+#endif /* SDRBASE_DSP_SAMPLESINKBROADCASTFIFO_H_ */
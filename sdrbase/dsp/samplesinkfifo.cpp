@@ -15,48 +15,71 @@
 // along with this program. If not, see <http://www.gnu.org/licenses/>.          //
 ///////////////////////////////////////////////////////////////////////////////////
 
-#include "samplesinkfifo.h"
+#include <algorithm>
 
-#define MIN(x, y) (((x) < (y)) ? (x) : (y))
+#include "samplesinkfifo.h"
 
 void SampleSinkFifo::create(uint s)
 {
+	uint size = 1;
+
+	while (size < s) {
+		size <<= 1;
+	}
+
 	m_size = 0;
-	m_fill = 0;
-	m_head = 0;
-	m_tail = 0;
+	m_mask = 0;
+	m_head.storeRelease(0);
+	m_tail.storeRelease(0);
+	m_notified.storeRelease(0);
 
-	m_data.resize(s);
+	m_data.resize(size);
 	m_size = m_data.size();
 
-	if(m_size != s)
+	if (m_size != size)
+	{
 		qCritical("SampleSinkFifo: out of memory");
+		m_size = 0;
+	}
+	else
+	{
+		m_mask = m_size - 1;
+	}
 }
 
 SampleSinkFifo::SampleSinkFifo(QObject* parent) :
 	QObject(parent),
-	m_data()
+	m_data(),
+	m_size(0),
+	m_mask(0),
+	m_wakeupThreshold(1),
+	m_head(0),
+	m_tail(0),
+	m_notified(0),
+	m_overflowCount(0),
+	m_overflowSamples(0),
+	m_underflowCount(0)
 {
-	m_suppressed = -1;
-	m_size = 0;
-	m_fill = 0;
-	m_head = 0;
-	m_tail = 0;
 }
 
 SampleSinkFifo::SampleSinkFifo(int size, QObject* parent) :
 	QObject(parent),
-	m_data()
+	m_data(),
+	m_size(0),
+	m_mask(0),
+	m_wakeupThreshold(1),
+	m_head(0),
+	m_tail(0),
+	m_notified(0),
+	m_overflowCount(0),
+	m_overflowSamples(0),
+	m_underflowCount(0)
 {
-	m_suppressed = -1;
-
 	create(size);
 }
 
 SampleSinkFifo::~SampleSinkFifo()
 {
-	QMutexLocker mutexLocker(&m_mutex);
-
 	m_size = 0;
 }
 
@@ -64,117 +87,88 @@ bool SampleSinkFifo::setSize(int size)
 {
 	create(size);
 
-	return m_data.size() == (uint)size;
+	return m_size >= (uint) size;
 }
 
-uint SampleSinkFifo::write(const quint8* data, uint count)
+void SampleSinkFifo::resetCounters()
 {
-	QMutexLocker mutexLocker(&m_mutex);
-	uint total;
-	uint remaining;
-	uint len;
-	const Sample* begin = (const Sample*)data;
-	count /= sizeof(Sample);
-
-	total = MIN(count, m_size - m_fill);
-	if(total < count) {
-		if(m_suppressed < 0) {
-			m_suppressed = 0;
-			m_msgRateTimer.start();
-			qCritical("SampleSinkFifo: overflow - dropping %u samples", count - total);
-		} else {
-			if(m_msgRateTimer.elapsed() > 2500) {
-				qCritical("SampleSinkFifo: %u messages dropped", m_suppressed);
-				qCritical("SampleSinkFifo: overflow - dropping %u samples", count - total);
-				m_suppressed = -1;
-			} else {
-				m_suppressed++;
-			}
-		}
+	m_overflowCount.storeRelease(0);
+	m_overflowSamples.storeRelease(0);
+	m_underflowCount.storeRelease(0);
+}
+
+uint SampleSinkFifo::writeSamples(const Sample* begin, uint count)
+{
+	if (m_size == 0) {
+		return 0;
 	}
 
-	remaining = total;
-	while(remaining > 0) {
-		len = MIN(remaining, m_size - m_tail);
-		std::copy(begin, begin + len, m_data.begin() + m_tail);
-		m_tail += len;
-		m_tail %= m_size;
-		m_fill += len;
-		begin += len;
-		remaining -= len;
+	quint32 tail = m_tail.loadAcquire(); // only this thread moves the tail
+	quint32 head = m_head.loadAcquire();
+	uint total = std::min(count, m_size - (tail - head));
+
+	if (total < count)
+	{
+		m_overflowCount.fetchAndAddRelaxed(1);
+		m_overflowSamples.fetchAndAddRelaxed(count - total);
 	}
 
-	if(m_fill > 0)
+	uint index = tail & m_mask;
+	uint len = std::min(total, m_size - index);
+	std::copy(begin, begin + len, m_data.begin() + index);
+	std::copy(begin + len, begin + total, m_data.begin());
+	m_tail.storeRelease(tail + total);
+
+	// notify only if the consumer has no pending notification already
+	if ((total > 0) && (tail + total - m_head.loadAcquire() >= m_wakeupThreshold) && m_notified.testAndSetOrdered(0, 1)) {
 		emit dataReady();
+	}
 
 	return total;
 }
 
-uint SampleSinkFifo::write(SampleVector::const_iterator begin, SampleVector::const_iterator end)
+void SampleSinkFifo::flush()
 {
-	QMutexLocker mutexLocker(&m_mutex);
-	uint count = end - begin;
-	uint total;
-	uint remaining;
-	uint len;
-
-	total = MIN(count, m_size - m_fill);
-	if(total < count) {
-		if(m_suppressed < 0) {
-			m_suppressed = 0;
-			m_msgRateTimer.start();
-			qCritical("SampleSinkFifo: overflow - dropping %u samples", count - total);
-		} else {
-			if(m_msgRateTimer.elapsed() > 2500) {
-				qCritical("SampleSinkFifo: %u messages dropped", m_suppressed);
-				qCritical("SampleSinkFifo: overflow - dropping %u samples", count - total);
-				m_suppressed = -1;
-			} else {
-				m_suppressed++;
-			}
-		}
+	if ((fill() > 0) && m_notified.testAndSetOrdered(0, 1)) {
+		emit dataReady();
 	}
+}
 
-	remaining = total;
-	while(remaining > 0) {
-		len = MIN(remaining, m_size - m_tail);
-		std::copy(begin, begin + len, m_data.begin() + m_tail);
-		m_tail += len;
-		m_tail %= m_size;
-		m_fill += len;
-		begin += len;
-		remaining -= len;
-	}
+uint SampleSinkFifo::write(const quint8* data, uint count)
+{
+	return writeSamples((const Sample*) data, count / sizeof(Sample));
+}
 
-	if(m_fill > 0)
-		emit dataReady();
+uint SampleSinkFifo::write(SampleVector::const_iterator begin, SampleVector::const_iterator end)
+{
+	if (end <= begin) {
+		return 0;
+	}
 
-	return total;
+	return writeSamples(&(*begin), end - begin);
 }
 
 uint SampleSinkFifo::read(SampleVector::iterator begin, SampleVector::iterator end)
 {
-	QMutexLocker mutexLocker(&m_mutex);
+	if (m_size == 0) {
+		return 0;
+	}
+
+	m_notified.fetchAndStoreOrdered(0);
 	uint count = end - begin;
-	uint total;
-	uint remaining;
-	uint len;
-
-	total = MIN(count, m_fill);
-	if(total < count)
-		qCritical("SampleSinkFifo: underflow - missing %u samples", count - total);
-
-	remaining = total;
-	while(remaining > 0) {
-		len = MIN(remaining, m_size - m_head);
-		std::copy(m_data.begin() + m_head, m_data.begin() + m_head + len, begin);
-		m_head += len;
-		m_head %= m_size;
-		m_fill -= len;
-		begin += len;
-		remaining -= len;
+	quint32 head = m_head.loadAcquire(); // only this thread moves the head
+	uint total = std::min(count, (uint) (m_tail.loadAcquire() - head));
+
+	if (total < count) {
+		m_underflowCount.fetchAndAddRelaxed(1);
 	}
 
+	uint index = head & m_mask;
+	uint len = std::min(total, m_size - index);
+	std::copy(m_data.begin() + index, m_data.begin() + index + len, begin);
+	std::copy(m_data.begin(), m_data.begin() + (total - len), begin + len);
+	m_head.storeRelease(head + total);
+
 	return total;
 }
 
@@ -182,35 +176,35 @@ uint SampleSinkFifo::readBegin(uint count,
 	SampleVector::iterator* part1Begin, SampleVector::iterator* part1End,
 	SampleVector::iterator* part2Begin, SampleVector::iterator* part2End)
 {
-	QMutexLocker mutexLocker(&m_mutex);
-	uint total;
-	uint remaining;
-	uint len;
-	uint head = m_head;
-
-	total = MIN(count, m_fill);
-	if(total < count)
-		qCritical("SampleSinkFifo: underflow - missing %u samples", count - total);
-
-	remaining = total;
-	if(remaining > 0) {
-		len = MIN(remaining, m_size - head);
-		*part1Begin = m_data.begin() + head;
-		*part1End = m_data.begin() + head + len;
-		head += len;
-		head %= m_size;
-		remaining -= len;
-	} else {
-		*part1Begin = m_data.end();
-		*part1End = m_data.end();
+	*part1Begin = m_data.end();
+	*part1End = m_data.end();
+	*part2Begin = m_data.end();
+	*part2End = m_data.end();
+
+	if (m_size == 0) {
+		return 0;
+	}
+
+	m_notified.fetchAndStoreOrdered(0);
+	quint32 head = m_head.loadAcquire();
+	uint total = std::min(count, (uint) (m_tail.loadAcquire() - head));
+
+	if (total < count) {
+		m_underflowCount.fetchAndAddRelaxed(1);
 	}
-	if(remaining > 0) {
-		len = MIN(remaining, m_size - head);
-		*part2Begin = m_data.begin() + head;
-		*part2End = m_data.begin() + head + len;
-	} else {
-		*part2Begin = m_data.end();
-		*part2End = m_data.end();
+
+	if (total > 0)
+	{
+		uint index = head & m_mask;
+		uint len = std::min(total, m_size - index);
+		*part1Begin = m_data.begin() + index;
+		*part1End = m_data.begin() + index + len;
+
+		if (len < total)
+		{
+			*part2Begin = m_data.begin();
+			*part2End = m_data.begin() + (total - len);
+		}
 	}
 
 	return total;
@@ -218,14 +212,16 @@ uint SampleSinkFifo::readBegin(uint count,
 
 uint SampleSinkFifo::readCommit(uint count)
 {
-	QMutexLocker mutexLocker(&m_mutex);
+	quint32 head = m_head.loadAcquire();
+	uint fill = m_tail.loadAcquire() - head;
 
-	if(count > m_fill) {
+	if (count > fill)
+	{
 		qCritical("SampleSinkFifo: cannot commit more than available samples");
-		count = m_fill;
+		count = fill;
 	}
-	m_head = (m_head + count) % m_size;
-	m_fill -= count;
+
+	m_head.storeRelease(head + count);
 
 	return count;
 }
@@ -19,27 +19,51 @@
 #define INCLUDE_SAMPLEFIFO_H
 
 #include <QObject>
-#include <QMutex>
-#include <QTime>
+#include <QAtomicInteger>
 #include "dsp/dsptypes.h"
 #include "export.h"
 
+/**
+ * Wait free single producer / single consumer ring buffer of samples.
+ *
+ * The write methods must only be called from one (producer) thread and the read methods
+ * from another (consumer) thread. Capacity is rounded up to the next power of two so that
+ * head and tail are free running counters masked on access. Head and tail live on separate
+ * cache lines so producer and consumer do not invalidate each other on every update.
+ *
+ * The dataReady() signal is emitted only when the fill reaches the wakeup threshold and
+ * no previous notification is still pending on the consumer side. This batches wakeups
+ * when the consumer thread is busy instead of queuing one event per written block.
+ * The threshold is one sample by default so that any write is signalled. A producer that
+ * raises it must call flush() when it pauses so that a partial batch is not left behind.
+ *
+ * The FIFO must not be resized with setSize() while the producer or the consumer use it.
+ */
 class SDRBASE_API SampleSinkFifo : public QObject {
 	Q_OBJECT
 
 private:
-	QMutex m_mutex;
-	QTime m_msgRateTimer;
-	int m_suppressed;
+	static const int m_cacheLineSize = 64;
 
 	SampleVector m_data;
-
 	uint m_size;
-	uint m_fill;
-	uint m_head;
-	uint m_tail;
+	uint m_mask;
+	uint m_wakeupThreshold;
+
+	char m_pad0[m_cacheLineSize];
+	QAtomicInteger<quint32> m_head; //!< read index (consumer owned)
+	char m_pad1[m_cacheLineSize - sizeof(QAtomicInteger<quint32>)];
+	QAtomicInteger<quint32> m_tail; //!< write index (producer owned)
+	char m_pad2[m_cacheLineSize - sizeof(QAtomicInteger<quint32>)];
+	QAtomicInteger<quint32> m_notified; //!< a dataReady() signal is pending
+	char m_pad3[m_cacheLineSize - sizeof(QAtomicInteger<quint32>)];
+
+	QAtomicInteger<quint32> m_overflowCount;    //!< number of writes that had to drop samples
+	QAtomicInteger<quint64> m_overflowSamples;  //!< total number of dropped samples
+	QAtomicInteger<quint32> m_underflowCount;   //!< number of reads that got less than requested
 
 	void create(uint s);
+	uint writeSamples(const Sample* begin, uint count);
 
 public:
 	SampleSinkFifo(QObject* parent = NULL);
@@ -48,7 +72,16 @@ public:
 
 	bool setSize(int size);
 	inline uint size() const { return m_size; }
-	inline uint fill() { QMutexLocker mutexLocker(&m_mutex); uint fill = m_fill; return fill; }
+	inline uint fill() const { return m_tail.loadAcquire() - m_head.loadAcquire(); }
+
+	void setWakeupThreshold(uint threshold) { m_wakeupThreshold = threshold < 1 ? 1 : threshold; } //!< set before the producer starts
+	uint getWakeupThreshold() const { return m_wakeupThreshold; }
+	void flush(); //!< producer side: signal samples below the wakeup threshold
+
+	quint32 getOverflowCount() const { return m_overflowCount.load(); }
+	quint64 getOverflowSamples() const { return m_overflowSamples.load(); }
+	quint32 getUnderflowCount() const { return m_underflowCount.load(); }
+	void resetCounters();
 
 	uint write(const quint8* data, uint count);
 	uint write(SampleVector::const_iterator begin, SampleVector::const_iterator end);
@@ -91,3 +91,16 @@ void SampleSourceFifo::bumpIndex(SampleVector::iterator& writeAt)
 
     writeAt = m_data.begin() + m_iw;
 }
+
+unsigned int SampleSourceFifo::getWriteSpan(SampleVector::iterator& writeAt)
+{
+    writeAt = m_data.begin() + m_iw;
+    return m_size - m_iw;
+}
+
+void SampleSourceFifo::bumpIndex(unsigned int nbSamples)
+{
+    assert(m_iw + nbSamples <= m_size);
+    std::copy(m_data.begin() + m_iw, m_data.begin() + m_iw + nbSamples, m_data.begin() + m_iw + m_size);
+    m_iw = (m_iw + nbSamples) % m_size;
+}
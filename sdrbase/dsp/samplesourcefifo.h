@@ -40,6 +40,8 @@ public:
     void getReadIterator(SampleVector::iterator& readUntil); //!< get iterator past the last sample of a read advance operation (i.e. current read iterator)
     void getWriteIterator(SampleVector::iterator& writeAt);  //!< get iterator to current item for update - write phase 1
     void bumpIndex(SampleVector::iterator& writeAt);         //!< copy current item to second buffer and bump write index - write phase 2
+    unsigned int getWriteSpan(SampleVector::iterator& writeAt); //!< get iterator to current item and the number of items that can be written contiguously - block write phase 1
+    void bumpIndex(unsigned int nbSamples);                  //!< copy the items written to second buffer and bump write index - block write phase 2
 
     void write(const Sample& sample);                        //!< write directly - phase 1 + phase 2
 
@@ -0,0 +1,260 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+
+#include <QFile>
+#include <QDateTime>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QJsonValue>
+#include <QVariant>
+#include <QDebug>
+
+#include "sigmffile.h"
+
+bool SigMFFile::isSigMFFileName(const QString& fileName)
+{
+    return fileName.endsWith(".sigmf-meta") || fileName.endsWith(".sigmf-data");
+}
+
+QString SigMFFile::getMetaFileName(const QString& fileName)
+{
+    if (fileName.endsWith(".sigmf-data")) {
+        return fileName.left(fileName.size() - 11) + ".sigmf-meta";
+    } else {
+        return fileName;
+    }
+}
+
+QString SigMFFile::getDataFileName(const QString& fileName)
+{
+    if (fileName.endsWith(".sigmf-meta")) {
+        return fileName.left(fileName.size() - 11) + ".sigmf-data";
+    } else {
+        return fileName;
+    }
+}
+
+QString SigMFFile::getDataFileNameFromRecordName(const QString& recordName)
+{
+    if (recordName.endsWith(".sdriq")) {
+        return recordName.left(recordName.size() - 6) + ".sigmf-data";
+    } else if (isSigMFFileName(recordName)) {
+        return getDataFileName(recordName);
+    } else {
+        return recordName + ".sigmf-data";
+    }
+}
+
+bool SigMFFile::readMeta(const QString& metaFileName, Meta& meta, QString& errorMessage)
+{
+    QFile metaFile(metaFileName);
+
+    if (!metaFile.open(QIODevice::ReadOnly))
+    {
+        errorMessage = QString("cannot open %1").arg(metaFileName);
+        return false;
+    }
+
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(metaFile.readAll(), &error);
+    metaFile.close();
+
+    if (doc.isNull() || !doc.isObject())
+    {
+        errorMessage = QString("JSON error: %1 at offset %2").arg(error.errorString()).arg(error.offset);
+        return false;
+    }
+
+    QJsonObject global = doc.object().value("global").toObject();
+    QString datatype = global.value("core:datatype").toString();
+
+    if (datatype == "ci16_le")
+    {
+        meta.m_sampleBits = 16;
+    }
+    else if (datatype == "ci32_le")
+    {
+        meta.m_sampleBits = global.value("sdrangel:sample_bits").toInt(32) == 24 ? 24 : 32;
+    }
+    else
+    {
+        errorMessage = QString("unsupported datatype \"%1\". Only ci16_le and ci32_le are supported").arg(datatype);
+        return false;
+    }
+
+    meta.m_sampleRate = (quint32) global.value("core:sample_rate").toDouble(0.0);
+    meta.m_description = global.value("core:description").toString();
+    meta.m_recorder = global.value("core:recorder").toString();
+    meta.m_captures.clear();
+    meta.m_annotations.clear();
+
+    QJsonArray captures = doc.object().value("captures").toArray();
+
+    for (QJsonArray::const_iterator it = captures.begin(); it != captures.end(); ++it)
+    {
+        QJsonObject captureObject = (*it).toObject();
+        Capture capture;
+        capture.m_sampleStart = captureObject.value("core:sample_start").toVariant().toULongLong();
+        capture.m_frequency = (quint64) captureObject.value("core:frequency").toDouble(0.0);
+        capture.m_sampleRate = (quint32) captureObject.value("sdrangel:sample_rate").toDouble(meta.m_sampleRate);
+        capture.m_timeStampUs = parseDateTime(captureObject.value("core:datetime").toString());
+        meta.m_captures.push_back(capture);
+    }
+
+    QJsonArray annotations = doc.object().value("annotations").toArray();
+
+    for (QJsonArray::const_iterator it = annotations.begin(); it != annotations.end(); ++it)
+    {
+        QJsonObject annotationObject = (*it).toObject();
+        Annotation annotation;
+        annotation.m_sampleStart = annotationObject.value("core:sample_start").toVariant().toULongLong();
+        annotation.m_sampleCount = annotationObject.value("core:sample_count").toVariant().toULongLong();
+        annotation.m_freqLowerEdge = (qint64) annotationObject.value("core:freq_lower_edge").toDouble(0.0);
+        annotation.m_freqUpperEdge = (qint64) annotationObject.value("core:freq_upper_edge").toDouble(0.0);
+        annotation.m_label = annotationObject.value("core:label").toString();
+        annotation.m_comment = annotationObject.value("core:comment").toString();
+        meta.m_annotations.push_back(annotation);
+    }
+
+    return true;
+}
+
+QByteArray SigMFFile::serializeMeta(const Meta& meta)
+{
+    QJsonObject global;
+    global.insert("core:datatype", meta.m_sampleBits > 16 ? "ci32_le" : "ci16_le");
+    global.insert("core:sample_rate", (double) meta.m_sampleRate);
+    global.insert("core:version", "0.0.2");
+
+    if (meta.m_sampleBits == 24) {
+        global.insert("sdrangel:sample_bits", 24);
+    }
+    if (!meta.m_description.isEmpty()) {
+        global.insert("core:description", meta.m_description);
+    }
+    if (!meta.m_recorder.isEmpty()) {
+        global.insert("core:recorder", meta.m_recorder);
+    }
+
+    QJsonObject extension;
+    extension.insert("name", "sdrangel");
+    extension.insert("version", "1.0.0");
+    extension.insert("optional", true);
+    QJsonArray extensions;
+    extensions.append(extension);
+    global.insert("core:extensions", extensions);
+
+    QJsonArray captures;
+
+    for (std::vector<Capture>::const_iterator it = meta.m_captures.begin(); it != meta.m_captures.end(); ++it)
+    {
+        QJsonObject capture;
+        capture.insert("core:sample_start", (qint64) it->m_sampleStart);
+        capture.insert("core:frequency", (double) it->m_frequency);
+
+        if (it->m_timeStampUs != 0) {
+            capture.insert("core:datetime", formatDateTime(it->m_timeStampUs));
+        }
+        if (it->m_sampleRate != meta.m_sampleRate) {
+            capture.insert("sdrangel:sample_rate", (double) it->m_sampleRate);
+        }
+
+        captures.append(capture);
+    }
+
+    QJsonArray annotations;
+
+    for (std::vector<Annotation>::const_iterator it = meta.m_annotations.begin(); it != meta.m_annotations.end(); ++it)
+    {
+        QJsonObject annotation;
+        annotation.insert("core:sample_start", (qint64) it->m_sampleStart);
+        annotation.insert("core:sample_count", (qint64) it->m_sampleCount);
+
+        if (it->m_freqLowerEdge != it->m_freqUpperEdge)
+        {
+            annotation.insert("core:freq_lower_edge", (double) it->m_freqLowerEdge);
+            annotation.insert("core:freq_upper_edge", (double) it->m_freqUpperEdge);
+        }
+        if (!it->m_label.isEmpty()) {
+            annotation.insert("core:label", it->m_label);
+        }
+        if (!it->m_comment.isEmpty()) {
+            annotation.insert("core:comment", it->m_comment);
+        }
+
+        annotations.append(annotation);
+    }
+
+    QJsonObject root;
+    root.insert("global", global);
+    root.insert("captures", captures);
+    root.insert("annotations", annotations);
+
+    return QJsonDocument(root).toJson(QJsonDocument::Indented);
+}
+
+bool SigMFFile::writeMeta(const QString& metaFileName, const Meta& meta)
+{
+    QFile metaFile(metaFileName);
+
+    if (!metaFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        qCritical("SigMFFile::writeMeta: cannot open %s", qPrintable(metaFileName));
+        return false;
+    }
+
+    QByteArray json = serializeMeta(meta);
+    bool ok = metaFile.write(json) == json.size();
+    metaFile.close();
+    return ok;
+}
+
+QString SigMFFile::formatDateTime(quint64 timeStampUs)
+{
+    QDateTime dateTime = QDateTime::fromMSecsSinceEpoch(timeStampUs / 1000, Qt::UTC);
+    return dateTime.toString("yyyy-MM-ddTHH:mm:ss.") + QString("%1Z").arg(timeStampUs % 1000000, 6, 10, QChar('0'));
+}
+
+quint64 SigMFFile::parseDateTime(const QString& dateTime)
+{
+    // ISO 8601 UTC with optional fractional seconds ex: 2018-10-17T08:15:30.123456Z
+    if (dateTime.size() < 19) {
+        return 0;
+    }
+
+    QDateTime seconds = QDateTime::fromString(dateTime.left(19), "yyyy-MM-ddTHH:mm:ss");
+
+    if (!seconds.isValid()) {
+        return 0;
+    }
+
+    seconds.setTimeSpec(Qt::UTC);
+    quint64 timeStampUs = (quint64) seconds.toMSecsSinceEpoch() * 1000;
+
+    if ((dateTime.size() > 20) && (dateTime.at(19) == QChar('.')))
+    {
+        quint64 scale = 100000;
+
+        for (int i = 20; (i < dateTime.size()) && dateTime.at(i).isDigit() && (scale > 0); i++, scale /= 10) {
+            timeStampUs += (dateTime.at(i).digitValue()) * scale;
+        }
+    }
+
+    return timeStampUs;
+}
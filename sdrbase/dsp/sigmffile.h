@@ -0,0 +1,102 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef SDRBASE_DSP_SIGMFFILE_H_
+#define SDRBASE_DSP_SIGMFFILE_H_
+
+#include <vector>
+
+#include <QString>
+#include <QByteArray>
+
+#include "export.h"
+
+/**
+ * SigMF recordings (https://github.com/gnuradio/SigMF) as a pair of files:
+ * name.sigmf-data with the raw samples and name.sigmf-meta with the JSON metadata.
+ * Only the complex integer little endian datatypes used by the sample FIFOs are supported
+ * (ci16_le and ci32_le) so that the data file can be read or written without conversion.
+ * A sample rate change is recorded in the capture segment with the "sdrangel:sample_rate"
+ * extension key since SigMF has a single global sample rate.
+ */
+class SDRBASE_API SigMFFile
+{
+public:
+    struct Capture
+    {
+        quint64 m_sampleStart;
+        quint64 m_frequency;
+        quint32 m_sampleRate;
+        quint64 m_timeStampUs;  //!< Unix epoch in microseconds. 0 if unknown.
+
+        Capture() :
+            m_sampleStart(0),
+            m_frequency(0),
+            m_sampleRate(0),
+            m_timeStampUs(0)
+        {}
+    };
+
+    struct Annotation
+    {
+        quint64 m_sampleStart;
+        quint64 m_sampleCount;
+        qint64 m_freqLowerEdge; //!< 0 if not given
+        qint64 m_freqUpperEdge; //!< 0 if not given
+        QString m_label;
+        QString m_comment;
+
+        Annotation() :
+            m_sampleStart(0),
+            m_sampleCount(0),
+            m_freqLowerEdge(0),
+            m_freqUpperEdge(0)
+        {}
+    };
+
+    struct Meta
+    {
+        quint32 m_sampleBits;   //!< significant bits: 16 for ci16_le, 24 (sdrangel 24 bit build) or 32 for ci32_le
+        quint32 m_sampleRate;   //!< global sample rate
+        QString m_description;
+        QString m_recorder;
+        std::vector<Capture> m_captures;
+        std::vector<Annotation> m_annotations;
+
+        Meta() :
+            m_sampleBits(16),
+            m_sampleRate(0)
+        {}
+    };
+
+    static bool isSigMFFileName(const QString& fileName); //!< true for a .sigmf-meta or .sigmf-data file name
+    static QString getMetaFileName(const QString& fileName);
+    static QString getDataFileName(const QString& fileName);
+    /** Get the name of a recording data file from a record file name ending with .sdriq or not */
+    static QString getDataFileNameFromRecordName(const QString& recordName);
+
+    /** Parse a metadata file. Returns false with an error message if it is not readable or not supported. */
+    static bool readMeta(const QString& metaFileName, Meta& meta, QString& errorMessage);
+    static QByteArray serializeMeta(const Meta& meta);
+    static bool writeMeta(const QString& metaFileName, const Meta& meta);
+
+    static QString formatDateTime(quint64 timeStampUs);
+    static quint64 parseDateTime(const QString& dateTime); //!< returns 0 if invalid
+};
+
+#endif /* SDRBASE_DSP_SIGMFFILE_H_ */
@@ -0,0 +1,340 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <cmath>
+#include <cfloat>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SPKERNELS_X86
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define SPKERNELS_NEON
+#include <arm_neon.h>
+#endif
+
+#include "spectrumpowerkernels.h"
+
+namespace
+{
+
+// log2(m) for m in [sqrt(1/2), sqrt(2)) is 2/ln(2) * atanh(t) with t = (m-1)/(m+1) and |t| < 0.172
+// so that 4 terms of the atanh series give full float precision
+const float log2C1 = 2.885390082f; // 2/ln(2)
+const float log2C3 = 0.961796694f; // 2/(3 ln(2))
+const float log2C5 = 0.577078017f; // 2/(5 ln(2))
+const float log2C7 = 0.412198583f; // 2/(7 ln(2))
+
+void windowSamplesGeneric(const Sample *in, const float *window, Real scale, Complex *out, unsigned int n)
+{
+    for (unsigned int i = 0; i < n; i++)
+    {
+        Real w = window[i] * scale;
+        out[i] = Complex(in[i].real() * w, in[i].imag() * w);
+    }
+}
+
+void magSqGeneric(const Complex *in, Real *out, unsigned int n)
+{
+    for (unsigned int i = 0; i < n; i++) {
+        out[i] = in[i].real() * in[i].real() + in[i].imag() * in[i].imag();
+    }
+}
+
+void powerToDBGeneric(const Real *in, Real *out, unsigned int n, Real mult, Real ofs)
+{
+    for (unsigned int i = 0; i < n; i++) {
+        out[i] = mult * std::log2(in[i]) + ofs;
+    }
+}
+
+#ifdef SPKERNELS_X86
+__attribute__((target("sse4.1")))
+void windowSamplesSSE41(const Sample *in, const float *window, Real scale, Complex *out, unsigned int n)
+{
+    const __m128 s = _mm_set1_ps(scale);
+    float *o = (float *) out;
+    unsigned int i = 0;
+
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128 w = _mm_mul_ps(_mm_loadu_ps(&window[i]), s);
+#if SDR_RX_SAMP_SZ == 24
+        __m128i lo = _mm_loadu_si128((const __m128i*) &in[i]);   // I0 Q0 I1 Q1
+        __m128i hi = _mm_loadu_si128((const __m128i*) &in[i+2]); // I2 Q2 I3 Q3
+#else
+        __m128i v = _mm_loadu_si128((const __m128i*) &in[i]);
+        __m128i lo = _mm_cvtepi16_epi32(v);
+        __m128i hi = _mm_cvtepi16_epi32(_mm_srli_si128(v, 8));
+#endif
+        _mm_storeu_ps(&o[2*i], _mm_mul_ps(_mm_cvtepi32_ps(lo), _mm_unpacklo_ps(w, w)));
+        _mm_storeu_ps(&o[2*i+4], _mm_mul_ps(_mm_cvtepi32_ps(hi), _mm_unpackhi_ps(w, w)));
+    }
+
+    windowSamplesGeneric(in + i, window + i, scale, out + i, n - i);
+}
+
+__attribute__((target("sse4.1")))
+void magSqSSE41(const Complex *in, Real *out, unsigned int n)
+{
+    const float *f = (const float *) in;
+    unsigned int i = 0;
+
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128 a = _mm_loadu_ps(&f[2*i]);
+        __m128 b = _mm_loadu_ps(&f[2*i+4]);
+        _mm_storeu_ps(&out[i], _mm_hadd_ps(_mm_mul_ps(a, a), _mm_mul_ps(b, b)));
+    }
+
+    magSqGeneric(in + i, out + i, n - i);
+}
+
+__attribute__((target("sse4.1")))
+inline __m128 log2SSE41(__m128 x)
+{
+    x = _mm_max_ps(x, _mm_set1_ps(FLT_MIN));
+    __m128i xi = _mm_castps_si128(x);
+    __m128i e = _mm_sub_epi32(_mm_srli_epi32(xi, 23), _mm_set1_epi32(127));
+    __m128 m = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(xi, _mm_set1_epi32(0x007fffff)), _mm_set1_epi32(0x3f800000)));
+    // bring mantissa to [sqrt(1/2), sqrt(2))
+    __m128 big = _mm_cmpgt_ps(m, _mm_set1_ps(1.41421356f));
+    m = _mm_blendv_ps(m, _mm_mul_ps(m, _mm_set1_ps(0.5f)), big);
+    e = _mm_sub_epi32(e, _mm_castps_si128(big)); // mask is -1 where true
+    __m128 t = _mm_div_ps(_mm_sub_ps(m, _mm_set1_ps(1.0f)), _mm_add_ps(m, _mm_set1_ps(1.0f)));
+    __m128 t2 = _mm_mul_ps(t, t);
+    __m128 p = _mm_add_ps(_mm_set1_ps(log2C5), _mm_mul_ps(t2, _mm_set1_ps(log2C7)));
+    p = _mm_add_ps(_mm_set1_ps(log2C3), _mm_mul_ps(t2, p));
+    p = _mm_add_ps(_mm_set1_ps(log2C1), _mm_mul_ps(t2, p));
+    return _mm_add_ps(_mm_cvtepi32_ps(e), _mm_mul_ps(t, p));
+}
+
+__attribute__((target("sse4.1")))
+void powerToDBSSE41(const Real *in, Real *out, unsigned int n, Real mult, Real ofs)
+{
+    const __m128 mv = _mm_set1_ps(mult);
+    const __m128 ov = _mm_set1_ps(ofs);
+    unsigned int i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(&out[i], _mm_add_ps(_mm_mul_ps(log2SSE41(_mm_loadu_ps(&in[i])), mv), ov));
+    }
+
+    powerToDBGeneric(in + i, out + i, n - i, mult, ofs);
+}
+
+__attribute__((target("avx2")))
+void windowSamplesAVX2(const Sample *in, const float *window, Real scale, Complex *out, unsigned int n)
+{
+    const __m256 s = _mm256_set1_ps(scale);
+    float *o = (float *) out;
+    unsigned int i = 0;
+
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256 w = _mm256_mul_ps(_mm256_loadu_ps(&window[i]), s);
+        __m256 wl = _mm256_unpacklo_ps(w, w); // w0 w0 w1 w1 | w4 w4 w5 w5
+        __m256 wh = _mm256_unpackhi_ps(w, w); // w2 w2 w3 w3 | w6 w6 w7 w7
+#if SDR_RX_SAMP_SZ == 24
+        __m256i lo = _mm256_loadu_si256((const __m256i*) &in[i]);
+        __m256i hi = _mm256_loadu_si256((const __m256i*) &in[i+4]);
+#else
+        __m256i lo = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*) &in[i]));
+        __m256i hi = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*) &in[i+4]));
+#endif
+        _mm256_storeu_ps(&o[2*i], _mm256_mul_ps(_mm256_cvtepi32_ps(lo), _mm256_permute2f128_ps(wl, wh, 0x20)));
+        _mm256_storeu_ps(&o[2*i+8], _mm256_mul_ps(_mm256_cvtepi32_ps(hi), _mm256_permute2f128_ps(wl, wh, 0x31)));
+    }
+
+    windowSamplesGeneric(in + i, window + i, scale, out + i, n - i);
+}
+
+__attribute__((target("avx2")))
+void magSqAVX2(const Complex *in, Real *out, unsigned int n)
+{
+    const float *f = (const float *) in;
+    unsigned int i = 0;
+
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256 a = _mm256_loadu_ps(&f[2*i]);
+        __m256 b = _mm256_loadu_ps(&f[2*i+8]);
+        // in lane horizontal add gives bins 0 1 4 5 2 3 6 7
+        __m256 h = _mm256_hadd_ps(_mm256_mul_ps(a, a), _mm256_mul_ps(b, b));
+        h = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(h), _MM_SHUFFLE(3,1,2,0)));
+        _mm256_storeu_ps(&out[i], h);
+    }
+
+    magSqGeneric(in + i, out + i, n - i);
+}
+
+__attribute__((target("avx2")))
+inline __m256 log2AVX2(__m256 x)
+{
+    x = _mm256_max_ps(x, _mm256_set1_ps(FLT_MIN));
+    __m256i xi = _mm256_castps_si256(x);
+    __m256i e = _mm256_sub_epi32(_mm256_srli_epi32(xi, 23), _mm256_set1_epi32(127));
+    __m256 m = _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(xi, _mm256_set1_epi32(0x007fffff)), _mm256_set1_epi32(0x3f800000)));
+    // bring mantissa to [sqrt(1/2), sqrt(2))
+    __m256 big = _mm256_cmp_ps(m, _mm256_set1_ps(1.41421356f), _CMP_GT_OQ);
+    m = _mm256_blendv_ps(m, _mm256_mul_ps(m, _mm256_set1_ps(0.5f)), big);
+    e = _mm256_sub_epi32(e, _mm256_castps_si256(big)); // mask is -1 where true
+    __m256 t = _mm256_div_ps(_mm256_sub_ps(m, _mm256_set1_ps(1.0f)), _mm256_add_ps(m, _mm256_set1_ps(1.0f)));
+    __m256 t2 = _mm256_mul_ps(t, t);
+    __m256 p = _mm256_add_ps(_mm256_set1_ps(log2C5), _mm256_mul_ps(t2, _mm256_set1_ps(log2C7)));
+    p = _mm256_add_ps(_mm256_set1_ps(log2C3), _mm256_mul_ps(t2, p));
+    p = _mm256_add_ps(_mm256_set1_ps(log2C1), _mm256_mul_ps(t2, p));
+    return _mm256_add_ps(_mm256_cvtepi32_ps(e), _mm256_mul_ps(t, p));
+}
+
+__attribute__((target("avx2")))
+void powerToDBAVX2(const Real *in, Real *out, unsigned int n, Real mult, Real ofs)
+{
+    const __m256 mv = _mm256_set1_ps(mult);
+    const __m256 ov = _mm256_set1_ps(ofs);
+    unsigned int i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(&out[i], _mm256_add_ps(_mm256_mul_ps(log2AVX2(_mm256_loadu_ps(&in[i])), mv), ov));
+    }
+
+    powerToDBGeneric(in + i, out + i, n - i, mult, ofs);
+}
+#endif // SPKERNELS_X86
+
+#ifdef SPKERNELS_NEON
+void windowSamplesNEON(const Sample *in, const float *window, Real scale, Complex *out, unsigned int n)
+{
+    float *o = (float *) out;
+    unsigned int i = 0;
+
+    for (; i + 4 <= n; i += 4)
+    {
+        float32x4_t ws = vmulq_n_f32(vld1q_f32(&window[i]), scale);
+        float32x4x2_t w = vzipq_f32(ws, ws); // w0 w0 w1 w1, w2 w2 w3 w3
+#if SDR_RX_SAMP_SZ == 24
+        int32x4_t lo = vld1q_s32((const int32_t *) &in[i]);
+        int32x4_t hi = vld1q_s32((const int32_t *) &in[i+2]);
+#else
+        int16x8_t v = vld1q_s16((const int16_t *) &in[i]);
+        int32x4_t lo = vmovl_s16(vget_low_s16(v));
+        int32x4_t hi = vmovl_s16(vget_high_s16(v));
+#endif
+        vst1q_f32(&o[2*i], vmulq_f32(vcvtq_f32_s32(lo), w.val[0]));
+        vst1q_f32(&o[2*i+4], vmulq_f32(vcvtq_f32_s32(hi), w.val[1]));
+    }
+
+    windowSamplesGeneric(in + i, window + i, scale, out + i, n - i);
+}
+
+void magSqNEON(const Complex *in, Real *out, unsigned int n)
+{
+    const float *f = (const float *) in;
+    unsigned int i = 0;
+
+    for (; i + 4 <= n; i += 4)
+    {
+        float32x4x2_t c = vld2q_f32(&f[2*i]); // deinterleave real and imaginary parts
+        vst1q_f32(&out[i], vmlaq_f32(vmulq_f32(c.val[0], c.val[0]), c.val[1], c.val[1]));
+    }
+
+    magSqGeneric(in + i, out + i, n - i);
+}
+
+inline float32x4_t log2NEON(float32x4_t x)
+{
+    x = vmaxq_f32(x, vdupq_n_f32(FLT_MIN));
+    int32x4_t xi = vreinterpretq_s32_f32(x);
+    int32x4_t e = vsubq_s32(vshrq_n_s32(xi, 23), vdupq_n_s32(127));
+    float32x4_t m = vreinterpretq_f32_s32(vorrq_s32(vandq_s32(xi, vdupq_n_s32(0x007fffff)), vdupq_n_s32(0x3f800000)));
+    // bring mantissa to [sqrt(1/2), sqrt(2))
+    uint32x4_t big = vcgtq_f32(m, vdupq_n_f32(1.41421356f));
+    m = vbslq_f32(big, vmulq_n_f32(m, 0.5f), m);
+    e = vsubq_s32(e, vreinterpretq_s32_u32(big)); // mask is -1 where true
+    float32x4_t den = vaddq_f32(m, vdupq_n_f32(1.0f));
+    float32x4_t r = vrecpeq_f32(den); // reciprocal estimate refined by two Newton-Raphson steps
+    r = vmulq_f32(vrecpsq_f32(den, r), r);
+    r = vmulq_f32(vrecpsq_f32(den, r), r);
+    float32x4_t t = vmulq_f32(vsubq_f32(m, vdupq_n_f32(1.0f)), r);
+    float32x4_t t2 = vmulq_f32(t, t);
+    float32x4_t p = vmlaq_f32(vdupq_n_f32(log2C5), t2, vdupq_n_f32(log2C7));
+    p = vmlaq_f32(vdupq_n_f32(log2C3), t2, p);
+    p = vmlaq_f32(vdupq_n_f32(log2C1), t2, p);
+    return vmlaq_f32(vcvtq_f32_s32(e), t, p);
+}
+
+void powerToDBNEON(const Real *in, Real *out, unsigned int n, Real mult, Real ofs)
+{
+    unsigned int i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        vst1q_f32(&out[i], vmlaq_n_f32(vdupq_n_f32(ofs), log2NEON(vld1q_f32(&in[i])), mult));
+    }
+
+    powerToDBGeneric(in + i, out + i, n - i, mult, ofs);
+}
+#endif // SPKERNELS_NEON
+
+struct Kernels
+{
+    SpectrumPowerKernels::WindowSamples m_windowSamples;
+    SpectrumPowerKernels::MagSq m_magSq;
+    SpectrumPowerKernels::PowerToDB m_powerToDB;
+};
+
+Kernels getKernels(SpectrumPowerKernels::ISA isa)
+{
+    switch (isa)
+    {
+#ifdef SPKERNELS_X86
+    case IntHalfbandFilterKernels::ISASSE41:
+        return Kernels{windowSamplesSSE41, magSqSSE41, powerToDBSSE41};
+    case IntHalfbandFilterKernels::ISAAVX2:
+        return Kernels{windowSamplesAVX2, magSqAVX2, powerToDBAVX2};
+#endif
+#ifdef SPKERNELS_NEON
+    case IntHalfbandFilterKernels::ISANEON:
+        return Kernels{windowSamplesNEON, magSqNEON, powerToDBNEON};
+#endif
+    default:
+        return Kernels{windowSamplesGeneric, magSqGeneric, powerToDBGeneric};
+    }
+}
+
+} // namespace
+
+SpectrumPowerKernels::ISA SpectrumPowerKernels::m_isa = IntHalfbandFilterKernels::getBestISA();
+SpectrumPowerKernels::WindowSamples SpectrumPowerKernels::m_windowSamples = getKernels(SpectrumPowerKernels::m_isa).m_windowSamples;
+SpectrumPowerKernels::MagSq SpectrumPowerKernels::m_magSq = getKernels(SpectrumPowerKernels::m_isa).m_magSq;
+SpectrumPowerKernels::PowerToDB SpectrumPowerKernels::m_powerToDB = getKernels(SpectrumPowerKernels::m_isa).m_powerToDB;
+
+bool SpectrumPowerKernels::setISA(ISA isa)
+{
+    if (!IntHalfbandFilterKernels::isSupported(isa)) {
+        return false;
+    }
+
+    Kernels kernels = getKernels(isa);
+    m_isa = isa;
+    m_windowSamples = kernels.m_windowSamples;
+    m_magSq = kernels.m_magSq;
+    m_powerToDB = kernels.m_powerToDB;
+    return true;
+}
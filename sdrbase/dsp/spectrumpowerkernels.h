@@ -0,0 +1,79 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+
+
+#ifndef SDRBASE_DSP_SPECTRUMPOWERKERNELS_H_
+#define SDRBASE_DSP_SPECTRUMPOWERKERNELS_H_
+
+#include "dsp/dsptypes.h"
+#include "dsp/inthalfbandfilterkernels.h"
+#include "export.h"
+
+/**
+ * Power spectrum building blocks used by the spectrum display: fused window and scaling
+ * of the input samples, magnitude squared of the FFT output and conversion to dB.
+ * Like the half band filter kernels the implementation is selected at run time
+ * from the instruction sets the CPU supports.
+ */
+class SDRBASE_API SpectrumPowerKernels
+{
+public:
+    typedef IntHalfbandFilterKernels::ISA ISA;
+
+    typedef void (*WindowSamples)(const Sample *in, const float *window, Real scale, Complex *out, unsigned int n);
+    typedef void (*MagSq)(const Complex *in, Real *out, unsigned int n);
+    typedef void (*PowerToDB)(const Real *in, Real *out, unsigned int n, Real mult, Real ofs);
+
+    /** out[i] = in[i] * window[i] * scale with the fixed point sample converted to float */
+    static void windowSamples(const Sample *in, const float *window, Real scale, Complex *out, unsigned int n) {
+        m_windowSamples(in, window, scale, out, n);
+    }
+
+    /** out[i] = |in[i]|^2 */
+    static void magSq(const Complex *in, Real *out, unsigned int n) {
+        m_magSq(in, out, n);
+    }
+
+    /**
+     * out[i] = mult * log2(in[i]) + ofs. Vectorized versions use a polynomial log2 accurate
+     * to a few float ulps and clamp null power to the smallest normal float (about -379 dB).
+     * In place operation (in == out) is allowed.
+     */
+    static void powerToDB(const Real *in, Real *out, unsigned int n, Real mult, Real ofs) {
+        m_powerToDB(in, out, n, mult, ofs);
+    }
+
+    /** out[i] = in[i] * factor. In place operation is allowed. */
+    static void scale(const Real *in, Real *out, unsigned int n, Real factor)
+    {
+        for (unsigned int i = 0; i < n; i++) {
+            out[i] = in[i] * factor;
+        }
+    }
+
+    static bool setISA(ISA isa); //!< Force an ISA (benchmarks). Returns false if not supported.
+    static ISA getISA() { return m_isa; }
+
+private:
+    static ISA m_isa;
+    static WindowSamples m_windowSamples;
+    static MagSq m_magSq;
+    static PowerToDB m_powerToDB;
+};
+
+#endif /* SDRBASE_DSP_SPECTRUMPOWERKERNELS_H_ */
@@ -5,66 +5,82 @@
 #include "dsp/dspcommands.h"
 #include "util/message.h"
 
-ThreadedBasebandSampleSinkFifo::ThreadedBasebandSampleSinkFifo(BasebandSampleSink *sampleSink, std::size_t size) :
-	m_sampleSink(sampleSink)
+ThreadedBasebandSampleSinkFifo::ThreadedBasebandSampleSinkFifo(BasebandSampleSink *sampleSink) :
+	m_sampleSink(sampleSink),
+	m_reader(0),
+	m_samplesCount(0),
+	m_maxLag(0),
+	m_skippedSamples(0)
 {
-	connect(&m_sampleFifo, SIGNAL(dataReady()), this, SLOT(handleFifoData()));
-	m_sampleFifo.setSize(size);
 }
 
 ThreadedBasebandSampleSinkFifo::~ThreadedBasebandSampleSinkFifo()
 {
-	m_sampleFifo.readCommit(m_sampleFifo.fill());
 }
 
-void ThreadedBasebandSampleSinkFifo::writeToFifo(SampleVector::const_iterator& begin, SampleVector::const_iterator& end)
+void ThreadedBasebandSampleSinkFifo::setReader(SampleSinkBroadcastFifoReader *reader)
 {
-	m_sampleFifo.write(begin, end);
+	if (m_reader) {
+		disconnect(m_reader, SIGNAL(dataReady()), this, SLOT(handleFifoData()));
+	}
+
+	m_reader = reader;
+
+	if (m_reader) {
+		connect(m_reader, SIGNAL(dataReady()), this, SLOT(handleFifoData()), Qt::QueuedConnection);
+	}
 }
 
 void ThreadedBasebandSampleSinkFifo::handleFifoData() // FIXME: Fixed? Move it to the new threadable sink class
 {
 	bool positiveOnly = false;
 
-	while ((m_sampleFifo.fill() > 0) && (m_sampleSink->getInputMessageQueue()->size() == 0))
+	if (m_reader == 0) {
+		return;
+	}
+
+	while ((m_reader->fill() > 0) && (m_sampleSink->getInputMessageQueue()->size() == 0))
 	{
 		SampleVector::iterator part1begin;
 		SampleVector::iterator part1end;
 		SampleVector::iterator part2begin;
 		SampleVector::iterator part2end;
+		quint32 maxLag = m_maxLag.load();
 
-		std::size_t count = m_sampleFifo.readBegin(m_sampleFifo.fill(), &part1begin, &part1end, &part2begin, &part2end);
+		if ((maxLag > 0) && (m_reader->fill() > maxLag))
+		{
+			// lagging too much: jump to the most recent samples instead of catching up
+			std::size_t skipped = m_reader->skip(m_reader->fill() - maxLag / 4);
+			m_skippedSamples.fetchAndAddRelaxed(skipped);
+			BasebandSampleSink::MsgSamplesSkipped *msg = BasebandSampleSink::MsgSamplesSkipped::create(skipped);
+			m_sampleSink->handleMessage(*msg);
+			delete msg;
+		}
 
-		// first part of FIFO data
+		// the block is read in place in the shared FIFO and released at commit time
+		std::size_t count = m_reader->readBegin(m_reader->fill(), &part1begin, &part1end, &part2begin, &part2end);
 
-		if (count > 0)
+		if (m_sampleSink != NULL)
 		{
-			// handle data
-			if(m_sampleSink != NULL)
-			{
+			// first part of FIFO data
+			if (part1begin != part1end) {
 				m_sampleSink->feed(part1begin, part1end, positiveOnly);
 			}
 
-			m_sampleFifo.readCommit(part1end - part1begin);
-		}
-
-		// second part of FIFO data (used when block wraps around)
-
-		if(part2begin != part2end)
-		{
-			// handle data
-			if(m_sampleSink != NULL)
-			{
+			// second part of FIFO data (used when block wraps around)
+			if (part2begin != part2end) {
 				m_sampleSink->feed(part2begin, part2end, positiveOnly);
 			}
-
-			m_sampleFifo.readCommit(part2end - part2begin);
 		}
+
+		m_reader->readCommit((unsigned int) count);
+		m_samplesCount.fetchAndAddRelaxed(count);
 	}
 }
 
 ThreadedBasebandSampleSink::ThreadedBasebandSampleSink(BasebandSampleSink* sampleSink, QObject *parent) :
-	m_basebandSampleSink(sampleSink)
+	m_basebandSampleSink(sampleSink),
+	m_fifoPolicy(SampleSinkBroadcastFifoReader::PolicyDrop)
 {
 	QString name = "ThreadedBasebandSampleSink(" + m_basebandSampleSink->objectName() + ")";
 	setObjectName(name);
@@ -72,6 +88,7 @@ ThreadedBasebandSampleSink::ThreadedBasebandSampleSink(BasebandSampleSink* sampl
 	qDebug() << "ThreadedBasebandSampleSink::ThreadedBasebandSampleSink: " << name;
 
 	m_thread = new QThread(parent);
+	m_thread->setObjectName(parent ? parent->objectName() : m_basebandSampleSink->objectName()); // system thread name
 	m_threadedBasebandSampleSinkFifo = new ThreadedBasebandSampleSinkFifo(m_basebandSampleSink);
 	//moveToThread(m_thread); // FIXME: Fixed? the intermediate FIFO should be handled within the sink. Define a new type of sink that is compatible with threading
 	m_basebandSampleSink->moveToThread(m_thread);
@@ -111,12 +128,22 @@ void ThreadedBasebandSampleSink::stop()
 	m_thread->wait();
 }
 
-void ThreadedBasebandSampleSink::feed(SampleVector::const_iterator begin, SampleVector::const_iterator end, bool positiveOnly)
+void ThreadedBasebandSampleSink::setFifoReader(SampleSinkBroadcastFifoReader *reader)
+{
+	if (reader) {
+		reader->setPolicy(m_fifoPolicy);
+	}
+
+	m_threadedBasebandSampleSinkFifo->setReader(reader);
+}
+
+void ThreadedBasebandSampleSink::setFifoPolicy(SampleSinkBroadcastFifoReader::Policy policy)
 {
-    (void) positiveOnly;
-	//m_sampleSink->feed(begin, end, positiveOnly);
-	//m_sampleFifo.write(begin, end);
-	m_threadedBasebandSampleSinkFifo->writeToFifo(begin, end);
+	m_fifoPolicy = policy;
+
+	if (m_threadedBasebandSampleSinkFifo->m_reader) {
+		m_threadedBasebandSampleSinkFifo->m_reader->setPolicy(policy);
+	}
 }
 
 bool ThreadedBasebandSampleSink::handleSinkMessage(const Message& cmd)
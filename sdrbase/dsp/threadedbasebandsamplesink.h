@@ -20,8 +20,9 @@
 
 #include <dsp/basebandsamplesink.h>
 #include <QMutex>
+#include <QAtomicInteger>
 
-#include "samplesinkfifo.h"
+#include "samplesinkbroadcastfifo.h"
 #include "util/messagequeue.h"
 #include "export.h"
 
@@ -36,12 +37,15 @@ class SDRBASE_API ThreadedBasebandSampleSinkFifo : public QObject {
 	Q_OBJECT
 
 public:
-	ThreadedBasebandSampleSinkFifo(BasebandSampleSink* sampleSink, std::size_t size = 1<<18);
+	ThreadedBasebandSampleSinkFifo(BasebandSampleSink* sampleSink);
 	~ThreadedBasebandSampleSinkFifo();
-	void writeToFifo(SampleVector::const_iterator& begin, SampleVector::const_iterator& end);
+	void setReader(SampleSinkBroadcastFifoReader *reader); //!< Attach to the device engine broadcast FIFO (null to detach)
 
 	BasebandSampleSink* m_sampleSink;
-	SampleSinkFifo m_sampleFifo;
+	SampleSinkBroadcastFifoReader *m_reader;
+	QAtomicInteger<quint64> m_samplesCount; //!< samples fed to the sink since creation
+	QAtomicInteger<quint32> m_maxLag;       //!< skip ahead when more samples than this are pending (0: never)
+	QAtomicInteger<quint64> m_skippedSamples; //!< samples skipped ahead since creation
 
 public slots:
 	void handleFifoData();
@@ -63,7 +67,14 @@ public:
 	void stop();  //!< this thread exit() and wait()
 
 	bool handleSinkMessage(const Message& cmd); //!< Send message to sink synchronously
-	void feed(SampleVector::const_iterator begin, SampleVector::const_iterator end, bool positiveOnly); //!< Feed sink with samples
+
+	void setFifoReader(SampleSinkBroadcastFifoReader *reader); //!< Set the read cursor on the device engine FIFO (done by the engine)
+	SampleSinkBroadcastFifoReader *getFifoReader() { return m_threadedBasebandSampleSinkFifo->m_reader; }
+	void setFifoPolicy(SampleSinkBroadcastFifoReader::Policy policy); //!< What to do when this sink cannot keep up
+	SampleSinkBroadcastFifoReader::Policy getFifoPolicy() const { return m_fifoPolicy; }
+	quint64 getSamplesCount() const { return m_threadedBasebandSampleSinkFifo->m_samplesCount.load(); } //!< Samples processed by the sink
+	void setMaxLag(quint32 maxLag) { m_threadedBasebandSampleSinkFifo->m_maxLag.store(maxLag); } //!< Skip to recent samples rather than catch up when lagging more (0: never)
+	quint64 getSkippedSamples() const { return m_threadedBasebandSampleSinkFifo->m_skippedSamples.load(); }
 
 	QString getSampleSinkObjectName() const;
     const QThread *getThread() const { return m_thread; }
@@ -73,6 +84,7 @@ protected:
 	QThread *m_thread; //!< The thead object
 	ThreadedBasebandSampleSinkFifo *m_threadedBasebandSampleSinkFifo;
 	BasebandSampleSink* m_basebandSampleSink;
+	SampleSinkBroadcastFifoReader::Policy m_fifoPolicy;
 };
 
 #endif // INCLUDE_THREADEDSAMPLESINK_H
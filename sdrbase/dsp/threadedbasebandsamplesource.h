@@ -44,6 +44,7 @@ public:
 
 	bool handleSourceMessage(const Message& cmd);  //!< Send message to source synchronously
 	void pull(Sample& sample);                     //!< Pull one sample from source
+	void pullBlock(SampleVector::iterator begin, unsigned int nbSamples) { m_basebandSampleSource->pullBlock(begin, nbSamples); } //!< Pull a block of samples from source
 	void pullAudio(int nbSamples) { if (m_basebandSampleSource) m_basebandSampleSource->pullAudio(nbSamples); }
 
     /** direct feeding of sample source FIFO */
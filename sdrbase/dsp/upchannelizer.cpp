@@ -22,6 +22,7 @@
 
 #include <QString>
 #include <QDebug>
+#include <algorithm>
 
 MESSAGE_CLASS_DEFINITION(UpChannelizer::MsgChannelizerNotification, Message)
 
@@ -102,6 +103,56 @@ void UpChannelizer::pull(Sample& sample)
     }
 }
 
+void UpChannelizer::pullBlock(SampleVector::iterator begin, unsigned int nbSamples)
+{
+    if(m_sampleSource == 0) {
+        return;
+    }
+
+    if (m_filterStages.size() == 0) // optimization when no downsampling is done anyway
+    {
+        m_sampleSource->pullBlock(begin, nbSamples);
+    }
+    else
+    {
+        // Each stage produces the samples it is asked for and tells how many it needs from the stage below.
+        // Then stages run block by block from the modulator up to the output.
+        // The last sample produced by a stage is held in m_stageSamples (m_sampleIn for the modulator)
+        // as the per sample path does so that both paths can be mixed.
+        unsigned int chunkBegin = 0;
+
+        while (chunkBegin < nbSamples)
+        {
+            unsigned int count = std::min(nbSamples - chunkBegin, (unsigned int) UPCHANNELIZER_BUFFER_SIZE);
+
+            m_mutex.lock();
+
+            unsigned int nbStages = m_filterStages.size();
+            m_stageCounts[0] = count;
+
+            for (unsigned int i = 0; i < nbStages; i++) {
+                m_stageCounts[i+1] = m_filterStages[i]->nbConsumed(m_stageCounts[i]);
+            }
+
+            // the input of stage i is in m_stageBuffers[(i+1) % 2] and its output in m_stageBuffers[i % 2]
+            m_sampleSource->pullBlock(m_stageBuffers[nbStages % 2].begin(), m_stageCounts[nbStages]);
+
+            for (int i = nbStages - 1; i >= 0; i--)
+            {
+                Sample *held = (i == (int) nbStages - 1) ? &m_sampleIn : &m_stageSamples[i+1];
+                Sample *out = (i == 0) ? &(*(begin + chunkBegin)) : &m_stageBuffers[i % 2][0];
+                m_filterStages[i]->work(held, &m_stageBuffers[(i+1) % 2][0], out, m_stageCounts[i]);
+            }
+
+            m_stageSamples[0] = *(begin + chunkBegin + count - 1);
+
+            m_mutex.unlock();
+
+            chunkBegin += count;
+        }
+    }
+}
+
 void UpChannelizer::start()
 {
     if (m_sampleSource != 0)
@@ -190,6 +241,10 @@ void UpChannelizer::applyConfiguration()
         m_outputSampleRate / -2, m_outputSampleRate / 2,
         m_requestedCenterFrequency - m_requestedInputSampleRate / 2, m_requestedCenterFrequency + m_requestedInputSampleRate / 2);
 
+    m_stageBuffers[0].resize(UPCHANNELIZER_BUFFER_SIZE);
+    m_stageBuffers[1].resize(UPCHANNELIZER_BUFFER_SIZE);
+    m_stageCounts.resize(m_filterStages.size() + 1);
+
     m_mutex.unlock();
 
     m_currentInputSampleRate = m_outputSampleRate / (1 << m_filterStages.size());
@@ -210,7 +265,8 @@ void UpChannelizer::applyConfiguration()
 #ifdef USE_SSE4_1
 UpChannelizer::FilterStage::FilterStage(Mode mode) :
     m_filter(new IntHalfbandFilterEO1<UPCHANNELIZER_HB_FILTER_ORDER>),
-    m_workFunction(0)
+    m_workFunction(0),
+    m_consumeNext(false)
 {
     switch(mode) {
         case ModeCenter:
@@ -229,7 +285,8 @@ UpChannelizer::FilterStage::FilterStage(Mode mode) :
 #else
 UpChannelizer::FilterStage::FilterStage(Mode mode) :
     m_filter(new IntHalfbandFilterDB<qint32, UPCHANNELIZER_HB_FILTER_ORDER>),
-    m_workFunction(0)
+    m_workFunction(0),
+    m_consumeNext(false)
 {
     switch(mode) {
         case ModeCenter:
@@ -30,6 +30,7 @@
 #endif
 
 #define UPCHANNELIZER_HB_FILTER_ORDER 96
+#define UPCHANNELIZER_BUFFER_SIZE (1<<14) //!< scratch buffer size in samples (output is processed by chunks of this size)
 
 class MessageQueue;
 
@@ -71,6 +72,7 @@ public:
     virtual void start();
     virtual void stop();
     virtual void pull(Sample& sample);
+    virtual void pullBlock(SampleVector::iterator begin, unsigned int nbSamples);
     virtual void pullAudio(int nbSamples) { if (m_sampleSource) m_sampleSource->pullAudio(nbSamples); }
 
     virtual bool handleMessage(const Message& cmd);
@@ -91,13 +93,41 @@ protected:
         IntHalfbandFilterDB<qint32, UPCHANNELIZER_HB_FILTER_ORDER>* m_filter;
 #endif
         WorkFunction m_workFunction;
+        bool m_consumeNext; //!< interpolators consume one input sample every other output sample
 
         FilterStage(Mode mode);
         ~FilterStage();
 
         bool work(Sample* sampleIn, Sample *sampleOut)
         {
-            return (m_filter->*m_workFunction)(sampleIn, sampleOut);
+            bool consumed = (m_filter->*m_workFunction)(sampleIn, sampleOut);
+            m_consumeNext = !consumed;
+            return consumed;
+        }
+
+        /** number of input samples consumed to produce the given number of output samples */
+        unsigned int nbConsumed(unsigned int nbOut) const
+        {
+            return (nbOut + (m_consumeNext ? 1 : 0)) / 2;
+        }
+
+        /** Produce nbOut samples. The first consumed sample is *held and the next ones are taken from sampleIn.
+         *  The last input sample is not consumed but moved to *held for the next call. */
+        void work(Sample* held, Sample* sampleIn, Sample *sampleOut, unsigned int nbOut)
+        {
+            unsigned int nbIn = nbConsumed(nbOut);
+            Sample *in = held;
+
+            for (unsigned int i = 0; i < nbOut; i++)
+            {
+                if (work(in, &sampleOut[i])) {
+                    in = sampleIn++;
+                }
+            }
+
+            if (nbIn > 0) {
+                *held = *in;
+            }
         }
     };
     typedef std::vector<FilterStage*> FilterStages;
@@ -110,6 +140,8 @@ protected:
     int m_currentInputSampleRate;
     int m_currentCenterFrequency;
     SampleVector m_sampleBuffer;
+    SampleVector m_stageBuffers[2]; //!< block processing: stages alternately read one and write the other
+    std::vector<unsigned int> m_stageCounts; //!< block processing: number of samples produced by each stage
     Sample m_sampleIn;
     QMutex m_mutex;
 
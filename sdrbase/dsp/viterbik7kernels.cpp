@@ -0,0 +1,363 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define VITERBIK7_X86
+#include <immintrin.h>
+#endif
+
+#include <string.h>
+
+#include "viterbik7kernels.h"
+
+// Branch table index of the expected coded bit (0: first, 1: second polynomial)
+// for the predecessor j + 32*x of the states 2j + b
+#define VITERBIK7_BRANCH(bit, x, b) ((((bit) * 2 + (x)) * 2 + (b)) * 32)
+
+namespace
+{
+
+int parity(int x)
+{
+    int p = 0;
+
+    for (; x; x >>= 1) {
+        p ^= x & 1;
+    }
+
+    return p;
+}
+
+int normalize(int16_t *metrics)
+{
+    int16_t best = metrics[0];
+
+    for (int n = 1; n < ViterbiK7Kernels::nbStates; n++)
+    {
+        if (metrics[n] < best) {
+            best = metrics[n];
+        }
+    }
+
+    for (int n = 0; n < ViterbiK7Kernels::nbStates; n++) {
+        metrics[n] -= best;
+    }
+
+    return best;
+}
+
+int acsGeneric(int16_t *metrics, const int16_t *table, const int16_t *costs, int nbSteps, uint64_t *decisions)
+{
+    int16_t banks[2][ViterbiK7Kernels::nbStates];
+    int16_t *oldMetrics = banks[0];
+    int16_t *newMetrics = banks[1];
+    memcpy(oldMetrics, metrics, sizeof(banks[0]));
+
+    for (int step = 0; step < nbSteps; step++, costs += 4)
+    {
+        uint64_t d = 0;
+
+        for (int j = 0; j < 32; j++)
+        {
+            for (int b = 0; b < 2; b++)
+            {
+                int m0 = oldMetrics[j]
+                    + costs[table[VITERBIK7_BRANCH(0, 0, b) + j] ? 1 : 0]
+                    + costs[table[VITERBIK7_BRANCH(1, 0, b) + j] ? 3 : 2];
+                int m1 = oldMetrics[j + 32]
+                    + costs[table[VITERBIK7_BRANCH(0, 1, b) + j] ? 1 : 0]
+                    + costs[table[VITERBIK7_BRANCH(1, 1, b) + j] ? 3 : 2];
+                int n = 2*j + b;
+
+                if (m1 < m0)
+                {
+                    newMetrics[n] = m1;
+                    d |= 1ULL << n;
+                }
+                else
+                {
+                    newMetrics[n] = m0;
+                }
+            }
+        }
+
+        decisions[step] = d;
+        int16_t *tmp = oldMetrics;
+        oldMetrics = newMetrics;
+        newMetrics = tmp;
+    }
+
+    memcpy(metrics, oldMetrics, sizeof(banks[0]));
+    return normalize(metrics);
+}
+
+#ifdef VITERBIK7_X86
+__attribute__((target("sse2")))
+inline __m128i branchCostSSE2(const int16_t *table, int offset, __m128i c0, __m128i dc)
+{
+    // c0 where the expected bit is 0, c1 = c0 ^ dc where it is 1
+    return _mm_xor_si128(c0, _mm_and_si128(dc, _mm_loadu_si128((const __m128i*) &table[offset])));
+}
+
+__attribute__((target("sse2")))
+int acsSSE2(int16_t *metrics, const int16_t *table, const int16_t *costs, int nbSteps, uint64_t *decisions)
+{
+    alignas(16) int16_t banks[2][ViterbiK7Kernels::nbStates];
+    int16_t *oldMetrics = banks[0];
+    int16_t *newMetrics = banks[1];
+    memcpy(oldMetrics, metrics, sizeof(banks[0]));
+
+    for (int step = 0; step < nbSteps; step++, costs += 4)
+    {
+        const __m128i x0 = _mm_set1_epi16(costs[0]);
+        const __m128i dx = _mm_set1_epi16(costs[0] ^ costs[1]);
+        const __m128i y0 = _mm_set1_epi16(costs[2]);
+        const __m128i dy = _mm_set1_epi16(costs[2] ^ costs[3]);
+        uint64_t d = 0;
+
+        for (int j = 0; j < 32; j += 8)
+        {
+            __m128i a = _mm_load_si128((const __m128i*) &oldMetrics[j]);
+            __m128i c = _mm_load_si128((const __m128i*) &oldMetrics[j + 32]);
+            __m128i m[2], dm[2];
+
+            for (int b = 0; b < 2; b++)
+            {
+                __m128i m0 = _mm_add_epi16(a, _mm_add_epi16(
+                    branchCostSSE2(table, VITERBIK7_BRANCH(0, 0, b) + j, x0, dx),
+                    branchCostSSE2(table, VITERBIK7_BRANCH(1, 0, b) + j, y0, dy)));
+                __m128i m1 = _mm_add_epi16(c, _mm_add_epi16(
+                    branchCostSSE2(table, VITERBIK7_BRANCH(0, 1, b) + j, x0, dx),
+                    branchCostSSE2(table, VITERBIK7_BRANCH(1, 1, b) + j, y0, dy)));
+                dm[b] = _mm_cmpgt_epi16(m0, m1);
+                m[b] = _mm_min_epi16(m0, m1);
+            }
+
+            // states 2j+b are interleaved
+            _mm_store_si128((__m128i*) &newMetrics[2*j], _mm_unpacklo_epi16(m[0], m[1]));
+            _mm_store_si128((__m128i*) &newMetrics[2*j + 8], _mm_unpackhi_epi16(m[0], m[1]));
+            __m128i dd = _mm_packs_epi16(_mm_unpacklo_epi16(dm[0], dm[1]), _mm_unpackhi_epi16(dm[0], dm[1]));
+            d |= ((uint64_t) (uint16_t) _mm_movemask_epi8(dd)) << (2*j);
+        }
+
+        decisions[step] = d;
+        int16_t *tmp = oldMetrics;
+        oldMetrics = newMetrics;
+        newMetrics = tmp;
+    }
+
+    // normalize with the best metric
+    __m128i best = _mm_load_si128((const __m128i*) &oldMetrics[0]);
+
+    for (int n = 8; n < ViterbiK7Kernels::nbStates; n += 8) {
+        best = _mm_min_epi16(best, _mm_load_si128((const __m128i*) &oldMetrics[n]));
+    }
+
+    best = _mm_min_epi16(best, _mm_srli_si128(best, 8));
+    best = _mm_min_epi16(best, _mm_srli_si128(best, 4));
+    best = _mm_min_epi16(best, _mm_srli_si128(best, 2));
+    int16_t bestMetric = (int16_t) _mm_cvtsi128_si32(best);
+    best = _mm_set1_epi16(bestMetric);
+
+    for (int n = 0; n < ViterbiK7Kernels::nbStates; n += 8) {
+        _mm_storeu_si128((__m128i*) &metrics[n], _mm_sub_epi16(_mm_load_si128((const __m128i*) &oldMetrics[n]), best));
+    }
+
+    return bestMetric;
+}
+
+__attribute__((target("avx2")))
+inline __m256i branchCostAVX2(const int16_t *table, int offset, __m256i c0, __m256i dc)
+{
+    return _mm256_xor_si256(c0, _mm256_and_si256(dc, _mm256_loadu_si256((const __m256i*) &table[offset])));
+}
+
+__attribute__((target("avx2")))
+int acsAVX2(int16_t *metrics, const int16_t *table, const int16_t *costs, int nbSteps, uint64_t *decisions)
+{
+    alignas(32) int16_t banks[2][ViterbiK7Kernels::nbStates];
+    int16_t *oldMetrics = banks[0];
+    int16_t *newMetrics = banks[1];
+    memcpy(oldMetrics, metrics, sizeof(banks[0]));
+
+    for (int step = 0; step < nbSteps; step++, costs += 4)
+    {
+        const __m256i x0 = _mm256_set1_epi16(costs[0]);
+        const __m256i dx = _mm256_set1_epi16(costs[0] ^ costs[1]);
+        const __m256i y0 = _mm256_set1_epi16(costs[2]);
+        const __m256i dy = _mm256_set1_epi16(costs[2] ^ costs[3]);
+        uint64_t d = 0;
+
+        for (int j = 0; j < 32; j += 16)
+        {
+            __m256i a = _mm256_load_si256((const __m256i*) &oldMetrics[j]);
+            __m256i c = _mm256_load_si256((const __m256i*) &oldMetrics[j + 32]);
+            __m256i m[2], dm[2];
+
+            for (int b = 0; b < 2; b++)
+            {
+                __m256i m0 = _mm256_add_epi16(a, _mm256_add_epi16(
+                    branchCostAVX2(table, VITERBIK7_BRANCH(0, 0, b) + j, x0, dx),
+                    branchCostAVX2(table, VITERBIK7_BRANCH(1, 0, b) + j, y0, dy)));
+                __m256i m1 = _mm256_add_epi16(c, _mm256_add_epi16(
+                    branchCostAVX2(table, VITERBIK7_BRANCH(0, 1, b) + j, x0, dx),
+                    branchCostAVX2(table, VITERBIK7_BRANCH(1, 1, b) + j, y0, dy)));
+                dm[b] = _mm256_cmpgt_epi16(m0, m1);
+                m[b] = _mm256_min_epi16(m0, m1);
+            }
+
+            // unpack works within 128 bit lanes: put the lanes back in state order
+            __m256i lo = _mm256_unpacklo_epi16(m[0], m[1]);
+            __m256i hi = _mm256_unpackhi_epi16(m[0], m[1]);
+            _mm256_store_si256((__m256i*) &newMetrics[2*j], _mm256_permute2x128_si256(lo, hi, 0x20));
+            _mm256_store_si256((__m256i*) &newMetrics[2*j + 16], _mm256_permute2x128_si256(lo, hi, 0x31));
+            lo = _mm256_unpacklo_epi16(dm[0], dm[1]);
+            hi = _mm256_unpackhi_epi16(dm[0], dm[1]);
+            __m256i dd = _mm256_packs_epi16(_mm256_permute2x128_si256(lo, hi, 0x20), _mm256_permute2x128_si256(lo, hi, 0x31));
+            dd = _mm256_permute4x64_epi64(dd, 0xD8);
+            d |= ((uint64_t) (uint32_t) _mm256_movemask_epi8(dd)) << (2*j);
+        }
+
+        decisions[step] = d;
+        int16_t *tmp = oldMetrics;
+        oldMetrics = newMetrics;
+        newMetrics = tmp;
+    }
+
+    // normalize with the best metric
+    __m256i best = _mm256_min_epi16(
+        _mm256_min_epi16(_mm256_load_si256((const __m256i*) &oldMetrics[0]), _mm256_load_si256((const __m256i*) &oldMetrics[16])),
+        _mm256_min_epi16(_mm256_load_si256((const __m256i*) &oldMetrics[32]), _mm256_load_si256((const __m256i*) &oldMetrics[48])));
+    __m128i best128 = _mm_min_epi16(_mm256_castsi256_si128(best), _mm256_extracti128_si256(best, 1));
+    best128 = _mm_min_epi16(best128, _mm_srli_si128(best128, 8));
+    best128 = _mm_min_epi16(best128, _mm_srli_si128(best128, 4));
+    best128 = _mm_min_epi16(best128, _mm_srli_si128(best128, 2));
+    int16_t bestMetric = (int16_t) _mm_cvtsi128_si32(best128);
+    best = _mm256_set1_epi16(bestMetric);
+
+    for (int n = 0; n < ViterbiK7Kernels::nbStates; n += 16) {
+        _mm256_storeu_si256((__m256i*) &metrics[n], _mm256_sub_epi16(_mm256_load_si256((const __m256i*) &oldMetrics[n]), best));
+    }
+
+    return bestMetric;
+}
+#endif // VITERBIK7_X86
+
+ViterbiK7Kernels::ACS getKernel(ViterbiK7Kernels::ISA isa)
+{
+    switch (isa)
+    {
+#ifdef VITERBIK7_X86
+    case ViterbiK7Kernels::ISASSE2:
+        return acsSSE2;
+    case ViterbiK7Kernels::ISAAVX2:
+        return acsAVX2;
+#endif
+    default:
+        return acsGeneric;
+    }
+}
+
+} // namespace
+
+ViterbiK7Kernels::ISA ViterbiK7Kernels::m_isa = ViterbiK7Kernels::getBestISA();
+ViterbiK7Kernels::ACS ViterbiK7Kernels::m_acs = getKernel(ViterbiK7Kernels::m_isa);
+
+void ViterbiK7Kernels::makeBranchTable(int g1, int g2, int16_t table[branchTableSize])
+{
+    for (int x = 0; x < 2; x++)
+    {
+        for (int b = 0; b < 2; b++)
+        {
+            for (int j = 0; j < 32; j++)
+            {
+                int p = j + 32*x; // predecessor in bit reversed order
+                int state = 0;
+
+                for (int i = 0; i < 6; i++)
+                {
+                    if (p & (1<<i)) {
+                        state |= 1 << (5-i);
+                    }
+                }
+
+                int reg = state | (b << 6);
+                table[VITERBIK7_BRANCH(0, x, b) + j] = parity(reg & g1) ? -1 : 0;
+                table[VITERBIK7_BRANCH(1, x, b) + j] = parity(reg & g2) ? -1 : 0;
+            }
+        }
+    }
+}
+
+bool ViterbiK7Kernels::isSupported(ISA isa)
+{
+#ifdef VITERBIK7_X86
+    __builtin_cpu_init(); // may run from a static initializer before the CPU model is known
+#endif
+
+    switch (isa)
+    {
+    case ISAGeneric:
+        return true;
+#ifdef VITERBIK7_X86
+    case ISASSE2:
+        return __builtin_cpu_supports("sse2");
+    case ISAAVX2:
+        return __builtin_cpu_supports("avx2");
+#endif
+    default:
+        return false;
+    }
+}
+
+ViterbiK7Kernels::ISA ViterbiK7Kernels::getBestISA()
+{
+    if (isSupported(ISAAVX2)) {
+        return ISAAVX2;
+    } else if (isSupported(ISASSE2)) {
+        return ISASSE2;
+    } else {
+        return ISAGeneric;
+    }
+}
+
+bool ViterbiK7Kernels::setISA(ISA isa)
+{
+    if (!isSupported(isa)) {
+        return false;
+    }
+
+    m_isa = isa;
+    m_acs = getKernel(isa);
+    return true;
+}
+
+const char *ViterbiK7Kernels::getISAName(ISA isa)
+{
+    switch (isa)
+    {
+    case ISAGeneric:
+        return "generic";
+    case ISASSE2:
+        return "sse2";
+    case ISAAVX2:
+        return "avx2";
+    default:
+        return "unknown";
+    }
+}
@@ -0,0 +1,82 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef SDRBASE_DSP_VITERBIK7KERNELS_H_
+#define SDRBASE_DSP_VITERBIK7KERNELS_H_
+
+#include <stdint.h>
+#include "export.h"
+
+/**
+ * Add compare select butterflies of the 64 state trellis of a constraint length 7 rate 1/2
+ * convolutional code (DVB-S, CCSDS...). The path metrics are 16 bit so that the SSE2 and
+ * AVX2 implementations process 8 or 16 states at once. The implementation is selected at
+ * run time from the instruction sets the CPU supports.
+ *
+ * States are stored in bit reversed order: state n is followed by states 2n and 2n+1
+ * (modulo 64) and the low bit of a state is the last input bit.
+ */
+class SDRBASE_API ViterbiK7Kernels
+{
+public:
+    enum ISA
+    {
+        ISAGeneric,
+        ISASSE2,
+        ISAAVX2,
+        ISAEnd
+    };
+
+    static const int nbStates = 64;
+    static const int branchTableSize = 256;
+    static const int maxSteps = 32;  //!< steps of one call so that the 16 bit metrics cannot overflow
+    static const int maxCost = 255;  //!< largest bit cost
+
+    /**
+     * Expected coded bits (0 or -1) of all the branches for polynomials g1 and g2
+     * applied to a 7 bit register with the new input bit at bit 6.
+     */
+    static void makeBranchTable(int g1, int g2, int16_t table[branchTableSize]);
+
+    /**
+     * Run nbSteps trellis steps.
+     * - metrics: the 64 path metrics, normalized on return so that the best is 0
+     * - table: output of makeBranchTable
+     * - costs: 4 costs for each step: first bit is 0, first bit is 1, second bit is 0, second bit is 1
+     * - decisions: one word per step. Bit n is set when the survivor of state n comes from state n/2 + 32.
+     * Returns the best path metric before normalization.
+     */
+    typedef int (*ACS)(int16_t *metrics, const int16_t *table, const int16_t *costs, int nbSteps, uint64_t *decisions);
+
+    static int acs(int16_t *metrics, const int16_t *table, const int16_t *costs, int nbSteps, uint64_t *decisions)
+    {
+        return m_acs(metrics, table, costs, nbSteps, decisions);
+    }
+
+    static bool isSupported(ISA isa); //!< ISA is compiled in and supported by this CPU
+    static bool setISA(ISA isa);      //!< Force an ISA (benchmarks). Returns false if not supported.
+    static ISA getISA() { return m_isa; }
+    static ISA getBestISA();
+    static const char *getISAName(ISA isa);
+
+private:
+    static ISA m_isa;
+    static ACS m_acs;
+};
+
+#endif /* SDRBASE_DSP_VITERBIK7KERNELS_H_ */
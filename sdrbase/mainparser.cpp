@@ -29,10 +29,27 @@ MainParser::MainParser() :
     m_serverPortOption(QStringList() << "p" << "api-port",
         "Web API server port.",
         "port",
-        "8091")
+        "8091"),
+    m_benchFileOption(QStringList() << "bench-file",
+        "Run the demodulator throughput benchmark playing this .sdriq file as fast as possible then exit.",
+        "file",
+        ""),
+    m_benchChannelsOption(QStringList() << "bench-channels",
+        "Comma separated list of channel types attached in benchmark mode (ex: NFMDemod,AMDemod).",
+        "channels",
+        "NFMDemod"),
+    m_benchTimeOption(QStringList() << "bench-time",
+        "Benchmark measurement duration in seconds.",
+        "seconds",
+        "10"),
+    m_fftPrewarmOption(QStringList() << "fft-prewarm",
+        "Comma separated list of FFT sizes planned at startup (ex: 1024,4096).",
+        "sizes",
+        "")
 {
     m_serverAddress = "127.0.0.1";
     m_serverPort = 8091;
+    m_benchTime = 10;
 
     m_parser.setApplicationDescription("Software Defined Radio application");
     m_parser.addHelpOption();
@@ -40,6 +57,10 @@ MainParser::MainParser() :
 
     m_parser.addOption(m_serverAddressOption);
     m_parser.addOption(m_serverPortOption);
+    m_parser.addOption(m_benchFileOption);
+    m_parser.addOption(m_benchChannelsOption);
+    m_parser.addOption(m_benchTimeOption);
+    m_parser.addOption(m_fftPrewarmOption);
 }
 
 MainParser::~MainParser()
@@ -79,4 +100,33 @@ void MainParser::parse(const QCoreApplication& app)
     } else {
         qWarning() << "MainParser::parse: server port invalid. Defaulting to " << m_serverPort;
     }
+
+    // benchmark
+
+    m_benchFile = m_parser.value(m_benchFileOption);
+    m_benchChannels = m_parser.value(m_benchChannelsOption).split(',', QString::SkipEmptyParts);
+
+    QString benchTimeStr = m_parser.value(m_benchTimeOption);
+    int benchTime = benchTimeStr.toInt(&ok);
+
+    if (ok && (benchTime > 0)) {
+        m_benchTime = benchTime;
+    } else {
+        qWarning() << "MainParser::parse: benchmark time invalid. Defaulting to " << m_benchTime;
+    }
+
+    // FFT plans
+
+    QStringList fftSizes = m_parser.value(m_fftPrewarmOption).split(',', QString::SkipEmptyParts);
+
+    for (int i = 0; i < fftSizes.size(); i++)
+    {
+        int fftSize = fftSizes[i].toInt(&ok);
+
+        if (ok && (fftSize > 0)) {
+            m_fftPrewarmSizes.push_back(fftSize);
+        } else {
+            qWarning() << "MainParser::parse: invalid FFT size " << fftSizes[i] << " ignored";
+        }
+    }
 }
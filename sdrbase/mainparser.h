@@ -20,6 +20,7 @@
 
 #include <QCommandLineParser>
 #include <stdint.h>
+#include <vector>
 
 #include "export.h"
 
@@ -33,14 +34,26 @@ public:
 
     const QString& getServerAddress() const { return m_serverAddress; }
     uint16_t getServerPort() const { return m_serverPort; }
+    const QString& getBenchFile() const { return m_benchFile; }
+    const QStringList& getBenchChannels() const { return m_benchChannels; }
+    int getBenchTime() const { return m_benchTime; }
+    const std::vector<int>& getFFTPrewarmSizes() const { return m_fftPrewarmSizes; }
 
 private:
     QString  m_serverAddress;
     uint16_t m_serverPort;
+    QString  m_benchFile;      //!< .sdriq file played as fast as possible in benchmark mode (empty if no benchmark)
+    QStringList m_benchChannels; //!< channel ids attached in benchmark mode
+    int      m_benchTime;      //!< benchmark measurement duration in seconds
+    std::vector<int> m_fftPrewarmSizes; //!< FFT sizes planned at startup
 
     QCommandLineParser m_parser;
     QCommandLineOption m_serverAddressOption;
     QCommandLineOption m_serverPortOption;
+    QCommandLineOption m_benchFileOption;
+    QCommandLineOption m_benchChannelsOption;
+    QCommandLineOption m_benchTimeOption;
+    QCommandLineOption m_fftPrewarmOption;
 };
 
 
@@ -4,7 +4,7 @@
 #
 #--------------------------------------------------------
 
-QT += core multimedia
+QT += core multimedia network
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
 TEMPLATE = lib
@@ -61,6 +61,7 @@ SOURCES += audio/audiodevicemanager.cpp\
         audio/audionetsink.cpp\
         channel/channelsinkapi.cpp\
         channel/channelsourceapi.cpp\
+        channel/sdrdaemoncodec.cpp\
         channel/sdrdaemondataqueue.cpp\
         channel/sdrdaemondatareadqueue.cpp\
         commands/command.cpp\
@@ -68,6 +69,7 @@ SOURCES += audio/audiodevicemanager.cpp\
         device/devicesinkapi.cpp\
         device/deviceenumerator.cpp\
         dsp/afsquelch.cpp\
+        dsp/channelizerbank.cpp\
         dsp/agc.cpp\
         dsp/downchannelizer.cpp\
         dsp/upchannelizer.cpp\
@@ -91,6 +93,7 @@ SOURCES += audio/audiodevicemanager.cpp\
         dsp/freqlockcomplex.cpp\
         dsp/interpolator.cpp\
         dsp/hbfiltertraits.cpp\
+        dsp/inthalfbandfilterkernels.cpp\
         dsp/lowpass.cpp\
         dsp/nco.cpp\
         dsp/ncof.cpp\
@@ -99,8 +102,13 @@ SOURCES += audio/audiodevicemanager.cpp\
         dsp/projector.cpp\
         dsp/recursivefilters.cpp\
         dsp/samplesinkfifo.cpp\
+        dsp/samplesinkbroadcastfifo.cpp\
         dsp/samplesourcefifo.cpp\
+        dsp/samplemixerkernels.cpp\
         dsp/samplesinkfifodoublebuffered.cpp\
+        dsp/sigmffile.cpp\
+        dsp/spectrumpowerkernels.cpp\
+        dsp/viterbik7kernels.cpp\
         dsp/basebandsamplesink.cpp\
         dsp/basebandsamplesource.cpp\
         dsp/nullsink.cpp\
@@ -112,16 +120,20 @@ SOURCES += audio/audiodevicemanager.cpp\
         settings/preferences.cpp\
         settings/preset.cpp\
         settings/mainsettings.cpp\
+        util/asyncfilewriter.cpp\
         util/CRC64.cpp\
         util/db.cpp\
+        util/mappedfile.cpp\
         util/message.cpp\
         util/messagequeue.cpp\
+        util/orderedworkerpool.cpp\
         util/prettyprint.cpp\
         util/rtpsink.cpp\
         util/syncmessenger.cpp\
         util/samplesourceserializer.cpp\
         util/simpleserializer.cpp\
         util/uid.cpp\
+        util/udpbatchsocket.cpp\
         util/timeutil.cpp\
         plugin/plugininterface.cpp\
         plugin/pluginapi.cpp\
@@ -139,6 +151,7 @@ HEADERS  += audio/audiodevicemanager.h\
         audio/audionetsink.h\
         channel/channelsinkapi.h\
         channel/channelsourceapi.h\
+        channel/sdrdaemoncodec.h\
         channel/sdrdaemondataqueue.h\
         channel/sdrdaemondatareadqueue.h\
         channel/sdrdaemondatablock.h\
@@ -147,6 +160,7 @@ HEADERS  += audio/audiodevicemanager.h\
         device/devicesinkapi.h\
         device/deviceenumerator.h\
         dsp/afsquelch.h\
+        dsp/channelizerbank.h\
         dsp/decimatorsfi.h\
         dsp/downchannelizer.h\
         dsp/upchannelizer.h\
@@ -178,6 +192,7 @@ HEADERS  += audio/audiodevicemanager.h\
         dsp/inthalfbandfilterdb.h\
         dsp/inthalfbandfiltereo1.h\
         dsp/inthalfbandfiltereo1i.h\
+        dsp/inthalfbandfilterkernels.h\
         dsp/inthalfbandfilterst.h\
         dsp/inthalfbandfiltersti.h\
         dsp/kissfft.h\
@@ -193,9 +208,14 @@ HEADERS  += audio/audiodevicemanager.h\
         dsp/projector.h\
         dsp/recursivefilters.h\
         dsp/samplesinkfifo.h\
+        dsp/samplesinkbroadcastfifo.h\
         dsp/samplesourcefifo.h\
+        dsp/samplemixerkernels.h\
         dsp/samplesinkfifodoublebuffered.h\
         dsp/samplesinkfifodecimator.h\
+        dsp/sigmffile.h\
+        dsp/spectrumpowerkernels.h\
+        dsp/viterbik7kernels.h\
         dsp/basebandsamplesink.h\
         dsp/basebandsamplesource.h\
         dsp/nullsink.h\
@@ -211,16 +231,20 @@ HEADERS  += audio/audiodevicemanager.h\
         settings/preferences.h\
         settings/preset.h\
         settings/mainsettings.h\
+        util/asyncfilewriter.h\
         util/CRC64.h\
         util/db.h\
+        util/mappedfile.h\
         util/message.h\
         util/messagequeue.h\
+        util/orderedworkerpool.h\
         util/prettyprint.h\
         util/rtpsink.h\
         util/syncmessenger.h\
         util/samplesourceserializer.h\
         util/simpleserializer.h\
         util/uid.h\
+        util/udpbatchsocket.h\
         util/timeutil.h\
         webapi/webapiadapterinterface.h\
         webapi/webapirequestmapper.h\
@@ -1,5 +1,7 @@
 #include <QSettings>
 #include <QStringList>
+#include <QFileInfo>
+#include <QCoreApplication>
 
 #include "settings/mainsettings.h"
 #include "commands/command.h"
@@ -73,6 +75,13 @@ void MainSettings::load()
 	}
 }
 
+QString MainSettings::getFFTWisdomFileName() const
+{
+	// the native format may not be a file (Windows registry) so locate the user config directory with the ini format
+	QSettings s(QSettings::IniFormat, QSettings::UserScope, QCoreApplication::organizationName(), QCoreApplication::applicationName());
+	return QFileInfo(s.fileName()).absolutePath() + "/fftw-wisdom";
+}
+
 void MainSettings::save() const
 {
 	QSettings s;
@@ -16,6 +16,7 @@ public:
 
 	void load();
 	void save() const;
+	QString getFFTWisdomFileName() const; //!< FFT planner wisdom kept next to the settings
 
 	void resetToDefaults();
 
@@ -57,6 +58,22 @@ public:
     bool getUseLogFile() const { return m_preferences.getUseLogFile(); }
     const QString& getLogFileName() const { return m_preferences.getLogFileName(); }
 
+    void setRecordFormat(int format) { m_preferences.setRecordFormat(format); }
+    void setRecordCodec(int codec) { m_preferences.setRecordCodec(codec); }
+    void setRecordCodecBits(int bits) { m_preferences.setRecordCodecBits(bits); }
+    void setRecordRotateMB(int rotateMB) { m_preferences.setRecordRotateMB(rotateMB); }
+    void setRecordRotateMinutes(int rotateMinutes) { m_preferences.setRecordRotateMinutes(rotateMinutes); }
+    void setRecordDirectIO(bool directIO) { m_preferences.setRecordDirectIO(directIO); }
+    int getRecordFormat() const { return m_preferences.getRecordFormat(); }
+    int getRecordCodec() const { return m_preferences.getRecordCodec(); }
+    int getRecordCodecBits() const { return m_preferences.getRecordCodecBits(); }
+    int getRecordRotateMB() const { return m_preferences.getRecordRotateMB(); }
+    int getRecordRotateMinutes() const { return m_preferences.getRecordRotateMinutes(); }
+    bool getRecordDirectIO() const { return m_preferences.getRecordDirectIO(); }
+
+    void setUseChannelizerBank(bool useChannelizerBank) { m_preferences.setUseChannelizerBank(useChannelizerBank); }
+    bool getUseChannelizerBank() const { return m_preferences.getUseChannelizerBank(); }
+
 	const AudioDeviceManager *getAudioDeviceManager() const { return m_audioDeviceManager; }
 	void setAudioDeviceManager(AudioDeviceManager *audioDeviceManager) { m_audioDeviceManager = audioDeviceManager; }
 
@@ -19,6 +19,13 @@ void Preferences::resetToDefaults()
 	m_logFileName = "sdrangel.log";
 	m_consoleMinLogLevel = QtDebugMsg;
     m_fileMinLogLevel = QtDebugMsg;
+	m_recordFormat = 0;
+	m_recordCodec = 0;
+	m_recordCodecBits = 12;
+	m_recordRotateMB = 0;
+	m_recordRotateMinutes = 0;
+	m_recordDirectIO = false;
+	m_useChannelizerBank = false;
 }
 
 QByteArray Preferences::serialize() const
@@ -35,6 +42,13 @@ QByteArray Preferences::serialize() const
 	s.writeBool(9, m_useLogFile);
 	s.writeString(10, m_logFileName);
     s.writeS32(11, (int) m_fileMinLogLevel);
+    s.writeS32(12, m_recordFormat);
+    s.writeS32(13, m_recordCodec);
+    s.writeS32(14, m_recordCodecBits);
+    s.writeS32(15, m_recordRotateMB);
+    s.writeS32(16, m_recordRotateMinutes);
+    s.writeBool(17, m_useChannelizerBank);
+    s.writeBool(18, m_recordDirectIO);
 	return s.final();
 }
 
@@ -86,6 +100,14 @@ bool Preferences::deserialize(const QByteArray& data)
             m_fileMinLogLevel = QtDebugMsg;
         }
 
+        d.readS32(12, &m_recordFormat, 0);
+        d.readS32(13, &m_recordCodec, 0);
+        d.readS32(14, &m_recordCodecBits, 12);
+        d.readS32(15, &m_recordRotateMB, 0);
+        d.readS32(16, &m_recordRotateMinutes, 0);
+        d.readBool(17, &m_useChannelizerBank, false);
+        d.readBool(18, &m_recordDirectIO, false);
+
 		return true;
 	} else
 	{
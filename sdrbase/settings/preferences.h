@@ -39,6 +39,22 @@ public:
 	bool getUseLogFile() const { return m_useLogFile; }
 	const QString& getLogFileName() const { return m_logFileName; }
 
+	void setRecordFormat(int format) { m_recordFormat = format; }
+	void setRecordCodec(int codec) { m_recordCodec = codec; }
+	void setRecordCodecBits(int bits) { m_recordCodecBits = bits; }
+	void setRecordRotateMB(int rotateMB) { m_recordRotateMB = rotateMB; }
+	void setRecordRotateMinutes(int rotateMinutes) { m_recordRotateMinutes = rotateMinutes; }
+	void setRecordDirectIO(bool directIO) { m_recordDirectIO = directIO; }
+	int getRecordFormat() const { return m_recordFormat; }
+	int getRecordCodec() const { return m_recordCodec; }
+	int getRecordCodecBits() const { return m_recordCodecBits; }
+	int getRecordRotateMB() const { return m_recordRotateMB; }
+	int getRecordRotateMinutes() const { return m_recordRotateMinutes; }
+	bool getRecordDirectIO() const { return m_recordDirectIO; }
+
+	void setUseChannelizerBank(bool useChannelizerBank) { m_useChannelizerBank = useChannelizerBank; }
+	bool getUseChannelizerBank() const { return m_useChannelizerBank; }
+
 protected:
 	QString m_sourceType;
 	QString m_sourceDevice;
@@ -54,6 +70,15 @@ protected:
     QtMsgType m_fileMinLogLevel;
 	bool m_useLogFile;
 	QString m_logFileName;
+
+	int m_recordFormat;        //!< 0: legacy .sdriq, 1: chunked .sdriq v2, 2: SigMF
+	int m_recordCodec;         //!< v2 payload codec (SDRDaemonCodec::CodecType)
+	int m_recordCodecBits;     //!< v2 payload codec bits per component
+	int m_recordRotateMB;      //!< v2 rotate file after this size in MB (0: never)
+	int m_recordRotateMinutes; //!< v2 rotate file after this duration in minutes (0: never)
+	bool m_recordDirectIO;     //!< write records bypassing the page cache when possible
+
+	bool m_useChannelizerBank; //!< feed the channels that fit in a filter bank channel by the channelizer bank
 };
 
 #endif // INCLUDE_PREFERENCES_H
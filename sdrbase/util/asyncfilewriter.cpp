@@ -0,0 +1,478 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+
+#include <algorithm>
+#include <cstring>
+
+#include <QDebug>
+#include <QElapsedTimer>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <linux/falloc.h>
+#define ASYNCFILEWRITER_LINUX
+#elif defined(__APPLE__)
+#include <fcntl.h>
+#endif
+
+#include "util/asyncfilewriter.h"
+
+const unsigned int AsyncFileWriter::m_alignment = 4096;
+
+AsyncFileWriter::AsyncFileWriter(unsigned int nbBuffers, unsigned int bufferSize) :
+    m_open(false),
+    m_worker(this),
+    m_bufferSize(((std::max(bufferSize, m_alignment) + m_alignment - 1) / m_alignment) * m_alignment),
+    m_current(-1),
+    m_bytesQueued(0),
+    m_stop(false),
+    m_error(false),
+    m_directIO(false),
+    m_directIORequested(false),
+    m_preallocateStep(0),
+    m_preallocated(0),
+    m_fileBytes(0),
+    m_bytesWritten(0),
+    m_bytesPending(0),
+    m_bytesDropped(0),
+    m_maxWriteLatencyUs(0)
+{
+    nbBuffers = nbBuffers < 2 ? 2 : nbBuffers;
+    m_storage.resize((std::size_t) nbBuffers * m_bufferSize + m_alignment);
+    quintptr base = (quintptr) m_storage.data();
+    base = ((base + m_alignment - 1) / m_alignment) * m_alignment;
+    m_buffers.resize(nbBuffers);
+
+    for (unsigned int i = 0; i < nbBuffers; i++)
+    {
+        m_buffers[i].m_data = (char *) (base + (quintptr) i * m_bufferSize);
+        m_buffers[i].m_fill = 0;
+    }
+}
+
+AsyncFileWriter::~AsyncFileWriter()
+{
+    close();
+}
+
+bool AsyncFileWriter::open(const QString& fileName, bool directIO, qint64 preallocateStep)
+{
+    close();
+    m_file.setFileName(fileName);
+
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered))
+    {
+        qWarning("AsyncFileWriter::open: cannot open %s: %s", qPrintable(fileName), qPrintable(m_file.errorString()));
+        return false;
+    }
+
+    m_free.clear();
+    m_filled.clear();
+    m_nextFileNames.clear();
+    m_sideFiles.clear();
+
+    for (unsigned int i = 0; i < m_buffers.size(); i++) {
+        m_free.push_back(i);
+    }
+
+    m_current = -1;
+    m_bytesQueued = 0;
+    m_stop = false;
+    m_error = false;
+    m_preallocateStep = preallocateStep < 0 ? 0 : ((preallocateStep + m_alignment - 1) / m_alignment) * m_alignment;
+    m_preallocated = 0;
+    m_fileBytes = 0;
+    m_bytesWritten = 0;
+    m_bytesPending = 0;
+    m_bytesDropped = 0;
+    m_avgWriteLatencyUs.reset();
+    m_maxWriteLatencyUs = 0;
+    m_directIORequested = false;
+    setDirectIO(directIO);
+
+    qDebug("AsyncFileWriter::open: %s: %u buffers of %u bytes direct I/O: %s",
+        qPrintable(fileName), (unsigned int) m_buffers.size(), m_bufferSize, m_directIO ? "on" : "off");
+
+    m_open = true;
+    m_worker.start();
+    return true;
+}
+
+void AsyncFileWriter::close()
+{
+    if (!m_open) {
+        return;
+    }
+
+    if ((m_current >= 0) && (m_buffers[m_current].m_fill > 0))
+    {
+        submitCurrent();
+    }
+    else if (m_current >= 0)
+    {
+        QMutexLocker mutexLocker(&m_mutex);
+        m_free.push_back(m_current);
+        m_current = -1;
+    }
+
+    m_mutex.lock();
+    m_stop = true;
+    m_bufferFilled.wakeAll();
+    m_mutex.unlock();
+    m_worker.wait();
+
+    releasePreallocated();
+    m_file.close();
+    m_open = false;
+
+    qDebug("AsyncFileWriter::close: %s: written: %llu dropped: %llu bytes",
+        qPrintable(m_file.fileName()), m_bytesWritten, m_bytesDropped);
+}
+
+void AsyncFileWriter::rotate(const QString& fileName)
+{
+    if (!m_open) {
+        return;
+    }
+
+    if ((m_current >= 0) && (m_buffers[m_current].m_fill > 0)) {
+        submitCurrent();
+    }
+
+    QMutexLocker mutexLocker(&m_mutex);
+    m_nextFileNames.push_back(fileName);
+    m_filled.push_back(-1);
+    m_bufferFilled.wakeOne();
+}
+
+void AsyncFileWriter::writeSideFile(const QString& fileName, const QByteArray& data)
+{
+    if (!m_open) {
+        return;
+    }
+
+    QMutexLocker mutexLocker(&m_mutex);
+
+    for (std::deque<std::pair<QString, QByteArray> >::iterator it = m_sideFiles.begin(); it != m_sideFiles.end(); ++it)
+    {
+        if (it->first == fileName)
+        {
+            it->second = data;
+            return;
+        }
+    }
+
+    m_sideFiles.push_back(std::make_pair(fileName, data));
+    m_filled.push_back(-2);
+    m_bufferFilled.wakeOne();
+}
+
+void AsyncFileWriter::releasePreallocated()
+{
+#ifdef ASYNCFILEWRITER_LINUX
+    if (m_preallocated > m_fileBytes) // give back the space reserved beyond the data
+    {
+        if (ftruncate(m_file.handle(), m_fileBytes) < 0) {
+            qWarning("AsyncFileWriter::releasePreallocated: cannot release preallocated space of %s", qPrintable(m_file.fileName()));
+        }
+    }
+#endif
+}
+
+void AsyncFileWriter::switchFile(const QString& fileName)
+{
+    bool directIO = m_directIO || m_directIORequested;
+    releasePreallocated();
+    m_file.close();
+    m_file.setFileName(fileName);
+    m_preallocated = 0;
+    m_fileBytes = 0;
+
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered))
+    {
+        qWarning("AsyncFileWriter::switchFile: cannot open %s: %s", qPrintable(fileName), qPrintable(m_file.errorString()));
+        QMutexLocker mutexLocker(&m_mutex);
+        m_error = true;
+        return;
+    }
+
+    setDirectIO(directIO);
+    qDebug("AsyncFileWriter::switchFile: %s direct I/O: %s", qPrintable(fileName), m_directIO ? "on" : "off");
+}
+
+void AsyncFileWriter::saveSideFile(const QString& fileName, const QByteArray& data)
+{
+    QFile file(fileName);
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        qWarning("AsyncFileWriter::saveSideFile: cannot open %s: %s", qPrintable(fileName), qPrintable(file.errorString()));
+        return;
+    }
+
+    if (file.write(data) != data.size()) {
+        qWarning("AsyncFileWriter::saveSideFile: cannot write %s: %s", qPrintable(fileName), qPrintable(file.errorString()));
+    }
+
+    file.close();
+}
+
+bool AsyncFileWriter::write(const char *data, qint64 length)
+{
+    if (!m_open) {
+        return false;
+    }
+
+    while (length > 0)
+    {
+        if (m_current < 0)
+        {
+            QMutexLocker mutexLocker(&m_mutex);
+
+            if (m_free.empty() || m_error) // the disk does not keep up: drop rather than wait
+            {
+                m_bytesDropped += length;
+                return false;
+            }
+
+            m_current = m_free.front();
+            m_free.pop_front();
+            m_buffers[m_current].m_fill = 0;
+        }
+
+        Buffer& buffer = m_buffers[m_current];
+        qint64 chunk = std::min(length, (qint64) m_bufferSize - buffer.m_fill);
+        std::memcpy(buffer.m_data + buffer.m_fill, data, chunk);
+        buffer.m_fill += chunk;
+        data += chunk;
+        length -= chunk;
+        m_bytesQueued += chunk;
+
+        if (buffer.m_fill == m_bufferSize) {
+            submitCurrent();
+        }
+    }
+
+    return true;
+}
+
+bool AsyncFileWriter::reserve(qint64 length)
+{
+    if (!m_open) {
+        return false;
+    }
+
+    // the writer thread can only give buffers back meanwhile
+    QMutexLocker mutexLocker(&m_mutex);
+    qint64 room = (qint64) m_free.size() * m_bufferSize + (m_current < 0 ? 0 : m_bufferSize - m_buffers[m_current].m_fill);
+
+    if (m_error || (length > room))
+    {
+        m_bytesDropped += length;
+        return false;
+    }
+
+    return true;
+}
+
+void AsyncFileWriter::submitCurrent()
+{
+    QMutexLocker mutexLocker(&m_mutex);
+    m_filled.push_back(m_current);
+    m_bytesPending += m_buffers[m_current].m_fill;
+    m_current = -1;
+    m_bufferFilled.wakeOne();
+}
+
+quint64 AsyncFileWriter::getBytesWritten() const
+{
+    QMutexLocker mutexLocker(&m_mutex);
+    return m_bytesWritten;
+}
+
+quint64 AsyncFileWriter::getBytesPending() const
+{
+    QMutexLocker mutexLocker(&m_mutex);
+    return m_bytesPending;
+}
+
+quint64 AsyncFileWriter::getBytesDropped() const
+{
+    QMutexLocker mutexLocker(&m_mutex);
+    return m_bytesDropped;
+}
+
+int AsyncFileWriter::getAvgWriteLatencyUs() const
+{
+    QMutexLocker mutexLocker(&m_mutex);
+    return m_avgWriteLatencyUs.instantAverage();
+}
+
+int AsyncFileWriter::getMaxWriteLatencyUs()
+{
+    QMutexLocker mutexLocker(&m_mutex);
+    int maxWriteLatencyUs = m_maxWriteLatencyUs;
+    m_maxWriteLatencyUs = 0;
+    return maxWriteLatencyUs;
+}
+
+void AsyncFileWriter::work()
+{
+    QElapsedTimer timer;
+
+    while (true)
+    {
+        m_mutex.lock();
+
+        while (!m_stop && m_filled.empty()) {
+            m_bufferFilled.wait(&m_mutex);
+        }
+
+        if (m_filled.empty()) // stopped and everything flushed
+        {
+            m_mutex.unlock();
+            return;
+        }
+
+        int index = m_filled.front();
+        m_filled.pop_front();
+        bool error = m_error;
+
+        if (index == -1) // switch to next file
+        {
+            QString fileName = m_nextFileNames.front();
+            m_nextFileNames.pop_front();
+            m_mutex.unlock();
+
+            if (!error) {
+                switchFile(fileName);
+            }
+
+            continue;
+        }
+        else if (index == -2) // write side file
+        {
+            std::pair<QString, QByteArray> sideFile = m_sideFiles.front();
+            m_sideFiles.pop_front();
+            m_mutex.unlock();
+            saveSideFile(sideFile.first, sideFile.second);
+            continue;
+        }
+
+        m_mutex.unlock();
+
+        const Buffer& buffer = m_buffers[index];
+        timer.start();
+        bool written = !error && writeBuffer(buffer);
+        int writeLatencyUs = timer.nsecsElapsed() / 1000;
+
+        m_mutex.lock();
+        m_bytesPending -= buffer.m_fill;
+
+        if (written)
+        {
+            m_fileBytes += buffer.m_fill;
+            m_bytesWritten += buffer.m_fill;
+            m_avgWriteLatencyUs(writeLatencyUs);
+            m_maxWriteLatencyUs = std::max(m_maxWriteLatencyUs, writeLatencyUs);
+        }
+        else
+        {
+            m_bytesDropped += buffer.m_fill;
+            m_error = true;
+        }
+
+        m_free.push_back(index);
+        m_mutex.unlock();
+    }
+}
+
+bool AsyncFileWriter::writeBuffer(const Buffer& buffer)
+{
+    if ((m_preallocateStep > 0) && (m_fileBytes + buffer.m_fill > m_preallocated)) {
+        preallocate(m_fileBytes + buffer.m_fill);
+    }
+
+    if (m_directIO && (buffer.m_fill % m_alignment != 0)) // last partial buffer of a file
+    {
+        setDirectIO(false);
+        m_directIORequested = true; // switch it back on in the next file
+    }
+
+    const char *data = buffer.m_data;
+    qint64 remaining = buffer.m_fill;
+
+    while (remaining > 0)
+    {
+        qint64 written = m_file.write(data, remaining);
+
+        if (written < 0)
+        {
+            if (m_directIO) // file system accepted the flag but not the write: retry through the page cache
+            {
+                m_directIORequested = false;
+                qDebug("AsyncFileWriter::writeBuffer: direct I/O not supported on %s", qPrintable(m_file.fileName()));
+                setDirectIO(false);
+                continue;
+            }
+
+            qWarning("AsyncFileWriter::writeBuffer: cannot write to %s: %s", qPrintable(m_file.fileName()), qPrintable(m_file.errorString()));
+            return false;
+        }
+
+        data += written;
+        remaining -= written;
+    }
+
+    return true;
+}
+
+void AsyncFileWriter::setDirectIO(bool directIO)
+{
+#if defined(ASYNCFILEWRITER_LINUX) && defined(O_DIRECT)
+    int flags = fcntl(m_file.handle(), F_GETFL);
+    bool success = (flags >= 0) && (fcntl(m_file.handle(), F_SETFL, directIO ? flags | O_DIRECT : flags & ~O_DIRECT) == 0);
+    m_directIO = directIO && success;
+#elif defined(__APPLE__)
+    bool success = fcntl(m_file.handle(), F_NOCACHE, directIO ? 1 : 0) == 0;
+    m_directIO = directIO && success;
+#else
+    m_directIO = false;
+#endif
+}
+
+void AsyncFileWriter::preallocate(qint64 upTo)
+{
+#ifdef ASYNCFILEWRITER_LINUX
+    qint64 target = ((upTo + m_preallocateStep - 1) / m_preallocateStep) * m_preallocateStep;
+
+    if (fallocate(m_file.handle(), FALLOC_FL_KEEP_SIZE, m_preallocated, target - m_preallocated) == 0)
+    {
+        m_preallocated = target;
+    }
+    else
+    {
+        qDebug("AsyncFileWriter::preallocate: not supported on %s", qPrintable(m_file.fileName()));
+        m_preallocateStep = 0;
+    }
+#else
+    (void) upTo;
+    m_preallocateStep = 0;
+#endif
+}
@@ -0,0 +1,144 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef SDRBASE_UTIL_ASYNCFILEWRITER_H_
+#define SDRBASE_UTIL_ASYNCFILEWRITER_H_
+
+#include <deque>
+#include <utility>
+#include <vector>
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+
+#include "util/movingaverage.h"
+#include "export.h"
+
+/**
+ * Sequential file writer with the disk writes done in a dedicated thread so that the
+ * thread producing the data never waits for the disk. Data is copied in a pool of
+ * preallocated buffers that are handed over to the writer thread as soon as they are full.
+ * If the disk cannot keep up and no free buffer is left the data is dropped and counted
+ * rather than stalling the producer.
+ *
+ * On Linux the file can be written with O_DIRECT (F_NOCACHE on Mac) to bypass the page
+ * cache: buffers are page aligned and only the last one may be partial in which case it is
+ * written with direct I/O switched off. Disk space is reserved ahead of the writes with
+ * fallocate to limit fragmentation and metadata updates while recording.
+ *
+ * Direct I/O is off unless requested at open().
+ *
+ * Writes are plain blocking writes from the dedicated thread. io_uring is not used: it would
+ * add a liburing dependency for Linux only. With the writer thread the disk latency is already
+ * taken off the producer, and the buffer pool covers the latency spikes.
+ *
+ * write() must be called from a single thread at a time.
+ */
+class SDRBASE_API AsyncFileWriter
+{
+public:
+    AsyncFileWriter(unsigned int nbBuffers = 8, unsigned int bufferSize = 4<<20);
+    ~AsyncFileWriter();
+
+    /** Create or truncate the file and start the writer thread.
+     *  If directIO is true the page cache is bypassed when the file system supports it.
+     *  If preallocateStep is not zero disk space is reserved by chunks of that many bytes. */
+    bool open(const QString& fileName, bool directIO = false, qint64 preallocateStep = 0);
+    void close(); //!< Flush pending data, stop the writer thread and close the file
+    /** Continue in a new file once the data queued so far is written. Does not wait for the disk.
+     *  Byte counters keep running over successive files. */
+    void rotate(const QString& fileName);
+    /** Replace the content of a small companion file (ex: metadata) from the writer thread once
+     *  the data queued so far is written. A pending update of the same file is superseded. */
+    void writeSideFile(const QString& fileName, const QByteArray& data);
+    bool isOpen() const { return m_open; }
+
+    bool write(const char *data, qint64 length); //!< Queue data for writing. Returns false if data had to be dropped.
+    /** Check that length bytes can be queued by the next write() calls without dropping any.
+     *  Else count them as dropped and return false: the caller must then not write them at all
+     *  so that a record is either written completely or not at all. */
+    bool reserve(qint64 length);
+
+    quint64 getBytesQueued() const { return m_bytesQueued; } //!< Bytes accepted by write() since open
+    quint64 getBytesWritten() const;     //!< Bytes actually written to disk since open
+    quint64 getBytesPending() const;     //!< Bytes handed to the writer thread and not on disk yet
+    quint64 getBytesDropped() const;     //!< Bytes lost for lack of free buffer or write error since open
+    int getAvgWriteLatencyUs() const;    //!< Moving average of the time to write one buffer
+    int getMaxWriteLatencyUs();          //!< Maximum time to write one buffer since last call
+    bool isDirectIO() const { return m_directIO; }
+
+private:
+    class Worker : public QThread
+    {
+    public:
+        Worker(AsyncFileWriter *writer) : m_writer(writer) {}
+    private:
+        AsyncFileWriter *m_writer;
+        void run() { m_writer->work(); }
+    };
+
+    struct Buffer
+    {
+        char *m_data;   //!< aligned start in the storage
+        qint64 m_fill;  //!< number of valid bytes
+    };
+
+    QFile m_file;                   //!< owned by the writer thread while open
+    bool m_open;
+    Worker m_worker;
+    std::vector<char> m_storage;    //!< memory of all buffers
+    std::vector<Buffer> m_buffers;
+    unsigned int m_bufferSize;      //!< multiple of the alignment
+    int m_current;                  //!< buffer being filled by write() or -1 (producer side)
+    quint64 m_bytesQueued;          //!< producer side
+    std::deque<int> m_free;         //!< buffers available to write()
+    std::deque<int> m_filled;       //!< buffers waiting for the writer thread, -1 to switch to the next file or -2 to write a side file
+    std::deque<QString> m_nextFileNames; //!< files to switch to
+    std::deque<std::pair<QString, QByteArray> > m_sideFiles; //!< side files to write
+    mutable QMutex m_mutex;
+    QWaitCondition m_bufferFilled;
+    bool m_stop;
+    bool m_error;                   //!< a write failed: further data is dropped
+    bool m_directIO;
+    bool m_directIORequested;       //!< direct I/O was switched off for a partial buffer only
+    qint64 m_preallocateStep;
+    qint64 m_preallocated;          //!< bytes reserved from the start of file
+    qint64 m_fileBytes;             //!< bytes written in the current file
+    quint64 m_bytesWritten;
+    quint64 m_bytesPending;
+    quint64 m_bytesDropped;
+    MovingAverageUtil<int, int, 16> m_avgWriteLatencyUs;
+    int m_maxWriteLatencyUs;
+
+    static const unsigned int m_alignment; //!< direct I/O alignment of buffers, file offsets and sizes
+
+    void submitCurrent();
+    void work();
+    void switchFile(const QString& fileName);
+    void saveSideFile(const QString& fileName, const QByteArray& data);
+    void releasePreallocated();
+    bool writeBuffer(const Buffer& buffer);
+    void setDirectIO(bool directIO);
+    void preallocate(qint64 upTo);
+};
+
+#endif /* SDRBASE_UTIL_ASYNCFILEWRITER_H_ */
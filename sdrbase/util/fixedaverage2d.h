@@ -72,6 +72,37 @@ public:
         }
     }
 
+    /** Same as storeAndGetAvg for indexes 0 to n-1 at once. avg may be the same array as v. */
+    template<typename U>
+    bool storeAndGetAvg(U *avg, const U *v, unsigned int n)
+    {
+        if (m_size <= 1)
+        {
+            if (avg != v) {
+                std::copy(v, v + n, avg);
+            }
+
+            return true;
+        }
+
+        for (unsigned int index = 0; index < n; index++) {
+            m_sum[index] += v[index];
+        }
+
+        if (m_maxIndex == m_size - 1)
+        {
+            for (unsigned int index = 0; index < n; index++) {
+                avg[index] = m_sum[index]/m_size;
+            }
+
+            return true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
     bool storeAndGetSum(T& sum, T v, unsigned int index)
     {
         if (m_size <= 1)
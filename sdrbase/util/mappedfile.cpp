@@ -0,0 +1,125 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+
+#include <algorithm>
+
+#include <QDebug>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/mman.h>
+#define MAPPEDFILE_MADVISE
+#endif
+
+#include "util/mappedfile.h"
+
+const qint64 MappedFile::m_windowSize = sizeof(void*) > 4 ? (1LL<<30) : (1LL<<27); // 1 GB or 128 MB on 32 bit systems
+const qint64 MappedFile::m_windowAlignment = 1LL<<20;
+
+MappedFile::MappedFile() :
+    m_size(0),
+    m_window(0),
+    m_windowOffset(0),
+    m_windowLength(0)
+{}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+bool MappedFile::open(const QString& fileName)
+{
+    close();
+    m_file.setFileName(fileName);
+
+    if (!m_file.open(QIODevice::ReadOnly))
+    {
+        qWarning("MappedFile::open: cannot open %s: %s", qPrintable(fileName), qPrintable(m_file.errorString()));
+        return false;
+    }
+
+    m_size = m_file.size();
+    return true;
+}
+
+void MappedFile::close()
+{
+    unmapWindow();
+
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+
+    m_size = 0;
+}
+
+void MappedFile::unmapWindow()
+{
+    if (m_window)
+    {
+        m_file.unmap(m_window);
+        m_window = 0;
+        m_windowOffset = 0;
+        m_windowLength = 0;
+    }
+}
+
+const quint8 *MappedFile::map(qint64 offset, qint64 length)
+{
+    if ((offset < 0) || (length <= 0) || (offset + length > m_size)) {
+        return 0;
+    }
+
+    if (m_window && (offset >= m_windowOffset) && (offset + length <= m_windowOffset + m_windowLength)) {
+        return m_window + (offset - m_windowOffset);
+    }
+
+    unmapWindow();
+    qint64 windowOffset = offset - (offset % m_windowAlignment);
+    qint64 windowLength = std::min(std::max(m_windowSize, offset + length - windowOffset), m_size - windowOffset);
+    m_window = m_file.map(windowOffset, windowLength);
+
+    if (!m_window)
+    {
+        qWarning("MappedFile::map: cannot map %lld bytes at %lld: %s", windowLength, windowOffset, qPrintable(m_file.errorString()));
+        return 0;
+    }
+
+    m_windowOffset = windowOffset;
+    m_windowLength = windowLength;
+#ifdef MAPPEDFILE_MADVISE
+    madvise(m_window, m_windowLength, MADV_SEQUENTIAL);
+#endif
+    return m_window + (offset - m_windowOffset);
+}
+
+void MappedFile::willNeed(qint64 offset, qint64 length)
+{
+#ifdef MAPPEDFILE_MADVISE
+    length = std::min(length, m_size - offset);
+
+    if (map(offset, length))
+    {
+        qint64 pageOffset = offset - (offset % m_windowAlignment); // window offsets are aligned so this is page aligned in the window
+        madvise(m_window + (pageOffset - m_windowOffset), length + (offset - pageOffset), MADV_WILLNEED);
+    }
+#else
+    (void) offset;
+    (void) length;
+#endif
+}
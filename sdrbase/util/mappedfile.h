@@ -0,0 +1,64 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef SDRBASE_UTIL_MAPPEDFILE_H_
+#define SDRBASE_UTIL_MAPPEDFILE_H_
+
+#include <QFile>
+#include <QString>
+
+#include "export.h"
+
+/**
+ * Read only memory mapped file. The file is mapped by windows of a few hundreds of MB
+ * so that files larger than the address space can be read. Accessing data in a window
+ * is a plain memory access and moving to another window is a single remap so seeking
+ * anywhere in the file costs the same. On Linux and Mac windows are advised for
+ * sequential access so that the kernel reads ahead aggressively.
+ */
+class SDRBASE_API MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+
+    bool open(const QString& fileName);
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+    qint64 size() const { return m_size; }
+
+    /** Pointer to length bytes of the file starting at offset. The pointer is valid until the
+     *  next call to map or close. Returns null if out of file bounds or mapping fails. */
+    const quint8 *map(qint64 offset, qint64 length);
+    /** Hint that length bytes at offset will be needed soon (ex: after a seek) */
+    void willNeed(qint64 offset, qint64 length);
+
+private:
+    QFile m_file;
+    qint64 m_size;
+    uchar *m_window;        //!< start of the current window
+    qint64 m_windowOffset;  //!< file offset of the current window
+    qint64 m_windowLength;  //!< length of the current window in bytes
+
+    static const qint64 m_windowSize;      //!< nominal window length in bytes
+    static const qint64 m_windowAlignment; //!< window offsets are multiples of this (multiple of page sizes)
+
+    void unmapWindow();
+};
+
+#endif /* SDRBASE_UTIL_MAPPEDFILE_H_ */
@@ -77,6 +77,40 @@ public:
         }
     }
 
+    /** Same as storeAndGetMax for indexes 0 to n-1 at once. max may be the same array as v. */
+    template<typename U>
+    bool storeAndGetMax(U *max, const U *v, unsigned int n)
+    {
+        if (m_size <= 1)
+        {
+            if (max != v) {
+                std::copy(v, v + n, max);
+            }
+
+            return true;
+        }
+
+        if (m_maxIndex == 0)
+        {
+            std::copy(v, v + n, m_max);
+            return false;
+        }
+
+        for (unsigned int index = 0; index < n; index++) {
+            m_max[index] = std::max(m_max[index], (T) v[index]);
+        }
+
+        if (m_maxIndex == m_size - 1)
+        {
+            std::copy(m_max, m_max + n, max);
+            return true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
     bool nextMax()
     {
         if (m_size <= 1) {
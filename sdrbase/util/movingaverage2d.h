@@ -85,6 +85,31 @@ public:
         }
     }
 
+    /** Same as storeAndGetAvg for indexes 0 to n-1 at once. avg may be the same array as v. */
+    template<typename U>
+    void storeAndGetAvg(U *avg, const U *v, unsigned int n)
+    {
+        if (m_depth <= 1)
+        {
+            if (avg != v) {
+                std::copy(v, v + n, avg);
+            }
+
+            return;
+        }
+
+        T *data = &m_data[m_avgIndex*m_width];
+        n = std::min(n, m_width);
+
+        for (unsigned int index = 0; index < n; index++)
+        {
+            T x = v[index];
+            m_sum[index] += (x - data[index]);
+            data[index] = x;
+            avg[index] = m_sum[index] / m_depth;
+        }
+    }
+
     T storeAndGetSum(T v, unsigned int index)
     {
         if (m_depth == 1)
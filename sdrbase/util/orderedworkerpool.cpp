@@ -0,0 +1,155 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+
+#include <algorithm>
+
+#include <QElapsedTimer>
+
+#include "util/orderedworkerpool.h"
+
+OrderedWorkerPool::OrderedWorkerPool(unsigned int maxWorkers, QObject *parent) :
+    QObject(parent),
+    m_stop(false),
+    m_maxProcessTimeUs(0)
+{
+    int idealCount = QThread::idealThreadCount();
+    unsigned int nbWorkers = std::min(idealCount < 1 ? 1U : (unsigned int) idealCount, maxWorkers);
+    nbWorkers = nbWorkers < 1 ? 1 : nbWorkers;
+
+    for (unsigned int i = 0; i < nbWorkers; i++)
+    {
+        m_workers.push_back(new Worker(this, i));
+        m_workers.back()->start();
+    }
+}
+
+OrderedWorkerPool::~OrderedWorkerPool()
+{
+    m_mutex.lock();
+    m_stop = true;
+    m_jobAvailable.wakeAll();
+    m_mutex.unlock();
+
+    for (std::vector<Worker*>::iterator it = m_workers.begin(); it != m_workers.end(); ++it)
+    {
+        (*it)->wait();
+        delete *it;
+    }
+}
+
+unsigned int OrderedWorkerPool::getNbPending() const
+{
+    QMutexLocker mutexLocker(&m_mutex);
+    return m_pending.size();
+}
+
+void OrderedWorkerPool::push(Job *job)
+{
+    QMutexLocker mutexLocker(&m_mutex);
+    job->m_processed = false;
+    m_pending.push_back(job);
+    m_toProcess.push_back(job);
+    m_jobAvailable.wakeOne();
+}
+
+OrderedWorkerPool::Job *OrderedWorkerPool::popProcessed()
+{
+    QMutexLocker mutexLocker(&m_mutex);
+
+    if (m_pending.empty() || !m_pending.front()->m_processed) {
+        return 0;
+    }
+
+    Job *job = m_pending.front();
+    m_pending.pop_front();
+    return job;
+}
+
+OrderedWorkerPool::Job *OrderedWorkerPool::popWait()
+{
+    QMutexLocker mutexLocker(&m_mutex);
+
+    if (m_pending.empty()) {
+        return 0;
+    }
+
+    while (!m_pending.front()->m_processed) {
+        m_jobDone.wait(&m_mutex);
+    }
+
+    Job *job = m_pending.front();
+    m_pending.pop_front();
+    return job;
+}
+
+int OrderedWorkerPool::getAvgProcessTimeUs() const
+{
+    QMutexLocker mutexLocker(&m_mutex);
+    return m_avgProcessTimeUs.instantAverage();
+}
+
+int OrderedWorkerPool::getMaxProcessTimeUs()
+{
+    QMutexLocker mutexLocker(&m_mutex);
+    int maxProcessTimeUs = m_maxProcessTimeUs;
+    m_maxProcessTimeUs = 0;
+    return maxProcessTimeUs;
+}
+
+void OrderedWorkerPool::work(unsigned int workerIndex)
+{
+    QElapsedTimer timer;
+
+    while (true)
+    {
+        m_mutex.lock();
+
+        while (!m_stop && m_toProcess.empty()) {
+            m_jobAvailable.wait(&m_mutex);
+        }
+
+        if (m_stop)
+        {
+            m_mutex.unlock();
+            return;
+        }
+
+        Job *job = m_toProcess.front();
+        m_toProcess.pop_front();
+        m_mutex.unlock();
+
+        timer.start();
+        bool timed = job->process(workerIndex);
+        int processTimeUs = timer.nsecsElapsed() / 1000;
+
+        m_mutex.lock();
+        job->m_processTimeUs = processTimeUs;
+        job->m_processed = true;
+
+        if (timed)
+        {
+            m_avgProcessTimeUs(processTimeUs);
+            m_maxProcessTimeUs = std::max(m_maxProcessTimeUs, processTimeUs);
+        }
+
+        m_jobDone.wakeAll();
+        m_mutex.unlock();
+
+        emit jobProcessed();
+    }
+}
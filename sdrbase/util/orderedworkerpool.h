@@ -0,0 +1,104 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef SDRBASE_UTIL_ORDEREDWORKERPOOL_H_
+#define SDRBASE_UTIL_ORDEREDWORKERPOOL_H_
+
+#include <deque>
+#include <vector>
+
+#include <QObject>
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+
+#include "util/movingaverage.h"
+#include "export.h"
+
+/**
+ * Pool of worker threads processing independent jobs concurrently while handing them
+ * back to the owner in the order they were pushed. The owner keeps ownership of the jobs:
+ * it pushes them with push() and gets them back with popProcessed() or popWait().
+ * The jobProcessed() signal is emitted from a worker thread each time a job is done so that
+ * the owner can collect processed jobs with a queued connection.
+ */
+class SDRBASE_API OrderedWorkerPool : public QObject {
+    Q_OBJECT
+
+public:
+    class Job
+    {
+    public:
+        Job() : m_processed(false), m_processTimeUs(0) {}
+        virtual ~Job() {}
+
+        /** Process the job in a pool thread. The worker index is in [0, getNbWorkers()[ so that
+         *  the owner can give each worker its own non thread safe resources.
+         *  Returns true if actual work was done so that it counts in the timing statistics */
+        virtual bool process(unsigned int workerIndex) = 0;
+
+        int getProcessTimeUs() const { return m_processTimeUs; } //!< Processing time of this job
+
+    private:
+        friend class OrderedWorkerPool;
+        bool m_processed;
+        int m_processTimeUs;
+    };
+
+    /** Starts min(ideal thread count, maxWorkers) worker threads (at least one) */
+    OrderedWorkerPool(unsigned int maxWorkers, QObject *parent = 0);
+    ~OrderedWorkerPool();
+
+    unsigned int getNbWorkers() const { return m_workers.size(); }
+    unsigned int getNbPending() const; //!< Number of jobs pushed and not popped yet
+
+    void push(Job *job);   //!< Queue job for processing
+    Job *popProcessed();   //!< Oldest pushed job if it has been processed else null
+    Job *popWait();        //!< Wait for the oldest pushed job to be processed and return it. Null if nothing is pending.
+
+    int getAvgProcessTimeUs() const; //!< Moving average of job processing time
+    int getMaxProcessTimeUs();       //!< Maximum job processing time since last call
+
+signals:
+    void jobProcessed();
+
+private:
+    class Worker : public QThread
+    {
+    public:
+        Worker(OrderedWorkerPool *pool, unsigned int index) : m_pool(pool), m_index(index) {}
+    private:
+        OrderedWorkerPool *m_pool;
+        unsigned int m_index;
+        void run() { m_pool->work(m_index); }
+    };
+
+    std::vector<Worker*> m_workers;
+    std::deque<Job*> m_pending;   //!< Jobs in push order until popped
+    std::deque<Job*> m_toProcess; //!< Jobs waiting for a worker
+    mutable QMutex m_mutex;
+    QWaitCondition m_jobAvailable;
+    QWaitCondition m_jobDone;
+    bool m_stop;
+    MovingAverageUtil<int, int, 16> m_avgProcessTimeUs;
+    int m_maxProcessTimeUs;
+
+    void work(unsigned int workerIndex);
+};
+
+#endif /* SDRBASE_UTIL_ORDEREDWORKERPOOL_H_ */
@@ -0,0 +1,416 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+
+#include <algorithm>
+
+#include <QUdpSocket>
+#include <QSocketNotifier>
+#include <QThread>
+#include <QDebug>
+
+#if defined(__linux__)
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#define UDPBATCHSOCKET_MMSG
+#endif
+
+#include "util/udpbatchsocket.h"
+
+const int UDPBatchSocket::m_maxBatchSize;
+
+UDPBatchSocket::UDPBatchSocket(QObject *parent) :
+    QObject(parent),
+    m_fd(-1),
+    m_notifier(0),
+    m_socket(0),
+    m_destAddress(QHostAddress::LocalHost),
+    m_destPort(9090),
+    m_sendBufferSize(0),
+    m_receiveBufferSize(0),
+    m_bytesPerUs(0.0),
+    m_burstBytes(0.0),
+    m_tokens(0.0),
+    m_burstDatagrams(1),
+    m_pacingDatagramSize(0),
+    m_pacingDelayUs(0),
+    m_nonBlocking(false),
+    m_fallbackEnabled(true)
+{
+}
+
+UDPBatchSocket::~UDPBatchSocket()
+{
+    close();
+}
+
+bool UDPBatchSocket::openNative()
+{
+#ifdef UDPBATCHSOCKET_MMSG
+    if (m_fd >= 0) {
+        return true;
+    }
+
+    m_fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+
+    if (m_fd < 0)
+    {
+        qWarning("UDPBatchSocket::openNative: cannot create socket: %s", strerror(errno));
+        return false;
+    }
+
+    applyBufferSizes();
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool UDPBatchSocket::openSender()
+{
+#ifdef UDPBATCHSOCKET_MMSG
+    return (m_destAddress.protocol() == QAbstractSocket::IPv4Protocol) && !m_socket && openNative();
+#else
+    return false;
+#endif
+}
+
+void UDPBatchSocket::openFallback()
+{
+    if (!m_socket)
+    {
+        m_socket = new QUdpSocket(this);
+        applyBufferSizes();
+    }
+}
+
+void UDPBatchSocket::applyBufferSizes()
+{
+#ifdef UDPBATCHSOCKET_MMSG
+    if (m_fd >= 0)
+    {
+        if ((m_sendBufferSize > 0) && (setsockopt(m_fd, SOL_SOCKET, SO_SNDBUF, &m_sendBufferSize, sizeof(m_sendBufferSize)) < 0)) {
+            qWarning("UDPBatchSocket::applyBufferSizes: cannot set send buffer size: %s", strerror(errno));
+        }
+
+        if ((m_receiveBufferSize > 0) && (setsockopt(m_fd, SOL_SOCKET, SO_RCVBUF, &m_receiveBufferSize, sizeof(m_receiveBufferSize)) < 0)) {
+            qWarning("UDPBatchSocket::applyBufferSizes: cannot set receive buffer size: %s", strerror(errno));
+        }
+    }
+#endif
+
+    if (m_socket)
+    {
+        if (m_sendBufferSize > 0) {
+            m_socket->setSocketOption(QAbstractSocket::SendBufferSizeSocketOption, m_sendBufferSize);
+        }
+
+        if (m_receiveBufferSize > 0) {
+            m_socket->setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, m_receiveBufferSize);
+        }
+    }
+}
+
+bool UDPBatchSocket::bind(const QHostAddress& address, quint16 port)
+{
+    close();
+
+#ifdef UDPBATCHSOCKET_MMSG
+    if ((address.protocol() == QAbstractSocket::IPv4Protocol) && openNative())
+    {
+        struct sockaddr_in bindAddress;
+        memset(&bindAddress, 0, sizeof(bindAddress));
+        bindAddress.sin_family = AF_INET;
+        bindAddress.sin_port = htons(port);
+        bindAddress.sin_addr.s_addr = htonl(address.toIPv4Address());
+
+        if (::bind(m_fd, (struct sockaddr *) &bindAddress, sizeof(bindAddress)) < 0)
+        {
+            qWarning("UDPBatchSocket::bind: cannot bind to %s:%d: %s", qPrintable(address.toString()), port, strerror(errno));
+            close();
+            return false;
+        }
+
+        m_notifier = new QSocketNotifier(m_fd, QSocketNotifier::Read, this);
+        connect(m_notifier, SIGNAL(activated(int)), this, SLOT(handleNotifier()));
+        return true;
+    }
+#endif
+
+    openFallback();
+
+    if (!m_socket->bind(address, port))
+    {
+        close();
+        return false;
+    }
+
+    connect(m_socket, SIGNAL(readyRead()), this, SIGNAL(readyRead()));
+    return true;
+}
+
+void UDPBatchSocket::close()
+{
+    if (m_notifier)
+    {
+        m_notifier->setEnabled(false);
+        delete m_notifier;
+        m_notifier = 0;
+    }
+
+#ifdef UDPBATCHSOCKET_MMSG
+    if (m_fd >= 0)
+    {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+#endif
+
+    if (m_socket)
+    {
+        delete m_socket;
+        m_socket = 0;
+    }
+}
+
+void UDPBatchSocket::setDestination(const QHostAddress& address, quint16 port)
+{
+    m_destAddress = address;
+    m_destPort = port;
+}
+
+void UDPBatchSocket::setBufferSizes(int sendBufferSize, int receiveBufferSize)
+{
+    m_sendBufferSize = sendBufferSize;
+    m_receiveBufferSize = receiveBufferSize;
+    applyBufferSizes();
+}
+
+void UDPBatchSocket::setPacing(int datagramSize, unsigned int datagramDelayUs, int burstDatagrams)
+{
+    burstDatagrams = std::max(1, std::min(burstDatagrams, m_maxBatchSize));
+
+    if ((datagramSize == m_pacingDatagramSize) && (datagramDelayUs == m_pacingDelayUs) && (burstDatagrams == m_burstDatagrams)) {
+        return;
+    }
+
+    m_pacingDatagramSize = datagramSize;
+    m_pacingDelayUs = datagramDelayUs;
+    m_burstDatagrams = burstDatagrams;
+    m_bytesPerUs = datagramDelayUs == 0 ? 0.0 : datagramSize / (double) datagramDelayUs;
+    m_burstBytes = burstDatagrams * datagramSize;
+    m_tokens = m_burstBytes;
+    m_pacingTimer.start();
+}
+
+void UDPBatchSocket::waitTokens(int nbBytes)
+{
+    m_tokens = std::min(m_burstBytes, m_tokens + (m_pacingTimer.nsecsElapsed() / 1000.0) * m_bytesPerUs);
+    m_pacingTimer.start();
+
+    if (m_tokens < nbBytes)
+    {
+        QThread::usleep((unsigned long) ((nbBytes - m_tokens) / m_bytesPerUs));
+        m_tokens += (m_pacingTimer.nsecsElapsed() / 1000.0) * m_bytesPerUs;
+        m_pacingTimer.start();
+    }
+
+    m_tokens -= nbBytes;
+}
+
+int UDPBatchSocket::writeDatagrams(const char *data, int datagramSize, int nbDatagrams)
+{
+    int batchSize = m_bytesPerUs > 0.0 ? m_burstDatagrams : m_maxBatchSize;
+    int nbSent = 0;
+
+    while (nbSent < nbDatagrams)
+    {
+        int nbBatch = std::min(nbDatagrams - nbSent, batchSize);
+
+        if (m_bytesPerUs > 0.0) {
+            waitTokens(nbBatch * datagramSize);
+        }
+
+        int nbBatchSent = sendBatch(&data[nbSent * datagramSize], datagramSize, nbBatch);
+
+        if (nbBatchSent <= 0) {
+            break;
+        }
+
+        nbSent += nbBatchSent;
+    }
+
+    return nbSent;
+}
+
+int UDPBatchSocket::sendBatch(const char *data, int datagramSize, int nbDatagrams)
+{
+#ifdef UDPBATCHSOCKET_MMSG
+    if ((m_destAddress.protocol() == QAbstractSocket::IPv4Protocol) && !m_socket && openNative())
+    {
+        struct sockaddr_in destAddress;
+        struct mmsghdr msgs[m_maxBatchSize];
+        struct iovec iovecs[m_maxBatchSize];
+
+        memset(&destAddress, 0, sizeof(destAddress));
+        destAddress.sin_family = AF_INET;
+        destAddress.sin_port = htons(m_destPort);
+        destAddress.sin_addr.s_addr = htonl(m_destAddress.toIPv4Address());
+        memset(msgs, 0, nbDatagrams * sizeof(struct mmsghdr));
+
+        for (int i = 0; i < nbDatagrams; i++)
+        {
+            iovecs[i].iov_base = (void *) &data[i * datagramSize];
+            iovecs[i].iov_len = datagramSize;
+            msgs[i].msg_hdr.msg_name = &destAddress;
+            msgs[i].msg_hdr.msg_namelen = sizeof(destAddress);
+            msgs[i].msg_hdr.msg_iov = &iovecs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        int nbSent = 0;
+        int flags = m_nonBlocking ? MSG_DONTWAIT : 0;
+
+        while (nbSent < nbDatagrams)
+        {
+            int ret = sendmmsg(m_fd, &msgs[nbSent], nbDatagrams - nbSent, flags);
+
+            if (ret < 0)
+            {
+                if (errno == EINTR) {
+                    continue;
+                }
+
+                if ((errno != EAGAIN) && (errno != EWOULDBLOCK)) { // else the send buffer is full
+                    qWarning("UDPBatchSocket::sendBatch: sendmmsg failed: %s", strerror(errno));
+                }
+
+                break;
+            }
+
+            nbSent += ret;
+        }
+
+        return nbSent;
+    }
+#endif
+
+    if (!m_fallbackEnabled) {
+        return 0;
+    }
+
+    openFallback();
+    int nbSent = 0;
+
+    for (int i = 0; i < nbDatagrams; i++)
+    {
+        if (m_socket->writeDatagram(&data[i * datagramSize], datagramSize, m_destAddress, m_destPort) < 0) {
+            break;
+        }
+
+        nbSent++;
+    }
+
+    return nbSent;
+}
+
+int UDPBatchSocket::readDatagrams(char *data, int datagramSize, int maxDatagrams, int *sizes, QHostAddress *sender)
+{
+    maxDatagrams = std::min(maxDatagrams, m_maxBatchSize);
+
+#ifdef UDPBATCHSOCKET_MMSG
+    if (m_fd >= 0)
+    {
+        struct sockaddr_in senderAddresses[m_maxBatchSize];
+        struct mmsghdr msgs[m_maxBatchSize];
+        struct iovec iovecs[m_maxBatchSize];
+
+        memset(msgs, 0, maxDatagrams * sizeof(struct mmsghdr));
+
+        for (int i = 0; i < maxDatagrams; i++)
+        {
+            iovecs[i].iov_base = (void *) &data[i * datagramSize];
+            iovecs[i].iov_len = datagramSize;
+            msgs[i].msg_hdr.msg_name = &senderAddresses[i];
+            msgs[i].msg_hdr.msg_namelen = sizeof(senderAddresses[i]);
+            msgs[i].msg_hdr.msg_iov = &iovecs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        int ret;
+
+        do {
+            ret = recvmmsg(m_fd, msgs, maxDatagrams, MSG_DONTWAIT, 0);
+        } while ((ret < 0) && (errno == EINTR));
+
+        if (ret < 0)
+        {
+            if ((errno != EAGAIN) && (errno != EWOULDBLOCK)) {
+                qWarning("UDPBatchSocket::readDatagrams: recvmmsg failed: %s", strerror(errno));
+            }
+
+            return 0;
+        }
+
+        if (sizes)
+        {
+            for (int i = 0; i < ret; i++) { // truncated datagrams are flagged with a negative size
+                sizes[i] = (msgs[i].msg_hdr.msg_flags & MSG_TRUNC) ? -1 : (int) msgs[i].msg_len;
+            }
+        }
+
+        if (sender && (ret > 0)) {
+            sender->setAddress(ntohl(senderAddresses[ret - 1].sin_addr.s_addr));
+        }
+
+        return ret;
+    }
+#endif
+
+    if (!m_socket) {
+        return 0;
+    }
+
+    int nbRead = 0;
+
+    while ((nbRead < maxDatagrams) && m_socket->hasPendingDatagrams())
+    {
+        qint64 pendingSize = m_socket->pendingDatagramSize();
+        qint64 readSize = m_socket->readDatagram(&data[nbRead * datagramSize], datagramSize, sender);
+
+        if (readSize < 0) {
+            break;
+        }
+
+        if (sizes) {
+            sizes[nbRead] = pendingSize > datagramSize ? -1 : (int) readSize;
+        }
+
+        nbRead++;
+    }
+
+    return nbRead;
+}
+
+void UDPBatchSocket::handleNotifier()
+{
+    emit readyRead();
+}
@@ -0,0 +1,104 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef SDRBASE_UTIL_UDPBATCHSOCKET_H_
+#define SDRBASE_UTIL_UDPBATCHSOCKET_H_
+
+#include <QObject>
+#include <QHostAddress>
+#include <QElapsedTimer>
+
+#include "export.h"
+
+class QUdpSocket;
+class QSocketNotifier;
+
+/**
+ * UDP socket sending and receiving datagrams by batches. On Linux with IPv4 addresses
+ * batches are moved with a single sendmmsg/recvmmsg system call. Elsewhere it falls back
+ * to one QUdpSocket call per datagram.
+ *
+ * Datagrams of a batch are contiguous in memory with a fixed stride of datagramSize bytes.
+ * Transmission can be paced with a token bucket instead of sleeping between datagrams.
+ */
+class SDRBASE_API UDPBatchSocket : public QObject {
+    Q_OBJECT
+
+public:
+    static const int m_maxBatchSize = 64; //!< Maximum number of datagrams per system call
+
+    UDPBatchSocket(QObject *parent = 0);
+    ~UDPBatchSocket();
+
+    bool bind(const QHostAddress& address, quint16 port); //!< Bind for reception. readyRead() is emitted when datagrams are pending.
+    void close();
+    bool isBatched() const { return m_fd >= 0; } //!< True if sendmmsg/recvmmsg are used
+
+    void setDestination(const QHostAddress& address, quint16 port);
+    /** Set kernel socket buffer sizes in bytes. Zero leaves the system default. */
+    void setBufferSizes(int sendBufferSize, int receiveBufferSize);
+    /** Pace transmission at one datagram of datagramSize bytes every datagramDelayUs microseconds
+     *  on average with bursts of at most burstDatagrams datagrams. A zero delay disables pacing. */
+    void setPacing(int datagramSize, unsigned int datagramDelayUs, int burstDatagrams = 8);
+    /** Never wait for room in the kernel send buffer. Datagrams that do not fit are not sent. */
+    void setNonBlocking(bool nonBlocking) { m_nonBlocking = nonBlocking; }
+    /** When disabled the QUdpSocket fallback is never used and nothing is sent without batching.
+     *  The native socket is not bound to a thread so sending is then possible from any thread. */
+    void setFallbackEnabled(bool fallbackEnabled) { m_fallbackEnabled = fallbackEnabled; }
+    /** Open the native socket for sending to the destination. Returns false if batching is not available. */
+    bool openSender();
+
+    /** Send nbDatagrams contiguous datagrams to the destination. Returns the number of datagrams sent. */
+    int writeDatagrams(const char *data, int datagramSize, int nbDatagrams);
+    /** Read at most maxDatagrams pending datagrams without blocking in contiguous slots of datagramSize bytes.
+     *  Actual sizes are returned in sizes if not null and the sender of the last datagram in sender if not null.
+     *  Returns the number of datagrams read. */
+    int readDatagrams(char *data, int datagramSize, int maxDatagrams, int *sizes = 0, QHostAddress *sender = 0);
+
+signals:
+    void readyRead();
+
+private:
+    int m_fd;                     //!< Native socket when batched else -1
+    QSocketNotifier *m_notifier;  //!< Read notifier of the native socket
+    QUdpSocket *m_socket;         //!< Fallback socket
+    QHostAddress m_destAddress;
+    quint16 m_destPort;
+    int m_sendBufferSize;
+    int m_receiveBufferSize;
+    double m_bytesPerUs;          //!< Token bucket rate. Zero if no pacing.
+    double m_burstBytes;          //!< Token bucket capacity
+    double m_tokens;              //!< Token bucket level in bytes
+    int m_burstDatagrams;
+    int m_pacingDatagramSize;
+    unsigned int m_pacingDelayUs;
+    QElapsedTimer m_pacingTimer;
+    bool m_nonBlocking;
+    bool m_fallbackEnabled;
+
+    bool openNative();
+    void openFallback();
+    void applyBufferSizes();
+    void waitTokens(int nbBytes);
+    int sendBatch(const char *data, int datagramSize, int nbDatagrams);
+
+private slots:
+    void handleNotifier();
+};
+
+#endif /* SDRBASE_UTIL_UDPBATCHSOCKET_H_ */
@@ -19,12 +19,21 @@
 #define INCLUDE_UTIL_UDPSINK_H_
 
 #include <stdint.h>
+#include <string.h>
+#include <algorithm>
 #include <QObject>
-#include <QUdpSocket>
 #include <QHostAddress>
 
 #include <cassert>
 
+#include "util/udpbatchsocket.h"
+
+#define UDPSINKUTIL_BATCHSIZE 16 // number of datagrams sent at once
+
+/**
+ * Samples are accumulated in a buffer of UDPSINKUTIL_BATCHSIZE datagrams sent in one batch
+ * when full or when flush() is called.
+ */
 template<typename T>
 class UDPSinkUtil
 {
@@ -36,9 +45,7 @@ public:
 		m_port(9999),
 		m_sampleBufferIndex(0)
 	{
-        assert(m_udpSamples > 0);
-		m_sampleBuffer = new T[m_udpSamples];
-		m_socket = new QUdpSocket(parent);
+        init(parent);
 	}
 
     UDPSinkUtil(QObject *parent, unsigned int udpSize, unsigned int port) :
@@ -48,9 +55,7 @@ public:
         m_port(port),
         m_sampleBufferIndex(0)
     {
-        assert(m_udpSamples > 0);
-        m_sampleBuffer = new T[m_udpSamples];
-        m_socket = new QUdpSocket(parent);
+        init(parent);
     }
 
 	UDPSinkUtil (QObject *parent, unsigned int udpSize, QHostAddress& address, unsigned int port) :
@@ -60,9 +65,7 @@ public:
 		m_port(port),
 		m_sampleBufferIndex(0)
 	{
-		assert(m_udpSamples > 0);
-		m_sampleBuffer = new T[m_udpSamples];
-		m_socket = new QUdpSocket(parent);
+        init(parent);
 	}
 
 	~UDPSinkUtil()
@@ -90,16 +93,11 @@ public:
 	 */
 	void write(T sample)
 	{
-		if (m_sampleBufferIndex < m_udpSamples)
-		{
-			m_sampleBuffer[m_sampleBufferIndex] = sample;
-			m_sampleBufferIndex++;
-		}
-		else
-		{
-			m_socket->writeDatagram((const char*)&m_sampleBuffer[0], (qint64 ) m_udpSize, m_address, m_port);
-			m_sampleBuffer[0] = sample;
-			m_sampleBufferIndex = 1;
+		m_sampleBuffer[m_sampleBufferIndex] = sample;
+		m_sampleBufferIndex++;
+
+		if (m_sampleBufferIndex == m_bufferSamples) {
+		    flush();
 		}
 	}
 
@@ -108,35 +106,54 @@ public:
 	 */
 	void write(T *samples, int nbSamples)
 	{
-	    int samplesIndex = 0;
-
-	    if (m_sampleBufferIndex + nbSamples > m_udpSamples) // fill remainder of buffer and send it
+	    while (nbSamples > 0)
 	    {
-	        memcpy(&m_sampleBuffer[m_sampleBufferIndex], &samples[samplesIndex], (m_udpSamples - m_sampleBufferIndex)*sizeof(T)); // fill remainder of buffer
-	        m_socket->writeDatagram((const char*)&m_sampleBuffer[0], (qint64 ) m_udpSize, m_address, m_port); // send buffer
-            samplesIndex += (m_udpSamples - m_sampleBufferIndex);
-            nbSamples -= (m_udpSamples - m_sampleBufferIndex);
-	        m_sampleBufferIndex = 0;
+	        int nbCopy = std::min(nbSamples, m_bufferSamples - m_sampleBufferIndex);
+	        memcpy(&m_sampleBuffer[m_sampleBufferIndex], samples, nbCopy*sizeof(T));
+	        m_sampleBufferIndex += nbCopy;
+	        samples += nbCopy;
+	        nbSamples -= nbCopy;
+
+	        if (m_sampleBufferIndex == m_bufferSamples) {
+	            flush();
+	        }
 	    }
+	}
 
-	    while (nbSamples > m_udpSamples) // send directly from input without buffering
-	    {
-	        m_socket->writeDatagram((const char*)&samples[samplesIndex], (qint64 ) m_udpSize, m_address, m_port);
-	        samplesIndex += m_udpSamples;
-	        nbSamples -= m_udpSamples;
+	/**
+	 * Send all complete datagrams in one batch. Samples of the incomplete datagram are kept.
+	 */
+	void flush()
+	{
+	    int nbDatagrams = m_sampleBufferIndex / m_udpSamples;
+
+	    if (nbDatagrams == 0) {
+	        return;
 	    }
 
-	    memcpy(&m_sampleBuffer[m_sampleBufferIndex], &samples[samplesIndex], nbSamples*sizeof(T)); // copy remainder of input to buffer
+	    m_socket->setDestination(m_address, m_port);
+	    m_socket->writeDatagrams((const char*) m_sampleBuffer, m_udpSamples*sizeof(T), nbDatagrams);
+	    m_sampleBufferIndex -= nbDatagrams*m_udpSamples;
+	    memmove(m_sampleBuffer, &m_sampleBuffer[nbDatagrams*m_udpSamples], m_sampleBufferIndex*sizeof(T));
 	}
 
 private:
 	int m_udpSize;
     int m_udpSamples;
+    int m_bufferSamples;
 	QHostAddress m_address;
 	unsigned int m_port;
-	QUdpSocket *m_socket;
-	T *m_sampleBuffer;;
+	UDPBatchSocket *m_socket;
+	T *m_sampleBuffer;
 	int m_sampleBufferIndex;
+
+	void init(QObject *parent)
+	{
+        assert(m_udpSamples > 0);
+        m_bufferSamples = m_udpSamples * UDPSINKUTIL_BATCHSIZE;
+        m_sampleBuffer = new T[m_bufferSamples];
+        m_socket = new UDPBatchSocket(parent);
+	}
 };
 
 
@@ -2430,6 +2430,8 @@ void WebAPIRequestMapper::resetDeviceReport(SWGSDRangel::SWGDeviceReport& device
     deviceReport.setSdrDaemonSinkReport(0);
     deviceReport.setSdrDaemonSourceReport(0);
     deviceReport.setSdrPlayReport(0);
+    deviceReport.setSampleFifoReport(0);
+    deviceReport.setFileRecordReport(0);
 }
 
 void WebAPIRequestMapper::resetChannelSettings(SWGSDRangel::SWGChannelSettings& channelSettings)
@@ -16,10 +16,16 @@
 // along with this program. If not, see <http://www.gnu.org/licenses/>.          //
 ///////////////////////////////////////////////////////////////////////////////////
 
+#include <QCoreApplication>
 #include <QDebug>
 #include <QElapsedTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSysInfo>
 
 #include "mainbench.h"
+#include "dsp/inthalfbandfilterkernels.h"
 
 MainBench *MainBench::m_instance = 0;
 
@@ -28,7 +34,8 @@ MainBench::MainBench(qtwebapp::LoggerWithFile *logger, const ParserBench& parser
     m_logger(logger),
     m_parser(parser),
     m_uniform_distribution_f(-1.0, 1.0),
-    m_uniform_distribution_s16(-2048, 2047)
+    m_uniform_distribution_s16(-2048, 2047),
+    m_nbFailures(0)
 {
     qDebug() << "MainBench::MainBench: start";
     m_instance = this;
@@ -47,23 +54,73 @@ void MainBench::run()
         << " repet: " << m_parser.getRepetition()
         << " log2f: " << m_parser.getLog2Factor();
 
-    if (m_parser.getTestType() == ParserBench::TestDecimatorsII) {
+    if (m_parser.getTestType() == ParserBench::TestAll)
+    {
+        for (int testType = 0; testType < (int) ParserBench::TestAll; testType++) {
+            runTest((ParserBench::TestType) testType);
+        }
+    }
+    else
+    {
+        runTest(m_parser.getTestType());
+    }
+
+    if (!m_parser.getJsonFile().isEmpty()) {
+        writeJsonResults(m_parser.getJsonFile());
+    }
+
+    emit finished();
+}
+
+void MainBench::runTest(ParserBench::TestType testType)
+{
+    if (testType == ParserBench::TestDecimatorsII) {
         testDecimateII();
-    } else if (m_parser.getTestType() == ParserBench::TestDecimatorsInfII) {
+    } else if (testType == ParserBench::TestDecimatorsInfII) {
         testDecimateII(ParserBench::TestDecimatorsInfII);
-    } else if (m_parser.getTestType() == ParserBench::TestDecimatorsSupII) {
+    } else if (testType == ParserBench::TestDecimatorsSupII) {
         testDecimateII(ParserBench::TestDecimatorsSupII);
-    } else if (m_parser.getTestType() == ParserBench::TestDecimatorsIF) {
+    } else if (testType == ParserBench::TestDecimatorsIF) {
         testDecimateIF();
-    } else if (m_parser.getTestType() == ParserBench::TestDecimatorsFI) {
+    } else if (testType == ParserBench::TestDecimatorsFI) {
         testDecimateFI();
-    } else if (m_parser.getTestType() == ParserBench::TestDecimatorsFF) {
+    } else if (testType == ParserBench::TestDecimatorsFF) {
         testDecimateFF();
+    } else if (testType == ParserBench::TestChannelizer) {
+        testChannelizer();
+    } else if (testType == ParserBench::TestUpChannelizer) {
+        testUpChannelizer();
+    } else if (testType == ParserBench::TestInterpolator) {
+        testInterpolator();
+    } else if (testType == ParserBench::TestNCO) {
+        testNCO();
+    } else if (testType == ParserBench::TestFFTFilt) {
+        testFFTFilt();
+    } else if (testType == ParserBench::TestFFTEngine) {
+        testFFTEngine();
+    } else if (testType == ParserBench::TestSpectrumVis) {
+        testSpectrumVis();
+    } else if (testType == ParserBench::TestPhaseDiscriminators) {
+        testPhaseDiscriminators();
+    } else if (testType == ParserBench::TestAGC) {
+        testAGC();
+    } else if (testType == ParserBench::TestCTCSS) {
+        testCTCSS();
+    } else if (testType == ParserBench::TestAFSquelch) {
+        testAFSquelch();
+    } else if (testType == ParserBench::TestMixer) {
+        testMixer();
+    } else if (testType == ParserBench::TestUDP) {
+        testUDP();
+    } else if (testType == ParserBench::TestCodec) {
+        testCodec();
+    } else if (testType == ParserBench::TestFEC) {
+        testFEC();
+    } else if (testType == ParserBench::TestBroadcastFifo) {
+        testBroadcastFifo();
     } else {
-        qDebug() << "MainBench::run: unknown test type: " << m_parser.getTestType();
+        qDebug() << "MainBench::runTest: unknown test type: " << testType;
     }
-
-    emit finished();
 }
 
 void MainBench::testDecimateII(ParserBench::TestType testType)
@@ -80,30 +137,43 @@ void MainBench::testDecimateII(ParserBench::TestType testType)
 
     qDebug() << "MainBench::testDecimateII: run test";
 
-    for (uint32_t i = 0; i < m_parser.getRepetition(); i++)
+    IntHalfbandFilterKernels::ISA defaultISA = IntHalfbandFilterKernels::getISA();
+
+    for (int isa = 0; isa < (int) IntHalfbandFilterKernels::ISAEnd; isa++)
     {
-        switch (testType)
+        if (!IntHalfbandFilterKernels::setISA((IntHalfbandFilterKernels::ISA) isa)) {
+            continue; // not available on this CPU
+        }
+
+        nsecs = 0;
+
+        for (uint32_t i = 0; i < m_parser.getRepetition(); i++)
         {
-        case ParserBench::TestDecimatorsInfII:
-            timer.start();
-            decimateInfII(buf, m_parser.getNbSamples()*2);
-            nsecs += timer.nsecsElapsed();
-            break;
-        case ParserBench::TestDecimatorsSupII:
-            timer.start();
-            decimateSupII(buf, m_parser.getNbSamples()*2);
-            nsecs += timer.nsecsElapsed();
-            break;
-        case ParserBench::TestDecimatorsII:
-        default:
-            timer.start();
-            decimateII(buf, m_parser.getNbSamples()*2);
-            nsecs += timer.nsecsElapsed();
-            break;
+            switch (testType)
+            {
+            case ParserBench::TestDecimatorsInfII:
+                timer.start();
+                decimateInfII(buf, m_parser.getNbSamples()*2);
+                nsecs += timer.nsecsElapsed();
+                break;
+            case ParserBench::TestDecimatorsSupII:
+                timer.start();
+                decimateSupII(buf, m_parser.getNbSamples()*2);
+                nsecs += timer.nsecsElapsed();
+                break;
+            case ParserBench::TestDecimatorsII:
+            default:
+                timer.start();
+                decimateII(buf, m_parser.getNbSamples()*2);
+                nsecs += timer.nsecsElapsed();
+                break;
+            }
         }
+
+        printResults(QString("MainBench::testDecimateII (%1)").arg(IntHalfbandFilterKernels::getISAName((IntHalfbandFilterKernels::ISA) isa)), nsecs);
     }
 
-    printResults("MainBench::testDecimateII", nsecs);
+    IntHalfbandFilterKernels::setISA(defaultISA);
 
     qDebug() << "MainBench::testDecimateII: cleanup test data";
     delete[] buf;
@@ -382,10 +452,67 @@ void MainBench::decimateFF(const float *buf, int len)
     }
 }
 
-void MainBench::printResults(const QString& prefix, qint64 nsecs)
+void MainBench::printResults(const QString& prefix, qint64 nsecs, qint64 nbSamples)
 {
-    double ratekSs = (m_parser.getNbSamples()*m_parser.getRepetition() / (double) nsecs) * 1e6;
+    if (nbSamples < 0) {
+        nbSamples = (qint64) m_parser.getNbSamples() * m_parser.getRepetition();
+    }
+
+    double rateMSs = nsecs == 0 ? 0.0 : (nbSamples / (double) nsecs) * 1e3;
+    double nsPerSample = nbSamples == 0 ? 0.0 : nsecs / (double) nbSamples;
     QDebug info = qInfo();
     info.noquote();
-    info << tr("%1: ran test in %L2 ns - sample rate: %3 kS/s").arg(prefix).arg(nsecs).arg(ratekSs);
+    info << tr("%1: ran test in %L2 ns - sample rate: %3 MS/s - %4 ns/S").arg(prefix).arg(nsecs).arg(rateMSs).arg(nsPerSample);
+
+    QJsonObject result;
+    result.insert("test", prefix);
+    result.insert("nsecs", (double) nsecs);
+    result.insert("samples", (double) nbSamples);
+    result.insert("msps", rateMSs);
+    result.insert("nsPerSample", nsPerSample);
+    m_jsonResults.append(result);
+}
+
+void MainBench::checkResult(const QString& prefix, bool passed)
+{
+    QJsonObject result;
+    result.insert("test", prefix);
+    result.insert("passed", passed);
+    m_jsonResults.append(result);
+
+    if (passed)
+    {
+        qInfo().noquote() << prefix << ": passed";
+    }
+    else
+    {
+        qCritical().noquote() << prefix << ": FAILED";
+        m_nbFailures++;
+    }
+}
+
+void MainBench::writeJsonResults(const QString& fileName)
+{
+    QJsonObject root;
+    root.insert("application", QCoreApplication::applicationName());
+    root.insert("version", QCoreApplication::applicationVersion());
+    root.insert("cpuArchitecture", QSysInfo::currentCpuArchitecture());
+    root.insert("rxSampleBits", SDR_RX_SAMP_SZ);
+    root.insert("nbSamples", (double) m_parser.getNbSamples());
+    root.insert("repetition", (double) m_parser.getRepetition());
+    root.insert("log2Factor", (double) m_parser.getLog2Factor());
+    root.insert("failures", m_nbFailures);
+    root.insert("results", m_jsonResults);
+
+    QFile file(fileName);
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        qWarning() << "MainBench::writeJsonResults: cannot open " << fileName;
+        return;
+    }
+
+    file.write(QJsonDocument(root).toJson());
+    file.close();
+    qDebug() << "MainBench::writeJsonResults: results written to " << fileName;
 }
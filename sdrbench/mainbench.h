@@ -20,6 +20,7 @@
 #define SDRBENCH_MAINBENCH_H_
 
 #include <QObject>
+#include <QJsonArray>
 #include <random>
 #include <functional>
 
@@ -40,6 +41,8 @@ public:
     explicit MainBench(qtwebapp::LoggerWithFile *logger, const ParserBench& parser, QObject *parent = 0);
     ~MainBench();
 
+    int getNbFailures() const { return m_nbFailures; }
+
 public slots:
     void run();
 
@@ -51,13 +54,32 @@ private:
     void testDecimateIF();
     void testDecimateFI();
     void testDecimateFF();
+    void runTest(ParserBench::TestType testType);
+    void testChannelizer();
+    void testUpChannelizer();
+    void testInterpolator();
+    void testNCO();
+    void testFFTFilt();
+    void testFFTEngine();
+    void testSpectrumVis();
+    void testPhaseDiscriminators();
+    void testAGC();
+    void testCTCSS();
+    void testAFSquelch();
+    void testMixer();
+    void testUDP();
+    void testCodec();
+    void testFEC();
+    void testBroadcastFifo();
     void decimateII(const qint16 *buf, int len);
     void decimateInfII(const qint16 *buf, int len);
     void decimateSupII(const qint16 *buf, int len);
     void decimateIF(const qint16 *buf, int len);
     void decimateFI(const float *buf, int len);
     void decimateFF(const float *buf, int len);
-    void printResults(const QString& prefix, qint64 nsecs);
+    void printResults(const QString& prefix, qint64 nsecs, qint64 nbSamples = -1); //!< nbSamples defaults to samples times repetitions
+    void checkResult(const QString& prefix, bool passed); //!< log a correctness check and count failures
+    void writeJsonResults(const QString& fileName);
 
     static MainBench *m_instance;
     qtwebapp::LoggerWithFile *m_logger;
@@ -73,6 +95,8 @@ private:
 
     SampleVector m_convertBuffer;
     FSampleVector m_convertBufferF;
+    QJsonArray m_jsonResults;
+    int m_nbFailures;
 };
 
 #endif // SDRBENCH_MAINBENCH_H_
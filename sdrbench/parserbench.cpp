@@ -37,7 +37,11 @@ ParserBench::ParserBench() :
     m_log2FactorOption(QStringList() << "l" << "log2-factor",
         "Log2 factor for rate conversion.",
         "log2",
-        "2")
+        "2"),
+    m_jsonFileOption(QStringList() << "j" << "json",
+        "Write results to this JSON file.",
+        "file",
+        "")
 {
     m_testStr = "decimateii";
     m_nbSamples = 1048576;
@@ -52,6 +56,7 @@ ParserBench::ParserBench() :
     m_parser.addOption(m_nbSamplesOption);
     m_parser.addOption(m_repetitionOption);
     m_parser.addOption(m_log2FactorOption);
+    m_parser.addOption(m_jsonFileOption);
 }
 
 ParserBench::~ParserBench()
@@ -110,6 +115,10 @@ void ParserBench::parse(const QCoreApplication& app)
     } else {
         qWarning() << "ParserBench::parse: repetilog2 factortion invalid. Defaulting to " << m_log2Factor;
     }
+
+    // JSON results file
+
+    m_jsonFile = m_parser.value(m_jsonFileOption);
 }
 
 ParserBench::TestType ParserBench::getTestType() const
@@ -124,6 +133,40 @@ ParserBench::TestType ParserBench::getTestType() const
         return TestDecimatorsInfII;
     } else if (m_testStr == "decimatesupii") {
         return TestDecimatorsSupII;
+    } else if (m_testStr == "channelizer") {
+        return TestChannelizer;
+    } else if (m_testStr == "upchannelizer") {
+        return TestUpChannelizer;
+    } else if (m_testStr == "interpolator") {
+        return TestInterpolator;
+    } else if (m_testStr == "nco") {
+        return TestNCO;
+    } else if (m_testStr == "fftfilt") {
+        return TestFFTFilt;
+    } else if (m_testStr == "fftengine") {
+        return TestFFTEngine;
+    } else if (m_testStr == "spectrumvis") {
+        return TestSpectrumVis;
+    } else if (m_testStr == "phasediscri") {
+        return TestPhaseDiscriminators;
+    } else if (m_testStr == "agc") {
+        return TestAGC;
+    } else if (m_testStr == "ctcss") {
+        return TestCTCSS;
+    } else if (m_testStr == "afsquelch") {
+        return TestAFSquelch;
+    } else if (m_testStr == "mixer") {
+        return TestMixer;
+    } else if (m_testStr == "udp") {
+        return TestUDP;
+    } else if (m_testStr == "codec") {
+        return TestCodec;
+    } else if (m_testStr == "fec") {
+        return TestFEC;
+    } else if (m_testStr == "broadcastfifo") {
+        return TestBroadcastFifo;
+    } else if (m_testStr == "all") {
+        return TestAll;
     } else {
         return TestDecimatorsII;
     }
@@ -31,7 +31,24 @@ public:
         TestDecimatorsFI,
         TestDecimatorsFF,
         TestDecimatorsInfII,
-        TestDecimatorsSupII
+        TestDecimatorsSupII,
+        TestChannelizer,
+        TestUpChannelizer,
+        TestInterpolator,
+        TestNCO,
+        TestFFTFilt,
+        TestFFTEngine,
+        TestSpectrumVis,
+        TestPhaseDiscriminators,
+        TestAGC,
+        TestCTCSS,
+        TestAFSquelch,
+        TestMixer,
+        TestUDP,
+        TestCodec,
+        TestFEC,
+        TestBroadcastFifo,
+        TestAll
     } TestType;
 
     ParserBench();
@@ -44,18 +61,21 @@ public:
     uint32_t getNbSamples() const { return m_nbSamples; }
     uint32_t getRepetition() const { return m_repetition; }
     uint32_t getLog2Factor() const { return m_log2Factor; }
+    const QString& getJsonFile() const { return m_jsonFile; }
 
 private:
     QString  m_testStr;
     uint32_t m_nbSamples;
     uint32_t m_repetition;
     uint32_t m_log2Factor;
+    QString  m_jsonFile;
 
     QCommandLineParser m_parser;
     QCommandLineOption m_testOption;
     QCommandLineOption m_nbSamplesOption;
     QCommandLineOption m_repetitionOption;
     QCommandLineOption m_log2FactorOption;
+    QCommandLineOption m_jsonFileOption;
 };
 
 
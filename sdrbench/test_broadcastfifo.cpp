@@ -0,0 +1,136 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// Baseband broadcast FIFO check and benchmark                                   //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <QElapsedTimer>
+#include <QDebug>
+
+#include "dsp/samplesinkbroadcastfifo.h"
+#include "mainbench.h"
+
+namespace {
+
+// Samples carry their index so that losses and reordering can be seen by the readers
+Sample indexSample(quint32 index)
+{
+    return Sample((FixReal) (index & 0x7ff), (FixReal) ((index >> 11) & 0x7ff));
+}
+
+bool sameSample(const Sample& a, const Sample& b)
+{
+    return (a.m_real == b.m_real) && (a.m_imag == b.m_imag);
+}
+
+// Read everything available and count the samples that are not the expected ones
+uint readAll(SampleSinkBroadcastFifoReader *reader, quint32& next, qint64& errors)
+{
+    SampleVector::iterator part1Begin, part1End, part2Begin, part2End;
+    uint count = reader->readBegin(reader->fill(), &part1Begin, &part1End, &part2Begin, &part2End);
+
+    for (SampleVector::iterator it = part1Begin; it != part1End; ++it, next++) {
+        errors += !sameSample(*it, indexSample(next));
+    }
+
+    for (SampleVector::iterator it = part2Begin; it != part2End; ++it, next++) {
+        errors += !sameSample(*it, indexSample(next));
+    }
+
+    reader->readCommit(count);
+    return count;
+}
+
+} // namespace
+
+void MainBench::testBroadcastFifo()
+{
+    // A fast reader that keeps up and a slow dropping reader that holds each of its blocks
+    // while the writer goes on for more than the FIFO size. Blocks are read in place so the
+    // writer overwrites the blocks of the slow reader: every overwritten sample must be counted
+    // as dropped when the block is committed and the fast reader must not be affected.
+    const uint fifoSize = 1<<16;
+    const uint writeSize = 4096;
+    const uint slowPeriod = 64;   // writes between two blocks of the slow reader
+    const uint slowHold = 32;     // writes while the slow reader holds its block
+    uint nbWrites = (m_parser.getNbSamples() / writeSize) * m_parser.getRepetition();
+    nbWrites = std::max(nbWrites, 2 * slowPeriod);
+
+    qDebug() << "MainBench::testBroadcastFifo: create test data";
+
+    SampleSinkBroadcastFifo fifo(fifoSize);
+    SampleSinkBroadcastFifoReader *fast = fifo.addReader(SampleSinkBroadcastFifoReader::PolicyDrop);
+    SampleSinkBroadcastFifoReader *slow = fifo.addReader(SampleSinkBroadcastFifoReader::PolicyDrop);
+    SampleVector block(writeSize);
+    SampleVector::iterator slowBegin, slowEnd, slowPart2Begin, slowPart2End;
+    quint32 index = 0;
+    quint32 fastNext = 0;
+    qint64 fastErrors = 0;
+    qint64 fastRead = 0;
+    qint64 slowErrors = 0;
+    qint64 slowOverwritten = 0;
+    uint slowCount = 0;
+    quint32 slowNext = 0;
+    QElapsedTimer timer;
+    qint64 nsecs = 0;
+
+    qDebug() << "MainBench::testBroadcastFifo: run test";
+
+    for (uint i = 0; i < nbWrites; i++)
+    {
+        for (uint k = 0; k < writeSize; k++, index++) {
+            block[k] = indexSample(index);
+        }
+
+        timer.start();
+        fifo.write(block.begin(), block.end());
+
+        if (i % slowPeriod == 0)
+        {
+            // the block starts where the unread samples of the slow reader start
+            slowCount = slow->readBegin(slow->fill(), &slowBegin, &slowEnd, &slowPart2Begin, &slowPart2End);
+            slowNext = index - slow->fill();
+        }
+        else if (i % slowPeriod == slowHold)
+        {
+            // samples that are not the ones of the block when it was taken must be counted as dropped
+            quint64 droppedBefore = slow->getDroppedSamples();
+
+            for (SampleVector::iterator it = slowBegin; it != slowEnd; ++it, slowNext++) {
+                slowErrors += !sameSample(*it, indexSample(slowNext));
+            }
+
+            for (SampleVector::iterator it = slowPart2Begin; it != slowPart2End; ++it, slowNext++) {
+                slowErrors += !sameSample(*it, indexSample(slowNext));
+            }
+
+            slow->readCommit(slowCount);
+            slowOverwritten += slow->getDroppedSamples() - droppedBefore;
+        }
+
+        fastRead += readAll(fast, fastNext, fastErrors);
+        nsecs += timer.nsecsElapsed();
+    }
+
+    printResults("MainBench::testBroadcastFifo: write and read", nsecs, (qint64) nbWrites * writeSize);
+    checkResult(QString("MainBench::testBroadcastFifo: fast reader read %1 of %2 samples with %3 errors")
+        .arg(fastRead).arg(index).arg(fastErrors),
+        (fastRead == index) && (fastErrors == 0) && (fast->getDroppedSamples() == 0) && (fifo.getOverflowSamples() == 0));
+    checkResult(QString("MainBench::testBroadcastFifo: slow reader dropped %1 samples with %2 overwritten of which %3 detected in held blocks")
+        .arg(slow->getDroppedSamples()).arg(slowErrors).arg(slowOverwritten),
+        (slowErrors > 0) && (slowErrors <= slowOverwritten));
+
+    qDebug() << "MainBench::testBroadcastFifo: cleanup test data";
+}
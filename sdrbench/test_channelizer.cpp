@@ -0,0 +1,222 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// Channelizers benchmark                                                        //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+
+#include <QElapsedTimer>
+#include <QDebug>
+
+#include "dsp/downchannelizer.h"
+#include "dsp/upchannelizer.h"
+#include "dsp/basebandsamplesource.h"
+#include "dsp/channelizerbank.h"
+#include "dsp/dspcommands.h"
+#include "dsp/nullsink.h"
+#include "mainbench.h"
+
+namespace
+{
+
+/**
+ * Channel source replaying a sample vector in a loop
+ */
+class BenchSampleSource : public BasebandSampleSource
+{
+public:
+    BenchSampleSource(const SampleVector& samples) :
+        m_samples(samples),
+        m_index(0)
+    {}
+
+    virtual void start() {}
+    virtual void stop() {}
+
+    virtual void pull(Sample& sample)
+    {
+        sample = m_samples[m_index];
+        m_index = m_index + 1 < m_samples.size() ? m_index + 1 : 0;
+    }
+
+    virtual bool handleMessage(const Message& cmd)
+    {
+        (void) cmd;
+        return true; // discard sample rate notifications
+    }
+
+private:
+    const SampleVector& m_samples;
+    unsigned int m_index;
+};
+
+} // namespace
+
+void MainBench::testChannelizer()
+{
+    // 16 kS/s channels on a 25 kHz raster around the center of a 2.048 MS/s baseband.
+    // The sample rate is a multiple of the filter bank size so that all channels fit in a bank channel.
+    const int sampleRate = 2048000;
+    const int channelSampleRate = 16000;
+    const int channelSpacing = 25000;
+    const unsigned int blockSize = 16384;
+
+    qDebug() << "MainBench::testChannelizer: create test data";
+
+    SampleVector samples(m_parser.getNbSamples());
+    auto my_rand = std::bind(m_uniform_distribution_s16, m_generator);
+
+    for (SampleVector::iterator it = samples.begin(); it != samples.end(); ++it)
+    {
+        it->setReal(my_rand());
+        it->setImag(my_rand());
+    }
+
+    qDebug() << "MainBench::testChannelizer: run test";
+
+    for (int nbChannels = 1; nbChannels <= 64; nbChannels *= 2)
+    {
+        std::vector<NullSink*> sinks;
+        std::vector<DownChannelizer*> chains;
+        std::vector<DownChannelizer*> bankChains;
+        std::vector<int> bankChannels;
+        ChannelizerBank bank;
+        DSPSignalNotification notif(sampleRate, 0);
+        bank.setSampleRate(sampleRate);
+
+        for (int i = 0; i < nbChannels; i++)
+        {
+            int centerFrequency = (i - nbChannels/2) * channelSpacing;
+            DSPConfigureChannelizer config(channelSampleRate, centerFrequency);
+
+            sinks.push_back(new NullSink());
+            chains.push_back(new DownChannelizer(sinks.back()));
+            chains.back()->handleMessage(notif);
+            chains.back()->handleMessage(config);
+
+            int channel = bank.getChannelIndex(centerFrequency, channelSampleRate);
+            bank.addChannel(channel);
+            bankChannels.push_back(channel);
+            DownChannelizer::MsgChannelizerBankInput bankInput(bank.getChannelSampleRate(), bank.getChannelFrequency(channel));
+            bankChains.push_back(new DownChannelizer(sinks.back()));
+            bankChains.back()->handleMessage(notif);
+            bankChains.back()->handleMessage(bankInput);
+            bankChains.back()->handleMessage(config);
+        }
+
+        QElapsedTimer timer;
+        qint64 nsecsChains = 0;
+        qint64 nsecsBank = 0;
+
+        for (uint32_t r = 0; r < m_parser.getRepetition(); r++)
+        {
+            // one half band chain per channel from the baseband
+            timer.start();
+
+            for (unsigned int i = 0; i < samples.size(); i += blockSize)
+            {
+                SampleVector::const_iterator begin = samples.begin() + i;
+                SampleVector::const_iterator end = samples.begin() + std::min(i + blockSize, (unsigned int) samples.size());
+
+                for (int c = 0; c < nbChannels; c++) {
+                    chains[c]->feed(begin, end, false);
+                }
+            }
+
+            nsecsChains += timer.nsecsElapsed();
+
+            // filter bank then remaining half band stages from the bank channel
+            timer.start();
+
+            for (unsigned int i = 0; i < samples.size(); i += blockSize)
+            {
+                SampleVector::const_iterator begin = samples.begin() + i;
+                SampleVector::const_iterator end = samples.begin() + std::min(i + blockSize, (unsigned int) samples.size());
+                bank.feed(begin, end);
+
+                for (int c = 0; c < nbChannels; c++)
+                {
+                    const SampleVector& channelSamples = bank.getChannelSamples(bankChannels[c]);
+                    bankChains[c]->feed(channelSamples.begin(), channelSamples.end(), false);
+                }
+            }
+
+            nsecsBank += timer.nsecsElapsed();
+        }
+
+        printResults(QString("MainBench::testChannelizer: %1 channels: DownChannelizer").arg(nbChannels), nsecsChains);
+        printResults(QString("MainBench::testChannelizer: %1 channels: ChannelizerBank").arg(nbChannels), nsecsBank);
+
+        for (int i = 0; i < nbChannels; i++)
+        {
+            delete chains[i];
+            delete bankChains[i];
+            delete sinks[i];
+        }
+    }
+
+    qDebug() << "MainBench::testChannelizer: cleanup test data";
+}
+
+void MainBench::testUpChannelizer()
+{
+    // channel interpolated up to a 2.048 MS/s baseband at a 100 kHz offset
+    const int sampleRate = 2048000;
+    const int channelSampleRates[] = {48000, 192000, 1024000};
+    const int centerFrequency = 100000;
+
+    qDebug() << "MainBench::testUpChannelizer: create test data";
+
+    SampleVector samples(m_parser.getNbSamples());
+    auto my_rand = std::bind(m_uniform_distribution_s16, m_generator);
+
+    for (SampleVector::iterator it = samples.begin(); it != samples.end(); ++it)
+    {
+        it->setReal(my_rand());
+        it->setImag(my_rand());
+    }
+
+    qDebug() << "MainBench::testUpChannelizer: run test";
+
+    for (unsigned int r = 0; r < sizeof(channelSampleRates)/sizeof(channelSampleRates[0]); r++)
+    {
+        BenchSampleSource source(samples);
+        UpChannelizer channelizer(&source);
+        DSPSignalNotification notif(sampleRate, 0);
+        DSPConfigureChannelizer config(channelSampleRates[r], centerFrequency);
+        channelizer.handleMessage(notif);
+        channelizer.handleMessage(config);
+
+        QElapsedTimer timer;
+        qint64 nsecs = 0;
+        Sample sample;
+
+        for (uint32_t i = 0; i < m_parser.getRepetition(); i++)
+        {
+            timer.start();
+
+            for (uint32_t n = 0; n < m_parser.getNbSamples(); n++) {
+                channelizer.pull(sample);
+            }
+
+            nsecs += timer.nsecsElapsed();
+        }
+
+        printResults(QString("MainBench::testUpChannelizer: %1 S/s").arg(channelSampleRates[r]), nsecs);
+    }
+
+    qDebug() << "MainBench::testUpChannelizer: cleanup test data";
+}
@@ -0,0 +1,112 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// SDRdaemon sample codec benchmark                                              //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+#include <vector>
+#include <cstdlib>
+
+#include <QElapsedTimer>
+#include <QDebug>
+
+#include "dsp/dsptypes.h"
+#include "channel/sdrdaemondatablock.h"
+#include "channel/sdrdaemoncodec.h"
+#include "mainbench.h"
+
+void MainBench::testCodec()
+{
+    // 12 bit ADC like samples coded block by block as done before FEC in the SDRdaemon streams
+    const int sampleBytes = sizeof(FixReal);
+    const int sampleBits = 12; // significant bits with sign of the test data
+    const SDRDaemonCodec::CodecType codecTypes[] = {
+        SDRDaemonCodec::CodecNone, SDRDaemonCodec::CodecPacked, SDRDaemonCodec::CodecPacked,
+        SDRDaemonCodec::CodecBFP, SDRDaemonCodec::CodecBFP, SDRDaemonCodec::CodecBFP
+    };
+    const int codecBits[] = {16, 12, 16, 6, 8, 10};
+    const char *codecNames[] = {"none", "packed", "bfp"};
+
+    qDebug() << "MainBench::testCodec: create test data";
+
+    SampleVector inBuffer(m_parser.getNbSamples());
+    SampleVector outBuffer(m_parser.getNbSamples() + SDRDaemonNbBytesPerBlock);
+    std::vector<SDRDaemonProtectedBlock> blocks;
+    auto my_rand = std::bind(m_uniform_distribution_s16, m_generator);
+
+    for (SampleVector::iterator it = inBuffer.begin(); it != inBuffer.end(); ++it)
+    {
+        it->m_real = my_rand();
+        it->m_imag = my_rand();
+    }
+
+    qDebug() << "MainBench::testCodec: run test";
+
+    for (unsigned int ic = 0; ic < sizeof(codecBits) / sizeof(int); ic++)
+    {
+        SDRDaemonCodec codec;
+        codec.setCodec(codecTypes[ic], codecBits[ic], sampleBytes);
+        int samplesPerBlock = codec.getNbSamplesPerBlock();
+        int nbBlocks = m_parser.getNbSamples() / samplesPerBlock; // complete blocks only
+        qint64 nbSamples = (qint64) nbBlocks * samplesPerBlock * m_parser.getRepetition();
+        blocks.resize(nbBlocks);
+        QElapsedTimer timer;
+        qint64 encodeNsecs = 0;
+        qint64 decodeNsecs = 0;
+
+        for (uint32_t i = 0; i < m_parser.getRepetition(); i++)
+        {
+            timer.start();
+
+            for (int ib = 0; ib < nbBlocks; ib++) {
+                codec.encode((const uint8_t *) &inBuffer[ib * samplesPerBlock], blocks[ib].buf);
+            }
+
+            encodeNsecs += timer.nsecsElapsed();
+            timer.start();
+
+            for (int ib = 0; ib < nbBlocks; ib++) {
+                codec.decode(blocks[ib].buf, (uint8_t *) &outBuffer[ib * samplesPerBlock]);
+            }
+
+            decodeNsecs += timer.nsecsElapsed();
+        }
+
+        int maxError = 0;
+
+        for (int is = 0; is < nbBlocks * samplesPerBlock; is++)
+        {
+            maxError = std::max(maxError, std::abs(inBuffer[is].m_real - outBuffer[is].m_real));
+            maxError = std::max(maxError, std::abs(inBuffer[is].m_imag - outBuffer[is].m_imag));
+        }
+
+        // raw and packed samples must be decoded bit exact, block floating point within its bound
+        int maxAllowedError = 0;
+
+        if ((codec.getCodecType() == SDRDaemonCodec::CodecBFP) && (sampleBits > codec.getNbBits())) {
+            maxAllowedError = 1 << (sampleBits - codec.getNbBits());
+        }
+
+        QString codecStr = QString("%1 %2 bits ratio %3 max error %4")
+            .arg(codecNames[codec.getCodecType()])
+            .arg(codec.getNbBits())
+            .arg(codec.getCompressionRatio())
+            .arg(maxError);
+        printResults(QString("MainBench::testCodec: encode %1").arg(codecStr), encodeNsecs, nbSamples);
+        printResults(QString("MainBench::testCodec: decode %1").arg(codecStr), decodeNsecs, nbSamples);
+        checkResult(QString("MainBench::testCodec: %1 (allowed %2)").arg(codecStr).arg(maxAllowedError), maxError <= maxAllowedError);
+    }
+
+    qDebug() << "MainBench::testCodec: cleanup test data";
+}
@@ -0,0 +1,213 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// Demodulator building blocks benchmark                                         //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+
+#include <QElapsedTimer>
+#include <QDebug>
+
+#include "dsp/phasediscri.h"
+#include "dsp/agc.h"
+#include "dsp/ctcssdetector.h"
+#include "dsp/afsquelch.h"
+#include "mainbench.h"
+
+void MainBench::testPhaseDiscriminators()
+{
+    qDebug() << "MainBench::testPhaseDiscriminators: create test data";
+
+    std::vector<Complex> samples(m_parser.getNbSamples());
+    auto my_rand = std::bind(m_uniform_distribution_f, m_generator);
+
+    for (std::vector<Complex>::iterator it = samples.begin(); it != samples.end(); ++it) {
+        *it = Complex(my_rand(), my_rand());
+    }
+
+    qDebug() << "MainBench::testPhaseDiscriminators: run test";
+
+    PhaseDiscriminators phaseDiscri;
+    phaseDiscri.setFMScaling(48000.0f / 5000.0f);
+    QElapsedTimer timer;
+    Real acc = 0;
+
+    for (int discri = 0; discri < 3; discri++)
+    {
+        qint64 nsecs = 0;
+        phaseDiscri.reset();
+
+        for (uint32_t i = 0; i < m_parser.getRepetition(); i++)
+        {
+            double magsq;
+            Real fmDev;
+            timer.start();
+
+            switch (discri)
+            {
+            case 0:
+                for (std::vector<Complex>::const_iterator it = samples.begin(); it != samples.end(); ++it) {
+                    acc += phaseDiscri.phaseDiscriminator(*it);
+                }
+                break;
+            case 1:
+                for (std::vector<Complex>::const_iterator it = samples.begin(); it != samples.end(); ++it) {
+                    acc += phaseDiscri.phaseDiscriminatorDelta(*it, magsq, fmDev);
+                }
+                break;
+            case 2:
+            default:
+                for (std::vector<Complex>::const_iterator it = samples.begin(); it != samples.end(); ++it) {
+                    acc += phaseDiscri.phaseDiscriminator2(*it);
+                }
+                break;
+            }
+
+            nsecs += timer.nsecsElapsed();
+        }
+
+        printResults(QString("MainBench::testPhaseDiscriminators: phaseDiscriminator%1").arg(discri == 0 ? "" : discri == 1 ? "Delta" : "2"), nsecs);
+    }
+
+    qDebug() << "MainBench::testPhaseDiscriminators: cleanup test data: " << acc;
+}
+
+void MainBench::testAGC()
+{
+    qDebug() << "MainBench::testAGC: create test data";
+
+    std::vector<Complex> samples(m_parser.getNbSamples());
+    auto my_rand = std::bind(m_uniform_distribution_f, m_generator);
+
+    for (std::vector<Complex>::iterator it = samples.begin(); it != samples.end(); ++it) {
+        *it = Complex(my_rand(), my_rand()) * (Real) SDR_RX_SCALEF;
+    }
+
+    qDebug() << "MainBench::testAGC: run test";
+
+    // set up as in the SSB demodulator with 200 ms AGC at 48 kS/s
+    double agcTarget = 3276.8;
+    int agcNbSamples = 9600;
+    MagAGC agc(agcNbSamples, agcTarget, 1e-2);
+    agc.resize(agcNbSamples, agcNbSamples/2, agcTarget);
+    agc.setStepDownDelay(agcNbSamples);
+    agc.setClampMax(SDR_RX_SCALED/100.0);
+    agc.setClamping(true);
+    agc.setThresholdEnable(true);
+    agc.setGate(192);
+
+    QElapsedTimer timer;
+    qint64 nsecs = 0;
+    double acc = 0;
+
+    for (uint32_t i = 0; i < m_parser.getRepetition(); i++)
+    {
+        timer.start();
+
+        for (std::vector<Complex>::const_iterator it = samples.begin(); it != samples.end(); ++it) {
+            acc += agc.feedAndGetValue(*it) * agc.getStepValue();
+        }
+
+        nsecs += timer.nsecsElapsed();
+    }
+
+    printResults("MainBench::testAGC: MagAGC", nsecs);
+
+    qDebug() << "MainBench::testAGC: cleanup test data: " << acc;
+}
+
+void MainBench::testCTCSS()
+{
+    const int sampleRate = 6000; // NFM audio rate decimated by 8
+
+    qDebug() << "MainBench::testCTCSS: create test data";
+
+    std::vector<Real> samples(m_parser.getNbSamples());
+    auto my_rand = std::bind(m_uniform_distribution_f, m_generator);
+
+    for (uint32_t i = 0; i < samples.size(); i++) {
+        samples[i] = 0.5f * sin(2.0 * M_PI * 88.5 * i / sampleRate) + 0.1f * my_rand(); // 88.5 Hz tone in noise
+    }
+
+    qDebug() << "MainBench::testCTCSS: run test";
+
+    CTCSSDetector ctcssDetector;
+    ctcssDetector.setCoefficients(sampleRate/2, sampleRate); // 0.5s / 2 Hz resolution
+    QElapsedTimer timer;
+    qint64 nsecs = 0;
+    int nbDetections = 0;
+
+    for (uint32_t i = 0; i < m_parser.getRepetition(); i++)
+    {
+        timer.start();
+
+        for (std::vector<Real>::iterator it = samples.begin(); it != samples.end(); ++it)
+        {
+            if (ctcssDetector.analyze(&(*it))) {
+                nbDetections++;
+            }
+        }
+
+        nsecs += timer.nsecsElapsed();
+    }
+
+    printResults("MainBench::testCTCSS: CTCSSDetector", nsecs);
+
+    qDebug() << "MainBench::testCTCSS: cleanup test data: " << nbDetections << " detections";
+}
+
+void MainBench::testAFSquelch()
+{
+    const int sampleRate = 48000;
+    const double afSqTones[2] = {1000.0, 6000.0};
+
+    qDebug() << "MainBench::testAFSquelch: create test data";
+
+    std::vector<double> samples(m_parser.getNbSamples());
+    auto my_rand = std::bind(m_uniform_distribution_f, m_generator);
+
+    for (std::vector<double>::iterator it = samples.begin(); it != samples.end(); ++it) {
+        *it = my_rand();
+    }
+
+    qDebug() << "MainBench::testAFSquelch: run test";
+
+    // set up as in the NFM demodulator
+    AFSquelch afSquelch;
+    afSquelch.setCoefficients(sampleRate/2000, 600, sampleRate, 200, 0, afSqTones);
+    afSquelch.setThreshold(0.5);
+    QElapsedTimer timer;
+    qint64 nsecs = 0;
+    int nbOpen = 0;
+
+    for (uint32_t i = 0; i < m_parser.getRepetition(); i++)
+    {
+        timer.start();
+
+        for (std::vector<double>::const_iterator it = samples.begin(); it != samples.end(); ++it)
+        {
+            if (afSquelch.analyze(*it) && afSquelch.evaluate()) {
+                nbOpen++;
+            }
+        }
+
+        nsecs += timer.nsecsElapsed();
+    }
+
+    printResults("MainBench::testAFSquelch: AFSquelch", nsecs);
+
+    qDebug() << "MainBench::testAFSquelch: cleanup test data: " << nbOpen << " open";
+}
@@ -0,0 +1,268 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// DATV FEC decoders benchmark                                                   //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+#include <vector>
+
+#include <QElapsedTimer>
+#include <QDebug>
+
+#include "leansdr/framework.h"
+#include "leansdr/generic.h"
+#include "leansdr/dsp.h"
+#include "leansdr/sdr.h"
+#include "leansdr/dvb.h"
+#include "leansdr/rs.h"
+#include "dsp/viterbik7kernels.h"
+#include "mainbench.h"
+
+namespace {
+
+typedef leansdr::viterbi_dec_interface<uint8_t, uint8_t, int32_t, int32_t> FECDecoder;
+
+// Coded symbols of the uncoded bits as expected by the leansdr trellis:
+// the first bit of a puncturing period is the oldest in the shift register.
+void fecEncode(const leansdr::fec_spec *fs, const std::vector<uint8_t>& bits, std::vector<uint8_t>& symbols)
+{
+    uint32_t state = 0;
+    symbols.resize(bits.size() / fs->bits_in);
+
+    for (unsigned int is = 0; is < symbols.size(); is++)
+    {
+        uint32_t reg = state;
+
+        for (int t = 0; t < fs->bits_in; t++) {
+            reg |= bits[is * fs->bits_in + t] << (6 + t);
+        }
+
+        uint8_t cs = 0;
+
+        for (int g = 0; g < fs->bits_out; g++) {
+            cs = (cs << 1) | leansdr::parity((uint16_t) (reg & fs->polys[g]));
+        }
+
+        symbols[is] = cs;
+        state = reg >> fs->bits_in;
+    }
+}
+
+// Decode and count the bit errors at the decoding delay that gives the fewest errors
+qint64 fecDecode(FECDecoder *decoder, const leansdr::fec_spec *fs, const std::vector<uint8_t>& symbols,
+    const std::vector<uint8_t>& bits, int& errors)
+{
+    QElapsedTimer timer;
+    std::vector<uint8_t> decoded(bits.size());
+    timer.start();
+
+    for (unsigned int is = 0; is < symbols.size(); is++)
+    {
+        int32_t quality;
+        uint8_t us = decoder->update(symbols[is], -16384, &quality); // clean QPSK symbol cost
+
+        for (int t = 0; t < fs->bits_in; t++) {
+            decoded[is * fs->bits_in + t] = (us >> (fs->bits_in - 1 - t)) & 1;
+        }
+    }
+
+    qint64 nsecs = timer.nsecsElapsed();
+    unsigned int window = std::min((unsigned int) bits.size() / 2, 8192U);
+    unsigned int bestDelay = 0;
+    int bestErrors = window;
+
+    for (unsigned int delay = 0; delay < 256 && delay < window; delay++)
+    {
+        int e = 0;
+
+        for (unsigned int i = 0; i < window; i++) {
+            e += decoded[i + delay] != bits[i];
+        }
+
+        if (e < bestErrors)
+        {
+            bestErrors = e;
+            bestDelay = delay;
+        }
+    }
+
+    errors = 0;
+
+    for (unsigned int i = 0; i + bestDelay < bits.size(); i++) {
+        errors += decoded[i + bestDelay] != bits[i];
+    }
+
+    return nsecs;
+}
+
+} // namespace
+
+void MainBench::testFEC()
+{
+    typedef leansdr::viterbi_sync VS;
+    const leansdr::code_rate rates[] = {leansdr::FEC12, leansdr::FEC34, leansdr::FEC78};
+    const char *rateNames[] = {"1/2", "3/4", "7/8"};
+    const double channelBER = 0.005;
+
+    qDebug() << "MainBench::testFEC: create test data";
+
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+    std::vector<uint8_t> bits(m_parser.getNbSamples() - m_parser.getNbSamples() % 420); // multiple of all bits_in
+    std::vector<uint8_t> symbols;
+
+    for (unsigned int i = 0; i < bits.size(); i++) {
+        bits[i] = m_generator() & 1;
+    }
+
+    qDebug() << "MainBench::testFEC: run Viterbi test";
+
+    ViterbiK7Kernels::ISA defaultISA = ViterbiK7Kernels::getISA();
+
+    for (unsigned int ir = 0; ir < sizeof(rates) / sizeof(rates[0]); ir++)
+    {
+        leansdr::fec_spec *fs = &leansdr::fec_specs[rates[ir]];
+        fecEncode(fs, bits, symbols);
+
+        // Flip the coded bits at the channel error rate
+        for (unsigned int is = 0; is < symbols.size(); is++)
+        {
+            for (int g = 0; g < fs->bits_out; g++)
+            {
+                if (uniform(m_generator) < channelBER) {
+                    symbols[is] ^= 1 << g;
+                }
+            }
+        }
+
+        qint64 nbBits = (qint64) bits.size() * m_parser.getRepetition();
+        qint64 nsecs = 0;
+        int errors = 0;
+
+        for (uint32_t i = 0; i < m_parser.getRepetition(); i++)
+        {
+            FECDecoder *decoder;
+
+            if (rates[ir] == leansdr::FEC12)
+            {
+                VS::trellis_12 *trellis = new VS::trellis_12();
+                trellis->init_convolutional(fs->polys);
+                decoder = new VS::dvb_dec_12(trellis);
+            }
+            else if (rates[ir] == leansdr::FEC34)
+            {
+                VS::trellis_34 *trellis = new VS::trellis_34();
+                trellis->init_convolutional(fs->polys);
+                decoder = new VS::dvb_dec_34(trellis);
+            }
+            else
+            {
+                VS::trellis_78 *trellis = new VS::trellis_78();
+                trellis->init_convolutional(fs->polys);
+                decoder = new VS::dvb_dec_78(trellis);
+            }
+
+            nsecs += fecDecode(decoder, fs, symbols, bits, errors);
+            delete decoder; // the trellis is leaked as in viterbi_sync
+        }
+
+        printResults(QString("MainBench::testFEC: Viterbi %1 trellis (Mbit/s) errors %2/%3")
+            .arg(rateNames[ir]).arg(errors).arg(bits.size()), nsecs, nbBits);
+
+        for (int isa = 0; isa < (int) ViterbiK7Kernels::ISAEnd; isa++)
+        {
+            if (!ViterbiK7Kernels::setISA((ViterbiK7Kernels::ISA) isa)) {
+                continue; // not available on this CPU
+            }
+
+            nsecs = 0;
+
+            for (uint32_t i = 0; i < m_parser.getRepetition(); i++)
+            {
+                FECDecoder *decoder = new leansdr::viterbi_k7_dec<uint8_t, uint8_t, int32_t, int32_t>(
+                    fs->polys, fs->bits_in, fs->bits_out, leansdr::DVBS_G1, leansdr::DVBS_G2);
+                nsecs += fecDecode(decoder, fs, symbols, bits, errors);
+                delete decoder;
+            }
+
+            printResults(QString("MainBench::testFEC: Viterbi %1 K7 %2 (Mbit/s) errors %3/%4")
+                .arg(rateNames[ir])
+                .arg(ViterbiK7Kernels::getISAName((ViterbiK7Kernels::ISA) isa))
+                .arg(errors).arg(bits.size()), nsecs, nbBits);
+        }
+    }
+
+    ViterbiK7Kernels::setISA(defaultISA);
+
+    qDebug() << "MainBench::testFEC: run Reed-Solomon test";
+
+    leansdr::rs_engine rs;
+    const int nbPackets = std::max(1, (int) (m_parser.getNbSamples() / (leansdr::SIZE_RSPACKET * 8)));
+    std::vector<leansdr::u8> packets(nbPackets * leansdr::SIZE_RSPACKET);
+
+    for (unsigned int i = 0; i < packets.size(); i++) {
+        packets[i] = m_generator() & 0xFF;
+    }
+
+    for (int ip = 0; ip < nbPackets; ip++) {
+        rs.encode(&packets[ip * leansdr::SIZE_RSPACKET]);
+    }
+
+    for (int withErrors = 0; withErrors < 2; withErrors++)
+    {
+        if (withErrors)
+        {
+            // 4 byte errors in every other packet
+            for (int ip = 0; ip < nbPackets; ip += 2) {
+                for (int ie = 0; ie < 4; ie++) {
+                    packets[ip * leansdr::SIZE_RSPACKET + (m_generator() % leansdr::SIZE_RSPACKET)] ^= 1 + m_generator() % 255;
+                }
+            }
+        }
+
+        qint64 nbBits = (qint64) nbPackets * leansdr::SIZE_RSPACKET * 8 * m_parser.getRepetition();
+
+        for (int fast = 0; fast < 2; fast++)
+        {
+            QElapsedTimer timer;
+            qint64 nsecs = 0;
+            int corrupted = 0;
+
+            for (uint32_t i = 0; i < m_parser.getRepetition(); i++)
+            {
+                timer.start();
+                corrupted = 0;
+
+                for (int ip = 0; ip < nbPackets; ip++)
+                {
+                    const leansdr::u8 *packet = &packets[ip * leansdr::SIZE_RSPACKET];
+                    leansdr::u8 synd[16];
+
+                    if (fast) {
+                        corrupted += !rs.divisible(packet) && rs.syndromes_table(packet, synd);
+                    } else {
+                        corrupted += rs.syndromes(packet, synd);
+                    }
+                }
+
+                nsecs += timer.nsecsElapsed();
+            }
+
+            printResults(QString("MainBench::testFEC: RS check %1 %2 (Mbit/s) corrupted %3/%4")
+                .arg(fast ? "fast" : "generic")
+                .arg(withErrors ? "with errors" : "error free")
+                .arg(corrupted).arg(nbPackets), nsecs, nbBits);
+        }
+    }
+
+    qDebug() << "MainBench::testFEC: cleanup test data";
+}
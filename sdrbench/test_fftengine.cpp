@@ -0,0 +1,83 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// FFT engines benchmark                                                         //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+
+#include <QElapsedTimer>
+#include <QDebug>
+
+#include "dsp/kissengine.h"
+#ifdef USE_FFTW
+#include "dsp/fftwengine.h"
+#endif
+#include "mainbench.h"
+
+void MainBench::testFFTEngine()
+{
+    const int fftSizes[] = {256, 1024, 4096, 16384};
+    std::vector<std::pair<QString, FFTEngine*> > engines;
+
+    qDebug() << "MainBench::testFFTEngine: create test data";
+
+    engines.push_back(std::pair<QString, FFTEngine*>("KissEngine", new KissEngine));
+#ifdef USE_FFTW
+    engines.push_back(std::pair<QString, FFTEngine*>("FFTWEngine", new FFTWEngine));
+#endif
+    auto my_rand = std::bind(m_uniform_distribution_f, m_generator);
+
+    qDebug() << "MainBench::testFFTEngine: run test";
+
+    for (unsigned int s = 0; s < sizeof(fftSizes)/sizeof(fftSizes[0]); s++)
+    {
+        int fftSize = fftSizes[s];
+        uint32_t nbTransforms = std::max(1U, m_parser.getNbSamples() / fftSize);
+
+        for (unsigned int e = 0; e < engines.size(); e++)
+        {
+            FFTEngine *engine = engines[e].second;
+            engine->configure(fftSize, false); // plan creation is not timed
+
+            for (int i = 0; i < fftSize; i++) {
+                engine->in()[i] = Complex(my_rand(), my_rand());
+            }
+
+            QElapsedTimer timer;
+            qint64 nsecs = 0;
+
+            for (uint32_t i = 0; i < m_parser.getRepetition(); i++)
+            {
+                timer.start();
+
+                for (uint32_t n = 0; n < nbTransforms; n++) {
+                    engine->transform();
+                }
+
+                nsecs += timer.nsecsElapsed();
+            }
+
+            printResults(QString("MainBench::testFFTEngine: %1: %2 points").arg(engines[e].first).arg(fftSize),
+                nsecs, (qint64) nbTransforms * fftSize * m_parser.getRepetition());
+        }
+    }
+
+    qDebug() << "MainBench::testFFTEngine: cleanup test data";
+
+    for (unsigned int e = 0; e < engines.size(); e++) {
+        delete engines[e].second;
+    }
+}
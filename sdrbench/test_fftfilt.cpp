@@ -0,0 +1,81 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// FFT filter benchmark                                                          //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <QElapsedTimer>
+#include <QDebug>
+
+#include "dsp/fftfilt.h"
+#include "mainbench.h"
+
+void MainBench::testFFTFilt()
+{
+    qDebug() << "MainBench::testFFTFilt: create test data";
+
+    std::vector<Complex> samples(m_parser.getNbSamples());
+    auto my_rand = std::bind(m_uniform_distribution_f, m_generator);
+
+    for (std::vector<Complex>::iterator it = samples.begin(); it != samples.end(); ++it) {
+        *it = Complex(my_rand(), my_rand());
+    }
+
+    qDebug() << "MainBench::testFFTFilt: run test";
+
+    QElapsedTimer timer;
+    fftfilt::cmplx *out;
+    int nbOut = 0;
+
+    // band pass as in the channel analyzer
+    {
+        fftfilt filter(300.0f / 48000.0f, 3000.0f / 48000.0f, 1024);
+        qint64 nsecs = 0;
+
+        for (uint32_t i = 0; i < m_parser.getRepetition(); i++)
+        {
+            timer.start();
+
+            for (std::vector<Complex>::const_iterator it = samples.begin(); it != samples.end(); ++it) {
+                nbOut += filter.runFilt(*it, &out);
+            }
+
+            nsecs += timer.nsecsElapsed();
+        }
+
+        printResults("MainBench::testFFTFilt: runFilt", nsecs);
+    }
+
+    // USB filter as in the SSB demodulator
+    {
+        fftfilt filter(300.0f / 48000.0f, 3000.0f / 48000.0f, 1024);
+        qint64 nsecs = 0;
+
+        for (uint32_t i = 0; i < m_parser.getRepetition(); i++)
+        {
+            timer.start();
+
+            for (std::vector<Complex>::const_iterator it = samples.begin(); it != samples.end(); ++it) {
+                nbOut += filter.runSSB(*it, &out, true);
+            }
+
+            nsecs += timer.nsecsElapsed();
+        }
+
+        printResults("MainBench::testFFTFilt: runSSB", nsecs);
+    }
+
+    qDebug() << "MainBench::testFFTFilt: cleanup test data: " << nbOut << " output samples";
+}
@@ -0,0 +1,122 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// Interpolator benchmark                                                        //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <QElapsedTimer>
+#include <QDebug>
+
+#include "dsp/interpolator.h"
+#include "mainbench.h"
+
+void MainBench::testInterpolator()
+{
+    qDebug() << "MainBench::testInterpolator: create test data";
+
+    std::vector<Complex> samples(m_parser.getNbSamples());
+    auto my_rand = std::bind(m_uniform_distribution_f, m_generator);
+
+    for (std::vector<Complex>::iterator it = samples.begin(); it != samples.end(); ++it) {
+        *it = Complex(my_rand(), my_rand());
+    }
+
+    qDebug() << "MainBench::testInterpolator: run test";
+
+    QElapsedTimer timer;
+    Complex ci;
+
+    // decimation as in the NFM demodulator: 384 kS/s channel to 48 kS/s audio. Counts input samples.
+    {
+        Interpolator interpolator;
+        interpolator.create(16, 384000, 12500 / 2.2f);
+        Real distance = 384000.0f / 48000.0f;
+        Real distanceRemain = 0;
+        qint64 nsecs = 0;
+
+        for (uint32_t i = 0; i < m_parser.getRepetition(); i++)
+        {
+            timer.start();
+
+            for (std::vector<Complex>::const_iterator it = samples.begin(); it != samples.end(); ++it)
+            {
+                if (interpolator.decimate(&distanceRemain, *it, &ci)) {
+                    distanceRemain += distance;
+                }
+            }
+
+            nsecs += timer.nsecsElapsed();
+        }
+
+        printResults("MainBench::testInterpolator: decimate", nsecs);
+    }
+
+    // interpolation as in the NFM modulator: 48 kS/s audio to 384 kS/s channel. Counts output samples.
+    {
+        Interpolator interpolator;
+        interpolator.create(48, 48000, 12500 / 2.2f, 3.0);
+        Real distance = 48000.0f / 384000.0f;
+        Real distanceRemain = 0;
+        qint64 nsecs = 0;
+
+        for (uint32_t i = 0; i < m_parser.getRepetition(); i++)
+        {
+            std::vector<Complex>::const_iterator it = samples.begin();
+            timer.start();
+
+            for (uint32_t n = 0; n < m_parser.getNbSamples(); n++)
+            {
+                if (interpolator.interpolate(&distanceRemain, *it, &ci))
+                {
+                    ++it;
+                    distanceRemain += distance;
+                }
+            }
+
+            nsecs += timer.nsecsElapsed();
+        }
+
+        printResults("MainBench::testInterpolator: interpolate", nsecs);
+    }
+
+    // rational resampling from 44.1 kS/s to 48 kS/s. Counts input samples.
+    {
+        Interpolator interpolator;
+        interpolator.create(16, 48000, 20000);
+        Real distance = 44100.0f / 48000.0f;
+        Real distanceRemain = 0;
+        qint64 nsecs = 0;
+
+        for (uint32_t i = 0; i < m_parser.getRepetition(); i++)
+        {
+            timer.start();
+
+            for (std::vector<Complex>::const_iterator it = samples.begin(); it != samples.end(); ++it)
+            {
+                bool consumed = false;
+
+                while (interpolator.resample(&distanceRemain, *it, &consumed, &ci)) {
+                    distanceRemain += distance;
+                }
+            }
+
+            nsecs += timer.nsecsElapsed();
+        }
+
+        printResults("MainBench::testInterpolator: resample", nsecs);
+    }
+
+    qDebug() << "MainBench::testInterpolator: cleanup test data";
+}
@@ -0,0 +1,85 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// Spectrum power extraction benchmark                                           //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <QElapsedTimer>
+#include <QDebug>
+
+#include "dsp/samplemixerkernels.h"
+#include "mainbench.h"
+
+void MainBench::testMixer()
+{
+    // mixing of several channel sources as done by DSPDeviceSinkEngine::work when more than one source is attached
+    const unsigned int nbSourcesList[] = {2, 4, 8};
+
+    qDebug() << "MainBench::testMixer: create test data";
+
+    std::vector<SampleVector> sources(nbSourcesList[sizeof(nbSourcesList)/sizeof(nbSourcesList[0]) - 1], SampleVector(m_parser.getNbSamples()));
+    SampleVector mix(m_parser.getNbSamples());
+    auto my_rand = std::bind(m_uniform_distribution_s16, m_generator);
+
+    for (std::vector<SampleVector>::iterator source = sources.begin(); source != sources.end(); ++source)
+    {
+        for (SampleVector::iterator it = source->begin(); it != source->end(); ++it)
+        {
+            it->setReal(my_rand());
+            it->setImag(my_rand());
+        }
+    }
+
+    SampleMixerKernels::ISA defaultISA = SampleMixerKernels::getISA();
+
+    qDebug() << "MainBench::testMixer: run test";
+
+    for (unsigned int s = 0; s < sizeof(nbSourcesList)/sizeof(nbSourcesList[0]); s++)
+    {
+        unsigned int nbSources = nbSourcesList[s];
+        unsigned int shift = nbSources < 3 ? 1 : nbSources;
+        std::vector<const Sample*> spans;
+
+        for (unsigned int is = 0; is < nbSources; is++) {
+            spans.push_back(&sources[is][0]);
+        }
+
+        for (int isa = 0; isa < (int) IntHalfbandFilterKernels::ISAEnd; isa++)
+        {
+            if (!SampleMixerKernels::setISA((SampleMixerKernels::ISA) isa)) {
+                continue;
+            }
+
+            QElapsedTimer timer;
+            qint64 nsecs = 0;
+
+            for (uint32_t i = 0; i < m_parser.getRepetition(); i++)
+            {
+                timer.start();
+                SampleMixerKernels::mix(spans.data(), nbSources, &mix[0], m_parser.getNbSamples(), shift);
+                nsecs += timer.nsecsElapsed();
+            }
+
+            printResults(QString("MainBench::testMixer (%1): %2 sources")
+                    .arg(IntHalfbandFilterKernels::getISAName((IntHalfbandFilterKernels::ISA) isa))
+                    .arg(nbSources),
+                nsecs);
+        }
+    }
+
+    SampleMixerKernels::setISA(defaultISA);
+
+    qDebug() << "MainBench::testMixer: cleanup test data";
+}
@@ -0,0 +1,83 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// NCO benchmark                                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <QElapsedTimer>
+#include <QDebug>
+
+#include "dsp/nco.h"
+#include "dsp/ncof.h"
+#include "mainbench.h"
+
+void MainBench::testNCO()
+{
+    qDebug() << "MainBench::testNCO: create test data";
+
+    std::vector<Complex> samples(m_parser.getNbSamples());
+    auto my_rand = std::bind(m_uniform_distribution_f, m_generator);
+
+    for (std::vector<Complex>::iterator it = samples.begin(); it != samples.end(); ++it) {
+        *it = Complex(my_rand(), my_rand());
+    }
+
+    qDebug() << "MainBench::testNCO: run test";
+
+    QElapsedTimer timer;
+    Complex acc(0, 0); // keeps the mixing products alive
+
+    // integer phase NCO mixing as in the channel demodulators
+    {
+        NCO nco;
+        nco.setFreq(-12345.0f, 2048000.0f);
+        qint64 nsecs = 0;
+
+        for (uint32_t i = 0; i < m_parser.getRepetition(); i++)
+        {
+            timer.start();
+
+            for (std::vector<Complex>::const_iterator it = samples.begin(); it != samples.end(); ++it) {
+                acc += *it * nco.nextIQ();
+            }
+
+            nsecs += timer.nsecsElapsed();
+        }
+
+        printResults("MainBench::testNCO: NCO", nsecs);
+    }
+
+    // floating point phase NCO
+    {
+        NCOF ncof;
+        ncof.setFreq(-12345.0f, 2048000.0f);
+        qint64 nsecs = 0;
+
+        for (uint32_t i = 0; i < m_parser.getRepetition(); i++)
+        {
+            timer.start();
+
+            for (std::vector<Complex>::const_iterator it = samples.begin(); it != samples.end(); ++it) {
+                acc += *it * ncof.nextIQ();
+            }
+
+            nsecs += timer.nsecsElapsed();
+        }
+
+        printResults("MainBench::testNCO: NCOF", nsecs);
+    }
+
+    qDebug() << "MainBench::testNCO: cleanup test data: " << acc.real() << acc.imag();
+}
@@ -0,0 +1,124 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// Spectrum power extraction benchmark                                           //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+
+#include <QElapsedTimer>
+#include <QDebug>
+
+#include "dsp/fftengine.h"
+#include "dsp/fftwindow.h"
+#include "dsp/spectrumpowerkernels.h"
+#include "util/movingaverage2d.h"
+#include "mainbench.h"
+
+void MainBench::testSpectrumVis()
+{
+    // SpectrumVis itself lives in sdrgui and needs a GLSpectrum so this runs the same
+    // power extraction steps as SpectrumVis::feed: window and scaling, FFT, |X|^2, averaging and log
+    // with each of the power spectrum kernels instruction sets supported by the CPU
+    const int fftSizes[] = {1024, 4096, 16384};
+    const Real scalef = SDR_RX_SCALEF;
+    const Real mult = (10.0f / log2f(10.0f));
+
+    qDebug() << "MainBench::testSpectrumVis: create test data";
+
+    SampleVector samples(m_parser.getNbSamples());
+    auto my_rand = std::bind(m_uniform_distribution_s16, m_generator);
+
+    for (SampleVector::iterator it = samples.begin(); it != samples.end(); ++it)
+    {
+        it->setReal(my_rand());
+        it->setImag(my_rand());
+    }
+
+    FFTEngine *fft = FFTEngine::create();
+    SpectrumPowerKernels::ISA defaultISA = SpectrumPowerKernels::getISA();
+
+    qDebug() << "MainBench::testSpectrumVis: run test";
+
+    for (int isa = 0; isa < (int) IntHalfbandFilterKernels::ISAEnd; isa++)
+    {
+        if (!SpectrumPowerKernels::setISA((SpectrumPowerKernels::ISA) isa)) {
+            continue;
+        }
+
+        for (unsigned int s = 0; s < sizeof(fftSizes)/sizeof(fftSizes[0]); s++)
+        {
+            std::size_t fftSize = fftSizes[s];
+            std::size_t halfSize = fftSize / 2;
+            uint32_t nbFrames = m_parser.getNbSamples() / fftSize;
+
+            if (nbFrames == 0) {
+                continue; // not enough samples for this FFT size
+            }
+
+            Real ofs = 20.0f * log10f(1.0f / fftSize);
+            std::vector<Real> powerBins(fftSize);
+            std::vector<Real> powerSpectrum(fftSize);
+            FFTWindow window;
+            MovingAverage2D<double> movingAverage;
+
+            fft->configure(fftSize, false);
+            window.create(FFTWindow::BlackmanHarris, fftSize);
+            movingAverage.resize(fftSize, 10);
+
+            for (int avg = 0; avg < 2; avg++)
+            {
+                QElapsedTimer timer;
+                qint64 nsecs = 0;
+
+                for (uint32_t i = 0; i < m_parser.getRepetition(); i++)
+                {
+                    timer.start();
+
+                    for (uint32_t f = 0; f < nbFrames; f++)
+                    {
+                        window.apply(&samples[f*fftSize], fft->in(), 1.0f / scalef);
+                        fft->transform();
+                        const Complex* fftOut = fft->out();
+
+                        SpectrumPowerKernels::magSq(fftOut + halfSize, &powerBins[0], halfSize);
+                        SpectrumPowerKernels::magSq(fftOut, &powerBins[halfSize], halfSize);
+
+                        if (avg)
+                        {
+                            movingAverage.storeAndGetAvg(&powerBins[0], &powerBins[0], fftSize);
+                            movingAverage.nextAverage();
+                        }
+
+                        SpectrumPowerKernels::powerToDB(&powerBins[0], &powerSpectrum[0], fftSize, mult, ofs);
+                    }
+
+                    nsecs += timer.nsecsElapsed();
+                }
+
+                printResults(QString("MainBench::testSpectrumVis (%1): %2 points: %3")
+                        .arg(IntHalfbandFilterKernels::getISAName((IntHalfbandFilterKernels::ISA) isa))
+                        .arg(fftSize)
+                        .arg(avg ? "moving average" : "no average"),
+                    nsecs, (qint64) nbFrames * fftSize * m_parser.getRepetition());
+            }
+        }
+    }
+
+    SpectrumPowerKernels::setISA(defaultISA);
+
+    qDebug() << "MainBench::testSpectrumVis: cleanup test data";
+    delete fft;
+}
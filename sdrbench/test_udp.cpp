@@ -0,0 +1,93 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// Spectrum power extraction benchmark                                           //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+#include <vector>
+
+#include <QElapsedTimer>
+#include <QDebug>
+
+#include "util/udpbatchsocket.h"
+#include "mainbench.h"
+
+void MainBench::testUDP()
+{
+    // loopback transfer of 512 byte datagrams as sent by SDRdaemon one datagram per system call or by batches
+    const int datagramSize = 512;
+    const int chunkSize = UDPBatchSocket::m_maxBatchSize;
+    const quint16 port = 9099;
+    int nbDatagrams = m_parser.getNbSamples() / (datagramSize / 4); // 16 bit I/Q samples
+    nbDatagrams = nbDatagrams < chunkSize ? chunkSize : nbDatagrams;
+
+    qDebug() << "MainBench::testUDP: create test data";
+
+    std::vector<char> txBuffer(chunkSize * datagramSize);
+    std::vector<char> rxBuffer(chunkSize * datagramSize);
+    auto my_rand = std::bind(m_uniform_distribution_s16, m_generator);
+    std::generate(txBuffer.begin(), txBuffer.end(), my_rand);
+
+    UDPBatchSocket rxSocket;
+    UDPBatchSocket txSocket;
+    rxSocket.setBufferSizes(0, 1<<22);
+    txSocket.setBufferSizes(1<<20, 0);
+    txSocket.setDestination(QHostAddress::LocalHost, port);
+
+    if (!rxSocket.bind(QHostAddress::LocalHost, port))
+    {
+        qWarning() << "MainBench::testUDP: cannot bind loopback port" << port;
+        return;
+    }
+
+    qDebug() << "MainBench::testUDP: run test:" << (txSocket.isBatched() ? "sendmmsg/recvmmsg" : "fallback");
+
+    for (int batchSize = 1; batchSize <= chunkSize; batchSize *= chunkSize)
+    {
+        QElapsedTimer timer;
+        qint64 nsecs = 0;
+        qint64 nbReceived = 0;
+
+        for (uint32_t i = 0; i < m_parser.getRepetition(); i++)
+        {
+            timer.start();
+
+            for (int sent = 0; sent < nbDatagrams; sent += chunkSize)
+            {
+                for (int b = 0; b < chunkSize; b += batchSize) {
+                    txSocket.writeDatagrams(&txBuffer[b * datagramSize], datagramSize, batchSize);
+                }
+
+                int nbRead;
+
+                do
+                {
+                    nbRead = rxSocket.readDatagrams(&rxBuffer[0], datagramSize, batchSize);
+                    nbReceived += nbRead;
+                } while (nbRead > 0);
+            }
+
+            nsecs += timer.nsecsElapsed();
+        }
+
+        printResults(QString("MainBench::testUDP: %1 datagram(s) per call %2/%3 received")
+                .arg(batchSize)
+                .arg(nbReceived)
+                .arg((qint64) ((nbDatagrams + chunkSize - 1) / chunkSize) * chunkSize * m_parser.getRepetition()),
+            nsecs);
+    }
+
+    rxSocket.close();
+    qDebug() << "MainBench::testUDP: cleanup test data";
+}
@@ -1,6 +1,7 @@
 #include "dsp/spectrumvis.h"
 #include "gui/glspectrum.h"
 #include "dsp/dspcommands.h"
+#include "dsp/spectrumpowerkernels.h"
 #include "util/messagequeue.h"
 
 #define MAX_FFT_SIZE 4096
@@ -21,6 +22,7 @@ SpectrumVis::SpectrumVis(Real scalef, GLSpectrum* glSpectrum) :
 	m_fft(FFTEngine::create()),
 	m_fftBuffer(MAX_FFT_SIZE),
 	m_powerSpectrum(MAX_FFT_SIZE),
+	m_powerBins(MAX_FFT_SIZE),
 	m_fftBufferFill(0),
 	m_needMoreSamples(false),
 	m_scalef(scalef),
@@ -96,190 +98,81 @@ void SpectrumVis::feed(const SampleVector::const_iterator& cbegin, const SampleV
 		if (todo >= samplesNeeded)
 		{
 			// fill up the buffer
-			std::vector<Complex>::iterator it = m_fftBuffer.begin() + m_fftBufferFill;
+			std::copy(begin, begin + samplesNeeded, m_fftBuffer.begin() + m_fftBufferFill);
+			begin += samplesNeeded;
 
-			for (std::size_t i = 0; i < samplesNeeded; ++i, ++begin)
-			{
-				*it++ = Complex(begin->real() / m_scalef, begin->imag() / m_scalef);
-			}
-
-			// apply fft window (and copy from m_fftBuffer to m_fftIn)
-			m_window.apply(&m_fftBuffer[0], m_fft->in());
+			// convert, scale and apply fft window (from m_fftBuffer to m_fftIn)
+			m_window.apply(&m_fftBuffer[0], m_fft->in(), 1.0f / m_scalef);
 
 			// calculate FFT
 			m_fft->transform();
 
 			// extract power spectrum and reorder buckets
 			const Complex* fftOut = m_fft->out();
-			Complex c;
-			Real v;
 			std::size_t halfSize = m_fftSize / 2;
+			std::size_t nbBins;
+			Real *power = &m_powerBins[0];
 
-			if (m_avgMode == AvgModeNone)
+			if (positiveOnly)
+			{
+			    SpectrumPowerKernels::magSq(fftOut, power, halfSize);
+			    nbBins = halfSize;
+			}
+			else
 			{
-                if ( positiveOnly )
-                {
-                    for (std::size_t i = 0; i < halfSize; i++)
-                    {
-                        c = fftOut[i];
-                        v = c.real() * c.real() + c.imag() * c.imag();
-                        v = m_linear ? v/m_powFFTDiv : m_mult * log2f(v) + m_ofs;
-                        m_powerSpectrum[i * 2] = v;
-                        m_powerSpectrum[i * 2 + 1] = v;
-                    }
-                }
-                else
-                {
-                    for (std::size_t i = 0; i < halfSize; i++)
-                    {
-                        c = fftOut[i + halfSize];
-                        v = c.real() * c.real() + c.imag() * c.imag();
-                        v = m_linear ? v/m_powFFTDiv : m_mult * log2f(v) + m_ofs;
-                        m_powerSpectrum[i] = v;
-
-                        c = fftOut[i];
-                        v = c.real() * c.real() + c.imag() * c.imag();
-                        v = m_linear ? v/m_powFFTDiv : m_mult * log2f(v) + m_ofs;
-                        m_powerSpectrum[i + halfSize] = v;
-                    }
-                }
-
-                // send new data to visualisation
-                m_glSpectrum->newSpectrum(m_powerSpectrum, m_fftSize);
+			    SpectrumPowerKernels::magSq(fftOut + halfSize, power, halfSize);
+			    SpectrumPowerKernels::magSq(fftOut, power + halfSize, halfSize);
+			    nbBins = m_fftSize;
 			}
-			else if (m_avgMode == AvgModeMovingAvg)
+
+			bool ready; // averaging result available
+
+			if (m_avgMode == AvgModeMovingAvg)
 			{
-	            if ( positiveOnly )
-	            {
-	                for (std::size_t i = 0; i < halfSize; i++)
-	                {
-	                    c = fftOut[i];
-	                    v = c.real() * c.real() + c.imag() * c.imag();
-	                    v = m_movingAverage.storeAndGetAvg(v, i);
-	                    v = m_linear ? v/m_powFFTDiv : m_mult * log2f(v) + m_ofs;
-	                    m_powerSpectrum[i * 2] = v;
-	                    m_powerSpectrum[i * 2 + 1] = v;
-	                }
-	            }
-	            else
-	            {
-	                for (std::size_t i = 0; i < halfSize; i++)
-	                {
-	                    c = fftOut[i + halfSize];
-	                    v = c.real() * c.real() + c.imag() * c.imag();
-	                    v = m_movingAverage.storeAndGetAvg(v, i+halfSize);
-	                    v = m_linear ? v/m_powFFTDiv : m_mult * log2f(v) + m_ofs;
-	                    m_powerSpectrum[i] = v;
-
-	                    c = fftOut[i];
-	                    v = c.real() * c.real() + c.imag() * c.imag();
-	                    v = m_movingAverage.storeAndGetAvg(v, i);
-	                    v = m_linear ? v/m_powFFTDiv : m_mult * log2f(v) + m_ofs;
-	                    m_powerSpectrum[i + halfSize] = v;
-	                }
-	            }
-
-	            // send new data to visualisation
-	            m_glSpectrum->newSpectrum(m_powerSpectrum, m_fftSize);
-	            m_movingAverage.nextAverage();
+			    m_movingAverage.storeAndGetAvg(power, power, nbBins);
+			    m_movingAverage.nextAverage();
+			    ready = true;
 			}
 			else if (m_avgMode == AvgModeFixedAvg)
 			{
-			    double avg;
-
-                if ( positiveOnly )
-                {
-                    for (std::size_t i = 0; i < halfSize; i++)
-                    {
-                        c = fftOut[i];
-                        v = c.real() * c.real() + c.imag() * c.imag();
-
-                        if (m_fixedAverage.storeAndGetAvg(avg, v, i))
-                        {
-                            avg = m_linear ? avg/m_powFFTDiv : m_mult * log2f(avg) + m_ofs;
-                            m_powerSpectrum[i * 2] = avg;
-                            m_powerSpectrum[i * 2 + 1] = avg;
-                        }
-                    }
-                }
-                else
-                {
-                    for (std::size_t i = 0; i < halfSize; i++)
-                    {
-                        c = fftOut[i + halfSize];
-                        v = c.real() * c.real() + c.imag() * c.imag();
-
-                        if (m_fixedAverage.storeAndGetAvg(avg, v, i+halfSize))
-                        { // result available
-                            avg = m_linear ? avg/m_powFFTDiv : m_mult * log2f(avg) + m_ofs;
-                            m_powerSpectrum[i] = avg;
-                        }
-
-                        c = fftOut[i];
-                        v = c.real() * c.real() + c.imag() * c.imag();
-
-                        if (m_fixedAverage.storeAndGetAvg(avg, v, i))
-                        { // result available
-                            avg = m_linear ? avg/m_powFFTDiv : m_mult * log2f(avg) + m_ofs;
-                            m_powerSpectrum[i + halfSize] = avg;
-                        }
-                    }
-                }
-
-                if (m_fixedAverage.nextAverage()) { // result available
-                    m_glSpectrum->newSpectrum(m_powerSpectrum, m_fftSize); // send new data to visualisation
-                }
+			    ready = m_fixedAverage.storeAndGetAvg(power, power, nbBins);
+			    m_fixedAverage.nextAverage();
 			}
 			else if (m_avgMode == AvgModeMax)
 			{
-			    double max;
-
-                if ( positiveOnly )
-                {
-                    for (std::size_t i = 0; i < halfSize; i++)
-                    {
-                        c = fftOut[i];
-                        v = c.real() * c.real() + c.imag() * c.imag();
-
-                        if (m_max.storeAndGetMax(max, v, i))
-                        {
-                            max = m_linear ? max/m_powFFTDiv : m_mult * log2f(max) + m_ofs;
-                            m_powerSpectrum[i * 2] = max;
-                            m_powerSpectrum[i * 2 + 1] = max;
-                        }
-                    }
-                }
-                else
-                {
-                    for (std::size_t i = 0; i < halfSize; i++)
-                    {
-                        c = fftOut[i + halfSize];
-                        v = c.real() * c.real() + c.imag() * c.imag();
-
-                        if (m_max.storeAndGetMax(max, v, i+halfSize))
-                        { // result available
-                            max = m_linear ? max/m_powFFTDiv : m_mult * log2f(max) + m_ofs;
-                            m_powerSpectrum[i] = max;
-                        }
-
-                        c = fftOut[i];
-                        v = c.real() * c.real() + c.imag() * c.imag();
-
-                        if (m_max.storeAndGetMax(max, v, i))
-                        { // result available
-                            max = m_linear ? max/m_powFFTDiv : m_mult * log2f(max) + m_ofs;
-                            m_powerSpectrum[i + halfSize] = max;
-                        }
-                    }
-                }
-
-                if (m_max.nextMax()) { // result available
-                    m_glSpectrum->newSpectrum(m_powerSpectrum, m_fftSize); // send new data to visualisation
-                }
+			    ready = m_max.storeAndGetMax(power, power, nbBins);
+			    m_max.nextMax();
+			}
+			else
+			{
+			    ready = true;
+			}
+
+			if (ready)
+			{
+			    Real *spectrum = positiveOnly ? power : &m_powerSpectrum[0];
+
+			    if (m_linear) {
+			        SpectrumPowerKernels::scale(power, spectrum, nbBins, 1.0f / m_powFFTDiv);
+			    } else {
+			        SpectrumPowerKernels::powerToDB(power, spectrum, nbBins, m_mult, m_ofs);
+			    }
+
+			    if (positiveOnly)
+			    {
+			        for (std::size_t i = 0; i < halfSize; i++)
+			        {
+			            m_powerSpectrum[i * 2] = power[i];
+			            m_powerSpectrum[i * 2 + 1] = power[i];
+			        }
+			    }
+
+			    // send new data to visualisation
+			    m_glSpectrum->newSpectrum(m_powerSpectrum, m_fftSize);
 			}
 
 			// advance buffer respecting the fft overlap factor
-			std::copy(m_fftBuffer.begin() + m_refillSize, m_fftBuffer.end(), m_fftBuffer.begin());
+			std::copy(m_fftBuffer.begin() + m_refillSize, m_fftBuffer.begin() + m_fftSize, m_fftBuffer.begin());
 
 			// start over
 			m_fftBufferFill = m_overlapSize;
@@ -288,10 +181,8 @@ void SpectrumVis::feed(const SampleVector::const_iterator& cbegin, const SampleV
 		else
 		{
 			// not enough samples for FFT - just fill in new data and return
-			for(std::vector<Complex>::iterator it = m_fftBuffer.begin() + m_fftBufferFill; begin < end; ++begin)
-			{
-				*it++ = Complex(begin->real() / m_scalef, begin->imag() / m_scalef);
-			}
+			std::copy(begin, end, m_fftBuffer.begin() + m_fftBufferFill);
+			begin = end;
 
 			m_fftBufferFill += todo;
 			m_needMoreSamples = true;
@@ -322,6 +213,13 @@ bool SpectrumVis::handleMessage(const Message& message)
 		        conf.getLinear());
 		return true;
 	}
+	else if (MsgSamplesSkipped::match(message))
+	{
+	    // samples are no longer contiguous so start a new FFT frame
+	    QMutexLocker mutexLocker(&m_mutex);
+	    m_fftBufferFill = 0;
+	    return true;
+	}
 	else
 	{
 		return false;
@@ -83,8 +83,9 @@ private:
 	FFTEngine* m_fft;
 	FFTWindow m_window;
 
-	std::vector<Complex> m_fftBuffer;
+	SampleVector m_fftBuffer;
 	std::vector<Real> m_powerSpectrum;
+	std::vector<Real> m_powerBins; //!< power of the FFT bins in display order before averaging and dB conversion
 
 	std::size_t m_fftSize;
 	std::size_t m_overlapPercent;
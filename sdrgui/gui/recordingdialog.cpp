@@ -0,0 +1,71 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include "recordingdialog.h"
+#include "ui_recordingdialog.h"
+
+RecordingDialog::RecordingDialog(MainSettings& mainSettings, QWidget* parent) :
+    QDialog(parent),
+    ui(new Ui::RecordingDialog),
+    m_mainSettings(mainSettings)
+{
+    ui->setupUi(this);
+    ui->format->setCurrentIndex(m_mainSettings.getRecordFormat());
+    ui->codec->setCurrentIndex(m_mainSettings.getRecordCodec());
+    ui->codecBits->setValue(m_mainSettings.getRecordCodecBits());
+    ui->rotateMB->setValue(m_mainSettings.getRecordRotateMB());
+    ui->rotateMinutes->setValue(m_mainSettings.getRecordRotateMinutes());
+    ui->directIO->setChecked(m_mainSettings.getRecordDirectIO());
+    displayEnables();
+}
+
+RecordingDialog::~RecordingDialog()
+{
+    delete ui;
+}
+
+void RecordingDialog::accept()
+{
+    m_mainSettings.setRecordFormat(ui->format->currentIndex());
+    m_mainSettings.setRecordCodec(ui->codec->currentIndex());
+    m_mainSettings.setRecordCodecBits(ui->codecBits->value());
+    m_mainSettings.setRecordRotateMB(ui->rotateMB->value());
+    m_mainSettings.setRecordRotateMinutes(ui->rotateMinutes->value());
+    m_mainSettings.setRecordDirectIO(ui->directIO->isChecked());
+    QDialog::accept();
+}
+
+void RecordingDialog::on_format_currentIndexChanged(int index)
+{
+    (void) index;
+    displayEnables();
+}
+
+void RecordingDialog::on_codec_currentIndexChanged(int index)
+{
+    (void) index;
+    displayEnables();
+}
+
+void RecordingDialog::displayEnables()
+{
+    bool v2 = ui->format->currentIndex() == 1;
+    ui->codec->setEnabled(v2);
+    ui->codecBits->setEnabled(v2 && (ui->codec->currentIndex() != 0));
+    ui->rotateMB->setEnabled(v2);
+    ui->rotateMinutes->setEnabled(v2);
+}
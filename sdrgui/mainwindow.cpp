@@ -49,9 +49,13 @@
 #include "gui/loggingdialog.h"
 #include "gui/samplingdevicecontrol.h"
 #include "gui/mypositiondialog.h"
+#include "gui/recordingdialog.h"
 #include "dsp/dspengine.h"
+#include "dsp/dspdevicesourceengine.h"
 #include "dsp/spectrumvis.h"
 #include "dsp/dspcommands.h"
+#include "dsp/fftengine.h"
+#include "dsp/filerecord.h"
 #include "dsp/devicesamplesource.h"
 #include "dsp/devicesamplesink.h"
 #include "plugin/pluginapi.h"
@@ -168,6 +172,12 @@ MainWindow::MainWindow(qtwebapp::LoggerWithFile *logger, const MainParser& parse
 
 	loadSettings();
 
+    FFTEngine::importWisdom(m_settings.getFFTWisdomFileName());
+
+    for (std::vector<int>::const_iterator it = parser.getFFTPrewarmSizes().begin(); it != parser.getFFTPrewarmSizes().end(); ++it) {
+        FFTEngine::prewarm(*it);
+    }
+
     qDebug() << "MainWindow::MainWindow: load plugins...";
 
     m_pluginManager = new PluginManager(this);
@@ -219,6 +229,7 @@ MainWindow::MainWindow(qtwebapp::LoggerWithFile *logger, const MainParser& parse
 
 MainWindow::~MainWindow()
 {
+    FFTEngine::exportWisdom(m_settings.getFFTWisdomFileName());
     m_apiServer->stop();
     delete m_apiServer;
     delete m_requestMapper;
@@ -262,7 +273,7 @@ void MainWindow::addSourceDevice(int deviceIndex)
 
     connect(m_deviceUIs.back()->m_samplingDeviceControl->getAddChannelButton(), SIGNAL(clicked(bool)), this, SLOT(channelAddClicked(bool)));
 
-    dspDeviceSourceEngine->addSink(m_deviceUIs.back()->m_spectrumVis);
+    dspDeviceSourceEngine->addSpectrumSink(m_deviceUIs.back()->m_spectrumVis);
     ui->tabSpectra->addTab(m_deviceUIs.back()->m_spectrum, tabNameCStr);
     ui->tabSpectraGUI->addTab(m_deviceUIs.back()->m_spectrumGUI, tabNameCStr);
     ui->tabChannels->addTab(m_deviceUIs.back()->m_channelWindow, tabNameCStr);
@@ -385,7 +396,7 @@ void MainWindow::removeLastDevice()
 	{
 	    DSPDeviceSourceEngine *lastDeviceEngine = m_deviceUIs.back()->m_deviceSourceEngine;
 	    lastDeviceEngine->stopAcquistion();
-	    lastDeviceEngine->removeSink(m_deviceUIs.back()->m_spectrumVis);
+	    lastDeviceEngine->removeSpectrumSink(m_deviceUIs.back()->m_spectrumVis);
 
 	    ui->tabSpectraGUI->removeTab(ui->tabSpectraGUI->count() - 1);
 	    ui->tabSpectra->removeTab(ui->tabSpectra->count() - 1);
@@ -564,6 +575,9 @@ void MainWindow::loadSettings()
     }
 
     setLoggingOptions();
+    setRecordingOptions();
+    ui->action_ChannelizerBank->setChecked(m_settings.getUseChannelizerBank());
+    DSPDeviceSourceEngine::setUseChannelizerBank(m_settings.getUseChannelizerBank());
 }
 
 void MainWindow::loadPresetSettings(const Preset* preset, int tabIndex)
@@ -1437,12 +1451,26 @@ void MainWindow::on_action_Logging_triggered()
     setLoggingOptions();
 }
 
+void MainWindow::on_action_Recording_triggered()
+{
+    RecordingDialog recordingDialog(m_settings, this);
+    recordingDialog.exec();
+    setRecordingOptions();
+}
+
 void MainWindow::on_action_My_Position_triggered()
 {
 	MyPositionDialog myPositionDialog(m_settings, this);
 	myPositionDialog.exec();
 }
 
+void MainWindow::on_action_ChannelizerBank_triggered(bool checked)
+{
+    // channels opened from now on are assigned to the filter bank when they fit
+    m_settings.setUseChannelizerBank(checked);
+    DSPDeviceSourceEngine::setUseChannelizerBank(checked);
+}
+
 void MainWindow::on_action_DV_Serial_triggered(bool checked)
 {
     m_dspEngine->setDVSerialSupport(checked);
@@ -1734,6 +1762,19 @@ void MainWindow::updateStatus()
     m_dateTimeWidget->setText(QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss t"));
 }
 
+void MainWindow::setRecordingOptions()
+{
+    FileRecord::Options options;
+    int format = m_settings.getRecordFormat();
+    options.m_format = (format < 0) || (format > (int) FileRecord::FormatSigMF) ? FileRecord::FormatV1 : (FileRecord::RecordFormat) format;
+    options.m_codec = m_settings.getRecordCodec();
+    options.m_codecBits = m_settings.getRecordCodecBits();
+    options.m_rotateMB = m_settings.getRecordRotateMB();
+    options.m_rotateMinutes = m_settings.getRecordRotateMinutes();
+    options.m_directIO = m_settings.getRecordDirectIO();
+    FileRecord::setDefaultOptions(options);
+}
+
 void MainWindow::setLoggingOptions()
 {
     m_logger->setConsoleMinMessageLevel(m_settings.getConsoleMinLogLevel());
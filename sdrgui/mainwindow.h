@@ -352,6 +352,7 @@ private:
     void deleteChannel(int deviceSetIndex, int channelIndex);
 
     void setLoggingOptions();
+    void setRecordingOptions();
 
     bool handleMessage(const Message& cmd);
 
@@ -379,8 +380,10 @@ private slots:
     void on_commandKeyboardConnect_toggled(bool checked);
 	void on_action_Audio_triggered();
     void on_action_Logging_triggered();
+	void on_action_ChannelizerBank_triggered(bool checked);
 	void on_action_DV_Serial_triggered(bool checked);
 	void on_action_My_Position_triggered();
+	void on_action_Recording_triggered();
 	void sampleSourceChanged();
 	void sampleSinkChanged();
     void channelAddClicked(bool checked);
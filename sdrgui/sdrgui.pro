@@ -79,6 +79,7 @@ SOURCES += mainwindow.cpp\
         gui/samplingdevicecontrol.cpp\
         gui/samplingdevicedialog.cpp\
         gui/mypositiondialog.cpp\
+        gui/recordingdialog.cpp\
         gui/scaleengine.cpp\
         gui/transverterbutton.cpp\
         gui/transverterdialog.cpp\
@@ -137,6 +138,7 @@ HEADERS  += mainwindow.h\
         gui/samplingdevicecontrol.h\
         gui/samplingdevicedialog.h\
         gui/mypositiondialog.h\
+        gui/recordingdialog.h\
         gui/scaleengine.h\
         gui/tickedslider.h\
         gui/transverterbutton.h\
@@ -172,6 +174,7 @@ FORMS    += mainwindow.ui\
         gui/samplingdevicedialog.ui\
         gui/myposdialog.ui\
         gui/loggingdialog.ui\
+        gui/recordingdialog.ui\
         gui/glspectrumgui.ui\
         gui/transverterdialog.ui\
         soapygui/arginfogui.ui\
@@ -28,6 +28,7 @@
 #include "device/deviceuiset.h"
 #include "device/deviceenumerator.h"
 #include "dsp/devicesamplesource.h"
+#include "dsp/samplesinkfifo.h"
 #include "dsp/devicesamplesink.h"
 #include "dsp/dspengine.h"
 #include "plugin/pluginapi.h"
@@ -51,6 +52,7 @@
 #include "SWGDeviceSettings.h"
 #include "SWGDeviceState.h"
 #include "SWGDeviceReport.h"
+#include "SWGSampleFifoReport.h"
 #include "SWGChannelsDetail.h"
 #include "SWGChannelSettings.h"
 #include "SWGChannelReport.h"
@@ -1223,6 +1225,8 @@ int WebAPIAdapterGUI::devicesetDeviceReportGet(
             response.setDeviceHwType(new QString(deviceSet->m_deviceSourceAPI->getHardwareId()));
             response.setTx(0);
             DeviceSampleSource *source = deviceSet->m_deviceSourceAPI->getSampleSource();
+            response.setSampleFifoReport(new SWGSDRangel::SWGSampleFifoReport());
+            getSampleFifoReport(response.getSampleFifoReport(), source->getSampleFifo());
             return source->webapiReportGet(response, *error.getMessage());
         }
         else if (deviceSet->m_deviceSinkEngine) // Tx
@@ -1718,6 +1722,15 @@ void WebAPIAdapterGUI::getDeviceSet(SWGSDRangel::SWGDeviceSet *deviceSet, const
     }
 }
 
+void WebAPIAdapterGUI::getSampleFifoReport(SWGSDRangel::SWGSampleFifoReport *sampleFifoReport, const SampleSinkFifo *sampleFifo)
+{
+    sampleFifoReport->setSize(sampleFifo->size());
+    sampleFifoReport->setFill(sampleFifo->fill());
+    sampleFifoReport->setOverflowCount(sampleFifo->getOverflowCount());
+    sampleFifoReport->setOverflowSamples(sampleFifo->getOverflowSamples());
+    sampleFifoReport->setUnderflowCount(sampleFifo->getUnderflowCount());
+}
+
 void WebAPIAdapterGUI::getChannelsDetail(SWGSDRangel::SWGChannelsDetail *channelsDetail, const DeviceUISet* deviceUISet)
 {
     channelsDetail->init();
@@ -25,6 +25,12 @@
 #include "export.h"
 
 class MainWindow;
+class SampleSinkFifo;
+
+namespace SWGSDRangel
+{
+    class SWGSampleFifoReport;
+}
 
 class SDRGUI_API WebAPIAdapterGUI: public WebAPIAdapterInterface
 {
@@ -233,6 +239,7 @@ private:
     void getDeviceSetList(SWGSDRangel::SWGDeviceSetList* deviceSetList);
     void getDeviceSet(SWGSDRangel::SWGDeviceSet *deviceSet, const DeviceUISet* deviceUISet, int deviceUISetIndex);
     void getChannelsDetail(SWGSDRangel::SWGChannelsDetail *channelsDetail, const DeviceUISet* deviceUISet);
+    void getSampleFifoReport(SWGSDRangel::SWGSampleFifoReport *sampleFifoReport, const SampleSinkFifo *sampleFifo);
     static QtMsgType getMsgTypeFromString(const QString& msgTypeString);
     static void getMsgTypeString(const QtMsgType& msgType, QString& level);
 };
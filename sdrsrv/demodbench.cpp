@@ -0,0 +1,221 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+
+#include <QDebug>
+#include <QTimer>
+#include <QDir>
+#include <QFile>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+#include "SWGDeviceSettings.h"
+#include "SWGFileSourceSettings.h"
+#include "SWGDeviceState.h"
+
+#include "dsp/dspdevicesourceengine.h"
+#include "dsp/devicesamplesource.h"
+#include "dsp/threadedbasebandsamplesink.h"
+#include "device/devicesourceapi.h"
+#include "device/deviceset.h"
+#include "plugin/pluginmanager.h"
+#include "mainparser.h"
+#include "maincore.h"
+
+#include "demodbench.h"
+
+DemodBench::DemodBench(MainCore& mainCore, const MainParser& parser, QObject *parent) :
+    QObject(parent),
+    m_mainCore(mainCore),
+    m_fileName(parser.getBenchFile()),
+    m_channelIds(parser.getBenchChannels()),
+    m_benchTime(parser.getBenchTime()),
+    m_deviceSetIndex(-1)
+{}
+
+DemodBench::~DemodBench()
+{}
+
+void DemodBench::start()
+{
+    qInfo("DemodBench::start: file: %s channels: %s time: %d s",
+            qPrintable(m_fileName), qPrintable(m_channelIds.join(",")), m_benchTime);
+
+    m_mainCore.addSourceDevice(); // File Source is the default device
+    m_deviceSetIndex = m_mainCore.m_deviceSets.size() - 1;
+    DeviceSet *deviceSet = m_mainCore.m_deviceSets.back();
+    DeviceSampleSource *source = deviceSet->m_deviceSourceAPI->getSampleSource();
+    QString errorMessage;
+
+    // play the file in a loop as fast as the channels can process it
+
+    SWGSDRangel::SWGDeviceSettings deviceSettings;
+    deviceSettings.setFileSourceSettings(new SWGSDRangel::SWGFileSourceSettings());
+    deviceSettings.getFileSourceSettings()->setFileName(new QString(m_fileName));
+    deviceSettings.getFileSourceSettings()->setAccelerationFactor(0);
+    deviceSettings.getFileSourceSettings()->setLoop(1);
+    QStringList deviceSettingsKeys;
+    deviceSettingsKeys << "fileName" << "accelerationFactor" << "loop";
+    source->webapiSettingsPutPatch(false, deviceSettingsKeys, deviceSettings, errorMessage);
+
+    // attach channels
+
+    PluginAPI::ChannelRegistrations *channelRegistrations = m_mainCore.m_pluginManager->getRxChannelRegistrations();
+
+    for (const QString& channelId : m_channelIds)
+    {
+        int index = 0;
+
+        for (; index < channelRegistrations->size(); index++)
+        {
+            if ((channelRegistrations->at(index).m_channelId == channelId)
+             || (channelRegistrations->at(index).m_channelIdURI == channelId)) {
+                break;
+            }
+        }
+
+        if (index < channelRegistrations->size()) {
+            m_mainCore.addChannel(m_deviceSetIndex, index);
+        } else {
+            qWarning("DemodBench::start: unknown channel %s", qPrintable(channelId));
+        }
+    }
+
+    // never lose samples in a channel: the source is slowed down to the slowest channel instead
+
+    deviceSet->m_deviceSourceEngine->getThreadedSinks(m_sinks);
+
+    if (m_sinks.size() == 0)
+    {
+        qCritical("DemodBench::start: no channel to benchmark");
+        quit();
+        return;
+    }
+
+    for (ThreadedBasebandSampleSink *sink : m_sinks) {
+        sink->setFifoPolicy(SampleSinkBroadcastFifoReader::PolicyBackPressure);
+    }
+
+    SWGSDRangel::SWGDeviceState deviceState;
+    deviceState.init();
+    source->webapiRun(true, deviceState, errorMessage);
+
+    QTimer::singleShot(1000, this, SLOT(startMeasurement())); // let the pipeline settle
+}
+
+void DemodBench::startMeasurement()
+{
+    m_startSamplesCounts.clear();
+    m_startDroppedCounts.clear();
+
+    for (ThreadedBasebandSampleSink *sink : m_sinks)
+    {
+        m_startSamplesCounts.push_back(sink->getSamplesCount());
+        m_startDroppedCounts.push_back(sink->getFifoReader() ? sink->getFifoReader()->getDroppedSamples() : 0);
+    }
+
+    getThreadsTimes(m_startThreadsTimes);
+    m_elapsedTimer.start();
+    QTimer::singleShot(m_benchTime * 1000, this, SLOT(stopMeasurement()));
+}
+
+void DemodBench::stopMeasurement()
+{
+    qint64 nsecs = m_elapsedTimer.nsecsElapsed();
+    ThreadsTimes stopThreadsTimes;
+    getThreadsTimes(stopThreadsTimes);
+    double secs = nsecs / 1e9;
+
+    qInfo("DemodBench::stopMeasurement: %.3f s", secs);
+
+    for (unsigned int i = 0; i < m_sinks.size(); i++)
+    {
+        quint64 samples = m_sinks[i]->getSamplesCount() - m_startSamplesCounts[i];
+        quint64 dropped = (m_sinks[i]->getFifoReader() ? m_sinks[i]->getFifoReader()->getDroppedSamples() : 0) - m_startDroppedCounts[i];
+
+        qInfo("DemodBench: channel %u %s: %.3f MS/s dropped: %llu",
+                i,
+                qPrintable(m_sinks[i]->getSampleSinkObjectName()),
+                (samples / secs) / 1e6,
+                dropped);
+    }
+
+#ifdef __linux__
+    long ticksPerSecond = sysconf(_SC_CLK_TCK);
+    double totalCPU = 0.0;
+
+    for (ThreadsTimes::const_iterator it = stopThreadsTimes.begin(); it != stopThreadsTimes.end(); ++it)
+    {
+        quint64 startTicks = m_startThreadsTimes.contains(it.key()) ? m_startThreadsTimes[it.key()].m_ticks : 0;
+        double cpu = ((it.value().m_ticks - startTicks) / (double) ticksPerSecond) / secs;
+        totalCPU += cpu;
+
+        if (cpu > 0.0) {
+            qInfo("DemodBench: thread %d %s: CPU %.1f%%", it.key(), qPrintable(it.value().m_name), cpu * 100.0);
+        }
+    }
+
+    qInfo("DemodBench: total CPU %.1f%%", totalCPU * 100.0);
+#endif
+
+    quit();
+}
+
+void DemodBench::getThreadsTimes(ThreadsTimes& threadsTimes)
+{
+    threadsTimes.clear();
+#ifdef __linux__
+    QDir taskDir("/proc/self/task");
+    QStringList tids = taskDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+
+    for (const QString& tid : tids)
+    {
+        QFile statFile(taskDir.filePath(tid + "/stat"));
+
+        if (!statFile.open(QIODevice::ReadOnly)) {
+            continue;
+        }
+
+        QString stat = QString(statFile.readAll());
+        int commStart = stat.indexOf('(');
+        int commEnd = stat.lastIndexOf(')'); // the thread name may contain spaces and parentheses
+
+        if ((commStart < 0) || (commEnd < 0)) {
+            continue;
+        }
+
+        // fields following the name start at state (3) so utime (14) and stime (15) are at 11 and 12
+        QStringList fields = stat.mid(commEnd + 2).split(' ');
+
+        if (fields.size() < 13) {
+            continue;
+        }
+
+        ThreadTimes& threadTimes = threadsTimes[tid.toInt()];
+        threadTimes.m_name = stat.mid(commStart + 1, commEnd - commStart - 1);
+        threadTimes.m_ticks = fields[11].toULongLong() + fields[12].toULongLong();
+    }
+#endif
+}
+
+void DemodBench::quit()
+{
+    MainCore::MsgDeleteInstance *msg = MainCore::MsgDeleteInstance::create();
+    m_mainCore.getInputMessageQueue()->push(msg);
+}
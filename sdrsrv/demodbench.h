@@ -0,0 +1,76 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef SDRSRV_DEMODBENCH_H_
+#define SDRSRV_DEMODBENCH_H_
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QMap>
+#include <QElapsedTimer>
+#include <vector>
+
+class MainCore;
+class MainParser;
+class ThreadedBasebandSampleSink;
+
+/**
+ * Headless demodulator throughput benchmark. Plays a .sdriq file through the
+ * File Source with no throttling, attaches a set of channel plugins whose FIFO readers
+ * apply back pressure and reports the samples/s processed by each channel as well
+ * as the CPU time used by each thread of the process.
+ */
+class DemodBench : public QObject {
+    Q_OBJECT
+
+public:
+    DemodBench(MainCore& mainCore, const MainParser& parser, QObject *parent = 0);
+    ~DemodBench();
+
+    void start(); //!< Create the device set, attach channels and start streaming
+
+private:
+    struct ThreadTimes
+    {
+        QString m_name;
+        quint64 m_ticks; //!< user + system time in clock ticks
+    };
+
+    typedef QMap<int, ThreadTimes> ThreadsTimes; //!< keyed by thread id
+
+    MainCore& m_mainCore;
+    QString m_fileName;
+    QStringList m_channelIds;
+    int m_benchTime;  //!< seconds
+    int m_deviceSetIndex;
+    std::vector<ThreadedBasebandSampleSink*> m_sinks;
+    std::vector<quint64> m_startSamplesCounts;
+    std::vector<quint64> m_startDroppedCounts;
+    ThreadsTimes m_startThreadsTimes;
+    QElapsedTimer m_elapsedTimer;
+
+    static void getThreadsTimes(ThreadsTimes& threadsTimes);
+    void quit();
+
+private slots:
+    void startMeasurement();
+    void stopMeasurement();
+};
+
+#endif /* SDRSRV_DEMODBENCH_H_ */
@@ -24,6 +24,8 @@
 #include "dsp/dspengine.h"
 #include "dsp/dspdevicesourceengine.h"
 #include "dsp/dspdevicesinkengine.h"
+#include "dsp/fftengine.h"
+#include "dsp/filerecord.h"
 #include "device/devicesourceapi.h"
 #include "device/devicesinkapi.h"
 #include "device/deviceset.h"
@@ -33,6 +35,7 @@
 #include "webapi/webapirequestmapper.h"
 #include "webapi/webapiserver.h"
 #include "webapi/webapiadaptersrv.h"
+#include "demodbench.h"
 
 #include "maincore.h"
 
@@ -69,6 +72,12 @@ MainCore::MainCore(qtwebapp::LoggerWithFile *logger, const MainParser& parser, Q
 
 	loadSettings();
 
+    FFTEngine::importWisdom(m_settings.getFFTWisdomFileName());
+
+    for (std::vector<int>::const_iterator it = parser.getFFTPrewarmSizes().begin(); it != parser.getFFTPrewarmSizes().end(); ++it) {
+        FFTEngine::prewarm(*it);
+    }
+
     QString applicationDirPath = QCoreApplication::instance()->applicationDirPath();
 
     if (QResource::registerResource(applicationDirPath + "/sdrbase.rcc")) {
@@ -83,17 +92,30 @@ MainCore::MainCore(qtwebapp::LoggerWithFile *logger, const MainParser& parser, Q
     m_apiServer = new WebAPIServer(parser.getServerAddress(), parser.getServerPort(), m_requestMapper);
     m_apiServer->start();
 
+    if (parser.getBenchFile().isEmpty())
+    {
+        m_demodBench = 0;
+    }
+    else
+    {
+        m_demodBench = new DemodBench(*this, parser);
+        m_demodBench->start();
+    }
+
     qDebug() << "MainCore::MainCore: end";
 }
 
 MainCore::~MainCore()
 {
+    delete m_demodBench;
+
     while (m_deviceSets.size() > 0) {
         removeLastDevice();
     }
 
 	m_apiServer->stop();
 	m_settings.save();
+    FFTEngine::exportWisdom(m_settings.getFFTWisdomFileName());
     delete m_apiServer;
     delete m_requestMapper;
     delete m_apiAdapter;
@@ -207,6 +229,21 @@ void MainCore::loadSettings()
     m_settings.load();
     m_settings.sortPresets();
     setLoggingOptions();
+    setRecordingOptions();
+    DSPDeviceSourceEngine::setUseChannelizerBank(m_settings.getUseChannelizerBank());
+}
+
+void MainCore::setRecordingOptions()
+{
+    FileRecord::Options options;
+    int format = m_settings.getRecordFormat();
+    options.m_format = (format < 0) || (format > (int) FileRecord::FormatSigMF) ? FileRecord::FormatV1 : (FileRecord::RecordFormat) format;
+    options.m_codec = m_settings.getRecordCodec();
+    options.m_codecBits = m_settings.getRecordCodecBits();
+    options.m_rotateMB = m_settings.getRecordRotateMB();
+    options.m_rotateMinutes = m_settings.getRecordRotateMinutes();
+    options.m_directIO = m_settings.getRecordDirectIO();
+    FileRecord::setDefaultOptions(options);
 }
 
 void MainCore::setLoggingOptions()
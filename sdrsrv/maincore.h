@@ -41,6 +41,7 @@ class DeviceSet;
 class WebAPIRequestMapper;
 class WebAPIServer;
 class WebAPIAdapterSrv;
+class DemodBench;
 
 namespace qtwebapp {
     class LoggerWithFile;
@@ -68,6 +69,7 @@ public:
     void deleteChannel(int deviceSetIndex, int channelIndex);
 
     friend class WebAPIAdapterSrv;
+    friend class DemodBench;
 
 signals:
     void finished();
@@ -285,11 +287,13 @@ private:
     WebAPIRequestMapper *m_requestMapper;
     WebAPIServer *m_apiServer;
     WebAPIAdapterSrv *m_apiAdapter;
+    DemodBench *m_demodBench; //!< only in benchmark mode
 
 	void loadSettings();
 	void loadPresetSettings(const Preset* preset, int tabIndex);
 	void savePresetSettings(Preset* preset, int tabIndex);
     void setLoggingOptions();
+    void setRecordingOptions();
 
     bool handleMessage(const Message& cmd);
 
@@ -42,6 +42,7 @@
 #include "SWGErrorResponse.h"
 #include "SWGDeviceState.h"
 #include "SWGDeviceReport.h"
+#include "SWGSampleFifoReport.h"
 
 #include "maincore.h"
 #include "loggerwithfile.h"
@@ -51,6 +52,7 @@
 #include "device/deviceenumerator.h"
 #include "dsp/devicesamplesink.h"
 #include "dsp/devicesamplesource.h"
+#include "dsp/samplesinkfifo.h"
 #include "dsp/dspengine.h"
 #include "channel/channelsourceapi.h"
 #include "channel/channelsinkapi.h"
@@ -1314,6 +1316,8 @@ int WebAPIAdapterSrv::devicesetDeviceReportGet(
             response.setDeviceHwType(new QString(deviceSet->m_deviceSourceAPI->getHardwareId()));
             response.setTx(0);
             DeviceSampleSource *source = deviceSet->m_deviceSourceAPI->getSampleSource();
+            response.setSampleFifoReport(new SWGSDRangel::SWGSampleFifoReport());
+            getSampleFifoReport(response.getSampleFifoReport(), source->getSampleFifo());
             return source->webapiReportGet(response, *error.getMessage());
         }
         else if (deviceSet->m_deviceSinkEngine) // Tx
@@ -1803,6 +1807,15 @@ void WebAPIAdapterSrv::getDeviceSet(SWGSDRangel::SWGDeviceSet *swgDeviceSet, con
     }
 }
 
+void WebAPIAdapterSrv::getSampleFifoReport(SWGSDRangel::SWGSampleFifoReport *sampleFifoReport, const SampleSinkFifo *sampleFifo)
+{
+    sampleFifoReport->setSize(sampleFifo->size());
+    sampleFifoReport->setFill(sampleFifo->fill());
+    sampleFifoReport->setOverflowCount(sampleFifo->getOverflowCount());
+    sampleFifoReport->setOverflowSamples(sampleFifo->getOverflowSamples());
+    sampleFifoReport->setUnderflowCount(sampleFifo->getUnderflowCount());
+}
+
 void WebAPIAdapterSrv::getChannelsDetail(SWGSDRangel::SWGChannelsDetail *channelsDetail, const DeviceSet* deviceSet)
 {
     channelsDetail->init();
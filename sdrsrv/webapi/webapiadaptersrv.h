@@ -25,6 +25,12 @@
 
 class MainCore;
 class DeviceSet;
+class SampleSinkFifo;
+
+namespace SWGSDRangel
+{
+    class SWGSampleFifoReport;
+}
 
 class WebAPIAdapterSrv: public WebAPIAdapterInterface
 {
@@ -243,6 +249,7 @@ private:
     void getDeviceSetList(SWGSDRangel::SWGDeviceSetList* deviceSetList);
     void getDeviceSet(SWGSDRangel::SWGDeviceSet *swgDeviceSet, const DeviceSet* deviceSet, int deviceUISetIndex);
     void getChannelsDetail(SWGSDRangel::SWGChannelsDetail *channelsDetail, const DeviceSet* deviceSet);
+    void getSampleFifoReport(SWGSDRangel::SWGSampleFifoReport *sampleFifoReport, const SampleSinkFifo *sampleFifo);
     static QtMsgType getMsgTypeFromString(const QString& msgTypeString);
     static void getMsgTypeString(const QtMsgType& msgType, QString& level);
 };
@@ -40,6 +40,12 @@ SWGDaemonSinkSettings::SWGDaemonSinkSettings() {
     m_rgb_color_isSet = false;
     title = nullptr;
     m_title_isSet = false;
+    datagram_size = 0;
+    m_datagram_size_isSet = false;
+    codec = 0;
+    m_codec_isSet = false;
+    codec_bits = 0;
+    m_codec_bits_isSet = false;
 }
 
 SWGDaemonSinkSettings::~SWGDaemonSinkSettings() {
@@ -60,6 +66,12 @@ SWGDaemonSinkSettings::init() {
     m_rgb_color_isSet = false;
     title = new QString("");
     m_title_isSet = false;
+    datagram_size = 0;
+    m_datagram_size_isSet = false;
+    codec = 0;
+    m_codec_isSet = false;
+    codec_bits = 0;
+    m_codec_bits_isSet = false;
 }
 
 void
@@ -74,6 +86,9 @@ SWGDaemonSinkSettings::cleanup() {
     if(title != nullptr) { 
         delete title;
     }
+
+
+
 }
 
 SWGDaemonSinkSettings*
@@ -99,6 +114,12 @@ SWGDaemonSinkSettings::fromJsonObject(QJsonObject &pJson) {
     
     ::SWGSDRangel::setValue(&title, pJson["title"], "QString", "QString");
     
+    ::SWGSDRangel::setValue(&datagram_size, pJson["datagramSize"], "qint32", "");
+    
+    ::SWGSDRangel::setValue(&codec, pJson["codec"], "qint32", "");
+    
+    ::SWGSDRangel::setValue(&codec_bits, pJson["codecBits"], "qint32", "");
+    
 }
 
 QString
@@ -133,6 +154,15 @@ SWGDaemonSinkSettings::asJsonObject() {
     if(title != nullptr && *title != QString("")){
         toJsonValue(QString("title"), title, obj, QString("QString"));
     }
+    if(m_datagram_size_isSet){
+        obj->insert("datagramSize", QJsonValue(datagram_size));
+    }
+    if(m_codec_isSet){
+        obj->insert("codec", QJsonValue(codec));
+    }
+    if(m_codec_bits_isSet){
+        obj->insert("codecBits", QJsonValue(codec_bits));
+    }
 
     return obj;
 }
@@ -197,6 +227,36 @@ SWGDaemonSinkSettings::setTitle(QString* title) {
     this->m_title_isSet = true;
 }
 
+qint32
+SWGDaemonSinkSettings::getDatagramSize() {
+    return datagram_size;
+}
+void
+SWGDaemonSinkSettings::setDatagramSize(qint32 datagram_size) {
+    this->datagram_size = datagram_size;
+    this->m_datagram_size_isSet = true;
+}
+
+qint32
+SWGDaemonSinkSettings::getCodec() {
+    return codec;
+}
+void
+SWGDaemonSinkSettings::setCodec(qint32 codec) {
+    this->codec = codec;
+    this->m_codec_isSet = true;
+}
+
+qint32
+SWGDaemonSinkSettings::getCodecBits() {
+    return codec_bits;
+}
+void
+SWGDaemonSinkSettings::setCodecBits(qint32 codec_bits) {
+    this->codec_bits = codec_bits;
+    this->m_codec_bits_isSet = true;
+}
+
 
 bool
 SWGDaemonSinkSettings::isSet(){
@@ -208,6 +268,9 @@ SWGDaemonSinkSettings::isSet(){
         if(m_tx_delay_isSet){ isObjectUpdated = true; break;}
         if(m_rgb_color_isSet){ isObjectUpdated = true; break;}
         if(title != nullptr && *title != QString("")){ isObjectUpdated = true; break;}
+        if(m_datagram_size_isSet){ isObjectUpdated = true; break;}
+        if(m_codec_isSet){ isObjectUpdated = true; break;}
+        if(m_codec_bits_isSet){ isObjectUpdated = true; break;}
     }while(false);
     return isObjectUpdated;
 }
@@ -60,6 +60,15 @@ public:
     QString* getTitle();
     void setTitle(QString* title);
 
+    qint32 getDatagramSize();
+    void setDatagramSize(qint32 datagram_size);
+
+    qint32 getCodec();
+    void setCodec(qint32 codec);
+
+    qint32 getCodecBits();
+    void setCodecBits(qint32 codec_bits);
+
 
     virtual bool isSet() override;
 
@@ -82,6 +91,15 @@ private:
     QString* title;
     bool m_title_isSet;
 
+    qint32 datagram_size;
+    bool m_datagram_size_isSet;
+
+    qint32 codec;
+    bool m_codec_isSet;
+
+    qint32 codec_bits;
+    bool m_codec_bits_isSet;
+
 };
 
 }
@@ -64,6 +64,10 @@ SWGDeviceReport::SWGDeviceReport() {
     m_soapy_sdr_input_report_isSet = false;
     soapy_sdr_output_report = nullptr;
     m_soapy_sdr_output_report_isSet = false;
+    sample_fifo_report = nullptr;
+    m_sample_fifo_report_isSet = false;
+    file_record_report = nullptr;
+    m_file_record_report_isSet = false;
 }
 
 SWGDeviceReport::~SWGDeviceReport() {
@@ -108,6 +112,10 @@ SWGDeviceReport::init() {
     m_soapy_sdr_input_report_isSet = false;
     soapy_sdr_output_report = new SWGSoapySDRReport();
     m_soapy_sdr_output_report_isSet = false;
+    sample_fifo_report = new SWGSampleFifoReport();
+    m_sample_fifo_report_isSet = false;
+    file_record_report = new SWGFileRecordReport();
+    m_file_record_report_isSet = false;
 }
 
 void
@@ -164,6 +172,12 @@ SWGDeviceReport::cleanup() {
     if(soapy_sdr_output_report != nullptr) { 
         delete soapy_sdr_output_report;
     }
+    if(sample_fifo_report != nullptr) { 
+        delete sample_fifo_report;
+    }
+    if(file_record_report != nullptr) { 
+        delete file_record_report;
+    }
 }
 
 SWGDeviceReport*
@@ -213,6 +227,10 @@ SWGDeviceReport::fromJsonObject(QJsonObject &pJson) {
     
     ::SWGSDRangel::setValue(&soapy_sdr_output_report, pJson["soapySDROutputReport"], "SWGSoapySDRReport", "SWGSoapySDRReport");
     
+    ::SWGSDRangel::setValue(&sample_fifo_report, pJson["sampleFifoReport"], "SWGSampleFifoReport", "SWGSampleFifoReport");
+    
+    ::SWGSDRangel::setValue(&file_record_report, pJson["fileRecordReport"], "SWGFileRecordReport", "SWGFileRecordReport");
+    
 }
 
 QString
@@ -283,6 +301,12 @@ SWGDeviceReport::asJsonObject() {
     if((soapy_sdr_output_report != nullptr) && (soapy_sdr_output_report->isSet())){
         toJsonValue(QString("soapySDROutputReport"), soapy_sdr_output_report, obj, QString("SWGSoapySDRReport"));
     }
+    if((sample_fifo_report != nullptr) && (sample_fifo_report->isSet())){
+        toJsonValue(QString("sampleFifoReport"), sample_fifo_report, obj, QString("SWGSampleFifoReport"));
+    }
+    if((file_record_report != nullptr) && (file_record_report->isSet())){
+        toJsonValue(QString("fileRecordReport"), file_record_report, obj, QString("SWGFileRecordReport"));
+    }
 
     return obj;
 }
@@ -467,6 +491,26 @@ SWGDeviceReport::setSoapySdrOutputReport(SWGSoapySDRReport* soapy_sdr_output_rep
     this->m_soapy_sdr_output_report_isSet = true;
 }
 
+SWGSampleFifoReport*
+SWGDeviceReport::getSampleFifoReport() {
+    return sample_fifo_report;
+}
+void
+SWGDeviceReport::setSampleFifoReport(SWGSampleFifoReport* sample_fifo_report) {
+    this->sample_fifo_report = sample_fifo_report;
+    this->m_sample_fifo_report_isSet = true;
+}
+
+SWGFileRecordReport*
+SWGDeviceReport::getFileRecordReport() {
+    return file_record_report;
+}
+void
+SWGDeviceReport::setFileRecordReport(SWGFileRecordReport* file_record_report) {
+    this->file_record_report = file_record_report;
+    this->m_file_record_report_isSet = true;
+}
+
 
 bool
 SWGDeviceReport::isSet(){
@@ -490,6 +534,8 @@ SWGDeviceReport::isSet(){
         if(sdr_play_report != nullptr && sdr_play_report->isSet()){ isObjectUpdated = true; break;}
         if(soapy_sdr_input_report != nullptr && soapy_sdr_input_report->isSet()){ isObjectUpdated = true; break;}
         if(soapy_sdr_output_report != nullptr && soapy_sdr_output_report->isSet()){ isObjectUpdated = true; break;}
+        if(sample_fifo_report != nullptr && sample_fifo_report->isSet()){ isObjectUpdated = true; break;}
+        if(file_record_report != nullptr && file_record_report->isSet()){ isObjectUpdated = true; break;}
     }while(false);
     return isObjectUpdated;
 }
@@ -26,6 +26,7 @@
 #include "SWGAirspyReport.h"
 #include "SWGBladeRF2InputReport.h"
 #include "SWGBladeRF2OutputReport.h"
+#include "SWGFileRecordReport.h"
 #include "SWGFileSourceReport.h"
 #include "SWGLimeSdrInputReport.h"
 #include "SWGLimeSdrOutputReport.h"
@@ -36,6 +37,7 @@
 #include "SWGSDRPlayReport.h"
 #include "SWGSDRdaemonSinkReport.h"
 #include "SWGSDRdaemonSourceReport.h"
+#include "SWGSampleFifoReport.h"
 #include "SWGSoapySDRReport.h"
 #include <QString>
 
@@ -111,6 +113,12 @@ public:
     SWGSoapySDRReport* getSoapySdrOutputReport();
     void setSoapySdrOutputReport(SWGSoapySDRReport* soapy_sdr_output_report);
 
+    SWGSampleFifoReport* getSampleFifoReport();
+    void setSampleFifoReport(SWGSampleFifoReport* sample_fifo_report);
+
+    SWGFileRecordReport* getFileRecordReport();
+    void setFileRecordReport(SWGFileRecordReport* file_record_report);
+
 
     virtual bool isSet() override;
 
@@ -169,6 +177,12 @@ private:
     SWGSoapySDRReport* soapy_sdr_output_report;
     bool m_soapy_sdr_output_report_isSet;
 
+    SWGSampleFifoReport* sample_fifo_report;
+    bool m_sample_fifo_report_isSet;
+
+    SWGFileRecordReport* file_record_report;
+    bool m_file_record_report_isSet;
+
 };
 
 }
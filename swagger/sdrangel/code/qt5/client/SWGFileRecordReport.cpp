@@ -0,0 +1,169 @@
+/**
+ * SDRangel
+ * This is the web REST/JSON API of SDRangel SDR software. SDRangel is an Open Source Qt5/OpenGL 3.0+ (4.3+ in Windows) GUI and server Software Defined Radio and signal analyzer in software. It supports Airspy, BladeRF, HackRF, LimeSDR, PlutoSDR, RTL-SDR, SDRplay RSP1 and FunCube    ---   Limitations and specifcities:    * In SDRangel GUI the first Rx device set cannot be deleted. Conversely the server starts with no device sets and its number of device sets can be reduced to zero by as many calls as necessary to /sdrangel/deviceset with DELETE method.   * Preset import and export from/to file is a server only feature.   * Device set focus is a GUI only feature.   * The following channels are not implemented (status 501 is returned): ATV and DATV demodulators, Channel Analyzer NG, LoRa demodulator   * The device settings and report structures contains only the sub-structure corresponding to the device type. The DeviceSettings and DeviceReport structures documented here shows all of them but only one will be or should be present at a time   * The channel settings and report structures contains only the sub-structure corresponding to the channel type. The ChannelSettings and ChannelReport structures documented here shows all of them but only one will be or should be present at a time    --- 
+ *
+ * OpenAPI spec version: 4.3.0
+ * Contact: f4exb06@gmail.com
+ *
+ * NOTE: This class is auto generated by the swagger code generator program.
+ * https://github.com/swagger-api/swagger-codegen.git
+ * Do not edit the class manually.
+ */
+
+
+#include "SWGFileRecordReport.h"
+
+#include "SWGHelpers.h"
+
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QObject>
+#include <QDebug>
+
+namespace SWGSDRangel {
+
+SWGFileRecordReport::SWGFileRecordReport(QString* json) {
+    init();
+    this->fromJson(*json);
+}
+
+SWGFileRecordReport::SWGFileRecordReport() {
+    bytes_pending = 0;
+    m_bytes_pending_isSet = false;
+    bytes_dropped = 0;
+    m_bytes_dropped_isSet = false;
+    avg_write_latency_us = 0;
+    m_avg_write_latency_us_isSet = false;
+    max_write_latency_us = 0;
+    m_max_write_latency_us_isSet = false;
+}
+
+SWGFileRecordReport::~SWGFileRecordReport() {
+    this->cleanup();
+}
+
+void
+SWGFileRecordReport::init() {
+    bytes_pending = 0;
+    m_bytes_pending_isSet = false;
+    bytes_dropped = 0;
+    m_bytes_dropped_isSet = false;
+    avg_write_latency_us = 0;
+    m_avg_write_latency_us_isSet = false;
+    max_write_latency_us = 0;
+    m_max_write_latency_us_isSet = false;
+}
+
+void
+SWGFileRecordReport::cleanup() {
+
+
+
+
+}
+
+SWGFileRecordReport*
+SWGFileRecordReport::fromJson(QString &json) {
+    QByteArray array (json.toStdString().c_str());
+    QJsonDocument doc = QJsonDocument::fromJson(array);
+    QJsonObject jsonObject = doc.object();
+    this->fromJsonObject(jsonObject);
+    return this;
+}
+
+void
+SWGFileRecordReport::fromJsonObject(QJsonObject &pJson) {
+    ::SWGSDRangel::setValue(&bytes_pending, pJson["bytesPending"], "qint64", "");
+    
+    ::SWGSDRangel::setValue(&bytes_dropped, pJson["bytesDropped"], "qint64", "");
+    
+    ::SWGSDRangel::setValue(&avg_write_latency_us, pJson["avgWriteLatencyUs"], "qint32", "");
+    
+    ::SWGSDRangel::setValue(&max_write_latency_us, pJson["maxWriteLatencyUs"], "qint32", "");
+    
+}
+
+QString
+SWGFileRecordReport::asJson ()
+{
+    QJsonObject* obj = this->asJsonObject();
+
+    QJsonDocument doc(*obj);
+    QByteArray bytes = doc.toJson();
+    delete obj;
+    return QString(bytes);
+}
+
+QJsonObject*
+SWGFileRecordReport::asJsonObject() {
+    QJsonObject* obj = new QJsonObject();
+    if(m_bytes_pending_isSet){
+        obj->insert("bytesPending", QJsonValue(bytes_pending));
+    }
+    if(m_bytes_dropped_isSet){
+        obj->insert("bytesDropped", QJsonValue(bytes_dropped));
+    }
+    if(m_avg_write_latency_us_isSet){
+        obj->insert("avgWriteLatencyUs", QJsonValue(avg_write_latency_us));
+    }
+    if(m_max_write_latency_us_isSet){
+        obj->insert("maxWriteLatencyUs", QJsonValue(max_write_latency_us));
+    }
+
+    return obj;
+}
+
+qint64
+SWGFileRecordReport::getBytesPending() {
+    return bytes_pending;
+}
+void
+SWGFileRecordReport::setBytesPending(qint64 bytes_pending) {
+    this->bytes_pending = bytes_pending;
+    this->m_bytes_pending_isSet = true;
+}
+
+qint64
+SWGFileRecordReport::getBytesDropped() {
+    return bytes_dropped;
+}
+void
+SWGFileRecordReport::setBytesDropped(qint64 bytes_dropped) {
+    this->bytes_dropped = bytes_dropped;
+    this->m_bytes_dropped_isSet = true;
+}
+
+qint32
+SWGFileRecordReport::getAvgWriteLatencyUs() {
+    return avg_write_latency_us;
+}
+void
+SWGFileRecordReport::setAvgWriteLatencyUs(qint32 avg_write_latency_us) {
+    this->avg_write_latency_us = avg_write_latency_us;
+    this->m_avg_write_latency_us_isSet = true;
+}
+
+qint32
+SWGFileRecordReport::getMaxWriteLatencyUs() {
+    return max_write_latency_us;
+}
+void
+SWGFileRecordReport::setMaxWriteLatencyUs(qint32 max_write_latency_us) {
+    this->max_write_latency_us = max_write_latency_us;
+    this->m_max_write_latency_us_isSet = true;
+}
+
+
+bool
+SWGFileRecordReport::isSet(){
+    bool isObjectUpdated = false;
+    do{
+        if(m_bytes_pending_isSet){ isObjectUpdated = true; break;}
+        if(m_bytes_dropped_isSet){ isObjectUpdated = true; break;}
+        if(m_avg_write_latency_us_isSet){ isObjectUpdated = true; break;}
+        if(m_max_write_latency_us_isSet){ isObjectUpdated = true; break;}
+    }while(false);
+    return isObjectUpdated;
+}
+}
+
@@ -0,0 +1,76 @@
+/**
+ * SDRangel
+ * This is the web REST/JSON API of SDRangel SDR software. SDRangel is an Open Source Qt5/OpenGL 3.0+ (4.3+ in Windows) GUI and server Software Defined Radio and signal analyzer in software. It supports Airspy, BladeRF, HackRF, LimeSDR, PlutoSDR, RTL-SDR, SDRplay RSP1 and FunCube    ---   Limitations and specifcities:    * In SDRangel GUI the first Rx device set cannot be deleted. Conversely the server starts with no device sets and its number of device sets can be reduced to zero by as many calls as necessary to /sdrangel/deviceset with DELETE method.   * Preset import and export from/to file is a server only feature.   * Device set focus is a GUI only feature.   * The following channels are not implemented (status 501 is returned): ATV and DATV demodulators, Channel Analyzer NG, LoRa demodulator   * The device settings and report structures contains only the sub-structure corresponding to the device type. The DeviceSettings and DeviceReport structures documented here shows all of them but only one will be or should be present at a time   * The channel settings and report structures contains only the sub-structure corresponding to the channel type. The ChannelSettings and ChannelReport structures documented here shows all of them but only one will be or should be present at a time    --- 
+ *
+ * OpenAPI spec version: 4.3.0
+ * Contact: f4exb06@gmail.com
+ *
+ * NOTE: This class is auto generated by the swagger code generator program.
+ * https://github.com/swagger-api/swagger-codegen.git
+ * Do not edit the class manually.
+ */
+
+/*
+ * SWGFileRecordReport.h
+ *
+ * Statistics of the baseband I/Q recording of a Rx device
+ */
+
+#ifndef SWGFileRecordReport_H_
+#define SWGFileRecordReport_H_
+
+#include <QJsonObject>
+
+
+
+#include "SWGObject.h"
+#include "export.h"
+
+namespace SWGSDRangel {
+
+class SWG_API SWGFileRecordReport: public SWGObject {
+public:
+    SWGFileRecordReport();
+    SWGFileRecordReport(QString* json);
+    virtual ~SWGFileRecordReport();
+    void init();
+    void cleanup();
+
+    virtual QString asJson () override;
+    virtual QJsonObject* asJsonObject() override;
+    virtual void fromJsonObject(QJsonObject &json) override;
+    virtual SWGFileRecordReport* fromJson(QString &jsonString) override;
+
+    qint64 getBytesPending();
+    void setBytesPending(qint64 bytes_pending);
+
+    qint64 getBytesDropped();
+    void setBytesDropped(qint64 bytes_dropped);
+
+    qint32 getAvgWriteLatencyUs();
+    void setAvgWriteLatencyUs(qint32 avg_write_latency_us);
+
+    qint32 getMaxWriteLatencyUs();
+    void setMaxWriteLatencyUs(qint32 max_write_latency_us);
+
+
+    virtual bool isSet() override;
+
+private:
+    qint64 bytes_pending;
+    bool m_bytes_pending_isSet;
+
+    qint64 bytes_dropped;
+    bool m_bytes_dropped_isSet;
+
+    qint32 avg_write_latency_us;
+    bool m_avg_write_latency_us_isSet;
+
+    qint32 max_write_latency_us;
+    bool m_max_write_latency_us_isSet;
+
+};
+
+}
+
+#endif /* SWGFileRecordReport_H_ */
@@ -32,8 +32,14 @@ SWGFileSourceSettings::SWGFileSourceSettings() {
     m_file_name_isSet = false;
     acceleration_factor = 0;
     m_acceleration_factor_isSet = false;
+    half_speed = 0;
+    m_half_speed_isSet = false;
     loop = 0;
     m_loop_isSet = false;
+    loop_start_ms = 0;
+    m_loop_start_ms_isSet = false;
+    loop_end_ms = 0;
+    m_loop_end_ms_isSet = false;
 }
 
 SWGFileSourceSettings::~SWGFileSourceSettings() {
@@ -46,8 +52,14 @@ SWGFileSourceSettings::init() {
     m_file_name_isSet = false;
     acceleration_factor = 0;
     m_acceleration_factor_isSet = false;
+    half_speed = 0;
+    m_half_speed_isSet = false;
     loop = 0;
     m_loop_isSet = false;
+    loop_start_ms = 0;
+    m_loop_start_ms_isSet = false;
+    loop_end_ms = 0;
+    m_loop_end_ms_isSet = false;
 }
 
 void
@@ -57,6 +69,9 @@ SWGFileSourceSettings::cleanup() {
     }
 
 
+
+
+
 }
 
 SWGFileSourceSettings*
@@ -74,8 +89,14 @@ SWGFileSourceSettings::fromJsonObject(QJsonObject &pJson) {
     
     ::SWGSDRangel::setValue(&acceleration_factor, pJson["accelerationFactor"], "qint32", "");
     
+    ::SWGSDRangel::setValue(&half_speed, pJson["halfSpeed"], "qint32", "");
+    
     ::SWGSDRangel::setValue(&loop, pJson["loop"], "qint32", "");
     
+    ::SWGSDRangel::setValue(&loop_start_ms, pJson["loopStartMs"], "qint32", "");
+    
+    ::SWGSDRangel::setValue(&loop_end_ms, pJson["loopEndMs"], "qint32", "");
+    
 }
 
 QString
@@ -98,9 +119,18 @@ SWGFileSourceSettings::asJsonObject() {
     if(m_acceleration_factor_isSet){
         obj->insert("accelerationFactor", QJsonValue(acceleration_factor));
     }
+    if(m_half_speed_isSet){
+        obj->insert("halfSpeed", QJsonValue(half_speed));
+    }
     if(m_loop_isSet){
         obj->insert("loop", QJsonValue(loop));
     }
+    if(m_loop_start_ms_isSet){
+        obj->insert("loopStartMs", QJsonValue(loop_start_ms));
+    }
+    if(m_loop_end_ms_isSet){
+        obj->insert("loopEndMs", QJsonValue(loop_end_ms));
+    }
 
     return obj;
 }
@@ -125,6 +155,16 @@ SWGFileSourceSettings::setAccelerationFactor(qint32 acceleration_factor) {
     this->m_acceleration_factor_isSet = true;
 }
 
+qint32
+SWGFileSourceSettings::getHalfSpeed() {
+    return half_speed;
+}
+void
+SWGFileSourceSettings::setHalfSpeed(qint32 half_speed) {
+    this->half_speed = half_speed;
+    this->m_half_speed_isSet = true;
+}
+
 qint32
 SWGFileSourceSettings::getLoop() {
     return loop;
@@ -135,6 +175,26 @@ SWGFileSourceSettings::setLoop(qint32 loop) {
     this->m_loop_isSet = true;
 }
 
+qint32
+SWGFileSourceSettings::getLoopStartMs() {
+    return loop_start_ms;
+}
+void
+SWGFileSourceSettings::setLoopStartMs(qint32 loop_start_ms) {
+    this->loop_start_ms = loop_start_ms;
+    this->m_loop_start_ms_isSet = true;
+}
+
+qint32
+SWGFileSourceSettings::getLoopEndMs() {
+    return loop_end_ms;
+}
+void
+SWGFileSourceSettings::setLoopEndMs(qint32 loop_end_ms) {
+    this->loop_end_ms = loop_end_ms;
+    this->m_loop_end_ms_isSet = true;
+}
+
 
 bool
 SWGFileSourceSettings::isSet(){
@@ -142,7 +202,10 @@ SWGFileSourceSettings::isSet(){
     do{
         if(file_name != nullptr && *file_name != QString("")){ isObjectUpdated = true; break;}
         if(m_acceleration_factor_isSet){ isObjectUpdated = true; break;}
+        if(m_half_speed_isSet){ isObjectUpdated = true; break;}
         if(m_loop_isSet){ isObjectUpdated = true; break;}
+        if(m_loop_start_ms_isSet){ isObjectUpdated = true; break;}
+        if(m_loop_end_ms_isSet){ isObjectUpdated = true; break;}
     }while(false);
     return isObjectUpdated;
 }
@@ -48,9 +48,18 @@ public:
     qint32 getAccelerationFactor();
     void setAccelerationFactor(qint32 acceleration_factor);
 
+    qint32 getHalfSpeed();
+    void setHalfSpeed(qint32 half_speed);
+
     qint32 getLoop();
     void setLoop(qint32 loop);
 
+    qint32 getLoopStartMs();
+    void setLoopStartMs(qint32 loop_start_ms);
+
+    qint32 getLoopEndMs();
+    void setLoopEndMs(qint32 loop_end_ms);
+
 
     virtual bool isSet() override;
 
@@ -61,9 +70,18 @@ private:
     qint32 acceleration_factor;
     bool m_acceleration_factor_isSet;
 
+    qint32 half_speed;
+    bool m_half_speed_isSet;
+
     qint32 loop;
     bool m_loop_isSet;
 
+    qint32 loop_start_ms;
+    bool m_loop_start_ms_isSet;
+
+    qint32 loop_end_ms;
+    bool m_loop_end_ms_isSet;
+
 };
 
 }
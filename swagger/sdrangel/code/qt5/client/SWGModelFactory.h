@@ -61,6 +61,7 @@
 #include "SWGErrorResponse.h"
 #include "SWGFCDProPlusSettings.h"
 #include "SWGFCDProSettings.h"
+#include "SWGFileRecordReport.h"
 #include "SWGFileSourceReport.h"
 #include "SWGFileSourceSettings.h"
 #include "SWGFrequency.h"
@@ -112,6 +113,7 @@
 #include "SWGSSBDemodSettings.h"
 #include "SWGSSBModReport.h"
 #include "SWGSSBModSettings.h"
+#include "SWGSampleFifoReport.h"
 #include "SWGSampleRate.h"
 #include "SWGSamplingDevice.h"
 #include "SWGSoapySDRFrequencySetting.h"
@@ -274,6 +276,9 @@ namespace SWGSDRangel {
     if(QString("SWGFCDProSettings").compare(type) == 0) {
       return new SWGFCDProSettings();
     }
+    if(QString("SWGFileRecordReport").compare(type) == 0) {
+      return new SWGFileRecordReport();
+    }
     if(QString("SWGFileSourceReport").compare(type) == 0) {
       return new SWGFileSourceReport();
     }
@@ -427,6 +432,9 @@ namespace SWGSDRangel {
     if(QString("SWGSSBModSettings").compare(type) == 0) {
       return new SWGSSBModSettings();
     }
+    if(QString("SWGSampleFifoReport").compare(type) == 0) {
+      return new SWGSampleFifoReport();
+    }
     if(QString("SWGSampleRate").compare(type) == 0) {
       return new SWGSampleRate();
     }
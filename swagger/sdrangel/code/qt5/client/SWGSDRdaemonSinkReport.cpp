@@ -32,6 +32,12 @@ SWGSDRdaemonSinkReport::SWGSDRdaemonSinkReport() {
     m_buffer_rw_balance_isSet = false;
     sample_count = 0;
     m_sample_count_isSet = false;
+    nb_fec_encoders = 0;
+    m_nb_fec_encoders_isSet = false;
+    avg_fec_encode_time_us = 0;
+    m_avg_fec_encode_time_us_isSet = false;
+    max_fec_encode_time_us = 0;
+    m_max_fec_encode_time_us_isSet = false;
 }
 
 SWGSDRdaemonSinkReport::~SWGSDRdaemonSinkReport() {
@@ -44,12 +50,21 @@ SWGSDRdaemonSinkReport::init() {
     m_buffer_rw_balance_isSet = false;
     sample_count = 0;
     m_sample_count_isSet = false;
+    nb_fec_encoders = 0;
+    m_nb_fec_encoders_isSet = false;
+    avg_fec_encode_time_us = 0;
+    m_avg_fec_encode_time_us_isSet = false;
+    max_fec_encode_time_us = 0;
+    m_max_fec_encode_time_us_isSet = false;
 }
 
 void
 SWGSDRdaemonSinkReport::cleanup() {
 
 
+
+
+
 }
 
 SWGSDRdaemonSinkReport*
@@ -67,6 +82,12 @@ SWGSDRdaemonSinkReport::fromJsonObject(QJsonObject &pJson) {
     
     ::SWGSDRangel::setValue(&sample_count, pJson["sampleCount"], "qint32", "");
     
+    ::SWGSDRangel::setValue(&nb_fec_encoders, pJson["nbFECEncoders"], "qint32", "");
+    
+    ::SWGSDRangel::setValue(&avg_fec_encode_time_us, pJson["avgFECEncodeTimeUs"], "qint32", "");
+    
+    ::SWGSDRangel::setValue(&max_fec_encode_time_us, pJson["maxFECEncodeTimeUs"], "qint32", "");
+    
 }
 
 QString
@@ -89,6 +110,15 @@ SWGSDRdaemonSinkReport::asJsonObject() {
     if(m_sample_count_isSet){
         obj->insert("sampleCount", QJsonValue(sample_count));
     }
+    if(m_nb_fec_encoders_isSet){
+        obj->insert("nbFECEncoders", QJsonValue(nb_fec_encoders));
+    }
+    if(m_avg_fec_encode_time_us_isSet){
+        obj->insert("avgFECEncodeTimeUs", QJsonValue(avg_fec_encode_time_us));
+    }
+    if(m_max_fec_encode_time_us_isSet){
+        obj->insert("maxFECEncodeTimeUs", QJsonValue(max_fec_encode_time_us));
+    }
 
     return obj;
 }
@@ -113,6 +143,36 @@ SWGSDRdaemonSinkReport::setSampleCount(qint32 sample_count) {
     this->m_sample_count_isSet = true;
 }
 
+qint32
+SWGSDRdaemonSinkReport::getNbFecEncoders() {
+    return nb_fec_encoders;
+}
+void
+SWGSDRdaemonSinkReport::setNbFecEncoders(qint32 nb_fec_encoders) {
+    this->nb_fec_encoders = nb_fec_encoders;
+    this->m_nb_fec_encoders_isSet = true;
+}
+
+qint32
+SWGSDRdaemonSinkReport::getAvgFecEncodeTimeUs() {
+    return avg_fec_encode_time_us;
+}
+void
+SWGSDRdaemonSinkReport::setAvgFecEncodeTimeUs(qint32 avg_fec_encode_time_us) {
+    this->avg_fec_encode_time_us = avg_fec_encode_time_us;
+    this->m_avg_fec_encode_time_us_isSet = true;
+}
+
+qint32
+SWGSDRdaemonSinkReport::getMaxFecEncodeTimeUs() {
+    return max_fec_encode_time_us;
+}
+void
+SWGSDRdaemonSinkReport::setMaxFecEncodeTimeUs(qint32 max_fec_encode_time_us) {
+    this->max_fec_encode_time_us = max_fec_encode_time_us;
+    this->m_max_fec_encode_time_us_isSet = true;
+}
+
 
 bool
 SWGSDRdaemonSinkReport::isSet(){
@@ -120,6 +180,9 @@ SWGSDRdaemonSinkReport::isSet(){
     do{
         if(m_buffer_rw_balance_isSet){ isObjectUpdated = true; break;}
         if(m_sample_count_isSet){ isObjectUpdated = true; break;}
+        if(m_nb_fec_encoders_isSet){ isObjectUpdated = true; break;}
+        if(m_avg_fec_encode_time_us_isSet){ isObjectUpdated = true; break;}
+        if(m_max_fec_encode_time_us_isSet){ isObjectUpdated = true; break;}
     }while(false);
     return isObjectUpdated;
 }
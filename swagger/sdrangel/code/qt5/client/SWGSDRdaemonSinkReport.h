@@ -47,6 +47,15 @@ public:
     qint32 getSampleCount();
     void setSampleCount(qint32 sample_count);
 
+    qint32 getNbFecEncoders();
+    void setNbFecEncoders(qint32 nb_fec_encoders);
+
+    qint32 getAvgFecEncodeTimeUs();
+    void setAvgFecEncodeTimeUs(qint32 avg_fec_encode_time_us);
+
+    qint32 getMaxFecEncodeTimeUs();
+    void setMaxFecEncodeTimeUs(qint32 max_fec_encode_time_us);
+
 
     virtual bool isSet() override;
 
@@ -57,6 +66,15 @@ private:
     qint32 sample_count;
     bool m_sample_count_isSet;
 
+    qint32 nb_fec_encoders;
+    bool m_nb_fec_encoders_isSet;
+
+    qint32 avg_fec_encode_time_us;
+    bool m_avg_fec_encode_time_us_isSet;
+
+    qint32 max_fec_encode_time_us;
+    bool m_max_fec_encode_time_us_isSet;
+
 };
 
 }
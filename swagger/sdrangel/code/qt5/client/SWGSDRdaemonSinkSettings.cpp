@@ -48,6 +48,8 @@ SWGSDRdaemonSinkSettings::SWGSDRdaemonSinkSettings() {
     m_device_index_isSet = false;
     channel_index = 0;
     m_channel_index_isSet = false;
+    datagram_size = 0;
+    m_datagram_size_isSet = false;
 }
 
 SWGSDRdaemonSinkSettings::~SWGSDRdaemonSinkSettings() {
@@ -76,6 +78,8 @@ SWGSDRdaemonSinkSettings::init() {
     m_device_index_isSet = false;
     channel_index = 0;
     m_channel_index_isSet = false;
+    datagram_size = 0;
+    m_datagram_size_isSet = false;
 }
 
 void
@@ -94,6 +98,7 @@ SWGSDRdaemonSinkSettings::cleanup() {
 
 
 
+
 }
 
 SWGSDRdaemonSinkSettings*
@@ -127,6 +132,8 @@ SWGSDRdaemonSinkSettings::fromJsonObject(QJsonObject &pJson) {
     
     ::SWGSDRangel::setValue(&channel_index, pJson["channelIndex"], "qint32", "");
     
+    ::SWGSDRangel::setValue(&datagram_size, pJson["datagramSize"], "qint32", "");
+    
 }
 
 QString
@@ -173,6 +180,9 @@ SWGSDRdaemonSinkSettings::asJsonObject() {
     if(m_channel_index_isSet){
         obj->insert("channelIndex", QJsonValue(channel_index));
     }
+    if(m_datagram_size_isSet){
+        obj->insert("datagramSize", QJsonValue(datagram_size));
+    }
 
     return obj;
 }
@@ -277,6 +287,16 @@ SWGSDRdaemonSinkSettings::setChannelIndex(qint32 channel_index) {
     this->m_channel_index_isSet = true;
 }
 
+qint32
+SWGSDRdaemonSinkSettings::getDatagramSize() {
+    return datagram_size;
+}
+void
+SWGSDRdaemonSinkSettings::setDatagramSize(qint32 datagram_size) {
+    this->datagram_size = datagram_size;
+    this->m_datagram_size_isSet = true;
+}
+
 
 bool
 SWGSDRdaemonSinkSettings::isSet(){
@@ -292,6 +312,7 @@ SWGSDRdaemonSinkSettings::isSet(){
         if(m_data_port_isSet){ isObjectUpdated = true; break;}
         if(m_device_index_isSet){ isObjectUpdated = true; break;}
         if(m_channel_index_isSet){ isObjectUpdated = true; break;}
+        if(m_datagram_size_isSet){ isObjectUpdated = true; break;}
     }while(false);
     return isObjectUpdated;
 }
@@ -72,6 +72,9 @@ public:
     qint32 getChannelIndex();
     void setChannelIndex(qint32 channel_index);
 
+    qint32 getDatagramSize();
+    void setDatagramSize(qint32 datagram_size);
+
 
     virtual bool isSet() override;
 
@@ -106,6 +109,9 @@ private:
     qint32 channel_index;
     bool m_channel_index_isSet;
 
+    qint32 datagram_size;
+    bool m_datagram_size_isSet;
+
 };
 
 }
@@ -40,6 +40,16 @@ SWGSDRdaemonSourceReport::SWGSDRdaemonSourceReport() {
     m_min_nb_blocks_isSet = false;
     max_nb_recovery = 0;
     m_max_nb_recovery_isSet = false;
+    nb_fec_decoders = 0;
+    m_nb_fec_decoders_isSet = false;
+    avg_fec_decode_time_us = 0;
+    m_avg_fec_decode_time_us_isSet = false;
+    max_fec_decode_time_us = 0;
+    m_max_fec_decode_time_us_isSet = false;
+    compression_ratio = 0.0f;
+    m_compression_ratio_isSet = false;
+    avg_decompress_ns_per_sample = 0.0f;
+    m_avg_decompress_ns_per_sample_isSet = false;
 }
 
 SWGSDRdaemonSourceReport::~SWGSDRdaemonSourceReport() {
@@ -60,6 +70,16 @@ SWGSDRdaemonSourceReport::init() {
     m_min_nb_blocks_isSet = false;
     max_nb_recovery = 0;
     m_max_nb_recovery_isSet = false;
+    nb_fec_decoders = 0;
+    m_nb_fec_decoders_isSet = false;
+    avg_fec_decode_time_us = 0;
+    m_avg_fec_decode_time_us_isSet = false;
+    max_fec_decode_time_us = 0;
+    m_max_fec_decode_time_us_isSet = false;
+    compression_ratio = 0.0f;
+    m_compression_ratio_isSet = false;
+    avg_decompress_ns_per_sample = 0.0f;
+    m_avg_decompress_ns_per_sample_isSet = false;
 }
 
 void
@@ -72,6 +92,11 @@ SWGSDRdaemonSourceReport::cleanup() {
     }
 
 
+
+
+
+
+
 }
 
 SWGSDRdaemonSourceReport*
@@ -97,6 +122,16 @@ SWGSDRdaemonSourceReport::fromJsonObject(QJsonObject &pJson) {
     
     ::SWGSDRangel::setValue(&max_nb_recovery, pJson["maxNbRecovery"], "qint32", "");
     
+    ::SWGSDRangel::setValue(&nb_fec_decoders, pJson["nbFECDecoders"], "qint32", "");
+    
+    ::SWGSDRangel::setValue(&avg_fec_decode_time_us, pJson["avgFECDecodeTimeUs"], "qint32", "");
+    
+    ::SWGSDRangel::setValue(&max_fec_decode_time_us, pJson["maxFECDecodeTimeUs"], "qint32", "");
+    
+    ::SWGSDRangel::setValue(&compression_ratio, pJson["compressionRatio"], "float", "");
+    
+    ::SWGSDRangel::setValue(&avg_decompress_ns_per_sample, pJson["avgDecompressNsPerSample"], "float", "");
+    
 }
 
 QString
@@ -131,6 +166,21 @@ SWGSDRdaemonSourceReport::asJsonObject() {
     if(m_max_nb_recovery_isSet){
         obj->insert("maxNbRecovery", QJsonValue(max_nb_recovery));
     }
+    if(m_nb_fec_decoders_isSet){
+        obj->insert("nbFECDecoders", QJsonValue(nb_fec_decoders));
+    }
+    if(m_avg_fec_decode_time_us_isSet){
+        obj->insert("avgFECDecodeTimeUs", QJsonValue(avg_fec_decode_time_us));
+    }
+    if(m_max_fec_decode_time_us_isSet){
+        obj->insert("maxFECDecodeTimeUs", QJsonValue(max_fec_decode_time_us));
+    }
+    if(m_compression_ratio_isSet){
+        obj->insert("compressionRatio", QJsonValue(compression_ratio));
+    }
+    if(m_avg_decompress_ns_per_sample_isSet){
+        obj->insert("avgDecompressNsPerSample", QJsonValue(avg_decompress_ns_per_sample));
+    }
 
     return obj;
 }
@@ -195,6 +245,56 @@ SWGSDRdaemonSourceReport::setMaxNbRecovery(qint32 max_nb_recovery) {
     this->m_max_nb_recovery_isSet = true;
 }
 
+qint32
+SWGSDRdaemonSourceReport::getNbFecDecoders() {
+    return nb_fec_decoders;
+}
+void
+SWGSDRdaemonSourceReport::setNbFecDecoders(qint32 nb_fec_decoders) {
+    this->nb_fec_decoders = nb_fec_decoders;
+    this->m_nb_fec_decoders_isSet = true;
+}
+
+qint32
+SWGSDRdaemonSourceReport::getAvgFecDecodeTimeUs() {
+    return avg_fec_decode_time_us;
+}
+void
+SWGSDRdaemonSourceReport::setAvgFecDecodeTimeUs(qint32 avg_fec_decode_time_us) {
+    this->avg_fec_decode_time_us = avg_fec_decode_time_us;
+    this->m_avg_fec_decode_time_us_isSet = true;
+}
+
+qint32
+SWGSDRdaemonSourceReport::getMaxFecDecodeTimeUs() {
+    return max_fec_decode_time_us;
+}
+void
+SWGSDRdaemonSourceReport::setMaxFecDecodeTimeUs(qint32 max_fec_decode_time_us) {
+    this->max_fec_decode_time_us = max_fec_decode_time_us;
+    this->m_max_fec_decode_time_us_isSet = true;
+}
+
+float
+SWGSDRdaemonSourceReport::getCompressionRatio() {
+    return compression_ratio;
+}
+void
+SWGSDRdaemonSourceReport::setCompressionRatio(float compression_ratio) {
+    this->compression_ratio = compression_ratio;
+    this->m_compression_ratio_isSet = true;
+}
+
+float
+SWGSDRdaemonSourceReport::getAvgDecompressNsPerSample() {
+    return avg_decompress_ns_per_sample;
+}
+void
+SWGSDRdaemonSourceReport::setAvgDecompressNsPerSample(float avg_decompress_ns_per_sample) {
+    this->avg_decompress_ns_per_sample = avg_decompress_ns_per_sample;
+    this->m_avg_decompress_ns_per_sample_isSet = true;
+}
+
 
 bool
 SWGSDRdaemonSourceReport::isSet(){
@@ -206,6 +306,11 @@ SWGSDRdaemonSourceReport::isSet(){
         if(daemon_timestamp != nullptr && *daemon_timestamp != QString("")){ isObjectUpdated = true; break;}
         if(m_min_nb_blocks_isSet){ isObjectUpdated = true; break;}
         if(m_max_nb_recovery_isSet){ isObjectUpdated = true; break;}
+        if(m_nb_fec_decoders_isSet){ isObjectUpdated = true; break;}
+        if(m_avg_fec_decode_time_us_isSet){ isObjectUpdated = true; break;}
+        if(m_max_fec_decode_time_us_isSet){ isObjectUpdated = true; break;}
+        if(m_compression_ratio_isSet){ isObjectUpdated = true; break;}
+        if(m_avg_decompress_ns_per_sample_isSet){ isObjectUpdated = true; break;}
     }while(false);
     return isObjectUpdated;
 }
@@ -60,6 +60,21 @@ public:
     qint32 getMaxNbRecovery();
     void setMaxNbRecovery(qint32 max_nb_recovery);
 
+    qint32 getNbFecDecoders();
+    void setNbFecDecoders(qint32 nb_fec_decoders);
+
+    qint32 getAvgFecDecodeTimeUs();
+    void setAvgFecDecodeTimeUs(qint32 avg_fec_decode_time_us);
+
+    qint32 getMaxFecDecodeTimeUs();
+    void setMaxFecDecodeTimeUs(qint32 max_fec_decode_time_us);
+
+    float getCompressionRatio();
+    void setCompressionRatio(float compression_ratio);
+
+    float getAvgDecompressNsPerSample();
+    void setAvgDecompressNsPerSample(float avg_decompress_ns_per_sample);
+
 
     virtual bool isSet() override;
 
@@ -82,6 +97,21 @@ private:
     qint32 max_nb_recovery;
     bool m_max_nb_recovery_isSet;
 
+    qint32 nb_fec_decoders;
+    bool m_nb_fec_decoders_isSet;
+
+    qint32 avg_fec_decode_time_us;
+    bool m_avg_fec_decode_time_us_isSet;
+
+    qint32 max_fec_decode_time_us;
+    bool m_max_fec_decode_time_us_isSet;
+
+    float compression_ratio;
+    bool m_compression_ratio_isSet;
+
+    float avg_decompress_ns_per_sample;
+    bool m_avg_decompress_ns_per_sample_isSet;
+
 };
 
 }
@@ -0,0 +1,190 @@
+/**
+ * SDRangel
+ * This is the web REST/JSON API of SDRangel SDR software. SDRangel is an Open Source Qt5/OpenGL 3.0+ (4.3+ in Windows) GUI and server Software Defined Radio and signal analyzer in software. It supports Airspy, BladeRF, HackRF, LimeSDR, PlutoSDR, RTL-SDR, SDRplay RSP1 and FunCube    ---   Limitations and specifcities:    * In SDRangel GUI the first Rx device set cannot be deleted. Conversely the server starts with no device sets and its number of device sets can be reduced to zero by as many calls as necessary to /sdrangel/deviceset with DELETE method.   * Preset import and export from/to file is a server only feature.   * Device set focus is a GUI only feature.   * The following channels are not implemented (status 501 is returned): ATV and DATV demodulators, Channel Analyzer NG, LoRa demodulator   * The device settings and report structures contains only the sub-structure corresponding to the device type. The DeviceSettings and DeviceReport structures documented here shows all of them but only one will be or should be present at a time   * The channel settings and report structures contains only the sub-structure corresponding to the channel type. The ChannelSettings and ChannelReport structures documented here shows all of them but only one will be or should be present at a time    --- 
+ *
+ * OpenAPI spec version: 4.3.0
+ * Contact: f4exb06@gmail.com
+ *
+ * NOTE: This class is auto generated by the swagger code generator program.
+ * https://github.com/swagger-api/swagger-codegen.git
+ * Do not edit the class manually.
+ */
+
+
+#include "SWGSampleFifoReport.h"
+
+#include "SWGHelpers.h"
+
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QObject>
+#include <QDebug>
+
+namespace SWGSDRangel {
+
+SWGSampleFifoReport::SWGSampleFifoReport(QString* json) {
+    init();
+    this->fromJson(*json);
+}
+
+SWGSampleFifoReport::SWGSampleFifoReport() {
+    size = 0;
+    m_size_isSet = false;
+    fill = 0;
+    m_fill_isSet = false;
+    overflow_count = 0;
+    m_overflow_count_isSet = false;
+    overflow_samples = 0;
+    m_overflow_samples_isSet = false;
+    underflow_count = 0;
+    m_underflow_count_isSet = false;
+}
+
+SWGSampleFifoReport::~SWGSampleFifoReport() {
+    this->cleanup();
+}
+
+void
+SWGSampleFifoReport::init() {
+    size = 0;
+    m_size_isSet = false;
+    fill = 0;
+    m_fill_isSet = false;
+    overflow_count = 0;
+    m_overflow_count_isSet = false;
+    overflow_samples = 0;
+    m_overflow_samples_isSet = false;
+    underflow_count = 0;
+    m_underflow_count_isSet = false;
+}
+
+void
+SWGSampleFifoReport::cleanup() {
+
+
+
+
+
+}
+
+SWGSampleFifoReport*
+SWGSampleFifoReport::fromJson(QString &json) {
+    QByteArray array (json.toStdString().c_str());
+    QJsonDocument doc = QJsonDocument::fromJson(array);
+    QJsonObject jsonObject = doc.object();
+    this->fromJsonObject(jsonObject);
+    return this;
+}
+
+void
+SWGSampleFifoReport::fromJsonObject(QJsonObject &pJson) {
+    ::SWGSDRangel::setValue(&size, pJson["size"], "qint32", "");
+    
+    ::SWGSDRangel::setValue(&fill, pJson["fill"], "qint32", "");
+    
+    ::SWGSDRangel::setValue(&overflow_count, pJson["overflowCount"], "qint32", "");
+    
+    ::SWGSDRangel::setValue(&overflow_samples, pJson["overflowSamples"], "qint64", "");
+    
+    ::SWGSDRangel::setValue(&underflow_count, pJson["underflowCount"], "qint32", "");
+    
+}
+
+QString
+SWGSampleFifoReport::asJson ()
+{
+    QJsonObject* obj = this->asJsonObject();
+
+    QJsonDocument doc(*obj);
+    QByteArray bytes = doc.toJson();
+    delete obj;
+    return QString(bytes);
+}
+
+QJsonObject*
+SWGSampleFifoReport::asJsonObject() {
+    QJsonObject* obj = new QJsonObject();
+    if(m_size_isSet){
+        obj->insert("size", QJsonValue(size));
+    }
+    if(m_fill_isSet){
+        obj->insert("fill", QJsonValue(fill));
+    }
+    if(m_overflow_count_isSet){
+        obj->insert("overflowCount", QJsonValue(overflow_count));
+    }
+    if(m_overflow_samples_isSet){
+        obj->insert("overflowSamples", QJsonValue(overflow_samples));
+    }
+    if(m_underflow_count_isSet){
+        obj->insert("underflowCount", QJsonValue(underflow_count));
+    }
+
+    return obj;
+}
+
+qint32
+SWGSampleFifoReport::getSize() {
+    return size;
+}
+void
+SWGSampleFifoReport::setSize(qint32 size) {
+    this->size = size;
+    this->m_size_isSet = true;
+}
+
+qint32
+SWGSampleFifoReport::getFill() {
+    return fill;
+}
+void
+SWGSampleFifoReport::setFill(qint32 fill) {
+    this->fill = fill;
+    this->m_fill_isSet = true;
+}
+
+qint32
+SWGSampleFifoReport::getOverflowCount() {
+    return overflow_count;
+}
+void
+SWGSampleFifoReport::setOverflowCount(qint32 overflow_count) {
+    this->overflow_count = overflow_count;
+    this->m_overflow_count_isSet = true;
+}
+
+qint64
+SWGSampleFifoReport::getOverflowSamples() {
+    return overflow_samples;
+}
+void
+SWGSampleFifoReport::setOverflowSamples(qint64 overflow_samples) {
+    this->overflow_samples = overflow_samples;
+    this->m_overflow_samples_isSet = true;
+}
+
+qint32
+SWGSampleFifoReport::getUnderflowCount() {
+    return underflow_count;
+}
+void
+SWGSampleFifoReport::setUnderflowCount(qint32 underflow_count) {
+    this->underflow_count = underflow_count;
+    this->m_underflow_count_isSet = true;
+}
+
+
+bool
+SWGSampleFifoReport::isSet(){
+    bool isObjectUpdated = false;
+    do{
+        if(m_size_isSet){ isObjectUpdated = true; break;}
+        if(m_fill_isSet){ isObjectUpdated = true; break;}
+        if(m_overflow_count_isSet){ isObjectUpdated = true; break;}
+        if(m_overflow_samples_isSet){ isObjectUpdated = true; break;}
+        if(m_underflow_count_isSet){ isObjectUpdated = true; break;}
+    }while(false);
+    return isObjectUpdated;
+}
+}
+